@@ -268,6 +268,7 @@ main (int argc, char *argv[])
   uint16_t numSTAs = 10;                          /* The number of DMG STAs. */
   string qdChannelFolder = "DenseScenario";  /* The name of the folder containing the QD-Channel files. */
   string directory = "";                     /* Path to the directory where to store the results. */
+  bool precompute = false;                        /* Precompute the Q-D channel before starting the simulation. */
 
   /* Command line argument parser setup. */
   CommandLine cmd;
@@ -291,6 +292,7 @@ main (int argc, char *argv[])
   cmd.AddValue ("directory", "Path to the directory where we store the results", directory);
   cmd.AddValue ("reportDataSnr", "Report SNR for data packets = True or for BF Control Packets = False", reportDataSnr);
   cmd.AddValue ("qdChannelFolder", "The name of the folder containing the QD-Channel files", qdChannelFolder);
+  cmd.AddValue ("precompute", "Load all the Q-D traces and array patterns in parallel before starting the simulation", precompute);
   cmd.AddValue ("numSTAs", "The number of DMG STA", numSTAs);
   cmd.AddValue ("pcap", "Enable PCAP Tracing", pcapTracing);
   cmd.AddValue ("snapshotLength", "The maximum PCAP snapshot length in bytes", snapshotLength);
@@ -405,6 +407,12 @@ main (int argc, char *argv[])
   mobilitySta.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
   mobilitySta.Install (staWifiNodes);
 
+  /* Load the Q-D channel of all the communicating pairs before starting the simulation */
+  if (precompute)
+    {
+      qdPropagationEngine->Precompute (NodeContainer (apWifiNode, staWifiNodes));
+    }
+
   /* Internet stack*/
   InternetStackHelper stack;
   stack.Install (apWifiNode);
@@ -0,0 +1,250 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "bucket-heap-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::BucketHeapScheduler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BucketHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (BucketHeapScheduler);
+
+TypeId
+BucketHeapScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BucketHeapScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<BucketHeapScheduler> ()
+  ;
+  return tid;
+}
+
+BucketHeapScheduler::BucketHeapScheduler ()
+  : m_lastBucket (NO_BUCKET)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BucketHeapScheduler::~BucketHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+BucketHeapScheduler::IsLess (const HeapEntry &a, const HeapEntry &b)
+{
+  return (a.ts < b.ts) || ((a.ts == b.ts) && (a.uid < b.uid));
+}
+
+void
+BucketHeapScheduler::SetEntry (uint32_t index, const HeapEntry &entry)
+{
+  m_heap[index] = entry;
+  m_buckets[entry.bucket].heapIndex = index;
+}
+
+void
+BucketHeapScheduler::SiftUp (uint32_t index)
+{
+  HeapEntry entry = m_heap[index];
+  while (index > 0)
+    {
+      uint32_t parent = (index - 1) / 4;
+      if (!IsLess (entry, m_heap[parent]))
+        {
+          break;
+        }
+      SetEntry (index, m_heap[parent]);
+      index = parent;
+    }
+  SetEntry (index, entry);
+}
+
+void
+BucketHeapScheduler::SiftDown (uint32_t index)
+{
+  HeapEntry entry = m_heap[index];
+  uint32_t size = m_heap.size ();
+  while (true)
+    {
+      uint32_t first = 4 * index + 1;
+      if (first >= size)
+        {
+          break;
+        }
+      uint32_t last = std::min (first + 4, size);
+      uint32_t smallest = first;
+      for (uint32_t child = first + 1; child < last; child++)
+        {
+          if (IsLess (m_heap[child], m_heap[smallest]))
+            {
+              smallest = child;
+            }
+        }
+      if (!IsLess (m_heap[smallest], entry))
+        {
+          break;
+        }
+      SetEntry (index, m_heap[smallest]);
+      index = smallest;
+    }
+  SetEntry (index, entry);
+}
+
+uint32_t
+BucketHeapScheduler::AllocateBucket (void)
+{
+  if (!m_freeBuckets.empty ())
+    {
+      uint32_t index = m_freeBuckets.back ();
+      m_freeBuckets.pop_back ();
+      return index;
+    }
+  Bucket bucket;
+  bucket.head = 0;
+  bucket.heapIndex = 0;
+  m_buckets.push_back (bucket);
+  return m_buckets.size () - 1;
+}
+
+void
+BucketHeapScheduler::ReleaseBucket (uint32_t index)
+{
+  Bucket &bucket = m_buckets[index];
+  uint32_t heapIndex = bucket.heapIndex;
+  /* Keep the storage of the events for the next burst */
+  bucket.events.clear ();
+  bucket.head = 0;
+  m_freeBuckets.push_back (index);
+  if (m_lastBucket == index)
+    {
+      m_lastBucket = NO_BUCKET;
+    }
+
+  HeapEntry last = m_heap.back ();
+  m_heap.pop_back ();
+  if (heapIndex < m_heap.size ())
+    {
+      SetEntry (heapIndex, last);
+      SiftDown (heapIndex);
+      SiftUp (m_buckets[last.bucket].heapIndex);
+    }
+}
+
+void
+BucketHeapScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  if (m_lastBucket != NO_BUCKET)
+    {
+      Bucket &bucket = m_buckets[m_lastBucket];
+      const Scheduler::EventKey &key = bucket.events.back ().key;
+      if ((key.m_ts == ev.key.m_ts) && (key.m_uid < ev.key.m_uid))
+        {
+          bucket.events.push_back (ev);
+          return;
+        }
+    }
+  uint32_t index = AllocateBucket ();
+  m_buckets[index].events.push_back (ev);
+  HeapEntry entry;
+  entry.ts = ev.key.m_ts;
+  entry.uid = ev.key.m_uid;
+  entry.bucket = index;
+  m_heap.push_back (entry);
+  SiftUp (m_heap.size () - 1);
+  m_lastBucket = index;
+}
+
+bool
+BucketHeapScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_heap.empty ();
+}
+
+Scheduler::Event
+BucketHeapScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  const Bucket &bucket = m_buckets[m_heap.front ().bucket];
+  return bucket.events[bucket.head];
+}
+
+Scheduler::Event
+BucketHeapScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  uint32_t index = m_heap.front ().bucket;
+  Bucket &bucket = m_buckets[index];
+  Scheduler::Event next = bucket.events[bucket.head];
+  bucket.head++;
+  if (bucket.head == bucket.events.size ())
+    {
+      ReleaseBucket (index);
+    }
+  else if ((bucket.head >= COMPACT_THRESHOLD) && (2 * bucket.head >= bucket.events.size ()))
+    {
+      /* Events keep being appended to the bucket being drained */
+      bucket.events.erase (bucket.events.begin (), bucket.events.begin () + bucket.head);
+      bucket.head = 0;
+    }
+  return next;
+}
+
+void
+BucketHeapScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  for (uint32_t i = 0; i < m_heap.size (); i++)
+    {
+      if (m_heap[i].ts != ev.key.m_ts)
+        {
+          continue;
+        }
+      uint32_t index = m_heap[i].bucket;
+      Bucket &bucket = m_buckets[index];
+      for (uint32_t j = bucket.head; j < bucket.events.size (); j++)
+        {
+          if (bucket.events[j].key.m_uid == ev.key.m_uid)
+            {
+              NS_ASSERT (bucket.events[j].impl == ev.impl);
+              bucket.events.erase (bucket.events.begin () + j);
+              if (bucket.head == bucket.events.size ())
+                {
+                  ReleaseBucket (index);
+                }
+              return;
+            }
+        }
+    }
+  NS_ASSERT (false);
+}
+
+} // namespace ns3
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BUCKET_HEAP_SCHEDULER_H
+#define BUCKET_HEAP_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::BucketHeapScheduler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a 4-ary heap of same-timestamp buckets event scheduler
+ *
+ * This scheduler is tuned for the bursts of events sharing a timestamp,
+ * such as the reception of a frame by all the PHYs of a channel or the
+ * events scheduled for now by a running event. Consecutive insertions
+ * with the same timestamp are appended to a bucket, a plain vector
+ * drained in FIFO order, so that only the first event of a burst goes
+ * through the heap.
+ *
+ * The buckets are kept in an implicit 4-ary heap of compact entries
+ * holding their timestamp and the uid of their first event: a node and
+ * its four children fit in two cache lines and the heap is half as
+ * deep as a binary heap. Emptied buckets are recycled with their
+ * storage, hence the scheduler stops allocating once the event
+ * population is stable.
+ *
+ * An event is only appended to the bucket of the previous insertion,
+ * so the buckets sharing a timestamp hold disjoint ranges of uids and
+ * are ordered by the uid of their first event. This relies on the
+ * simulator implementations assigning increasing uids to the events
+ * they insert.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | Logarithmic     | Constant when appending to the bucket of the previous insertion
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Heap kept in sorted order
+ * Remove()     | Linear          | Search for the bucket and the event
+ * RemoveNext() | Logarithmic     | Constant until the bucket is emptied
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 3 x 3 x `sizeof (*)` + 4 bytes   | 3 x `std::vector`
+ * Per Event | 0 to 48 bytes                    | Heap entry and bucket of the first event of a burst
+ */
+class BucketHeapScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  BucketHeapScheduler ();
+  /** Destructor. */
+  virtual ~BucketHeapScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** The events sharing a timestamp, in FIFO order. */
+  struct Bucket
+  {
+    std::vector<Scheduler::Event> events;  //!< The events, including the ones already removed.
+    uint32_t head;                         //!< The index of the next event.
+    uint32_t heapIndex;                    //!< The index of the heap entry of the bucket.
+  };
+  /** The entry of a bucket in the heap. */
+  struct HeapEntry
+  {
+    uint64_t ts;      //!< The timestamp of the events of the bucket.
+    uint32_t uid;     //!< The uid of the first event of the bucket.
+    uint32_t bucket;  //!< The index of the bucket.
+  };
+
+  /**
+   * Compare two heap entries.
+   * \param [in] a The first entry.
+   * \param [in] b The second entry.
+   * \returns \c true if the bucket of \p a comes first.
+   */
+  static bool IsLess (const HeapEntry &a, const HeapEntry &b);
+  /**
+   * Move an entry up to its place in the heap.
+   * \param [in] index The index of the entry.
+   */
+  void SiftUp (uint32_t index);
+  /**
+   * Move an entry down to its place in the heap.
+   * \param [in] index The index of the entry.
+   */
+  void SiftDown (uint32_t index);
+  /**
+   * Store an entry in the heap and update the index of its bucket.
+   * \param [in] index The index in the heap.
+   * \param [in] entry The entry.
+   */
+  void SetEntry (uint32_t index, const HeapEntry &entry);
+  /**
+   * Get an empty bucket, reusing an emptied one if possible.
+   * \returns The index of the bucket.
+   */
+  uint32_t AllocateBucket (void);
+  /**
+   * Remove an empty bucket from the heap and keep it for reuse.
+   * \param [in] index The index of the bucket.
+   */
+  void ReleaseBucket (uint32_t index);
+
+  /** Marks the absence of a bucket. */
+  static const uint32_t NO_BUCKET = 0xffffffff;
+  /** Drained events are erased from a bucket beyond this number. */
+  static const uint32_t COMPACT_THRESHOLD = 64;
+
+  std::vector<HeapEntry> m_heap;         //!< The 4-ary heap of the non-empty buckets.
+  std::vector<Bucket> m_buckets;         //!< The buckets, empty or not.
+  std::vector<uint32_t> m_freeBuckets;   //!< The indices of the empty buckets.
+  uint32_t m_lastBucket;                 //!< The bucket of the previous insertion.
+};
+
+} // namespace ns3
+
+#endif /* BUCKET_HEAP_SCHEDULER_H */
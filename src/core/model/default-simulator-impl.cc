@@ -22,6 +22,7 @@
 #include "default-simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-allocator.h"
 
 #include "ptr.h"
 #include "pointer.h"
@@ -29,6 +30,7 @@
 #include "log.h"
 
 #include <cmath>
+#include <thread>
 
 
 /**
@@ -58,6 +60,8 @@ DefaultSimulatorImpl::GetTypeId (void)
 }
 
 DefaultSimulatorImpl::DefaultSimulatorImpl ()
+  // enough for the events sent by a few threads between two events of the main thread
+  : m_eventsWithContextQueue (1024)
 {
   NS_LOG_FUNCTION (this);
   m_stop = false;
@@ -72,7 +76,7 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
   m_eventCount = 0;
-  m_eventsWithContextEmpty = true;
+  m_eventsWithContextOverflow = false;
   m_main = SystemThread::Self ();
 }
 
@@ -93,6 +97,7 @@ DefaultSimulatorImpl::DoDispose (void)
       next.impl->Unref ();
     }
   m_events = 0;
+  EventAllocator::Release ();
   SimulatorImpl::DoDispose ();
 }
 void
@@ -163,31 +168,60 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+  if (!m_eventsWithContextOverflow && m_eventsWithContextQueue.IsEmpty ())
     {
       return;
     }
 
-  // swap queues
-  EventsWithContext eventsWithContext;
-  {
-    CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap (eventsWithContext);
-    m_eventsWithContextEmpty = true;
-  }
-  while (!eventsWithContext.empty ())
+  EventWithContext event;
+  if (m_eventsWithContextOverflow)
     {
-      EventWithContext event = eventsWithContext.front ();
-      eventsWithContext.pop_front ();
-      Scheduler::Event ev;
-      ev.impl = event.event;
-      ev.key.m_ts = m_currentTs + event.timestamp;
-      ev.key.m_context = event.context;
-      ev.key.m_uid = m_uid;
-      m_uid++;
-      m_unscheduledEvents++;
-      m_events->Insert (ev);
+      // A thread which has found the lock-free queue full keeps using the
+      // list until it is swapped, so its events in the queue were claimed
+      // either before the swap, and are moved before the list, or after.
+      EventsWithContext eventsWithContext;
+      uint64_t swapPosition;
+      {
+        CriticalSection cs (m_eventsWithContextMutex);
+        m_eventsWithContext.swap (eventsWithContext);
+        swapPosition = m_eventsWithContextQueue.GetEnqueuePosition ();
+        m_eventsWithContextOverflow = false;
+      }
+      while (m_eventsWithContextQueue.GetDequeuePosition () < swapPosition)
+        {
+          if (m_eventsWithContextQueue.Pop (event))
+            {
+              InsertEventWithContext (event);
+            }
+          else
+            {
+              // wait for the producer which claimed the position to publish its event
+              std::this_thread::yield ();
+            }
+        }
+      while (!eventsWithContext.empty ())
+        {
+          InsertEventWithContext (eventsWithContext.front ());
+          eventsWithContext.pop_front ();
+        }
     }
+  while (m_eventsWithContextQueue.Pop (event))
+    {
+      InsertEventWithContext (event);
+    }
+}
+
+void
+DefaultSimulatorImpl::InsertEventWithContext (const EventWithContext &event)
+{
+  Scheduler::Event ev;
+  ev.impl = event.event;
+  ev.key.m_ts = m_currentTs + event.timestamp;
+  ev.key.m_context = event.context;
+  ev.key.m_uid = m_uid;
+  m_uid++;
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
 }
 
 void
@@ -270,11 +304,12 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       // Current time added in ProcessEventsWithContext()
       ev.timestamp = delay.GetTimeStep ();
       ev.event = event;
-      {
-        CriticalSection cs (m_eventsWithContextMutex);
-        m_eventsWithContext.push_back (ev);
-        m_eventsWithContextEmpty = false;
-      }
+      if (m_eventsWithContextOverflow || !m_eventsWithContextQueue.Push (ev))
+        {
+          CriticalSection cs (m_eventsWithContextMutex);
+          m_eventsWithContext.push_back (ev);
+          m_eventsWithContextOverflow = true;
+        }
     }
 }
 
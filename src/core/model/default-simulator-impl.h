@@ -26,9 +26,11 @@
 #include "event-impl.h"
 #include "system-thread.h"
 #include "system-mutex.h"
+#include "mpsc-queue.h"
 
 #include "ptr.h"
 
+#include <atomic>
 #include <list>
 
 /**
@@ -97,15 +99,26 @@ private:
     /** The event implementation. */
     EventImpl *event;
   };
+  /**
+   * Insert an event from a different context into the main event queue.
+   * \param [in] event The event with its context.
+   */
+  void InsertEventWithContext (const EventWithContext &event);
   /** Container type for the events from a different context. */
   typedef std::list<struct EventWithContext> EventsWithContext;
-  /** The container of events from a different context. */
+  /** The lock-free queue of events from a different context. */
+  MpscQueue<EventWithContext> m_eventsWithContextQueue;
+  /**
+   * The container of events from a different context pushed while the
+   * lock-free queue was full, or until the events pushed before have
+   * been moved to the primary event queue.
+   */
   EventsWithContext m_eventsWithContext;
   /**
-   * Flag \c true if all events with context have been moved to the
-   * primary event queue.
+   * Flag \c true if the container of events from a different context is
+   * in use, i.e., the lock-free queue has been found full.
    */
-  bool m_eventsWithContextEmpty;
+  std::atomic<bool> m_eventsWithContextOverflow;
   /** Mutex to control access to the list of events with context. */
   SystemMutex m_eventsWithContextMutex;
 
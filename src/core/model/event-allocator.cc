@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-allocator.h"
+#include "log.h"
+#include <atomic>
+#include <new>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventAllocator implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventAllocator");
+
+namespace {
+
+/** The number of size classes. */
+const std::size_t SIZE_CLASSES = EventAllocator::MAX_SIZE / EventAllocator::GRANULARITY;
+
+/** A released event on a free list. */
+struct FreeBlock
+{
+  FreeBlock *next;  //!< The next released event of the size class.
+};
+
+/**
+ * The free lists and counters of a thread. This is kept trivially
+ * destructible so that events released while the thread exits never
+ * touch a destroyed object.
+ */
+struct ThreadPool
+{
+  FreeBlock *freeLists[SIZE_CLASSES];  //!< The released events of each size class.
+  uint64_t heapAllocations;            //!< The number of events allocated from the heap.
+  uint64_t poolAllocations;            //!< The number of events allocated from the free lists.
+};
+
+/** The free lists of the calling thread. */
+thread_local ThreadPool g_pool;
+
+/**
+ * Whether released events are kept on the free lists. This is shared by
+ * all the threads, which may release events while it is changed.
+ */
+std::atomic<bool> g_enabled (true);
+
+/**
+ * \param [in] size The size of an event.
+ * \returns The index of the size class of the event.
+ */
+inline std::size_t
+GetSizeClass (std::size_t size)
+{
+  return (size - 1) / EventAllocator::GRANULARITY;
+}
+
+} // unnamed namespace
+
+void *
+EventAllocator::Allocate (std::size_t size)
+{
+  if (size == 0 || size > MAX_SIZE)
+    {
+      g_pool.heapAllocations++;
+      return ::operator new (size);
+    }
+  std::size_t sizeClass = GetSizeClass (size);
+  FreeBlock *block = g_pool.freeLists[sizeClass];
+  if (block != 0)
+    {
+      g_pool.freeLists[sizeClass] = block->next;
+      g_pool.poolAllocations++;
+      return block;
+    }
+  g_pool.heapAllocations++;
+  /* Always allocate the whole size class so the event can be reused by
+     any event of its class, even if the free lists are disabled now */
+  return ::operator new ((sizeClass + 1) * GRANULARITY);
+}
+
+void
+EventAllocator::Deallocate (void *ptr, std::size_t size)
+{
+  if (ptr == 0)
+    {
+      return;
+    }
+  if (!g_enabled.load (std::memory_order_relaxed) || size == 0 || size > MAX_SIZE)
+    {
+      ::operator delete (ptr);
+      return;
+    }
+  std::size_t sizeClass = GetSizeClass (size);
+  FreeBlock *block = static_cast<FreeBlock *> (ptr);
+  block->next = g_pool.freeLists[sizeClass];
+  g_pool.freeLists[sizeClass] = block;
+}
+
+void
+EventAllocator::Release (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  for (std::size_t i = 0; i < SIZE_CLASSES; i++)
+    {
+      while (g_pool.freeLists[i] != 0)
+        {
+          FreeBlock *block = g_pool.freeLists[i];
+          g_pool.freeLists[i] = block->next;
+          ::operator delete (block);
+        }
+    }
+}
+
+void
+EventAllocator::SetEnabled (bool enabled)
+{
+  NS_LOG_FUNCTION (enabled);
+  g_enabled.store (enabled, std::memory_order_relaxed);
+  if (!enabled)
+    {
+      Release ();
+    }
+}
+
+bool
+EventAllocator::IsEnabled (void)
+{
+  return g_enabled.load (std::memory_order_relaxed);
+}
+
+uint64_t
+EventAllocator::GetHeapAllocations (void)
+{
+  return g_pool.heapAllocations;
+}
+
+uint64_t
+EventAllocator::GetPoolAllocations (void)
+{
+  return g_pool.poolAllocations;
+}
+
+void
+EventAllocator::ResetCounters (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_pool.heapAllocations = 0;
+  g_pool.poolAllocations = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_ALLOCATOR_H
+#define EVENT_ALLOCATOR_H
+
+#include <stdint.h>
+#include <cstddef>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventAllocator declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief The allocator of the memory of the simulation events.
+ *
+ * Every event created by one of the MakeEvent functions, hence by
+ * every Simulator::Schedule call, used to be a separate heap
+ * allocation released as soon as the event was run or cancelled.
+ * EventImpl routes its allocations here instead: the sizes are
+ * rounded up to a multiple of GRANULARITY and the memory of a released
+ * event is kept on a free list of its size class, to be handed out to
+ * the next event of the same class without going through the heap.
+ * Events larger than MAX_SIZE are allocated from the heap directly.
+ *
+ * The free lists belong to the thread releasing the events, which is
+ * the thread running the simulator for all but the events scheduled
+ * with context from other threads, so that no locking is needed.
+ * The simulator implementations release the free lists of their thread
+ * when they are disposed.
+ */
+class EventAllocator
+{
+public:
+  /** The size classes are multiples of this number of bytes. */
+  static const std::size_t GRANULARITY = 16;
+  /** The size of the largest events kept on the free lists. */
+  static const std::size_t MAX_SIZE = 256;
+
+  /**
+   * Allocate the memory of an event.
+   * \param [in] size The size of the event.
+   * \returns The memory of the event.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Release the memory of an event.
+   * \param [in] ptr The memory of the event.
+   * \param [in] size The size the event was allocated with.
+   */
+  static void Deallocate (void *ptr, std::size_t size);
+  /**
+   * Return the memory kept on the free lists of the calling thread
+   * to the heap.
+   */
+  static void Release (void);
+  /**
+   * Enable or disable the free lists of all the threads, mostly to measure
+   * their effect. Only the free lists of the calling thread are released
+   * when they are disabled; the other threads stop filling theirs.
+   * \param [in] enabled Whether released events are kept on the free lists.
+   */
+  static void SetEnabled (bool enabled);
+  /**
+   * \returns Whether released events are kept on the free lists.
+   */
+  static bool IsEnabled (void);
+  /**
+   * \returns The number of events the calling thread allocated from the heap.
+   */
+  static uint64_t GetHeapAllocations (void);
+  /**
+   * \returns The number of events the calling thread allocated from the free lists.
+   */
+  static uint64_t GetPoolAllocations (void);
+  /**
+   * Reset the allocation counters of the calling thread.
+   */
+  static void ResetCounters (void);
+};
+
+} // namespace ns3
+
+#endif /* EVENT_ALLOCATOR_H */
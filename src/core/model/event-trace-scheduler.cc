@@ -0,0 +1,250 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-trace-scheduler.h"
+#include "event-impl.h"
+#include "map-scheduler.h"
+#include "abort.h"
+#include "assert.h"
+#include "log.h"
+#include "simulator.h"
+#include "string.h"
+#include <cstring>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::EventTraceScheduler and ns3::EventTraceReader implementations.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventTraceScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (EventTraceScheduler);
+
+namespace {
+
+/** The header of the event traces, the last byte is the version. */
+const char TRACE_HEADER[8] = { 'n', 's', '3', 'e', 'v', 't', 'r', 1 };
+
+/** The trace file shared by all the schedulers of the process. */
+std::ofstream g_traceFile;
+/** The name of the trace file. */
+std::string g_traceFileName;
+
+/**
+ * Append a value to a trace.
+ * \param [in] file The trace file.
+ * \param [in] value The value.
+ */
+template <typename T>
+void
+WriteValue (std::ofstream *file, T value)
+{
+  file->write (reinterpret_cast<const char *> (&value), sizeof (value));
+}
+
+/**
+ * Read a value from a trace.
+ * \param [in] file The trace file.
+ * \param [out] value The value.
+ * \returns \c false at the end of the trace.
+ */
+template <typename T>
+bool
+ReadValue (std::ifstream &file, T &value)
+{
+  file.read (reinterpret_cast<char *> (&value), sizeof (value));
+  return file.good ();
+}
+
+} // unnamed namespace
+
+TypeId
+EventTraceScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::EventTraceScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<EventTraceScheduler> ()
+    .AddAttribute ("Scheduler",
+                   "The factory of the recorded scheduler.",
+                   ObjectFactoryValue (ObjectFactory ("ns3::MapScheduler")),
+                   MakeObjectFactoryAccessor (&EventTraceScheduler::SetScheduler),
+                   MakeObjectFactoryChecker ())
+    .AddAttribute ("FileName",
+                   "The file the events are recorded to, nothing is recorded if empty.",
+                   StringValue (""),
+                   MakeStringAccessor (&EventTraceScheduler::SetFileName),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+EventTraceScheduler::EventTraceScheduler ()
+  : m_file (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+EventTraceScheduler::~EventTraceScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file != 0)
+    {
+      m_file->flush ();
+    }
+}
+
+void
+EventTraceScheduler::SetScheduler (ObjectFactory factory)
+{
+  NS_LOG_FUNCTION (this << factory);
+  NS_ASSERT (m_scheduler == 0 || m_scheduler->IsEmpty ());
+  m_scheduler = factory.Create<Scheduler> ();
+}
+
+void
+EventTraceScheduler::SetFileName (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  if (fileName.empty ())
+    {
+      m_file = 0;
+      return;
+    }
+  if (fileName != g_traceFileName)
+    {
+      if (g_traceFile.is_open ())
+        {
+          g_traceFile.close ();
+        }
+      g_traceFile.open (fileName.c_str (), std::ios::out | std::ios::trunc | std::ios::binary);
+      NS_ABORT_MSG_IF (!g_traceFile.is_open (), "Cannot open " << fileName);
+      g_traceFile.write (TRACE_HEADER, sizeof (TRACE_HEADER));
+      g_traceFileName = fileName;
+    }
+  m_file = &g_traceFile;
+  WriteValue<uint8_t> (m_file, EventTraceRecord::BEGIN);
+}
+
+void
+EventTraceScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  if (m_file != 0)
+    {
+      WriteValue<uint8_t> (m_file, EventTraceRecord::INSERT);
+      WriteValue<uint64_t> (m_file, ev.key.m_ts);
+      WriteValue<uint64_t> (m_file, Simulator::Now ().GetTimeStep ());
+      WriteValue<uint32_t> (m_file, ev.key.m_uid);
+      WriteValue<uint32_t> (m_file, ev.key.m_context);
+    }
+  m_scheduler->Insert (ev);
+}
+
+bool
+EventTraceScheduler::IsEmpty (void) const
+{
+  return m_scheduler->IsEmpty ();
+}
+
+Scheduler::Event
+EventTraceScheduler::PeekNext (void) const
+{
+  return m_scheduler->PeekNext ();
+}
+
+Scheduler::Event
+EventTraceScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  Scheduler::Event ev = m_scheduler->RemoveNext ();
+  if (m_file != 0)
+    {
+      WriteValue<uint8_t> (m_file, EventTraceRecord::REMOVE_NEXT);
+      WriteValue<uint32_t> (m_file, ev.key.m_uid);
+      WriteValue<uint8_t> (m_file, (ev.impl != 0 && ev.impl->IsCancelled ()) ? 1 : 0);
+    }
+  return ev;
+}
+
+void
+EventTraceScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  if (m_file != 0)
+    {
+      WriteValue<uint8_t> (m_file, EventTraceRecord::REMOVE);
+      WriteValue<uint64_t> (m_file, ev.key.m_ts);
+      WriteValue<uint32_t> (m_file, ev.key.m_uid);
+    }
+  m_scheduler->Remove (ev);
+}
+
+EventTraceReader::EventTraceReader ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+EventTraceReader::Open (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  m_file.open (fileName.c_str (), std::ios::in | std::ios::binary);
+  char header[sizeof (TRACE_HEADER)];
+  m_file.read (header, sizeof (header));
+  return m_file.good () && (std::memcmp (header, TRACE_HEADER, sizeof (header)) == 0);
+}
+
+bool
+EventTraceReader::Read (EventTraceRecord &record)
+{
+  uint8_t type;
+  if (!ReadValue (m_file, type))
+    {
+      return false;
+    }
+  record.type = static_cast<EventTraceRecord::Type> (type);
+  record.ts = 0;
+  record.now = 0;
+  record.uid = 0;
+  record.context = 0;
+  record.cancelled = false;
+  switch (record.type)
+    {
+    case EventTraceRecord::BEGIN:
+      return true;
+    case EventTraceRecord::INSERT:
+      return ReadValue (m_file, record.ts) && ReadValue (m_file, record.now)
+             && ReadValue (m_file, record.uid) && ReadValue (m_file, record.context);
+    case EventTraceRecord::REMOVE_NEXT:
+      {
+        uint8_t cancelled;
+        bool ok = ReadValue (m_file, record.uid) && ReadValue (m_file, cancelled);
+        record.cancelled = (cancelled != 0);
+        return ok;
+      }
+    case EventTraceRecord::REMOVE:
+      return ReadValue (m_file, record.ts) && ReadValue (m_file, record.uid);
+    default:
+      NS_ABORT_MSG ("Corrupted event trace, unknown record type " << +type);
+    }
+  return false;
+}
+
+} // namespace ns3
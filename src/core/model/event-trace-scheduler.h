@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_TRACE_SCHEDULER_H
+#define EVENT_TRACE_SCHEDULER_H
+
+#include "scheduler.h"
+#include "object-factory.h"
+#include "ptr.h"
+#include <fstream>
+#include <stdint.h>
+#include <string>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::EventTraceScheduler and ns3::EventTraceReader declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * A record of an event trace.
+ */
+struct EventTraceRecord
+{
+  /** The operations recorded in an event trace. */
+  enum Type
+  {
+    BEGIN = 0,        //!< A new scheduler starts, e.g., a new simulation.
+    INSERT = 1,       //!< An event is scheduled.
+    REMOVE_NEXT = 2,  //!< The next event is run, or discarded if cancelled.
+    REMOVE = 3        //!< An event is removed with Simulator::Remove.
+  };
+
+  Type type;          //!< The operation.
+  uint64_t ts;        //!< The timestamp of the event (INSERT and REMOVE).
+  uint64_t now;       //!< The simulation time the event was scheduled at (INSERT).
+  uint32_t uid;       //!< The uid of the event (all but BEGIN).
+  uint32_t context;   //!< The context of the event (INSERT).
+  bool cancelled;     //!< Whether the event was cancelled (REMOVE_NEXT).
+};
+
+/**
+ * \ingroup scheduler
+ * \brief A scheduler recording the events going through another scheduler.
+ *
+ * Every operation changing the event list is forwarded to the Scheduler
+ * created by the Scheduler attribute and appended to a binary event
+ * trace, which can be replayed against any scheduler without the model
+ * code (see utils/bench-event-trace.cc). The trace holds the timestamp,
+ * context and insertion time of every event, the order in which the
+ * events are run, whether they were cancelled, and the events removed
+ * with Simulator::Remove.
+ *
+ * The simulator records its events when the EventTraceFile global
+ * value is set. The trace starts with an 8 bytes header, followed by a
+ * BEGIN record for every scheduler created in the process, e.g., for
+ * every simulation, and by the records of that scheduler. The records
+ * are made of a type byte followed by:
+ *  - INSERT: the timestamp, insertion time (uint64_t), uid and context (uint32_t);
+ *  - REMOVE_NEXT: the uid (uint32_t) and whether the event was cancelled (uint8_t);
+ *  - REMOVE: the timestamp (uint64_t) and uid (uint32_t);
+ *
+ * in host byte order, with the times in time steps.
+ */
+class EventTraceScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  EventTraceScheduler ();
+  /** Destructor. */
+  virtual ~EventTraceScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /**
+   * Create the recorded scheduler.
+   * \param [in] factory The factory of the recorded scheduler.
+   */
+  void SetScheduler (ObjectFactory factory);
+  /**
+   * Open the trace, appending to it if another scheduler of the process
+   * already opened it.
+   * \param [in] fileName The name of the trace file.
+   */
+  void SetFileName (std::string fileName);
+
+  Ptr<Scheduler> m_scheduler;   //!< The recorded scheduler.
+  std::ofstream *m_file;        //!< The trace file.
+};
+
+/**
+ * \ingroup scheduler
+ * \brief A reader of the event traces written by the EventTraceScheduler.
+ */
+class EventTraceReader
+{
+public:
+  /** Constructor. */
+  EventTraceReader ();
+  /**
+   * Open an event trace.
+   * \param [in] fileName The name of the trace file.
+   * \returns \c false if the file cannot be opened or is not an event trace.
+   */
+  bool Open (std::string fileName);
+  /**
+   * Read the next record of the trace.
+   * \param [out] record The record.
+   * \returns \c false at the end of the trace.
+   */
+  bool Read (EventTraceRecord &record);
+
+private:
+  std::ifstream m_file;   //!< The trace file.
+};
+
+} // namespace ns3
+
+#endif /* EVENT_TRACE_SCHEDULER_H */
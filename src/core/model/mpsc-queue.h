@@ -0,0 +1,230 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "assert.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup thread
+ * ns3::MpscQueue declaration and implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * @ingroup thread
+ * @brief A bounded lock-free queue with multiple producers and a single consumer.
+ *
+ * The queue is a ring of cells, each tagged with a sequence number
+ * telling whether the cell is free for the producer claiming a given
+ * position or holds an item ready for the consumer. A producer claims
+ * a position with a single compare-and-swap and then publishes its item
+ * in the cell, so producers never block each other nor the consumer.
+ * Push fails instead of waiting when the ring is full, leaving the
+ * overflow policy to the caller.
+ *
+ * Items are popped in the order in which their positions were claimed,
+ * hence the items pushed by one thread are popped in the order they were
+ * pushed. An item whose position has been claimed but which has not been
+ * published yet stops Pop until it is published.
+ *
+ * Push can be called from any thread, while Pop, IsEmpty and
+ * GetDequeuePosition must only be called from the consumer thread.
+ *
+ * @tparam T \explicit The type of the items, which must be copy-assignable.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+  /**
+   * Constructor.
+   * @param [in] capacity The number of items the queue can hold, rounded
+   * up to a power of two.
+   */
+  MpscQueue (uint32_t capacity);
+
+  /**
+   * Append an item to the queue.
+   * @param [in] item The item.
+   * @return \c false if the queue is full.
+   */
+  bool Push (const T &item);
+  /**
+   * Remove the item at the head of the queue.
+   * @param [out] item The item.
+   * @return \c false if the queue is empty or the item at its head has
+   * not been published yet.
+   */
+  bool Pop (T &item);
+  /**
+   * @return \c true if there is no item ready to be popped.
+   */
+  bool IsEmpty (void) const;
+  /**
+   * @return The number of items the queue can hold.
+   */
+  uint32_t GetCapacity (void) const;
+  /**
+   * @return The number of positions claimed by the producers so far.
+   */
+  uint64_t GetEnqueuePosition (void) const;
+  /**
+   * @return The number of items popped by the consumer so far.
+   */
+  uint64_t GetDequeuePosition (void) const;
+
+private:
+  /** A cell of the ring. */
+  struct Cell
+  {
+    /** The position the cell is ready for, plus one once its item is published. */
+    std::atomic<uint64_t> sequence;
+    /** The item. */
+    T item;
+  };
+
+  /** The ring of cells. */
+  std::vector<Cell> m_cells;
+  /** The mask giving the index of the cell of a position. */
+  uint64_t m_mask;
+  /** The next position to be claimed by a producer. */
+  std::atomic<uint64_t> m_enqueuePosition;
+  /** Padding to keep the positions of the producers and of the consumer on separate cache lines. */
+  char m_padding[64];
+  /** The next position to be popped by the consumer. */
+  uint64_t m_dequeuePosition;
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+MpscQueue<T>::MpscQueue (uint32_t capacity)
+  : m_enqueuePosition (0),
+    m_dequeuePosition (0)
+{
+  NS_ASSERT (capacity > 0);
+  uint64_t size = 1;
+  while (size < capacity)
+    {
+      size <<= 1;
+    }
+  m_mask = size - 1;
+  std::vector<Cell> cells (size);
+  m_cells.swap (cells);
+  for (uint64_t i = 0; i < size; i++)
+    {
+      m_cells[i].sequence.store (i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Push (const T &item)
+{
+  uint64_t position = m_enqueuePosition.load (std::memory_order_relaxed);
+  Cell *cell;
+  while (true)
+    {
+      cell = &m_cells[position & m_mask];
+      uint64_t sequence = cell->sequence.load (std::memory_order_acquire);
+      int64_t diff = static_cast<int64_t> (sequence - position);
+      if (diff == 0)
+        {
+          // the cell is free, try to claim its position
+          if (m_enqueuePosition.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          // the cell still holds the item of the previous lap
+          return false;
+        }
+      else
+        {
+          // another producer claimed this position
+          position = m_enqueuePosition.load (std::memory_order_relaxed);
+        }
+    }
+  cell->item = item;
+  cell->sequence.store (position + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Pop (T &item)
+{
+  Cell *cell = &m_cells[m_dequeuePosition & m_mask];
+  if (cell->sequence.load (std::memory_order_acquire) != m_dequeuePosition + 1)
+    {
+      return false;
+    }
+  item = cell->item;
+  // free the cell for the next lap
+  cell->sequence.store (m_dequeuePosition + m_mask + 1, std::memory_order_release);
+  m_dequeuePosition++;
+  return true;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty (void) const
+{
+  const Cell *cell = &m_cells[m_dequeuePosition & m_mask];
+  return cell->sequence.load (std::memory_order_acquire) != m_dequeuePosition + 1;
+}
+
+template <typename T>
+uint32_t
+MpscQueue<T>::GetCapacity (void) const
+{
+  return static_cast<uint32_t> (m_mask + 1);
+}
+
+template <typename T>
+uint64_t
+MpscQueue<T>::GetEnqueuePosition (void) const
+{
+  return m_enqueuePosition.load ();
+}
+
+template <typename T>
+uint64_t
+MpscQueue<T>::GetDequeuePosition (void) const
+{
+  return m_dequeuePosition;
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
@@ -21,6 +21,7 @@
 #include "wall-clock-synchronizer.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-allocator.h"
 #include "synchronizer.h"
 
 #include "ptr.h"
@@ -115,6 +116,7 @@ RealtimeSimulatorImpl::DoDispose (void)
     }
   m_events = 0;
   m_synchronizer = 0;
+  EventAllocator::Release ();
   SimulatorImpl::DoDispose ();
 }
 
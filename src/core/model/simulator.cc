@@ -22,6 +22,7 @@
 #include "simulator-impl.h"
 #include "scheduler.h"
 #include "map-scheduler.h"
+#include "event-trace-scheduler.h"
 #include "event-impl.h"
 #include "des-metrics.h"
 
@@ -78,6 +79,38 @@ static GlobalValue g_schedTypeImpl = GlobalValue ("SchedulerType",
                                                   TypeIdValue (MapScheduler::GetTypeId ()),
                                                   MakeTypeIdChecker ());
 
+/**
+ * \ingroup scheduler
+ * \anchor GlobalValueEventTraceFile
+ * The file the events of the simulations are recorded to by an
+ * EventTraceScheduler, nothing is recorded if empty.
+ */
+static GlobalValue g_eventTraceFile = GlobalValue ("EventTraceFile",
+                                                   "The file the events are recorded to, nothing is recorded if empty",
+                                                   StringValue (""),
+                                                   MakeStringChecker ());
+
+/**
+ * \ingroup scheduler
+ * \brief Wrap a scheduler in an EventTraceScheduler if the events are recorded.
+ * \param [in] schedulerFactory The factory of the scheduler.
+ * \return The factory of the scheduler to use.
+ */
+static ObjectFactory
+GetSchedulerFactory (ObjectFactory schedulerFactory)
+{
+  StringValue fileName;
+  g_eventTraceFile.GetValue (fileName);
+  if (fileName.Get ().empty ())
+    {
+      return schedulerFactory;
+    }
+  ObjectFactory factory ("ns3::EventTraceScheduler");
+  factory.Set ("Scheduler", ObjectFactoryValue (schedulerFactory));
+  factory.Set ("FileName", fileName);
+  return factory;
+}
+
 /**
  * \ingroup simulator
  * \brief Get the static SimulatorImpl instance.
@@ -116,7 +149,7 @@ static SimulatorImpl * GetImpl (void)
         StringValue s;
         g_schedTypeImpl.GetValue (s);
         factory.SetTypeId (s.Get ());
-        (*pimpl)->SetScheduler (factory);
+        (*pimpl)->SetScheduler (GetSchedulerFactory (factory));
       }
 
 //
@@ -158,7 +191,7 @@ void
 Simulator::SetScheduler (ObjectFactory schedulerFactory)
 {
   NS_LOG_FUNCTION (schedulerFactory);
-  GetImpl ()->SetScheduler (schedulerFactory);
+  GetImpl ()->SetScheduler (GetSchedulerFactory (schedulerFactory));
 }
 
 bool
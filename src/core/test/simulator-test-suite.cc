@@ -19,11 +19,19 @@
  */
 #include "ns3/test.h"
 #include "ns3/simulator.h"
+#include "ns3/event-allocator.h"
+#include "ns3/event-impl.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/bucket-heap-scheduler.h"
+#include "ns3/event-trace-scheduler.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/random-variable-stream.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -465,6 +473,193 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SimulatorEventAllocatorTestCase : public TestCase
+{
+public:
+  SimulatorEventAllocatorTestCase ();
+  virtual void DoRun (void);
+  void Chain (uint32_t remaining);
+  void Cancelled (void);
+  uint32_t m_chained;
+  bool m_cancelledRun;
+};
+
+SimulatorEventAllocatorTestCase::SimulatorEventAllocatorTestCase ()
+  : TestCase ("Check that the memory of the events run or cancelled is reused")
+{}
+void
+SimulatorEventAllocatorTestCase::Chain (uint32_t remaining)
+{
+  m_chained++;
+  if (remaining > 0)
+    {
+      Simulator::Schedule (Seconds (1.0), &SimulatorEventAllocatorTestCase::Chain, this, remaining - 1);
+    }
+}
+void
+SimulatorEventAllocatorTestCase::Cancelled (void)
+{
+  m_cancelledRun = true;
+}
+void
+SimulatorEventAllocatorTestCase::DoRun (void)
+{
+  m_chained = 0;
+  m_cancelledRun = false;
+  bool enabled = EventAllocator::IsEnabled ();
+  EventAllocator::SetEnabled (true);
+  EventAllocator::Release ();
+  EventAllocator::ResetCounters ();
+
+  EventId cancelled = Simulator::Schedule (Seconds (5.0), &SimulatorEventAllocatorTestCase::Cancelled, this);
+  Simulator::Cancel (cancelled);
+  Simulator::Schedule (Seconds (1.0), &SimulatorEventAllocatorTestCase::Chain, this, 99);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_chained, 100, "All the chained events should have run");
+  NS_TEST_EXPECT_MSG_EQ (m_cancelledRun, false, "The cancelled event should not have run");
+  // the cancelled event is kept alive by its EventId
+  NS_TEST_EXPECT_MSG_EQ (cancelled.PeekEventImpl ()->IsCancelled (), true, "The cancelled event should not have been reused");
+  // each chained event is scheduled before the previous one is released
+  NS_TEST_EXPECT_MSG_EQ (EventAllocator::GetHeapAllocations (), 3, "Only the first events should come from the heap");
+  NS_TEST_EXPECT_MSG_EQ (EventAllocator::GetPoolAllocations (), 98, "The chained events should reuse the released ones");
+
+  Simulator::Destroy ();
+  EventAllocator::SetEnabled (enabled);
+}
+
+class SchedulerBurstsTestCase : public TestCase
+{
+public:
+  SchedulerBurstsTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerBurstsTestCase::SchedulerBurstsTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that bursts of events with the same timestamp are ordered like with the MapScheduler by " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{}
+void
+SchedulerBurstsTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<Scheduler> reference = CreateObject<MapScheduler> ();
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  std::vector<Scheduler::Event> pending;
+  uint64_t now = 0;
+  uint32_t uid = 1;
+
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      double action = random->GetValue ();
+      if (action < 0.6 || reference->IsEmpty ())
+        {
+          // half of the events are scheduled for now, the others in bursts
+          uint32_t delay = random->GetInteger (0, 9);
+          Scheduler::Event ev;
+          ev.impl = 0;
+          ev.key.m_ts = now + ((delay < 5) ? 0 : delay * 10);
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          scheduler->Insert (ev);
+          reference->Insert (ev);
+          pending.push_back (ev);
+        }
+      else if (action < 0.9)
+        {
+          NS_TEST_ASSERT_MSG_EQ (scheduler->PeekNext ().key.m_uid, reference->PeekNext ().key.m_uid, "Wrong next event");
+          Scheduler::Event next = scheduler->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (next.key.m_uid, reference->RemoveNext ().key.m_uid, "Wrong event removed");
+          now = next.key.m_ts;
+          for (uint32_t j = 0; j < pending.size (); j++)
+            {
+              if (pending[j].key.m_uid == next.key.m_uid)
+                {
+                  pending[j] = pending.back ();
+                  pending.pop_back ();
+                  break;
+                }
+            }
+        }
+      else
+        {
+          uint32_t j = random->GetInteger (0, pending.size () - 1);
+          scheduler->Remove (pending[j]);
+          reference->Remove (pending[j]);
+          pending[j] = pending.back ();
+          pending.pop_back ();
+        }
+    }
+  while (!reference->IsEmpty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), false, "Events lost");
+      NS_TEST_ASSERT_MSG_EQ (scheduler->RemoveNext ().key.m_uid, reference->RemoveNext ().key.m_uid, "Wrong event removed");
+    }
+  NS_TEST_EXPECT_MSG_EQ (scheduler->IsEmpty (), true, "Events left");
+}
+
+class SimulatorEventTraceTestCase : public TestCase
+{
+public:
+  SimulatorEventTraceTestCase ();
+  virtual void DoRun (void);
+  void First (void);
+  void Event (void);
+};
+
+SimulatorEventTraceTestCase::SimulatorEventTraceTestCase ()
+  : TestCase ("Check that the events of a simulation are recorded in the event trace")
+{}
+void
+SimulatorEventTraceTestCase::First (void)
+{
+  Simulator::ScheduleWithContext (7, MicroSeconds (5), &SimulatorEventTraceTestCase::Event, this);
+}
+void
+SimulatorEventTraceTestCase::Event (void)
+{}
+void
+SimulatorEventTraceTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("simulator-event-trace.evt");
+  Config::SetGlobal ("EventTraceFile", StringValue (fileName));
+  Simulator::Schedule (MicroSeconds (1), &SimulatorEventTraceTestCase::First, this);
+  EventId cancelled = Simulator::Schedule (MicroSeconds (2), &SimulatorEventTraceTestCase::Event, this);
+  EventId removed = Simulator::Schedule (MicroSeconds (3), &SimulatorEventTraceTestCase::Event, this);
+  Simulator::Cancel (cancelled);
+  Simulator::Remove (removed);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::SetGlobal ("EventTraceFile", StringValue (""));
+
+  EventTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (fileName), true, "Cannot open the event trace");
+  std::vector<EventTraceRecord> records;
+  EventTraceRecord record;
+  while (reader.Read (record))
+    {
+      records.push_back (record);
+    }
+  NS_TEST_ASSERT_MSG_EQ (records.size (), 9, "Wrong number of records");
+  NS_TEST_EXPECT_MSG_EQ (records[0].type, EventTraceRecord::BEGIN, "The trace should start with a new scheduler");
+  NS_TEST_EXPECT_MSG_EQ (records[1].type, EventTraceRecord::INSERT, "The first event should have been scheduled");
+  NS_TEST_EXPECT_MSG_EQ (records[1].ts, static_cast<uint64_t> (MicroSeconds (1).GetTimeStep ()), "Wrong timestamp");
+  NS_TEST_EXPECT_MSG_EQ (records[4].type, EventTraceRecord::REMOVE, "The third event should have been removed");
+  NS_TEST_EXPECT_MSG_EQ (records[4].uid, records[3].uid, "Wrong event removed");
+  NS_TEST_EXPECT_MSG_EQ (records[5].type, EventTraceRecord::REMOVE_NEXT, "The first event should have run");
+  NS_TEST_EXPECT_MSG_EQ (records[5].uid, records[1].uid, "Wrong event run");
+  NS_TEST_EXPECT_MSG_EQ (records[6].type, EventTraceRecord::INSERT, "The first event should have scheduled another one");
+  NS_TEST_EXPECT_MSG_EQ (records[6].now, static_cast<uint64_t> (MicroSeconds (1).GetTimeStep ()), "Wrong insertion time");
+  NS_TEST_EXPECT_MSG_EQ (records[6].context, 7, "Wrong context");
+  NS_TEST_EXPECT_MSG_EQ (records[7].type, EventTraceRecord::REMOVE_NEXT, "The cancelled event should have been removed");
+  NS_TEST_EXPECT_MSG_EQ (records[7].cancelled, true, "The event should have been cancelled");
+  NS_TEST_EXPECT_MSG_EQ (records[8].uid, records[6].uid, "The last event should have run");
+  NS_TEST_EXPECT_MSG_EQ (records[8].cancelled, false, "The last event should not have been cancelled");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -483,5 +678,10 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (BucketHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SchedulerBurstsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorEventAllocatorTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorEventTraceTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
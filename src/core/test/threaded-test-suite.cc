@@ -27,11 +27,13 @@
 #include "ns3/string.h"
 #include "ns3/system-thread.h"
 
+#include <atomic>
 #include <chrono>  // seconds, milliseconds
 #include <ctime>
 #include <list>
 #include <thread>  // sleep_for
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -225,6 +227,121 @@ ThreadedSimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * Stress the queue of the events scheduled from other threads: many
+ * threads schedule events while the simulator is blocked, which fills
+ * the lock-free queue of DefaultSimulatorImpl and forces its overflow
+ * list, and then while the simulator runs. Check that no event is lost
+ * and that the events of each thread are run in the order in which
+ * they were scheduled.
+ */
+class ThreadedContextQueueStressTestCase : public TestCase
+{
+public:
+  ThreadedContextQueueStressTestCase (unsigned int threads, unsigned int events);
+  static void SchedulingThread (std::pair<ThreadedContextQueueStressTestCase *, unsigned int> context);
+  void Event (unsigned int threadno, unsigned int seq);
+  void WaitForThreads (void);
+  void Poll (void);
+  unsigned int m_threads;
+  unsigned int m_events;
+  std::atomic<unsigned int> m_done;
+  std::vector<unsigned int> m_received;
+  uint64_t m_total;
+  std::string m_error;
+  std::list<Ptr<SystemThread> > m_threadlist;
+
+private:
+  virtual void DoRun (void);
+};
+
+ThreadedContextQueueStressTestCase::ThreadedContextQueueStressTestCase (unsigned int threads, unsigned int events)
+  : TestCase ("Check the order of " + std::to_string (events) + " events scheduled by each of " +
+              std::to_string (threads) + " threads in ns3::DefaultSimulatorImpl"),
+    m_threads (threads),
+    m_events (events)
+{}
+
+void
+ThreadedContextQueueStressTestCase::SchedulingThread (std::pair<ThreadedContextQueueStressTestCase *, unsigned int> context)
+{
+  ThreadedContextQueueStressTestCase *me = context.first;
+  unsigned int threadno = context.second;
+  for (unsigned int seq = 0; seq < me->m_events; seq++)
+    {
+      Simulator::ScheduleWithContext (threadno, Seconds (0),
+                                      &ThreadedContextQueueStressTestCase::Event, me, threadno, seq);
+      if (seq == me->m_events / 2)
+        {
+          // let the simulator run the first half of the events
+          me->m_done++;
+        }
+    }
+  me->m_done++;
+}
+void
+ThreadedContextQueueStressTestCase::Event (unsigned int threadno, unsigned int seq)
+{
+  if (m_received[threadno] != seq)
+    {
+      m_error = "Events of thread " + std::to_string (threadno) + " out of order";
+    }
+  m_received[threadno] = seq + 1;
+  m_total++;
+}
+void
+ThreadedContextQueueStressTestCase::WaitForThreads (void)
+{
+  // block the simulator until every thread has scheduled half of its events
+  while (m_done < m_threads)
+    {
+      std::this_thread::sleep_for (std::chrono::microseconds (100));
+    }
+}
+void
+ThreadedContextQueueStressTestCase::Poll (void)
+{
+  if ((m_done < 2 * m_threads) || (m_total < static_cast<uint64_t> (m_threads) * m_events))
+    {
+      Simulator::Schedule (NanoSeconds (1), &ThreadedContextQueueStressTestCase::Poll, this);
+    }
+}
+void
+ThreadedContextQueueStressTestCase::DoRun (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  m_done = 0;
+  m_total = 0;
+  m_received = std::vector<unsigned int> (m_threads, 0);
+  m_error = "";
+
+  Simulator::Schedule (MicroSeconds (1), &ThreadedContextQueueStressTestCase::WaitForThreads, this);
+  Simulator::Schedule (MicroSeconds (2), &ThreadedContextQueueStressTestCase::Poll, this);
+  for (unsigned int i = 0; i < m_threads; ++i)
+    {
+      m_threadlist.push_back (
+        Create<SystemThread> (MakeBoundCallback (
+                                &ThreadedContextQueueStressTestCase::SchedulingThread,
+                                std::pair<ThreadedContextQueueStressTestCase *, unsigned int> (this, i) )) );
+      m_threadlist.back ()->Start ();
+    }
+
+  Simulator::Run ();
+  for (std::list<Ptr<SystemThread> >::iterator it = m_threadlist.begin (); it != m_threadlist.end (); ++it)
+    {
+      (*it)->Join ();
+    }
+  m_threadlist.clear ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_error.empty (), true, m_error.c_str ());
+  NS_TEST_EXPECT_MSG_EQ (m_total, static_cast<uint64_t> (m_threads) * m_events, "Events lost");
+  for (unsigned int i = 0; i < m_threads; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_received[i], m_events, "Events of thread " << i << " lost");
+    }
+}
+
 class ThreadedSimulatorTestSuite : public TestSuite
 {
 public:
@@ -262,5 +379,6 @@ public:
               }
           }
       }
+    AddTestCase (new ThreadedContextQueueStressTestCase (8, 4096), TestCase::QUICK);
   }
 } g_threadedSimulatorTestSuite;
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/mpi-module.h"
+#include "ns3/wifi-module.h"
+
+// Network Topology
+//
+// A row of buildings, each one with a DMG PCP/AP and nStas DMG STAs.
+// Building b is simulated by rank b % systemCount and the buildings are
+// "gap" meters apart. All the BSSs operate on the same channel, so the
+// PPDUs of a building reach the PHYs of the other buildings through the
+// DmgWifiRemoteChannel.
+//
+//      Building 0            Building 1
+//   +-------------+  gap  +-------------+
+//   |   *  AP  *  |<----->|   *  AP  *  |
+//   +-------------+       +-------------+
+//       Rank 0                Rank 1
+//
+// Each AP sends a saturated downlink flow to each of its STAs. Every rank
+// prints the throughput of the STAs it simulates, so running the program
+// with and without mpirun gives the same report.
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgDistributed");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nBuildings = 2;
+  uint32_t nStas = 2;
+  double buildingSize = 10.0;
+  double gap = 6.0;
+  double simulationTime = 2.0;
+  bool nullmsg = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nBuildings", "Number of buildings", nBuildings);
+  cmd.AddValue ("nStas", "Number of DMG STAs per building", nStas);
+  cmd.AddValue ("buildingSize", "Side of a building in meters", buildingSize);
+  cmd.AddValue ("gap", "Distance between two buildings in meters", gap);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
+  cmd.AddValue ("nullmsg", "Enable the use of null-message synchronization", nullmsg);
+  cmd.Parse (argc, argv);
+
+  uint32_t systemId = 0;
+  uint32_t systemCount = 1;
+
+#ifdef NS3_MPI
+  if (nullmsg)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::NullMessageSimulatorImpl"));
+    }
+  else
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::DistributedSimulatorImpl"));
+    }
+
+  MpiInterface::Enable (&argc, &argv);
+
+  systemId = MpiInterface::GetSystemId ();
+  systemCount = MpiInterface::GetSize ();
+#endif // NS3_MPI
+
+  /* One partition per building */
+  DmgWifiPartitionHelper partition;
+  for (uint32_t b = 0; b < nBuildings; b++)
+    {
+      double xMin = b * (buildingSize + gap);
+      partition.AddPartition (Box (xMin, xMin + buildingSize, 0.0, buildingSize, 0.0, 3.0));
+    }
+
+  NodeContainer apNodes;
+  std::vector<NodeContainer> staNodes;
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  for (uint32_t b = 0; b < nBuildings; b++)
+    {
+      NodeContainer ap = partition.Create (1, b);
+      NodeContainer stas = partition.Create (nStas, b);
+      Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+      Vector center (b * (buildingSize + gap) + buildingSize / 2, buildingSize / 2, 1.5);
+      positionAlloc->Add (center);
+      for (uint32_t i = 0; i < nStas; i++)
+        {
+          double angle = 2 * M_PI * i / nStas;
+          positionAlloc->Add (Vector (center.x + 2.0 * std::cos (angle), center.y + 2.0 * std::sin (angle), 1.0));
+        }
+      mobility.SetPositionAllocator (positionAlloc);
+      mobility.Install (ap);
+      mobility.Install (stas);
+      apNodes.Add (ap);
+      staNodes.push_back (stas);
+    }
+
+  DmgWifiHelper wifi;
+  DmgWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+  Ptr<DmgWifiChannel> channel = wifiChannel.Create ();
+
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (channel);
+  wifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  wifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  wifiPhy.SetErrorRateModel ("ns3::DmgErrorModel",
+                             "FileName", StringValue ("DmgFiles/ErrorModel/LookupTable_1458.txt"));
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "ControlMode", StringValue ("DMG_MCS12"),
+                                                                "DataMode", StringValue ("DMG_MCS12"));
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (SIMPLE_CODEBOOK),
+                    "Antennas", UintegerValue (1),
+                    "Sectors", UintegerValue (8));
+
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  NetDeviceContainer apDevices;
+  std::vector<NetDeviceContainer> staDevices;
+  for (uint32_t b = 0; b < nBuildings; b++)
+    {
+      std::ostringstream ssid;
+      ssid << "Building" << b;
+      wifiMac.SetType ("ns3::DmgApWifiMac",
+                       "Ssid", SsidValue (Ssid (ssid.str ())),
+                       "BE_MaxAmpduSize", UintegerValue (262143),
+                       "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                       "BeaconInterval", TimeValue (MicroSeconds (102400)));
+      apDevices.Add (partition.Install (wifi, wifiPhy, wifiMac, channel, apNodes.Get (b)));
+      wifiMac.SetType ("ns3::DmgStaWifiMac",
+                       "Ssid", SsidValue (Ssid (ssid.str ())),
+                       "ActiveProbing", BooleanValue (false),
+                       "BE_MaxAmpduSize", UintegerValue (262143));
+      staDevices.push_back (partition.Install (wifi, wifiPhy, wifiMac, channel, staNodes[b]));
+    }
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (NodeContainer::GetGlobal ());
+
+  /* Applications only run on the nodes of this rank */
+  std::vector<std::vector<Ptr<PacketSink> > > sinks (nBuildings);
+  for (uint32_t b = 0; b < nBuildings; b++)
+    {
+      if (partition.GetSystemId (b) != systemId)
+        {
+          continue;
+        }
+      for (uint32_t i = 0; i < nStas; i++)
+        {
+          PacketSocketAddress socket;
+          socket.SetSingleDevice (apDevices.Get (b)->GetIfIndex ());
+          socket.SetPhysicalAddress (staDevices[b].Get (i)->GetAddress ());
+          socket.SetProtocol (1);
+
+          OnOffHelper onoff ("ns3::PacketSocketFactory", Address (socket));
+          onoff.SetConstantRate (DataRate ("500Mbps"), 1448);
+          ApplicationContainer source = onoff.Install (apNodes.Get (b));
+          source.Start (Seconds (0.5));
+
+          PacketSinkHelper sinkHelper ("ns3::PacketSocketFactory", Address (socket));
+          ApplicationContainer sink = sinkHelper.Install (staNodes[b].Get (i));
+          sinks[b].push_back (StaticCast<PacketSink> (sink.Get (0)));
+        }
+    }
+
+  Simulator::Stop (Seconds (simulationTime));
+  Simulator::Run ();
+
+  for (uint32_t b = 0; b < nBuildings; b++)
+    {
+      for (uint32_t i = 0; i < sinks[b].size (); i++)
+        {
+          double throughput = sinks[b][i]->GetTotalRx () * 8.0 / ((simulationTime - 0.5) * 1e6);
+          std::cout << "Rank " << systemId << "/" << systemCount << ": building " << b
+                    << ", STA " << i << ": " << throughput << " Mbps" << std::endl;
+        }
+    }
+
+  Simulator::Destroy ();
+
+#ifdef NS3_MPI
+  MpiInterface::Disable ();
+#endif
+
+  return 0;
+}
@@ -32,6 +32,7 @@
 #include "ns3/log.h"
 
 #include <cmath>
+#include <set>
 
 #ifdef NS3_MPI
 #include <mpi.h>
@@ -179,6 +180,7 @@ DistributedSimulatorImpl::CalculateLookAhead (void)
         }
       // else it was already set by SetLookAhead
 
+      std::set<uint32_t> sharedChannels;
       NodeContainer c = NodeContainer::GetGlobal ();
       for (NodeContainer::Iterator iter = c.Begin (); iter != c.End (); ++iter)
         {
@@ -190,14 +192,30 @@ DistributedSimulatorImpl::CalculateLookAhead (void)
           for (uint32_t i = 0; i < (*iter)->GetNDevices (); ++i)
             {
               Ptr<NetDevice> localNetDevice = (*iter)->GetDevice (i);
-              // only works for p2p links currently
-              if (!localNetDevice->IsPointToPoint ())
+              Ptr<Channel> channel = localNetDevice->GetChannel ();
+              if (channel == 0)
                 {
                   continue;
                 }
-              Ptr<Channel> channel = localNetDevice->GetChannel ();
-              if (channel == 0)
+
+              // shared channels spanning several ranks (e.g. DmgWifiRemoteChannel)
+              // give the minimum delay towards any remote device as "Delay"
+              if (!localNetDevice->IsPointToPoint ())
                 {
+                  TimeValue delay;
+                  if (!sharedChannels.insert (channel->GetId ()).second
+                      || !channel->GetAttributeFailSafe ("Delay", delay))
+                    {
+                      continue;
+                    }
+                  for (std::size_t j = 0; j < channel->GetNDevices (); ++j)
+                    {
+                      if ((channel->GetDevice (j)->GetNode ()->GetSystemId () != MpiInterface::GetSystemId ())
+                          && (delay.Get () < m_lookAhead))
+                        {
+                          m_lookAhead = delay.Get ();
+                        }
+                    }
                   continue;
                 }
 
@@ -25,6 +25,7 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
 
 #include "ns3/nstime.h"
 #include "ns3/buffer.h"
@@ -39,12 +40,6 @@ typedef void* MPI_Request;
 
 namespace ns3 {
 
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-const uint32_t MAX_MPI_MSG_SIZE = 2000;
-
 /**
  * \ingroup mpi
  *
@@ -160,11 +155,8 @@ private:
   static bool     m_initialized;
   static bool     m_enabled;
 
-  // Pending non-blocking receives
-  static MPI_Request* m_requests;
-
-  // Data buffers for non-blocking reads
-  static char**   m_pRxBuffers;
+  // Data buffer for the received messages, grown to the largest one
+  static std::vector<char> m_rxBuffer;
 
   // List of pending non-blocking sends
   static std::list<SentBuffer> m_pendingTx;
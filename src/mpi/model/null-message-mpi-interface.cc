@@ -45,14 +45,6 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("NullMessageMpiInterface");
 
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-#ifdef NS3_MPI
-const uint32_t NULL_MESSAGE_MAX_MPI_MSG_SIZE = 2000;
-#endif
-
 NullMessageSentBuffer::NullMessageSentBuffer ()
 {
   m_buffer = 0;
@@ -89,8 +81,7 @@ bool                  NullMessageMpiInterface::g_initialized = false;
 bool                  NullMessageMpiInterface::g_enabled = false;
 std::list<NullMessageSentBuffer> NullMessageMpiInterface::g_pendingTx;
 
-MPI_Request* NullMessageMpiInterface::g_requests;
-char**       NullMessageMpiInterface::g_pRxBuffers;
+std::vector<char>     NullMessageMpiInterface::g_rxBuffer;
 
 NullMessageMpiInterface::NullMessageMpiInterface ()
 {
@@ -178,21 +169,7 @@ NullMessageMpiInterface::InitializeSendReceiveBuffers(void)
 
   g_numNeighbors = RemoteChannelBundleManager::Size();
 
-  // Post a non-blocking receive for all peers
-  g_requests = new MPI_Request[g_numNeighbors];
-  g_pRxBuffers = new char*[g_numNeighbors];
-  int index = 0;
-  for (uint32_t rank = 0; rank < g_size; ++rank)
-    {
-      Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(rank);
-      if (bundle) 
-        {
-          g_pRxBuffers[index] = new char[NULL_MESSAGE_MAX_MPI_MSG_SIZE];
-          MPI_Irecv (g_pRxBuffers[index], NULL_MESSAGE_MAX_MPI_MSG_SIZE, MPI_CHAR, rank, 0,
-                     MPI_COMM_WORLD, &g_requests[index]);
-          ++index;
-        }
-    }
+  // The messages are received once probed, only the neighbors send to this task
 #endif
 }
 
@@ -311,27 +288,33 @@ NullMessageMpiInterface::ReceiveMessages (bool blocking)
   do
     {
       int messageReceived = 0;
-      int index = 0;
       MPI_Status status;
 
+      // Probe first, the size of the message is only known once it has arrived
       if (blocking)
         {
-          MPI_Waitany (g_numNeighbors, g_requests, &index, &status);
-          messageReceived = 1; /* Wait always implies message was received */
+          MPI_Probe (MPI_ANY_SOURCE, 0, MPI_COMM_WORLD, &status);
+          messageReceived = 1; /* Probe always implies message was received */
           stop = true;
         }
       else
         {
-          MPI_Testany (g_numNeighbors, g_requests, &index, &messageReceived, &status);
+          MPI_Iprobe (MPI_ANY_SOURCE, 0, MPI_COMM_WORLD, &messageReceived, &status);
         }
 
       if (messageReceived)
         {
           int count;
           MPI_Get_count (&status, MPI_CHAR, &count);
+          if (g_rxBuffer.size () < static_cast<std::size_t> (count))
+            {
+              g_rxBuffer.resize (count);
+            }
+          MPI_Recv (g_rxBuffer.data (), count, MPI_CHAR, status.MPI_SOURCE, 0,
+                    MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
           // Get the meta data first
-          uint64_t* pTime = reinterpret_cast<uint64_t *> (g_pRxBuffers[index]);
+          uint64_t* pTime = reinterpret_cast<uint64_t *> (g_rxBuffer.data ());
           uint64_t time = *pTime++;
           uint64_t guaranteeUpdate = *pTime++;
 
@@ -374,11 +357,6 @@ NullMessageMpiInterface::ReceiveMessages (bool blocking)
           NS_ASSERT (bundle);
 
           bundle->SetGuaranteeTime (Time (guaranteeUpdate));
-
-          // Re-queue the next read
-          MPI_Irecv (g_pRxBuffers[index], NULL_MESSAGE_MAX_MPI_MSG_SIZE, MPI_CHAR, status.MPI_SOURCE, 0,
-                     MPI_COMM_WORLD, &g_requests[index]);
-
         }
       else
         {
@@ -433,21 +411,9 @@ NullMessageMpiInterface::Disable ()
           MPI_Request_free (iter->GetRequest ());
         }
 
-      for (uint32_t i = 0; i < g_numNeighbors; ++i)
-        {
-          MPI_Cancel (&g_requests[i]);
-          MPI_Request_free (&g_requests[i]);
-        }
-
       MPI_Finalize ();
 
-      for (uint32_t i = 0; i < g_numNeighbors; ++i)
-        {
-          delete [] g_pRxBuffers[i];
-        }
-      delete [] g_pRxBuffers;
-      delete [] g_requests;
-
+      g_rxBuffer.clear ();
       g_pendingTx.clear ();
 
       g_enabled = false;
@@ -34,6 +34,7 @@ typedef void* MPI_Request;
 #endif
 
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -211,11 +212,8 @@ private:
   static bool     g_initialized;
   static bool     g_enabled;
 
-  // Pending non-blocking receives
-  static MPI_Request* g_requests;
-
-  // Data buffers for non-blocking receives
-  static char**   g_pRxBuffers;
+  // Data buffer for the received messages, grown to the largest one
+  static std::vector<char> g_rxBuffer;
 
   // List of pending non-blocking sends
   static std::list<NullMessageSentBuffer> g_pendingTx;
@@ -38,6 +38,7 @@
 #include <ns3/log.h>
 
 #include <cmath>
+#include <set>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -145,6 +146,7 @@ NullMessageSimulatorImpl::CalculateLookAhead (void)
 
   if (MpiInterface::GetSize () > 1)
     {
+      std::set<uint32_t> sharedChannels;
       NodeContainer c = NodeContainer::GetGlobal ();
       for (NodeContainer::Iterator iter = c.Begin (); iter != c.End (); ++iter)
         {
@@ -158,14 +160,36 @@ NullMessageSimulatorImpl::CalculateLookAhead (void)
           for (uint32_t i = 0; i < (*iter)->GetNDevices (); ++i)
             {
               Ptr<NetDevice> localNetDevice = (*iter)->GetDevice (i);
-              // only works for p2p links currently
-              if (!localNetDevice->IsPointToPoint ())
+              Ptr<Channel> channel = localNetDevice->GetChannel ();
+              if (channel == 0)
                 {
                   continue;
                 }
-              Ptr<Channel> channel = localNetDevice->GetChannel ();
-              if (channel == 0)
+
+              // shared channels spanning several ranks (e.g. DmgWifiRemoteChannel)
+              // give the minimum delay towards any remote device as "Delay"
+              if (!localNetDevice->IsPointToPoint ())
                 {
+                  TimeValue delay;
+                  if (!sharedChannels.insert (channel->GetId ()).second
+                      || !channel->GetAttributeFailSafe ("Delay", delay))
+                    {
+                      continue;
+                    }
+                  for (std::size_t j = 0; j < channel->GetNDevices (); ++j)
+                    {
+                      uint32_t remoteSystemId = channel->GetDevice (j)->GetNode ()->GetSystemId ();
+                      if (remoteSystemId == MpiInterface::GetSystemId ())
+                        {
+                          continue;
+                        }
+                      Ptr<RemoteChannelBundle> remoteChannelBundle = RemoteChannelBundleManager::Find (remoteSystemId);
+                      if (!remoteChannelBundle)
+                        {
+                          remoteChannelBundle = RemoteChannelBundleManager::Add (remoteSystemId);
+                        }
+                      remoteChannelBundle->AddChannel (channel, delay.Get ());
+                    }
                   continue;
                 }
 
@@ -235,6 +235,10 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  // receivers whose received power is calculated when the signal reaches them
+  bool prepareRxPower = m_spectrumPropagationLoss && m_spectrumPropagationLoss->DoCalculateRxPowerAtReceiverSide ();
+  SpectrumReceiverList receivers;
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
@@ -325,6 +329,11 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                     {
                       delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
                     }
+
+                  if (prepareRxPower)
+                    {
+                      receivers.push_back (std::make_pair (rxParams, receiverMobility));
+                    }
                 }
 
               Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
@@ -346,6 +355,11 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
     }
 
+  // the StartRx events scheduled above run after the received power has been prepared
+  if (!receivers.empty ())
+    {
+      m_spectrumPropagationLoss->PrepareRxPower (txMobility, receivers);
+    }
 }
 
 void
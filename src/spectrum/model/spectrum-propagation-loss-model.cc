@@ -107,4 +107,10 @@ SpectrumPropagationLossModel::CalcMimoRxPower (Ptr<SpectrumSignalParameters> rxP
   NS_FATAL_ERROR ("You must define this function");
 }
 
+void
+SpectrumPropagationLossModel::PrepareRxPower (Ptr<const MobilityModel> a,
+                                              const SpectrumReceiverList &receivers) const
+{
+}
+
 } // namespace ns3
@@ -25,11 +25,18 @@
 #include <ns3/object.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-value.h>
+#include <vector>
 
 namespace ns3 {
 
 class SpectrumSignalParameters;
 
+/**
+ * \ingroup spectrum
+ * The signal parameters and the mobility model of each receiver of a transmission.
+ */
+typedef std::vector<std::pair<Ptr<SpectrumSignalParameters>, Ptr<const MobilityModel> > > SpectrumReceiverList;
+
 /**
  * \ingroup spectrum
  *
@@ -113,6 +120,16 @@ public:
   virtual void CalcMimoRxPower (Ptr<SpectrumSignalParameters> params,
                                 Ptr<const MobilityModel> a,
                                 Ptr<const MobilityModel> b) const;
+  /**
+   * This method is called once per transmission, before the signal reaches any receiver, if the received
+   * power is calculated at the receiver side. It gives the model the opportunity to calculate the received
+   * power of all the receivers at once, e.g., in parallel. By default it does nothing.
+   *
+   * \param a sender mobility
+   * \param receivers the signal parameters and the mobility of each receiver the signal is delivered to.
+   */
+  virtual void PrepareRxPower (Ptr<const MobilityModel> a,
+                               const SpectrumReceiverList &receivers) const;
 
 protected:
   virtual void DoDispose ();
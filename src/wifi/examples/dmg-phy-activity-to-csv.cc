@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <iostream>
+#include "ns3/command-line.h"
+#include "ns3/dmg-phy-activity-recorder.h"
+
+using namespace ns3;
+
+/**
+ * This program converts a binary file written by DmgPhyActivityRecorder into
+ * the CSV format of the ASCII PHY activity trace, i.e., one line per PHY
+ * activity with the following columns:
+ *
+ * start (ns), source node ID, destination node ID, duration (ns), power (dBm),
+ * PLCP field type, activity type
+ *
+ * Sample usage:
+ * ./waf --run "dmg-phy-activity-to-csv --input=phyActivity.bin --output=phyActivity.csv"
+ *
+ * If no output file is given, the CSV lines are written to the standard output.
+ */
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("input", "The binary file written by DmgPhyActivityRecorder", input);
+  cmd.AddValue ("output", "The CSV file to write, the standard output if empty", output);
+  cmd.Parse (argc, argv);
+
+  std::vector<DmgPhyActivityRecorder::Record> records;
+  if (!DmgPhyActivityRecorder::ReadFile (input, records))
+    {
+      std::cerr << "Error: " << input << " is not a PHY activity recording" << std::endl;
+      return 1;
+    }
+
+  std::ofstream file;
+  if (!output.empty ())
+    {
+      file.open (output.c_str (), std::ios::out | std::ios::trunc);
+      if (!file.is_open ())
+        {
+          std::cerr << "Error: cannot open " << output << std::endl;
+          return 1;
+        }
+    }
+  std::ostream &os = output.empty () ? std::cout : file;
+
+  for (std::vector<DmgPhyActivityRecorder::Record>::const_iterator it = records.begin (); it != records.end (); it++)
+    {
+      os << it->start << ","
+         << it->srcId << ","
+         << it->dstId << ","
+         << it->duration << ","
+         << it->power << ","
+         << it->fieldType << ","
+         << it->activityType << "\n";
+    }
+
+  return 0;
+}
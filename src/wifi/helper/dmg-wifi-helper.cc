@@ -22,10 +22,12 @@
 #include "ns3/names.h"
 #include "ns3/pointer.h"
 #include "ns3/log.h"
+#include "ns3/mpi-interface.h"
 #include "dmg-wifi-helper.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/dmg-wifi-phy.h"
+#include "ns3/dmg-wifi-remote-channel.h"
 #include "ns3/dmg-wifi-mac.h"
 #include "ns3/wifi-mac-queue.h"
 #include "ns3/spectrum-dmg-wifi-phy.h"
@@ -103,7 +105,15 @@ DmgWifiChannelHelper::SetPropagationDelay (std::string type,
 Ptr<DmgWifiChannel>
 DmgWifiChannelHelper::Create (void) const
 {
-  Ptr<DmgWifiChannel> channel = CreateObject<DmgWifiChannel> ();
+  Ptr<DmgWifiChannel> channel;
+  if (MpiInterface::IsEnabled ())
+    {
+      channel = CreateObject<DmgWifiRemoteChannel> ();
+    }
+  else
+    {
+      channel = CreateObject<DmgWifiChannel> ();
+    }
   Ptr<PropagationLossModel> prev = 0;
   for (std::vector<ObjectFactory>::const_iterator i = m_propagationLoss.begin (); i != m_propagationLoss.end (); ++i)
     {
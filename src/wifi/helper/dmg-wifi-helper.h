@@ -125,6 +125,7 @@ public:
    * \returns a new channel
    *
    * Create a channel based on the configuration parameters set previously.
+   * When MPI is enabled, the channel is a DmgWifiRemoteChannel.
    */
   Ptr<DmgWifiChannel> Create (void) const;
 
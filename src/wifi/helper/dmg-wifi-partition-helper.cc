@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/dmg-wifi-phy.h"
+#include "ns3/dmg-wifi-remote-channel.h"
+#include "dmg-wifi-helper.h"
+#include "dmg-wifi-mac-helper.h"
+#include "dmg-wifi-partition-helper.h"
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DmgWifiPartitionHelper");
+
+DmgWifiPartitionHelper::DmgWifiPartitionHelper ()
+{
+}
+
+DmgWifiPartitionHelper::~DmgWifiPartitionHelper ()
+{
+}
+
+uint32_t
+DmgWifiPartitionHelper::AddPartition (const Box &region)
+{
+  m_regions.push_back (region);
+  return m_regions.size () - 1;
+}
+
+uint32_t
+DmgWifiPartitionHelper::GetNPartitions (void) const
+{
+  return m_regions.size ();
+}
+
+uint32_t
+DmgWifiPartitionHelper::GetSystemId (uint32_t partition) const
+{
+  NS_ASSERT (partition < m_regions.size ());
+  return partition % MpiInterface::GetSize ();
+}
+
+uint32_t
+DmgWifiPartitionHelper::GetPartition (const Vector &position) const
+{
+  for (uint32_t partition = 0; partition < m_regions.size (); partition++)
+    {
+      if (m_regions[partition].IsInside (position))
+        {
+          return partition;
+        }
+    }
+  NS_FATAL_ERROR ("Position " << position << " is outside every partition");
+  return 0;
+}
+
+NodeContainer
+DmgWifiPartitionHelper::Create (uint32_t n, uint32_t partition) const
+{
+  NodeContainer nodes;
+  nodes.Create (n, GetSystemId (partition));
+  return nodes;
+}
+
+Time
+DmgWifiPartitionHelper::GetLookahead (double speed) const
+{
+  double minDistance = std::numeric_limits<double>::infinity ();
+  for (uint32_t i = 0; i < m_regions.size (); i++)
+    {
+      for (uint32_t j = i + 1; j < m_regions.size (); j++)
+        {
+          if (GetSystemId (i) == GetSystemId (j))
+            {
+              continue;
+            }
+          const Box &a = m_regions[i];
+          const Box &b = m_regions[j];
+          double dx = std::max (0.0, std::max (a.xMin - b.xMax, b.xMin - a.xMax));
+          double dy = std::max (0.0, std::max (a.yMin - b.yMax, b.yMin - a.yMax));
+          double dz = std::max (0.0, std::max (a.zMin - b.zMax, b.zMin - a.zMax));
+          minDistance = std::min (minDistance, std::sqrt (dx * dx + dy * dy + dz * dz));
+        }
+    }
+  if (std::isinf (minDistance))
+    {
+      return Time (0);
+    }
+  return NanoSeconds (std::floor (minDistance / speed * 1e9));
+}
+
+NetDeviceContainer
+DmgWifiPartitionHelper::Install (const DmgWifiHelper &wifi, const DmgWifiPhyHelper &phy,
+                                 const DmgWifiMacHelper &mac, Ptr<DmgWifiChannel> channel,
+                                 NodeContainer c) const
+{
+  Ptr<DmgWifiRemoteChannel> remoteChannel = DynamicCast<DmgWifiRemoteChannel> (channel);
+  if (remoteChannel != 0)
+    {
+      Time lookahead = GetLookahead ();
+      if (MpiInterface::GetSize () > 1)
+        {
+          NS_ABORT_MSG_IF (lookahead.IsZero (), "Partitions simulated by different ranks must not touch");
+          remoteChannel->SetAttribute ("Delay", TimeValue (lookahead));
+        }
+    }
+
+  NetDeviceContainer devices;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      if (node->GetSystemId () == MpiInterface::GetSystemId ())
+        {
+          Ptr<NetDevice> device = wifi.Install (phy, mac, node).Get (0);
+          if (remoteChannel != 0)
+            {
+              Ptr<DmgWifiPhy> dmgPhy = StaticCast<DmgWifiPhy> (device->GetObject<WifiNetDevice> ()->GetPhy ());
+              remoteChannel->EnableMpiReceive (dmgPhy);
+            }
+          devices.Add (device);
+        }
+      else
+        {
+          NS_ABORT_MSG_IF (remoteChannel == 0, "Node " << node->GetId () << " of another rank needs a DmgWifiRemoteChannel");
+          /* Allocate the address the real device gets on its rank, so that all ranks agree on the MAC addresses */
+          Ptr<SimpleNetDevice> proxy = CreateObject<SimpleNetDevice> ();
+          proxy->SetAddress (Mac48Address::Allocate ());
+          node->AddDevice (proxy);
+          remoteChannel->AddRemote (proxy);
+          devices.Add (proxy);
+        }
+    }
+  return devices;
+}
+
+} //namespace ns3
@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DMG_WIFI_PARTITION_HELPER_H
+#define DMG_WIFI_PARTITION_HELPER_H
+
+#include "ns3/box.h"
+#include "ns3/nstime.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include <vector>
+
+namespace ns3 {
+
+class DmgWifiChannel;
+class DmgWifiHelper;
+class DmgWifiPhyHelper;
+class DmgWifiMacHelper;
+
+/**
+ * \brief helps to split a DMG network over several MPI ranks
+ *
+ * The deployment is divided into partitions, typically one per building,
+ * each covering a region of space. Partitions are assigned to the ranks
+ * in a round-robin fashion and their nodes are created on that rank.
+ * Every rank must create the same nodes and install the devices in the
+ * same order, as for the other distributed ns-3 simulations.
+ *
+ * Install creates the DMG devices of the local nodes only. The nodes of
+ * the other ranks get a passive proxy device, so that the channel can
+ * forward PPDUs to them (see DmgWifiRemoteChannel). The lookahead of the
+ * channel is the propagation delay over the shortest distance between
+ * two regions simulated by different ranks, so the nodes must stay in
+ * the region of their partition.
+ */
+class DmgWifiPartitionHelper
+{
+public:
+  DmgWifiPartitionHelper ();
+  virtual ~DmgWifiPartitionHelper ();
+
+  /**
+   * Add a partition covering the given region.
+   * \param region the region covered by the partition.
+   * \return the index of the new partition.
+   */
+  uint32_t AddPartition (const Box &region);
+  /**
+   * \return the number of partitions.
+   */
+  uint32_t GetNPartitions (void) const;
+  /**
+   * \param partition the index of the partition.
+   * \return the rank (system ID) simulating the partition.
+   */
+  uint32_t GetSystemId (uint32_t partition) const;
+  /**
+   * \param position a position in the deployment.
+   * \return the index of the partition whose region contains the position.
+   */
+  uint32_t GetPartition (const Vector &position) const;
+  /**
+   * Create nodes on the rank simulating a partition.
+   * \param n the number of nodes to create.
+   * \param partition the index of the partition.
+   * \return the new nodes.
+   */
+  NodeContainer Create (uint32_t n, uint32_t partition) const;
+  /**
+   * \param speed the propagation speed in m/s.
+   * \return the propagation delay over the shortest distance between two
+   *         regions simulated by different ranks, or zero if a single rank
+   *         simulates all the partitions.
+   */
+  Time GetLookahead (double speed = 299792458.0) const;
+  /**
+   * Install DMG devices on the nodes of this rank and proxy devices on the
+   * nodes of the other ranks, and set the lookahead of the channel.
+   *
+   * \param wifi the DMG helper used to install the local devices.
+   * \param phy the PHY helper, attached to the given channel.
+   * \param mac the MAC helper.
+   * \param channel the channel of the PHY helper.
+   * \param c the nodes, in the same order on every rank.
+   * \return the devices, proxies included.
+   */
+  NetDeviceContainer Install (const DmgWifiHelper &wifi, const DmgWifiPhyHelper &phy,
+                              const DmgWifiMacHelper &mac, Ptr<DmgWifiChannel> channel,
+                              NodeContainer c) const;
+
+private:
+  std::vector<Box> m_regions;   //!< Region covered by each partition.
+};
+
+} //namespace ns3
+
+#endif /* DMG_WIFI_PARTITION_HELPER_H */
@@ -175,8 +175,9 @@ BlockAckManager::CreateAgreement (const MgtAddBaRequestHeader *reqHdr, Mac48Addr
   uint8_t tid = reqHdr->GetTid ();
   m_agreementState (Simulator::Now (), recipient, tid, OriginatorBlockAckAgreement::PENDING);
   agreement.SetState (OriginatorBlockAckAgreement::PENDING);
-  PacketQueue queue;
-  std::pair<OriginatorBlockAckAgreement, PacketQueue> value (agreement, queue);
+  BlockAckScoreboard scoreboard;
+  scoreboard.Init (agreement.GetBufferSize ());
+  std::pair<OriginatorBlockAckAgreement, BlockAckScoreboard> value (agreement, scoreboard);
   if (ExistsAgreement (recipient, tid))
     {
       // Delete agreement if it exists and in RESET state
@@ -250,6 +251,10 @@ BlockAckManager::UpdateAgreement (const MgtAddBaResponseHeader *respHdr, Mac48Ad
         }
       agreement.SetStartingSequence (startSeq);
       agreement.InitTxWindow ();
+      if (it->second.second.IsEmpty ())
+        {
+          it->second.second.Init (agreement.GetBufferSize ());
+        }
       if (respHdr->IsImmediateBlockAck ())
         {
           agreement.SetImmediateBlockAck ();
@@ -301,28 +306,12 @@ BlockAckManager::StorePacket (Ptr<WifiMacQueueItem> mpdu)
       return;
     }
 
-  // store the packet and keep the list sorted in increasing order of sequence number
-  // with respect to the starting sequence number
-  PacketQueueI it = agreementIt->second.second.begin ();
-  while (it != agreementIt->second.second.end ())
+  // store the packet in the slot of the scoreboard indexed by its sequence number
+  if (!agreementIt->second.second.Insert (mpdu))
     {
-      if (mpdu->GetHeader ().GetSequenceControl () == (*it)->GetHeader ().GetSequenceControl ())
-        {
-          NS_LOG_DEBUG ("Packet already in the queue of the BA agreement");
-          return;
-        }
-
-      uint16_t dist = agreementIt->second.first.GetDistance ((*it)->GetHeader ().GetSequenceNumber ());
-
-      if (mpduDist < dist ||
-          (mpduDist == dist && mpdu->GetHeader ().GetFragmentNumber () < (*it)->GetHeader ().GetFragmentNumber ()))
-        {
-          break;
-        }
-
-      it++;
+      NS_LOG_DEBUG ("Packet already in the queue of the BA agreement");
+      return;
     }
-  agreementIt->second.second.insert (it, mpdu);
   agreementIt->second.first.NotifyTransmittedMpdu (mpdu);
 }
 
@@ -357,17 +346,13 @@ BlockAckManager::GetBar (bool remove)
               continue;
             }
           // remove expired outstanding MPDUs and update the starting sequence number
-          for (auto mpduIt = it->second.second.begin (); mpduIt != it->second.second.end (); )
+          for (auto& mpdu : it->second.second.GetMpdus ())
             {
-              if ((*mpduIt)->GetTimeStamp () + m_queue->GetMaxDelay () <= Simulator::Now ())
+              if (mpdu->GetTimeStamp () + m_queue->GetMaxDelay () <= Simulator::Now ())
                 {
                   // MPDU expired
-                  it->second.first.NotifyDiscardedMpdu (*mpduIt);
-                  mpduIt = it->second.second.erase (mpduIt);
-                }
-              else
-                {
-                  mpduIt++;
+                  it->second.first.NotifyDiscardedMpdu (mpdu);
+                  it->second.second.Remove (mpdu);
                 }
             }
           // update BAR if the starting sequence number changed
@@ -408,19 +393,8 @@ BlockAckManager::GetNBufferedPackets (Mac48Address recipient, uint8_t tid) const
     {
       return 0;
     }
-  uint32_t nPackets = 0;
-  PacketQueueCI queueIt = (*it).second.second.begin ();
-  while (queueIt != (*it).second.second.end ())
-    {
-      uint16_t currentSeq = (*queueIt)->GetHeader ().GetSequenceNumber ();
-      nPackets++;
-      /* a fragmented packet must be counted as one packet */
-      while (queueIt != (*it).second.second.end () && (*queueIt)->GetHeader ().GetSequenceNumber () == currentSeq)
-        {
-          queueIt++;
-        }
-    }
-  return nPackets;
+  /* a fragmented packet must be counted as one packet */
+  return it->second.second.GetNSequenceNumbers ();
 }
 
 void
@@ -451,18 +425,7 @@ BlockAckManager::NotifyGotAck (Ptr<const WifiMacQueueItem> mpdu)
   NS_ASSERT (it != m_agreements.end ());
 
   // remove the acknowledged frame from the queue of outstanding packets
-  PacketQueueI queueIt = it->second.second.begin ();
-  while (queueIt != it->second.second.end ())
-    {
-      if ((*queueIt)->GetHeader ().GetSequenceNumber () == mpdu->GetHeader ().GetSequenceNumber ())
-        {
-          queueIt = it->second.second.erase (queueIt);
-        }
-      else
-      {
-        queueIt++;
-      }
-    }
+  it->second.second.Remove (mpdu->GetHeader ().GetSequenceNumber ());
 
   it->second.first.NotifyAckedMpdu (mpdu);
 }
@@ -482,18 +445,7 @@ BlockAckManager::NotifyMissedAck (Ptr<WifiMacQueueItem> mpdu)
 
   // remove the frame from the queue of outstanding packets (it will be re-inserted
   // if retransmitted)
-  PacketQueueI queueIt = it->second.second.begin ();
-  while (queueIt != it->second.second.end ())
-    {
-      if ((*queueIt)->GetHeader ().GetSequenceNumber () == mpdu->GetHeader ().GetSequenceNumber ())
-        {
-          queueIt = it->second.second.erase (queueIt);
-        }
-      else
-      {
-        queueIt++;
-      }
-    }
+  it->second.second.Remove (mpdu->GetHeader ().GetSequenceNumber ());
 
   // insert in the retransmission queue
   InsertInRetryQueue (mpdu);
@@ -512,7 +464,6 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
           uint8_t nSuccessfulMpdus = 0;
           uint8_t nFailedMpdus = 0;
           AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-          PacketQueueI queueEnd = it->second.second.end ();
 
           if (it->second.first.m_inactivityEvent.IsRunning ())
             {
@@ -532,11 +483,14 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
 
           if (blockAck->IsBasic ())
             {
-              for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd; )
+              while (!it->second.second.IsEmpty ())
                 {
-                  currentSeq = (*queueIt)->GetHeader ().GetSequenceNumber ();
+                  Ptr<WifiMacQueueItem> mpdu = it->second.second.GetFront ();
+                  // in any case, this packet is no longer outstanding
+                  it->second.second.RemoveFront ();
+                  currentSeq = mpdu->GetHeader ().GetSequenceNumber ();
                   if (blockAck->IsFragmentReceived (currentSeq,
-                                                    (*queueIt)->GetHeader ().GetFragmentNumber ()))
+                                                    mpdu->GetHeader ().GetFragmentNumber ()))
                     {
                       nSuccessfulMpdus++;
                     }
@@ -548,10 +502,8 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
                           RemoveOldPackets (recipient, tid, currentSeq);
                         }
                       nFailedMpdus++;
-                      InsertInRetryQueue (*queueIt);
+                      InsertInRetryQueue (mpdu);
                     }
-                  // in any case, this packet is no longer outstanding
-                  queueIt = it->second.second.erase (queueIt);
                 }
               // If all frames were acknowledged, move the transmit window past the last one
               if (!foundFirstLost && currentSeq != SEQNO_SPACE_SIZE)
@@ -563,16 +515,19 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
           else if (blockAck->IsCompressed () || blockAck->IsExtendedCompressed () || blockAck->IsEdmgCompressed ())
           //// WIGIG ////
             {
-              for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd; )
+              while (!it->second.second.IsEmpty ())
                 {
-                  currentSeq = (*queueIt)->GetHeader ().GetSequenceNumber ();
+                  Ptr<WifiMacQueueItem> mpdu = it->second.second.GetFront ();
+                  // in any case, this packet is no longer outstanding
+                  it->second.second.RemoveFront ();
+                  currentSeq = mpdu->GetHeader ().GetSequenceNumber ();
                   if (blockAck->IsPacketReceived (currentSeq))
                     {
-                      it->second.first.NotifyAckedMpdu (*queueIt);
+                      it->second.first.NotifyAckedMpdu (mpdu);
                       nSuccessfulMpdus++;
                       if (!m_txOkCallback.IsNull ())
                         {
-                          m_txOkCallback ((*queueIt)->GetHeader ());
+                          m_txOkCallback (mpdu->GetHeader ());
                         }
                     }
                   else if (!QosUtilsIsOldPacket (currentStartingSeq, currentSeq))
@@ -580,12 +535,10 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
                       nFailedMpdus++;
                       if (!m_txFailedCallback.IsNull ())
                         {
-                          m_txFailedCallback ((*queueIt)->GetHeader ());
+                          m_txFailedCallback (mpdu->GetHeader ());
                         }
-                      InsertInRetryQueue (*queueIt);
+                      InsertInRetryQueue (mpdu);
                     }
-                  // in any case, this packet is no longer outstanding
-                  queueIt = it->second.second.erase (queueIt);
                 }
             }
           m_stationManager->ReportAmpduTxStatus (recipient, nSuccessfulMpdus, nFailedMpdus, rxSnr, dataSnr, dataTxVector);
@@ -605,14 +558,14 @@ BlockAckManager::NotifyMissedBlockAck (Mac48Address recipient, uint8_t tid)
   if (ExistsAgreementInState (recipient, tid, OriginatorBlockAckAgreement::ESTABLISHED))
     {
       AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-      for (auto& item : it->second.second)
+      for (auto& item : it->second.second.GetMpdus ())
         {
           // Queue previously transmitted packets that do not already exist in the retry queue.
           InsertInRetryQueue (item);
         }
       // remove all packets from the queue of outstanding packets (they will be
       // re-inserted if retransmitted)
-      it->second.second.clear ();
+      it->second.second.Clear ();
     }
 }
 
@@ -623,13 +576,13 @@ BlockAckManager::DiscardOutstandingMpdus (Mac48Address recipient, uint8_t tid)
   if (ExistsAgreementInState (recipient, tid, OriginatorBlockAckAgreement::ESTABLISHED))
     {
       AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-      while (!it->second.second.empty ())
+      while (!it->second.second.IsEmpty ())
         {
-          Ptr<WifiMacQueueItem> mpdu = it->second.second.front ();
+          Ptr<WifiMacQueueItem> mpdu = it->second.second.GetFront ();
           if (it->second.first.GetDistance (mpdu->GetHeader ().GetSequenceNumber ()) >= SEQNO_SPACE_HALF_SIZE)
             {
               // old packet
-              it->second.second.pop_front ();
+              it->second.second.RemoveFront ();
             }
           else
             {
@@ -837,7 +790,7 @@ bool BlockAckManager::NeedBarRetransmission (uint8_t tid, Mac48Address recipient
       NS_ASSERT (it != m_agreements.end ());
 
       // A BAR needs to be retransmitted if there is at least a non-expired outstanding MPDU
-      for (auto& mpdu : it->second.second)
+      for (auto& mpdu : it->second.second.GetMpdus ())
         {
           if (mpdu->GetTimeStamp () + m_queue->GetMaxDelay () > Simulator::Now ())
             {
@@ -907,21 +860,15 @@ BlockAckManager::RemoveOldPackets (Mac48Address recipient, uint8_t tid, uint16_t
   uint16_t lastRemovedSeq = (startingSeq - 1 + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE;
   RemoveFromRetryQueue (recipient, tid, currStartingSeq, lastRemovedSeq);
 
-  // remove packets that will become old from the queue of outstanding packets
-  PacketQueueI it = agreementIt->second.second.begin ();
-  while (it != agreementIt->second.second.end ())
+  // remove packets that will become old from the queue of outstanding packets,
+  // i.e., all the sequence numbers the transmit window moves past
+  BlockAckScoreboard& scoreboard = agreementIt->second.second;
+  uint16_t lastRemovedDist = agreementIt->second.first.GetDistance (lastRemovedSeq);
+  for (uint16_t dist = 0; dist <= lastRemovedDist && !scoreboard.IsEmpty (); dist++)
     {
-      uint16_t itSeq = (*it)->GetHeader ().GetSequenceNumber ();
-
-      if (agreementIt->second.first.GetDistance (itSeq) <= agreementIt->second.first.GetDistance (lastRemovedSeq))
-        {
-          NS_LOG_DEBUG ("Removing frame with seqnum = " << itSeq);
-          it = agreementIt->second.second.erase (it);
-        }
-      else
-        {
-          it++;
-        }
+      uint16_t seq = (currStartingSeq + dist) % SEQNO_SPACE_SIZE;
+      NS_LOG_DEBUG ("Removing frames with seqnum = " << seq);
+      scoreboard.Remove (seq);
     }
 }
 
@@ -29,6 +29,7 @@
 #include "wifi-remote-station-manager.h"
 #include "block-ack-type.h"
 #include "wifi-mac-queue-item.h"
+#include "block-ack-scoreboard.h"
 
 namespace ns3 {
 
@@ -441,32 +442,21 @@ private:
   void RemoveOldPackets (Mac48Address recipient, uint8_t tid, uint16_t startingSeq);
 
   /**
-   * typedef for a list of WifiMacQueueItem.
-   */
-  typedef std::list<Ptr<WifiMacQueueItem>> PacketQueue;
-  /**
-   * typedef for an iterator for PacketQueue.
-   */
-  typedef std::list<Ptr<WifiMacQueueItem>>::iterator PacketQueueI;
-  /**
-   * typedef for a const iterator for PacketQueue.
-   */
-  typedef std::list<Ptr<WifiMacQueueItem>>::const_iterator PacketQueueCI;
-  /**
-   * typedef for a map between MAC address and block ack agreement.
+   * typedef for a map between MAC address and block ack agreement. Each
+   * agreement is paired with the scoreboard of its outstanding MPDUs.
    */
   typedef std::map<std::pair<Mac48Address, uint8_t>,
-                   std::pair<OriginatorBlockAckAgreement, PacketQueue> > Agreements;
+                   std::pair<OriginatorBlockAckAgreement, BlockAckScoreboard> > Agreements;
   /**
    * typedef for an iterator for Agreements.
    */
   typedef std::map<std::pair<Mac48Address, uint8_t>,
-                   std::pair<OriginatorBlockAckAgreement, PacketQueue> >::iterator AgreementsI;
+                   std::pair<OriginatorBlockAckAgreement, BlockAckScoreboard> >::iterator AgreementsI;
   /**
    * typedef for a const iterator for Agreements.
    */
   typedef std::map<std::pair<Mac48Address, uint8_t>,
-                   std::pair<OriginatorBlockAckAgreement, PacketQueue> >::const_iterator AgreementsCI;
+                   std::pair<OriginatorBlockAckAgreement, BlockAckScoreboard> >::const_iterator AgreementsCI;
 
   /**
    * \param mpdu the packet to insert in the retransmission queue
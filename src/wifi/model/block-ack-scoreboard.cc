@@ -0,0 +1,285 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "block-ack-scoreboard.h"
+#include "wifi-mac-queue-item.h"
+#include "wifi-utils.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BlockAckScoreboard");
+
+/// Minimum number of slots of a scoreboard
+static const std::size_t MIN_SCOREBOARD_SLOTS = 64;
+
+BlockAckScoreboard::BlockAckScoreboard ()
+  : m_mask (0),
+    m_headSeq (0),
+    m_span (0),
+    m_nMpdus (0),
+    m_nSeqs (0)
+{
+  Init (MIN_SCOREBOARD_SLOTS);
+}
+
+void
+BlockAckScoreboard::Init (uint16_t winSize)
+{
+  NS_LOG_FUNCTION (this << winSize);
+  std::size_t nSlots = MIN_SCOREBOARD_SLOTS;
+  while (nSlots < winSize && nSlots < SEQNO_SPACE_SIZE)
+    {
+      nSlots <<= 1;
+    }
+  m_slots.assign (nSlots, Slot ());
+  m_mask = nSlots - 1;
+  m_headSeq = 0;
+  m_span = 0;
+  m_nMpdus = 0;
+  m_nSeqs = 0;
+}
+
+BlockAckScoreboard::Slot&
+BlockAckScoreboard::GetSlot (uint16_t seq)
+{
+  return m_slots[seq & m_mask];
+}
+
+const BlockAckScoreboard::Slot&
+BlockAckScoreboard::GetSlot (uint16_t seq) const
+{
+  return m_slots[seq & m_mask];
+}
+
+bool
+BlockAckScoreboard::Insert (Ptr<WifiMacQueueItem> mpdu)
+{
+  uint16_t seq = mpdu->GetHeader ().GetSequenceNumber ();
+  uint8_t frag = mpdu->GetHeader ().GetFragmentNumber ();
+
+  if (m_nMpdus == 0)
+    {
+      m_headSeq = seq;
+      m_span = 1;
+    }
+  else
+    {
+      uint16_t offset = (seq - m_headSeq + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE;
+      if (offset < SEQNO_SPACE_HALF_SIZE)
+        {
+          // the MPDU follows the head
+          if (offset >= m_span)
+            {
+              if (offset >= m_slots.size ())
+                {
+                  Grow (offset + 1);
+                }
+              m_span = offset + 1;
+            }
+        }
+      else
+        {
+          // the MPDU precedes the head, which has to be moved backward
+          uint16_t span = m_span + SEQNO_SPACE_SIZE - offset;
+          NS_ASSERT (span <= SEQNO_SPACE_SIZE);
+          if (span > m_slots.size ())
+            {
+              Grow (span);
+            }
+          m_headSeq = seq;
+          m_span = span;
+        }
+    }
+
+  Slot& slot = GetSlot (seq);
+  Slot::iterator it = slot.begin ();
+  while (it != slot.end () && (*it)->GetHeader ().GetFragmentNumber () < frag)
+    {
+      it++;
+    }
+  if (it != slot.end () && (*it)->GetHeader ().GetFragmentNumber () == frag)
+    {
+      NS_LOG_DEBUG ("MPDU with sequence number " << seq << " and fragment number "
+                    << +frag << " already stored");
+      return false;
+    }
+  if (slot.empty ())
+    {
+      m_nSeqs++;
+    }
+  slot.insert (it, mpdu);
+  m_nMpdus++;
+  return true;
+}
+
+void
+BlockAckScoreboard::Remove (uint16_t seq)
+{
+  uint16_t offset = (seq - m_headSeq + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE;
+  if (offset >= m_span)
+    {
+      return;
+    }
+  Slot& slot = GetSlot (seq);
+  if (slot.empty ())
+    {
+      return;
+    }
+  m_nMpdus -= slot.size ();
+  m_nSeqs--;
+  slot.clear ();
+  Trim ();
+}
+
+void
+BlockAckScoreboard::Remove (Ptr<const WifiMacQueueItem> mpdu)
+{
+  uint16_t seq = mpdu->GetHeader ().GetSequenceNumber ();
+  uint16_t offset = (seq - m_headSeq + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE;
+  if (offset >= m_span)
+    {
+      return;
+    }
+  Slot& slot = GetSlot (seq);
+  for (Slot::iterator it = slot.begin (); it != slot.end (); it++)
+    {
+      if ((*it)->GetHeader ().GetFragmentNumber () == mpdu->GetHeader ().GetFragmentNumber ())
+        {
+          slot.erase (it);
+          m_nMpdus--;
+          if (slot.empty ())
+            {
+              m_nSeqs--;
+              Trim ();
+            }
+          return;
+        }
+    }
+}
+
+Ptr<WifiMacQueueItem>
+BlockAckScoreboard::GetFront (void) const
+{
+  NS_ASSERT (m_nMpdus > 0);
+  return GetSlot (m_headSeq).front ();
+}
+
+void
+BlockAckScoreboard::RemoveFront (void)
+{
+  NS_ASSERT (m_nMpdus > 0);
+  Slot& slot = GetSlot (m_headSeq);
+  slot.erase (slot.begin ());
+  m_nMpdus--;
+  if (slot.empty ())
+    {
+      m_nSeqs--;
+      Trim ();
+    }
+}
+
+std::vector<Ptr<WifiMacQueueItem>>
+BlockAckScoreboard::GetMpdus (void) const
+{
+  std::vector<Ptr<WifiMacQueueItem>> mpdus;
+  mpdus.reserve (m_nMpdus);
+  for (uint16_t offset = 0; offset < m_span; offset++)
+    {
+      const Slot& slot = GetSlot ((m_headSeq + offset) % SEQNO_SPACE_SIZE);
+      mpdus.insert (mpdus.end (), slot.begin (), slot.end ());
+    }
+  return mpdus;
+}
+
+void
+BlockAckScoreboard::Clear (void)
+{
+  for (uint16_t offset = 0; offset < m_span; offset++)
+    {
+      GetSlot ((m_headSeq + offset) % SEQNO_SPACE_SIZE).clear ();
+    }
+  m_span = 0;
+  m_nMpdus = 0;
+  m_nSeqs = 0;
+}
+
+bool
+BlockAckScoreboard::IsEmpty (void) const
+{
+  return m_nMpdus == 0;
+}
+
+std::size_t
+BlockAckScoreboard::GetNMpdus (void) const
+{
+  return m_nMpdus;
+}
+
+std::size_t
+BlockAckScoreboard::GetNSequenceNumbers (void) const
+{
+  return m_nSeqs;
+}
+
+std::size_t
+BlockAckScoreboard::GetCapacity (void) const
+{
+  return m_slots.size ();
+}
+
+void
+BlockAckScoreboard::Grow (uint16_t span)
+{
+  NS_LOG_FUNCTION (this << span);
+  std::size_t nSlots = m_slots.size ();
+  while (nSlots < span)
+    {
+      nSlots <<= 1;
+    }
+  NS_ASSERT (nSlots <= SEQNO_SPACE_SIZE);
+  std::vector<Slot> slots (nSlots);
+  std::size_t mask = nSlots - 1;
+  for (uint16_t offset = 0; offset < m_span; offset++)
+    {
+      uint16_t seq = (m_headSeq + offset) % SEQNO_SPACE_SIZE;
+      slots[seq & mask].swap (GetSlot (seq));
+    }
+  m_slots.swap (slots);
+  m_mask = mask;
+}
+
+void
+BlockAckScoreboard::Trim (void)
+{
+  if (m_nMpdus == 0)
+    {
+      m_span = 0;
+      return;
+    }
+  // each step shrinks the span, hence the cost is amortized over the insertions
+  while (GetSlot (m_headSeq).empty ())
+    {
+      m_headSeq = (m_headSeq + 1) % SEQNO_SPACE_SIZE;
+      m_span--;
+    }
+  while (GetSlot ((m_headSeq + m_span - 1) % SEQNO_SPACE_SIZE).empty ())
+    {
+      m_span--;
+    }
+}
+
+} //namespace ns3
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BLOCK_ACK_SCOREBOARD_H
+#define BLOCK_ACK_SCOREBOARD_H
+
+#include <vector>
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class WifiMacQueueItem;
+
+/**
+ * \ingroup wifi
+ * \brief Scoreboard of the MPDUs outstanding under an originator Block Ack agreement
+ *
+ * The scoreboard stores the MPDUs that have been transmitted under a Block Ack
+ * agreement and are waiting to be acknowledged. It is implemented as a vector
+ * of slots managed as a circular queue: the MPDU having sequence number
+ * <i>seq</i> is stored in the slot <i>seq</i> modulo the number of slots, which
+ * is a power of two. A slot holds all the fragments of the same MSDU, sorted
+ * by increasing fragment number. Hence, storing, looking up and removing an MPDU
+ * take constant time, regardless of the size of the Block Ack window (up to
+ * 1024 MPDUs for EDMG stations).
+ *
+ * The scoreboard also tracks the sequence number of the oldest stored MPDU
+ * (the head) and the number of sequence numbers spanned by the stored MPDUs.
+ * MPDUs are returned in increasing order of sequence number with respect to
+ * the head. Should an MPDU fall outside the span covered by the slots, the
+ * number of slots is doubled.
+ */
+class BlockAckScoreboard
+{
+public:
+  /**
+   * Constructor
+   */
+  BlockAckScoreboard ();
+  /**
+   * Clear the scoreboard and size it so that it can hold the MPDUs of a
+   * window of the given size without being resized.
+   *
+   * \param winSize the window size
+   */
+  void Init (uint16_t winSize);
+  /**
+   * Store the given MPDU, unless an MPDU with the same sequence control is
+   * already stored.
+   *
+   * \param mpdu the MPDU to store
+   * \return true if the MPDU has been stored, false if it is a duplicate
+   */
+  bool Insert (Ptr<WifiMacQueueItem> mpdu);
+  /**
+   * Remove all the MPDUs (i.e., all the fragments) having the given sequence number.
+   *
+   * \param seq the sequence number
+   */
+  void Remove (uint16_t seq);
+  /**
+   * Remove the given MPDU, if stored.
+   *
+   * \param mpdu the MPDU to remove
+   */
+  void Remove (Ptr<const WifiMacQueueItem> mpdu);
+  /**
+   * Get the stored MPDU having the lowest sequence number (and the lowest
+   * fragment number) with respect to the head. The scoreboard must not be empty.
+   *
+   * \return the MPDU at the front of the scoreboard
+   */
+  Ptr<WifiMacQueueItem> GetFront (void) const;
+  /**
+   * Remove the MPDU at the front of the scoreboard. The scoreboard must not be empty.
+   */
+  void RemoveFront (void);
+  /**
+   * Get all the stored MPDUs, in increasing order of sequence number (and
+   * fragment number) with respect to the head.
+   *
+   * \return the stored MPDUs
+   */
+  std::vector<Ptr<WifiMacQueueItem>> GetMpdus (void) const;
+  /**
+   * Remove all the stored MPDUs.
+   */
+  void Clear (void);
+  /**
+   * \return true if no MPDU is stored
+   */
+  bool IsEmpty (void) const;
+  /**
+   * \return the number of stored MPDUs
+   */
+  std::size_t GetNMpdus (void) const;
+  /**
+   * \return the number of distinct sequence numbers among the stored MPDUs
+   */
+  std::size_t GetNSequenceNumbers (void) const;
+  /**
+   * \return the number of slots
+   */
+  std::size_t GetCapacity (void) const;
+
+private:
+  /// Fragments of the same MSDU, sorted by increasing fragment number
+  typedef std::vector<Ptr<WifiMacQueueItem>> Slot;
+
+  /**
+   * \param seq a sequence number
+   * \return the slot associated with the given sequence number
+   */
+  Slot& GetSlot (uint16_t seq);
+  /**
+   * \param seq a sequence number
+   * \return the slot associated with the given sequence number
+   */
+  const Slot& GetSlot (uint16_t seq) const;
+  /**
+   * Double the number of slots until the given span can be covered and
+   * move the stored MPDUs to the new slots.
+   *
+   * \param span the number of sequence numbers that must be covered
+   */
+  void Grow (uint16_t span);
+  /**
+   * Update the bookkeeping after a slot has been emptied: move the head
+   * forward to the oldest sequence number having stored MPDUs and shrink
+   * the span so that it ends at the newest one.
+   */
+  void Trim (void);
+
+  std::vector<Slot> m_slots;  ///< the slots, indexed by sequence number modulo their number
+  std::size_t m_mask;         ///< number of slots minus one
+  uint16_t m_headSeq;         ///< sequence number of the oldest stored MPDU
+  uint16_t m_span;            ///< number of sequence numbers from the head to the newest stored MPDU
+  std::size_t m_nMpdus;       ///< number of stored MPDUs
+  std::size_t m_nSeqs;        ///< number of non-empty slots
+};
+
+} //namespace ns3
+
+#endif /* BLOCK_ACK_SCOREBOARD_H */
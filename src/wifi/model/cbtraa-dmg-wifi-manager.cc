@@ -19,6 +19,7 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/pointer.h"
 #include "cbtraa-dmg-wifi-manager.h"
 #include "wifi-phy.h"
 #include "wifi-utils.h"
@@ -35,6 +36,9 @@ struct CbtraaDmgWifiRemoteStation : public WifiRemoteStation
 {
   double m_lastSnrCached;    //!< SNR most recently used to select a rate.
   WifiMode m_lastMode;       //!< Mode most recently used to the remote station.
+  DmgSnrThresholdTable::SelectionTable m_selectionTable;  //!< Selection table restricted to the supported modes.
+  WifiModeList m_supportedModes; //!< Supported modes, but the first one, when the selection table was built.
+  uint16_t m_channelWidth;   //!< Channel width when the selection table was built.
 };
 
 /// To avoid using the cache before a valid value has been cached
@@ -56,6 +60,14 @@ CbtraaDmgWifiManager::GetTypeId (void)
                    DoubleValue (1e-9),
                    MakeDoubleAccessor (&CbtraaDmgWifiManager::m_ber),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrThresholdTable",
+                   "The table of the minimum SNR of each mode and of the derived rate selection "
+                   "tables. The thresholds at the BER threshold of this manager, in dB, are added "
+                   "to the table for the modes of the PHY which are missing, so the table can be "
+                   "shared with other rate managers.",
+                   PointerValue (),
+                   MakePointerAccessor (&CbtraaDmgWifiManager::m_thresholdTable),
+                   MakePointerChecker<DmgSnrThresholdTable> ())
     .AddTraceSource ("Rate",
                      "Traced value for MCS changes",
                      MakeTraceSourceAccessor (&CbtraaDmgWifiManager::m_mcsChanged),
@@ -78,41 +90,74 @@ void
 CbtraaDmgWifiManager::DoInitialize ()
 {
   NS_LOG_FUNCTION (this);
+  if (m_thresholdTable == 0)
+    {
+      m_thresholdTable = CreateObject<DmgSnrThresholdTable> ();
+    }
+  AddSnrThresholds (GetPhy ()->GetChannelWidth ());
+}
+
+void
+CbtraaDmgWifiManager::AddSnrThresholds (uint16_t channelWidth)
+{
+  NS_LOG_FUNCTION (this << channelWidth);
+  DmgSnrThresholdTable::Key key (channelWidth, m_ber, DmgSnrThresholdTable::SNR_DB);
   WifiMode mode;
   WifiTxVector txVector;
   uint8_t nModes = GetPhy ()->GetNModes ();
   for (uint8_t i = 1; i < nModes; i++)
     {
       mode = GetPhy ()->GetMode (i);
-      txVector.SetChannelWidth (GetPhy ()->GetChannelWidth ());
+      if (m_thresholdTable->HasSnrThreshold (mode, key))
+        {
+          continue;
+        }
+      txVector.SetChannelWidth (channelWidth);
       txVector.SetMode (mode);
       NS_LOG_DEBUG ("Initialize, adding mode = " << mode.GetUniqueName ());
-      AddSnrThreshold (txVector, RatioToDb (GetPhy ()->CalculateSnr (txVector, m_ber)));
+      m_thresholdTable->AddSnrThreshold (mode, key, RatioToDb (GetPhy ()->CalculateSnr (txVector, m_ber)));
     }
 }
 
 double
-CbtraaDmgWifiManager::GetSnrThreshold (WifiTxVector txVector) const
+CbtraaDmgWifiManager::GetSnrThreshold (const WifiTxVector &txVector)
 {
   NS_LOG_FUNCTION (this << txVector.GetMode ().GetUniqueName ());
-  for (Thresholds::const_iterator i = m_thresholds.begin (); i != m_thresholds.end (); i++)
+  DmgSnrThresholdTable::Key key (txVector.GetChannelWidth (), m_ber, DmgSnrThresholdTable::SNR_DB);
+  if (!m_thresholdTable->HasSnrThreshold (txVector.GetMode (), key))
     {
-      NS_LOG_DEBUG ("Checking " << i->second.GetMode ().GetUniqueName ()
-                    << " against TxVector " << txVector.GetMode ().GetUniqueName ());
-      if (txVector.GetMode () == i->second.GetMode ())
-        {
-          return i->first;
-        }
+      AddSnrThresholds (txVector.GetChannelWidth ());
     }
-  NS_ASSERT (false);
-  return 0.0;
+  return m_thresholdTable->GetSnrThreshold (txVector.GetMode (), key);
 }
 
-void
-CbtraaDmgWifiManager::AddSnrThreshold (WifiTxVector txVector, double snr)
+const DmgSnrThresholdTable::SelectionTable&
+CbtraaDmgWifiManager::GetSelectionTable (WifiRemoteStation *st, uint16_t channelWidth)
 {
-  NS_LOG_FUNCTION (this << txVector.GetMode ().GetUniqueName () << snr);
-  m_thresholds.push_back (std::make_pair (snr, txVector));
+  NS_LOG_FUNCTION (this << st << channelWidth);
+  CbtraaDmgWifiRemoteStation *station = static_cast<CbtraaDmgWifiRemoteStation*> (st);
+  uint8_t nSupported = GetNSupported (station);
+  /* The supported modes can be replaced by others without changing their number */
+  bool changed = (station->m_channelWidth != channelWidth) || (station->m_supportedModes.size () + 1u != nSupported);
+  for (uint8_t i = 1; !changed && (i < nSupported); i++)
+    {
+      changed = !(station->m_supportedModes[i - 1] == GetSupported (station, i));
+    }
+  if (changed)
+    {
+      AddSnrThresholds (channelWidth);
+      WifiModeList modes;
+      for (uint8_t i = 1; i < nSupported; i++)
+        {
+          modes.push_back (GetSupported (station, i));
+        }
+      station->m_selectionTable = m_thresholdTable->BuildSelectionTable (modes, DmgSnrThresholdTable::Key (channelWidth, m_ber, DmgSnrThresholdTable::SNR_DB));
+      station->m_channelWidth = channelWidth;
+      NS_LOG_DEBUG ("Built selection table with " << station->m_selectionTable.size ()
+                    << " entries out of " << modes.size () << " supported modes");
+      station->m_supportedModes.swap (modes);
+    }
+  return station->m_selectionTable;
 }
 
 WifiRemoteStation *
@@ -122,6 +167,7 @@ CbtraaDmgWifiManager::DoCreateStation (void) const
   CbtraaDmgWifiRemoteStation *station = new CbtraaDmgWifiRemoteStation ();
   station->m_lastSnrCached = CACHE_INITIAL_VALUE;
   station->m_lastMode = GetDefaultMode ();
+  station->m_channelWidth = 0;
   return station;
 }
 
@@ -185,9 +231,6 @@ CbtraaDmgWifiManager::DoGetDataTxVector (WifiRemoteStation *st)
   //highest data rate for which the snr threshold is smaller than m_lastSnr
   //to ensure correct packet delivery.
   WifiMode maxMode = GetDefaultMode ();
-  WifiTxVector txVector;
-  WifiMode mode;
-  uint64_t bestRate = 0;
   if (station->m_lastSnrCached != CACHE_INITIAL_VALUE && station->m_lastSnrCached == station->m_state->m_linkSnr)
     {
       // SNR has not changed, so skip the search and use the last
@@ -199,26 +242,10 @@ CbtraaDmgWifiManager::DoGetDataTxVector (WifiRemoteStation *st)
     }
   else
     {
-      for (uint8_t i = 1; i < GetNSupported (station); i++)
-        {
-          mode = GetSupported (station, i);
-          txVector.SetMode (mode);
-          txVector.SetChannelWidth (GetPhy ()->GetChannelWidth ());
-          double threshold = GetSnrThreshold (txVector);
-          uint64_t dataRate = mode.GetDmgDataRate ();
-          NS_LOG_DEBUG ("mode = " << mode.GetUniqueName () <<
-                        " threshold " << threshold  <<
-                        " link SNR " << station->m_state->m_linkSnr);
-          if (dataRate > bestRate && threshold < station->m_state->m_linkSnr)
-            {
-              NS_LOG_DEBUG ("Candidate mode = " << mode.GetUniqueName () <<
-                            " data rate " << dataRate <<
-                            " threshold " << threshold  <<
-                            " link SNR " << station->m_state->m_linkSnr);
-              bestRate = dataRate;
-              maxMode = mode;
-            }
-        }
+      // the selection table is sorted by increasing SNR threshold and
+      // increasing data rate, hence a binary search finds the mode
+      maxMode = DmgSnrThresholdTable::Lookup (GetSelectionTable (station, GetPhy ()->GetChannelWidth ()),
+                                              station->m_state->m_linkSnr, GetDefaultMode ());
       NS_LOG_DEBUG ("Updating cached values for station to " <<  maxMode.GetUniqueName () << " SNR " << station->m_state->m_linkSnr);
       station->m_lastSnrCached = station->m_state->m_linkSnr;
       if (station->m_lastMode.GetMcsValue () != maxMode.GetMcsValue ())
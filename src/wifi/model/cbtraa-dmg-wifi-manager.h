@@ -23,6 +23,7 @@
 
 #include "ns3/traced-value.h"
 #include "wifi-remote-station-manager.h"
+#include "dmg-snr-threshold-table.h"
 
 namespace ns3 {
 
@@ -64,6 +65,14 @@ private:
   WifiTxVector DoGetRtsTxVector (WifiRemoteStation *station);
   bool IsLowLatency (void) const;
 
+  /**
+   * Add to the SNR threshold table the minimum SNR needed to successfully
+   * transmit data with each mode of the PHY at the specified BER, for the
+   * given channel width, unless the table already holds it.
+   *
+   * \param channelWidth the channel width in MHz
+   */
+  void AddSnrThresholds (uint16_t channelWidth);
   /**
    * Return the minimum SNR needed to successfully transmit
    * data with this WifiTxVector at the specified BER.
@@ -72,24 +81,21 @@ private:
    *
    * \return the minimum SNR in dB for the given WifiTxVector
    */
-  double GetSnrThreshold (WifiTxVector txVector) const;
+  double GetSnrThreshold (const WifiTxVector &txVector);
   /**
-   * Adds a pair of WifiTxVector and the minimum SNR for that given vector
-   * to the list.
+   * Return the selection table restricted to the modes supported by the
+   * given station, (re)building it if the supported modes or the channel
+   * width changed since it was last built.
    *
-   * \param txVector the WifiTxVector storing mode, channel width, and nss
-   * \param snr the minimum SNR in dB for the given txVector
-   */
-  void AddSnrThreshold (WifiTxVector txVector, double snr);
-
-  /**
-   * A vector of <snr, WifiTxVector> pair holding the minimum SNR for the
-   * WifiTxVector
+   * \param station the remote station
+   * \param channelWidth the channel width in MHz
+   *
+   * \return the selection table of the station
    */
-  typedef std::vector<std::pair<double, WifiTxVector> > Thresholds;
+  const DmgSnrThresholdTable::SelectionTable& GetSelectionTable (WifiRemoteStation *station, uint16_t channelWidth);
 
   double m_ber;                       //!< The maximum Bit Error Rate acceptable at any transmission mode.
-  Thresholds m_thresholds;            //!< List of WifiTxVector and the minimum SNR pair.
+  Ptr<DmgSnrThresholdTable> m_thresholdTable;  //!< SNR thresholds and selection tables of the modes.
   /**
    * Trace callback for rate change with particular remote station.
    * \param Mac48Address The MAC address of the remote station.
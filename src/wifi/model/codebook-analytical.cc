@@ -194,6 +194,9 @@ CodebookAnalytical::LoadCodebook (std::string filename)
       m_antennaArrayList[antennaID] = config;
     }
 
+  /* Read the optional hierarchy of wide and narrow sectors */
+  ReadSectorHierarchy (file, filename);
+
   /* Close the file */
   file.close ();
 }
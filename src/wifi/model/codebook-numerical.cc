@@ -216,6 +216,9 @@ CodebookNumerical::LoadCodebook (std::string filename)
       m_antennaArrayList[antennaID] = antennaConfig;
     }
 
+  /* Read the optional hierarchy of wide and narrow sectors */
+  ReadSectorHierarchy (file, filename);
+
   /* Close the file */
   file.close ();
 }
@@ -313,6 +316,7 @@ CodebookNumerical::ChangeAntennaOrientation (AntennaID antennaID, double orienta
                        sectorConfig->directivity + uint (orientation),
                        sectorConfig->directivity + AZIMUTH_CARDINALITY);
         }
+      m_version++;
     }
   else
     {
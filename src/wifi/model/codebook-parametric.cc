@@ -31,6 +31,18 @@ ParametricPatternConfig::GetArrayPattern (uint16_t azimuthAngle, uint16_t elevat
   return arrayPatternMap[std::make_pair (azimuthAngle, elevationAngle)];
 }
 
+bool
+ParametricPatternConfig::FindArrayPattern (uint16_t azimuthAngle, uint16_t elevationAngle, Complex &value) const
+{
+  ArrayPatternMapCI it = arrayPatternMap.find (std::make_pair (azimuthAngle, elevationAngle));
+  if (it == arrayPatternMap.end ())
+    {
+      return false;
+    }
+  value = it->second;
+  return true;
+}
+
 void
 ParametricPatternConfig::CalculateArrayPattern (Ptr<ParametricAntennaConfig> antennaConfig,
                                                 uint16_t azimuthAngle, uint16_t elevationAngle)
@@ -165,11 +177,15 @@ CodebookParametric::DisposeAntennaConfig (Ptr<ParametricAntennaConfig> antennaCo
        sectorIter != antennaConfig->sectorList.end (); sectorIter++)
     {
       Ptr<ParametricSectorConfig> sectorConfig = DynamicCast<ParametricSectorConfig> (sectorIter->second);
-      for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
+      /* The sector patterns are allocated only if they are precalculated */
+      if (m_precalculatedPatterns)
         {
-          delete[] sectorConfig->arrayPattern[m];
+          for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
+            {
+              delete[] sectorConfig->arrayPattern[m];
+            }
+          delete[] sectorConfig->arrayPattern;
         }
-      delete[] sectorConfig->arrayPattern;
       /* Iterate over all the custom AWVs */
       for (AWV_LIST_I awvIt = sectorConfig->awvList.begin (); awvIt != sectorConfig->awvList.end (); awvIt++)
         {
@@ -185,7 +201,10 @@ CodebookParametric::DisposeAntennaConfig (Ptr<ParametricAntennaConfig> antennaCo
   for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
     {
       delete[] antennaConfig->singleElementDirectivity[m];
-      delete[] antennaConfig->GetQuasiOmniConfig ()->arrayPattern[m];
+      if (m_precalculatedPatterns)
+        {
+          delete[] antennaConfig->GetQuasiOmniConfig ()->arrayPattern[m];
+        }
       for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
         {
           delete[] antennaConfig->steeringVector[m][n];
@@ -195,7 +214,10 @@ CodebookParametric::DisposeAntennaConfig (Ptr<ParametricAntennaConfig> antennaCo
 
   // Free the array of pointers
   delete[] antennaConfig->singleElementDirectivity;
-  delete[] antennaConfig->GetQuasiOmniConfig ()->arrayPattern;
+  if (m_precalculatedPatterns)
+    {
+      delete[] antennaConfig->GetQuasiOmniConfig ()->arrayPattern;
+    }
   delete[] antennaConfig->steeringVector;
 }
 
@@ -504,6 +526,9 @@ CodebookParametric::LoadCodebook (std::string filename)
       m_antennaArrayList[antennaID] = antennaConfig;
     }
 
+  /* Read the optional hierarchy of wide and narrow sectors */
+  ReadSectorHierarchy (file, filename);
+
   /* Close the file */
   file.close ();
   // For testing purposes - appendds 8 AWVs to all sectors
@@ -805,6 +830,7 @@ CodebookParametric::UpdateSectorWeights (AntennaID antennaID, SectorID sectorID,
           Ptr<ParametricSectorConfig> sectorConfig = DynamicCast<ParametricSectorConfig> (sectorIter->second);
           sectorConfig->weights = weightsVector;
           antennaConfig->CalculateArrayPattern (weightsVector, sectorConfig->arrayPattern);
+          m_version++;
         }
       else
         {
@@ -948,6 +974,7 @@ CodebookParametric::UpdateQuasiOmniWeights (AntennaID antennaID, WeightsVector &
       Ptr<ParametricAntennaConfig> antennaConfig = StaticCast<ParametricAntennaConfig> (iter->second);
       antennaConfig->GetQuasiOmniConfig ()->weights = weightsVector;
       antennaConfig->CalculateArrayPattern (weightsVector, antennaConfig->GetQuasiOmniConfig ()->arrayPattern);
+      m_version++;
     }
   else
     {
@@ -1001,6 +1028,7 @@ CodebookParametric::AppendSector (AntennaID antennaID, SectorID sectorID, Sector
           NS_LOG_DEBUG ("Appending new sector to the codebook");
         }
       antennaConfig->sectorList[sectorID] = sectorConfig;
+      m_version++;
     }
   else
     {
@@ -1025,6 +1053,7 @@ CodebookParametric::AppendBeamRefinementAwv (AntennaID antennaID, SectorID secto
           sectorConfig->awvList.push_back (awvConfig);
           /* Change this */
           NS_ASSERT_MSG (sectorConfig->awvList.size () <= 64, "We can append upto 64 AWV per sector.");
+          m_version++;
         }
       else
         {
@@ -1076,6 +1105,7 @@ CodebookParametric::AppendBeamRefinementAwv (AntennaID antennaID, SectorID secto
           awvConfig->weights = weightsVector;
           antennaConfig->CalculateArrayPattern (awvConfig->weights, awvConfig->arrayPattern);
           sectorConfig->awvList.push_back (awvConfig);
+          m_version++;
         }
       else
         {
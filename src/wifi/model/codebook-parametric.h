@@ -98,6 +98,15 @@ public:
    * \return The array pattern of the antenna array for particular angles.
    */
   Complex GetArrayPattern (uint16_t azimuthAngle, uint16_t elevationAngle);
+  /**
+   * Find the array pattern value associated with this sector/awv for particular angles without
+   * modifying the pattern, so it can be called concurrently.
+   * \param azimuthAngle The azimuth angle in degrees.
+   * \param elevationAngle The azimuth angle in degrees.
+   * \param value The array pattern of the antenna array for these angles.
+   * \return True if the array pattern has been calculated for these angles, otherwise false.
+   */
+  bool FindArrayPattern (uint16_t azimuthAngle, uint16_t elevationAngle, Complex &value) const;
   /**
    * Calculate the complex array pattern value for particular angles.
    * \param azimuthAngle The azimuth angle in degrees.
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <numeric>
 
@@ -41,6 +42,7 @@ Codebook::Codebook ()
     m_totalRxSectors (0),
     m_totalSectors (0),
     m_totalAntennas (0),
+    m_version (0),
     m_beaconRandomization (false),
     m_btiSectorOffset (0)
 {
@@ -177,6 +179,7 @@ Codebook::SetGlobalBeamformingSectorList (SectorSweepType type, Antenna2SectorLi
     {
       m_rxBeamformingSectors = sectorList;
     }
+  m_version++;
 }
 
 void
@@ -192,6 +195,7 @@ Codebook::AppendBeamformingSector (SectorSweepType type, AntennaID antennaID, Se
     {
       AppendToSectorList (m_rxBeamformingSectors, antennaID, sectorID);
     }
+  m_version++;
 }
 
 uint8_t
@@ -218,6 +222,7 @@ Codebook::SetBeamformingSectorList (SectorSweepType type, Mac48Address address,
     {
       m_rxCustomSectors[address] = sectorList;
     }
+  m_version++;
 }
 
 uint8_t
@@ -536,6 +541,254 @@ Codebook::StartSectorSweeping (Mac48Address address, SectorSweepType type, uint8
   m_remainingSectors = CountNumberOfSectors (m_currentSectorList) * peerAntennas - 1;
 }
 
+void
+Codebook::StartSectorSweeping (Mac48Address address, const Antenna2SectorList &sectorList, uint8_t peerAntennas)
+{
+  NS_LOG_DEBUG (this << address << sectorList.size () << static_cast<uint16_t> (peerAntennas));
+  NS_ASSERT_MSG (sectorList.size () > 0, "The list of sectors for a partial sector sweep is empty.");
+  m_partialSectors = sectorList;
+  m_currentSectorList = &m_partialSectors;
+  m_beamformingAntenna = m_currentSectorList->begin ();
+  m_beamformingSectorList = m_beamformingAntenna->second;
+  SetActiveTxSectorID (m_beamformingAntenna->first, m_beamformingSectorList.front ());
+  m_currentBFPhase = SLS_PHASE;
+  m_sectorSweepType = TransmitSectorSweep;
+  m_peerStation = address;
+  m_currentSectorIndex = 0;
+  m_remainingSectors = CountNumberOfSectors (m_currentSectorList) * peerAntennas - 1;
+}
+
+Antenna2SectorList
+Codebook::GetNeighborSectorList (Mac48Address address, AntennaID antennaID, SectorID sectorID, uint8_t neighbors)
+{
+  Antenna2SectorList neighborList;
+  BeamformingSectorListCI iter = m_txCustomSectors.find (address);
+  const Antenna2SectorList *antennaList;
+  if (iter != m_txCustomSectors.end ())
+    {
+      antennaList = &iter->second;
+    }
+  else
+    {
+      antennaList = &m_txBeamformingSectors;
+    }
+  Antenna2SectorListCI antennaI = antennaList->find (antennaID);
+  if (antennaI == antennaList->end ())
+    {
+      return neighborList;
+    }
+  const SectorIDList &sectors = antennaI->second;
+  SectorIDList::const_iterator sectorI = std::find (sectors.begin (), sectors.end (), sectorID);
+  if (sectorI == sectors.end ())
+    {
+      return neighborList;
+    }
+
+  /* The sectors of an antenna array are ordered around it, so wrap around the ends of the list */
+  int size = sectors.size ();
+  if (2 * neighbors + 1 >= size)
+    {
+      neighborList[antennaID] = sectors;
+      return neighborList;
+    }
+  int center = std::distance (sectors.begin (), sectorI);
+  SectorIDList &sectorList = neighborList[antennaID];
+  for (int offset = -static_cast<int> (neighbors); offset <= static_cast<int> (neighbors); offset++)
+    {
+      sectorList.push_back (sectors[(center + offset + size) % size]);
+    }
+  return neighborList;
+}
+
+void
+Codebook::AppendChildSector (AntennaID antennaID, SectorID parentID, SectorID childID)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint16_t> (antennaID) << static_cast<uint16_t> (parentID)
+                   << static_cast<uint16_t> (childID));
+  AntennaArrayListI iter = m_antennaArrayList.find (antennaID);
+  NS_ABORT_MSG_IF (iter == m_antennaArrayList.end (),
+                   "Cannot find the specified antenna ID=" << static_cast<uint16_t> (antennaID));
+  Ptr<PhasedAntennaArrayConfig> antennaConfig = StaticCast<PhasedAntennaArrayConfig> (iter->second);
+  NS_ABORT_MSG_IF (antennaConfig->sectorList.find (parentID) == antennaConfig->sectorList.end (),
+                   "Cannot find the specified sector ID=" << static_cast<uint16_t> (parentID));
+  NS_ABORT_MSG_IF (antennaConfig->sectorList.find (childID) == antennaConfig->sectorList.end (),
+                   "Cannot find the specified sector ID=" << static_cast<uint16_t> (childID));
+  m_txSectorHierarchy[antennaID][parentID].push_back (childID);
+  m_version++;
+}
+
+bool
+Codebook::HasSectorHierarchy (void) const
+{
+  return !m_txSectorHierarchy.empty ();
+}
+
+bool
+Codebook::IsWideSector (AntennaID antennaID, SectorID sectorID) const
+{
+  Antenna2SectorHierarchy::const_iterator iter = m_txSectorHierarchy.find (antennaID);
+  return (iter != m_txSectorHierarchy.end ()) && (iter->second.find (sectorID) != iter->second.end ());
+}
+
+Antenna2SectorList
+Codebook::GetWideSectorList (void) const
+{
+  Antenna2SectorList wideList;
+  for (Antenna2SectorHierarchy::const_iterator antennaI = m_txSectorHierarchy.begin ();
+       antennaI != m_txSectorHierarchy.end (); antennaI++)
+    {
+      /* Only keep the wide sectors that are not refined from a wider sector */
+      for (SectorHierarchy::const_iterator parentI = antennaI->second.begin (); parentI != antennaI->second.end (); parentI++)
+        {
+          bool isChild = false;
+          for (SectorHierarchy::const_iterator otherI = antennaI->second.begin (); otherI != antennaI->second.end (); otherI++)
+            {
+              if (std::find (otherI->second.begin (), otherI->second.end (), parentI->first) != otherI->second.end ())
+                {
+                  isChild = true;
+                  break;
+                }
+            }
+          if (!isChild)
+            {
+              wideList[antennaI->first].push_back (parentI->first);
+            }
+        }
+    }
+  return wideList;
+}
+
+Antenna2SectorList
+Codebook::GetChildSectorList (AntennaID antennaID, SectorID parentID) const
+{
+  Antenna2SectorList childList;
+  Antenna2SectorHierarchy::const_iterator antennaI = m_txSectorHierarchy.find (antennaID);
+  if (antennaI != m_txSectorHierarchy.end ())
+    {
+      SectorHierarchy::const_iterator parentI = antennaI->second.find (parentID);
+      if (parentI != antennaI->second.end ())
+        {
+          childList[antennaID] = parentI->second;
+        }
+    }
+  return childList;
+}
+
+/**
+ * Get the number of the line starting at the given position of a file.
+ * \param file The file.
+ * \param position The position of the start of the line.
+ * \return The number of the line, starting from one.
+ */
+static uint32_t
+GetLineNumber (std::istream &file, std::streampos position)
+{
+  file.clear ();
+  file.seekg (0);
+  uint32_t lineNumber = 1;
+  char c;
+  while ((file.tellg () < position) && file.get (c))
+    {
+      if (c == '\n')
+        {
+          lineNumber++;
+        }
+    }
+  return lineNumber;
+}
+
+/**
+ * Parse an antenna or sector ID of the sector hierarchy.
+ * \param value The text of the ID.
+ * \param id The parsed ID.
+ * \return True if the text is a valid ID, otherwise false.
+ */
+static bool
+ParseHierarchyId (std::string value, uint8_t &id)
+{
+  std::size_t begin = value.find_first_not_of (" \t\r");
+  if (begin == std::string::npos)
+    {
+      return false;
+    }
+  value = value.substr (begin, value.find_last_not_of (" \t\r") - begin + 1);
+  if ((value.size () > 3) || (value.find_first_not_of ("0123456789") != std::string::npos)
+      || (std::atoi (value.c_str ()) > 255))
+    {
+      return false;
+    }
+  id = std::atoi (value.c_str ());
+  return true;
+}
+
+void
+Codebook::ReadSectorHierarchy (std::istream &file, std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  /* A codebook loaded again replaces its previous hierarchy */
+  m_txSectorHierarchy.clear ();
+  m_version++;
+  std::string line, value;
+  /* Only the lines following the section marker are parsed, anything else at the end of the file is ignored */
+  bool found = false;
+  while (!found && std::getline (file, line))
+    {
+      std::string::size_type first = line.find_first_not_of (" \t\r");
+      std::string::size_type last = line.find_last_not_of (" \t\r");
+      found = (first != std::string::npos) && (line.substr (first, last - first + 1) == SECTOR_HIERARCHY_MARKER);
+    }
+  if (!found)
+    {
+      return;
+    }
+  std::streampos lineStart = file.tellg ();
+  while (std::getline (file, line))
+    {
+      if (line.find_first_not_of (" \t\r") == std::string::npos)
+        {
+          lineStart = file.tellg ();
+          continue;
+        }
+      std::istringstream split (line);
+      std::vector<uint8_t> ids;
+      while (std::getline (split, value, ','))
+        {
+          uint8_t id;
+          if (!ParseHierarchyId (value, id))
+            {
+              NS_FATAL_ERROR ("Invalid ID \"" << value << "\" in the sector hierarchy of " << filename
+                              << " at line " << GetLineNumber (file, lineStart));
+            }
+          ids.push_back (id);
+        }
+      if (ids.size () < 3)
+        {
+          NS_FATAL_ERROR ("The sector hierarchy of " << filename << " expects AntennaID,WideSectorID,ChildSectorID,..."
+                          << " at line " << GetLineNumber (file, lineStart));
+        }
+      AntennaArrayListI iter = m_antennaArrayList.find (ids[0]);
+      if (iter == m_antennaArrayList.end ())
+        {
+          NS_FATAL_ERROR ("Antenna [" << static_cast<uint16_t> (ids[0]) << "] does not exist in " << filename
+                          << " at line " << GetLineNumber (file, lineStart));
+        }
+      Ptr<PhasedAntennaArrayConfig> antennaConfig = StaticCast<PhasedAntennaArrayConfig> (iter->second);
+      for (std::vector<uint8_t>::const_iterator id = ids.begin () + 1; id != ids.end (); id++)
+        {
+          if (antennaConfig->sectorList.find (*id) == antennaConfig->sectorList.end ())
+            {
+              NS_FATAL_ERROR ("Sector [" << static_cast<uint16_t> (*id) << "] does not exist in " << filename
+                              << " at line " << GetLineNumber (file, lineStart));
+            }
+        }
+      for (std::vector<uint8_t>::const_iterator id = ids.begin () + 2; id != ids.end (); id++)
+        {
+          AppendChildSector (ids[0], ids[1], *id);
+        }
+      lineStart = file.tellg ();
+    }
+}
+
 bool
 Codebook::GetNextSector (bool &changeAntenna)
 {
@@ -633,6 +886,14 @@ Codebook::CopyCodebook (const Ptr<Codebook> codebook)
   m_activeRFChainID = codebook->m_activeRFChainID;
   /* BTI Variables */
   m_bhiAntennaList = codebook->m_bhiAntennaList;
+  m_txSectorHierarchy = codebook->m_txSectorHierarchy;
+  m_version++;
+}
+
+uint32_t
+Codebook::GetVersion (void) const
+{
+  return m_version;
 }
 
 void
@@ -647,6 +908,7 @@ Codebook::AppendAWV (AntennaID antennaID, SectorID sectorID, Ptr<AWV_Config> awv
         {
           Ptr<SectorConfig> sectorConfig = StaticCast<SectorConfig> (sectorI->second);
           sectorConfig->awvList.push_back (awvConfig);
+          m_version++;
         }
       else
         {
@@ -675,6 +937,7 @@ Codebook::DeleteAWVs (AntennaID antennaID, SectorID sectorID)
               awvIt = 0;
             }
           sectorConfig->awvList.clear ();
+          m_version++;
         }
       else
         {
@@ -750,6 +1013,7 @@ Codebook::ChangeAntennaOrientation (AntennaID antennaID, double psi, double thet
       antennaConfig->orientation.psi = DegreesToRadians (psi);
       antennaConfig->orientation.theta = DegreesToRadians (theta);
       antennaConfig->orientation.phi = DegreesToRadians (phi);
+      m_version++;
     }
   else
     {
@@ -15,9 +15,12 @@
 #include "wigig-data-types.h"
 
 #include <cmath>
+#include <istream>
 #include <map>
 #include <vector>
 
+class QdPrecomputeTest;
+
 namespace ns3 {
 
 #define MAXIMUM_NUMBER_OF_RF_CHAINS     8       //!< The maximum number of RF Chains for 802.11ay.
@@ -27,10 +30,13 @@ namespace ns3 {
 #define MAXIMUM_NUMBER_OF_SECTORS       128     //!< The maximum total number of sectors is limited to 1028 sectors.
 #define AZIMUTH_CARDINALITY     361             //!< Number of the azimuth angles (1 Degree granularity from 0 -> 360).
 #define ELEVATION_CARDINALITY   181             //!< Number of the elevation angles (1 Degree granularity from -90 -> 90).
+#define SECTOR_HIERARCHY_MARKER "SECTOR_HIERARCHY" //!< The line starting the sector hierarchy in a codebook file.
 
 typedef std::map<Mac48Address, Antenna2SectorList> BeamformingSectorList;     //!< Typedef for beamforming sector list (Custom sector set for specific station).
 typedef BeamformingSectorList::iterator BeamformingSectorListI;               //!< Typedef for beafmorming sector Iterator.
 typedef BeamformingSectorList::const_iterator BeamformingSectorListCI;        //!< Typedef for beafmorming sector Iterator.
+typedef std::map<SectorID, SectorIDList> SectorHierarchy;                      //!< Typedef for the child sectors of each wide sector.
+typedef std::map<AntennaID, SectorHierarchy> Antenna2SectorHierarchy;          //!< Typedef for the sector hierarchy of each antenna array.
 
 enum CurrentBeamformingPhase {
   BHI_PHASE = 0,
@@ -193,6 +199,43 @@ public:
    * \param codebook A pointer to the codebook that we want to copy its content.
    */
   virtual void CopyCodebook (const Ptr<Codebook> codebook);
+  /**
+   * Get the version of the codebook. The version changes whenever the beamforming sector lists,
+   * the AWVs or the orientation of the antenna arrays change.
+   * \return The current version of the codebook.
+   */
+  uint32_t GetVersion (void) const;
+  /**
+   * Declare a transmit sector as a child of a wider sector in the sector hierarchy of an antenna array.
+   * \param antennaID The ID of the antenna array.
+   * \param parentID The ID of the wide sector.
+   * \param childID The ID of the narrower sector covered by the wide sector.
+   */
+  void AppendChildSector (AntennaID antennaID, SectorID parentID, SectorID childID);
+  /**
+   * Check whether the codebook declares a sector hierarchy for hierarchical beam search.
+   * \return True if at least one wide sector has been declared, otherwise false.
+   */
+  bool HasSectorHierarchy (void) const;
+  /**
+   * Check whether a sector is a wide sector, i.e. it has child sectors in the sector hierarchy.
+   * \param antennaID The ID of the antenna array.
+   * \param sectorID The ID of the sector.
+   * \return True if the sector has child sectors, otherwise false.
+   */
+  bool IsWideSector (AntennaID antennaID, SectorID sectorID) const;
+  /**
+   * Get the top level of the sector hierarchy, i.e. the wide sectors that are not children of another sector.
+   * \return The list of antennas with their top level wide sectors.
+   */
+  Antenna2SectorList GetWideSectorList (void) const;
+  /**
+   * Get the child sectors of a wide sector.
+   * \param antennaID The ID of the antenna array.
+   * \param parentID The ID of the wide sector.
+   * \return The list of antennas with the child sectors or an empty list if the sector has no children.
+   */
+  Antenna2SectorList GetChildSectorList (AntennaID antennaID, SectorID parentID) const;
   /**
    * Change phased antenna array orientation using Euler transformation.
    * \param antennaID The ID of the antenna array.
@@ -281,6 +324,8 @@ protected:
   friend class WifiPhy;
   friend class SpectrumDmgWifiPhy;
   friend class QdPropagationEngine;
+  /// allow QdPrecomputeTest class access
+  friend class ::QdPrecomputeTest;
 
   virtual void DoDispose ();
   virtual void DoInitialize (void);
@@ -290,6 +335,16 @@ protected:
    * \param device A pointer to the WifiNetDevice we are associated with.
    */
   void SetDevice (Ptr<WifiNetDevice> device);
+  /**
+   * Read the optional sector hierarchy at the end of a codebook file. The hierarchy starts with a line
+   * holding SECTOR_HIERARCHY_MARKER, then each line declares a wide sector and its children as
+   * "AntennaID,WideSectorID,ChildSectorID,...". The content of a file without the marker is ignored.
+   * Within the hierarchy, a malformed line or an unknown antenna or sector ID is a fatal error reporting
+   * the line of the file.
+   * \param file The codebook file positioned after the last phased antenna array.
+   * \param filename The name of the codebook file.
+   */
+  void ReadSectorHierarchy (std::istream &file, std::string filename);
   /**
    * Get a pointer to the WifiNetDevice we are associated with.
    * \return device A pointer to the WifiNetDevice we are associated with.
@@ -519,6 +574,23 @@ protected:
    * \param type Sector Sweep Type (Transmit/Receive).
    */
   void StartSectorSweeping (Mac48Address address, SectorSweepType type, uint8_t peerAntennas);
+  /**
+   * Start a partial transmit sector sweep over a subset of the transmit sectors (e.g. the neighborhood of a previous
+   * best sector or one level of the sector hierarchy).
+   * \param address the MAC address of the peer station.
+   * \param sectorList The list of antennas with their sectors to sweep.
+   * \param peerAntennas The number of receive DMG antennas in the peer station.
+   */
+  void StartSectorSweeping (Mac48Address address, const Antenna2SectorList &sectorList, uint8_t peerAntennas);
+  /**
+   * Get the transmit sectors in the neighborhood of a sector within the list of sectors used with a peer station.
+   * \param address the MAC address of the peer station.
+   * \param antennaID The ID of the antenna array.
+   * \param sectorID The ID of the sector in the center of the neighborhood.
+   * \param neighbors The number of sectors on each side of the center sector.
+   * \return The sectors in the neighborhood or an empty list if the sector is not used with the peer station.
+   */
+  Antenna2SectorList GetNeighborSectorList (Mac48Address address, AntennaID antennaID, SectorID sectorID, uint8_t neighbors);
   /**
    * Get the next Sector ID in the Beamforming Sector List.
    * \param changeAntenna True if we are changing the antenna otherwise false.
@@ -733,6 +805,7 @@ protected:
   SectorIDList m_beamformingSectorList;       //!< The list of the sectors witin the current used antenna.
   Antenna2SectorList *m_currentSectorList;    //!< Current list of TXSS sectors.
   Mac48Address m_peerStation;                 //!< The MAC address of the peer station in the SLS phase.
+  Antenna2SectorList m_partialSectors;        //!< List of transmit sectors for a partial TXSS.
 
   /* Beamforming Variables */  
   Antenna2SectorList m_txBeamformingSectors;  //!< List of the general transmit sectors utilized during SLS.
@@ -743,6 +816,8 @@ protected:
   uint8_t m_totalRxSectors;                   //!< The total number of receive sectors within the Codebook.
   uint8_t m_totalSectors;                     //!< The total number of sectors within the Codebook.
   uint8_t m_totalAntennas;                    //!< The total number of antennas within the Codebook.
+  Antenna2SectorHierarchy m_txSectorHierarchy; //!< Hierarchy of wide and narrow transmit sectors for hierarchical beam search.
+  uint32_t m_version;                         //!< The version of the codebook, incremented on each modification.
 
   /* BHI Access Period Variables */
   Antenna2SectorList m_bhiAntennaList;        //!< List of antenna arrays utilized during the BHI access period.
@@ -287,7 +287,7 @@ DmgAdhocWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
         }
       else
         {
-          ForwardUp (mpdu->GetPacket ()->Copy (), from, to);
+          ForwardUp (mpdu->GetPacket (), from, to);
         }
       return;
     }
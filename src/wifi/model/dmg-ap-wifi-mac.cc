@@ -21,6 +21,7 @@
 #include "wifi-utils.h"
 #include "wifi-phy.h"
 #include "dmg-wifi-phy.h"
+#include "dmg-profiler.h"
 
 namespace ns3 {
 
@@ -1395,6 +1396,7 @@ DmgApWifiMac::FrameTxOk (const WifiMacHeader &hdr)
       m_dmgSlsTxop->SLS_BFT_Completed ();
       m_performingBFT = false;
       m_slsResponderStateMachine = SLS_RESPONDER_TXSS_PHASE_COMPELTED;
+      RecordTransmitSectorSweep (address, m_isResponderTXSS);
       m_slsCompleted (SlsCompletionAttrbitutes (address, CHANNEL_ACCESS_DTI, BeamformingResponder,
                                                 m_isInitiatorTXSS, m_isResponderTXSS,
                                                 antennaConfig.first, antennaConfig.second, m_maxSnr));
@@ -2286,11 +2288,13 @@ DmgApWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
   NS_LOG_FUNCTION (this << *mpdu);
 
   const WifiMacHeader* hdr = &mpdu->GetHeader ();
-  Ptr<Packet> packet = mpdu->GetPacket ()->Copy ();
   Mac48Address from = hdr->GetAddr2 ();
 
   if (hdr->IsData ())
     {
+      /* Data frames are not modified here, hence the received packet is only
+         copied when it has to be forwarded down */
+      Ptr<const Packet> packet = mpdu->GetPacket ();
       Mac48Address bssid = hdr->GetAddr1 ();
       if (!hdr->IsFromDs ()
           && hdr->IsToDs ()
@@ -2306,7 +2310,6 @@ DmgApWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
                     {
                       NS_LOG_DEBUG ("Received A-MSDU from=" << from << ", size=" << packet->GetSize ());
                       DeaggregateAmsduAndForward (mpdu);
-                      packet = 0;
                     }
                   else
                     {
@@ -2321,20 +2324,18 @@ DmgApWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
           else if (to.IsGroup () || m_stationManager->IsAssociated (to))
             {
               NS_LOG_DEBUG ("forwarding frame from=" << from << ", to=" << to);
-              Ptr<Packet> copy = packet->Copy ();
-
               // If the frame we are forwarding is of type QoS Data,
               // then we need to preserve the UP in the QoS control
               // header...
               if (hdr->IsQosData ())
                 {
-                  ForwardDown (packet, from, to, hdr->GetQosTid ());
+                  ForwardDown (packet->Copy (), from, to, hdr->GetQosTid ());
                 }
               else
                 {
-                  ForwardDown (packet, from, to);
+                  ForwardDown (packet->Copy (), from, to);
                 }
-              ForwardUp (copy, from, to);
+              ForwardUp (packet, from, to);
             }
           else
             {
@@ -2355,11 +2356,15 @@ DmgApWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
         }
       return;
     }
-  else if (hdr->IsSSW ())
+
+  Ptr<Packet> packet = mpdu->GetPacket ()->Copy ();
+
+  if (hdr->IsSSW ())
     {
       if (m_accessPeriod == CHANNEL_ACCESS_ABFT)
         {
           NS_LOG_INFO ("Received SSW frame during A-BFT from=" << hdr->GetAddr2 ());
+          NS_DMG_PROFILE_SCOPE (DMG_PROFILE_MAC_SLS);
 
           /* Check if we have received any SSW frame during the current SSW-Slot */
           if (!m_receivedOneSSW)
@@ -2438,6 +2443,7 @@ DmgApWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
   else if (hdr->IsSSW_FBCK ())
     {
       NS_LOG_LOGIC ("Responder: Received SSW-FBCK frame from=" << hdr->GetAddr2 ());
+      NS_DMG_PROFILE_SCOPE (DMG_PROFILE_MAC_SLS);
 
       if (m_performingBFT && (m_peerStationAddress != hdr->GetAddr2 ()))
         {
@@ -9,6 +9,7 @@
 #include "ns3/log.h"
 #include "dmg-information-elements.h"
 #include <cmath>
+#include <limits>
 
 NS_LOG_COMPONENT_DEFINE ("DmgInformationElements");
 
@@ -1635,20 +1636,28 @@ BeamRefinementElement::SerializeInformationField (Buffer::Iterator start) const
   value4 |= (static_cast<uint8_t> (m_bfTrainingType) & 0x3) << 1;
   value4 |= (m_edmgDualPolarizationTrnChanneMeasurementPresent & 0x1) << 3;
 
-  start.WriteHtolsbU32 (value1);
-  start.WriteU8 (value2);
-  start.WriteHtolsbU16 (value3);
-  start.WriteU8 (value4);
+  /* Lay out the information field in little endian order and write it at once */
+  uint8_t buffer[8];
+  buffer[0] = value1 & 0xFF;
+  buffer[1] = (value1 >> 8) & 0xFF;
+  buffer[2] = (value1 >> 16) & 0xFF;
+  buffer[3] = (value1 >> 24) & 0xFF;
+  buffer[4] = value2;
+  buffer[5] = value3 & 0xFF;
+  buffer[6] = (value3 >> 8) & 0xFF;
+  buffer[7] = value4;
+  start.Write (buffer, 8);
 }
 
 uint8_t
 BeamRefinementElement::DeserializeInformationField (Buffer::Iterator start, uint8_t length)
 {
-  Buffer::Iterator i = start;
-  uint32_t value1 = i.ReadLsbtohU32 ();
-  uint8_t value2 = i.ReadU8 ();
-  uint16_t value3 = i.ReadLsbtohU16 ();
-  uint8_t value4 = i.ReadU8 ();
+  uint8_t buffer[8];
+  start.Read (buffer, 8);
+  uint32_t value1 = buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | (static_cast<uint32_t> (buffer[3]) << 24);
+  uint8_t value2 = buffer[4];
+  uint16_t value3 = buffer[5] | (buffer[6] << 8);
+  uint8_t value4 = buffer[7];
 
   m_initiator = value1 & 0x1;
   m_txTrainResponse = (value1 >> 1) & 0x1;
@@ -2267,7 +2276,7 @@ uint32_t
 AllocationField::GetSerializedSize (void) const
 {
   NS_LOG_FUNCTION (this);
-  return 15;
+  return ALLOCATION_FIELD_SIZE;
 }
 
 Buffer::Iterator
@@ -2275,16 +2284,9 @@ AllocationField::Serialize (Buffer::Iterator start) const
 {
   NS_LOG_FUNCTION (this << &start);
   Buffer::Iterator i = start;
-
-  i.WriteHtolsbU16 (GetAllocationControl ());
-  i = m_bfControl.Serialize (i);
-  i.WriteU8 (m_SourceAid);
-  i.WriteU8 (m_destinationAid);
-  i.WriteHtolsbU32 (m_allocationStart);
-  i.WriteHtolsbU16 (m_allocationBlockDuration);
-  i.WriteU8 (m_numberOfBlocks);
-  i.WriteHtolsbU16 (m_allocationBlockPeriod);
-
+  uint8_t buffer[ALLOCATION_FIELD_SIZE];
+  Serialize (buffer);
+  i.Write (buffer, ALLOCATION_FIELD_SIZE);
   return i;
 }
 
@@ -2293,17 +2295,47 @@ AllocationField::Deserialize (Buffer::Iterator start)
 {
   NS_LOG_FUNCTION (this << &start);
   Buffer::Iterator i = start;
+  uint8_t buffer[ALLOCATION_FIELD_SIZE];
+  i.Read (buffer, ALLOCATION_FIELD_SIZE);
+  Deserialize (buffer);
+  return i;
+}
 
-  SetAllocationControl (i.ReadLsbtohU16 ());
-  i = m_bfControl.Deserialize (i);
-  m_SourceAid = i.ReadU8 ();
-  m_destinationAid = i.ReadU8 ();
-  m_allocationStart = i.ReadLsbtohU32 ();
-  m_allocationBlockDuration = i.ReadLsbtohU16 ();
-  m_numberOfBlocks = i.ReadU8 ();
-  m_allocationBlockPeriod = i.ReadLsbtohU16 ();
+void
+AllocationField::Serialize (uint8_t *buffer) const
+{
+  /* All the subfields have a fixed position, so write them into a flat array in little endian
+   * order and copy the whole field into the packet buffer at once */
+  uint16_t allocationControl = GetAllocationControl ();
+  uint16_t bfControl = m_bfControl.GetBfControl ();
+  buffer[0] = allocationControl & 0xFF;
+  buffer[1] = (allocationControl >> 8) & 0xFF;
+  buffer[2] = bfControl & 0xFF;
+  buffer[3] = (bfControl >> 8) & 0xFF;
+  buffer[4] = m_SourceAid;
+  buffer[5] = m_destinationAid;
+  buffer[6] = m_allocationStart & 0xFF;
+  buffer[7] = (m_allocationStart >> 8) & 0xFF;
+  buffer[8] = (m_allocationStart >> 16) & 0xFF;
+  buffer[9] = (m_allocationStart >> 24) & 0xFF;
+  buffer[10] = m_allocationBlockDuration & 0xFF;
+  buffer[11] = (m_allocationBlockDuration >> 8) & 0xFF;
+  buffer[12] = m_numberOfBlocks;
+  buffer[13] = m_allocationBlockPeriod & 0xFF;
+  buffer[14] = (m_allocationBlockPeriod >> 8) & 0xFF;
+}
 
-  return i;
+void
+AllocationField::Deserialize (const uint8_t *buffer)
+{
+  SetAllocationControl (buffer[0] | (buffer[1] << 8));
+  m_bfControl.SetBfControl (buffer[2] | (buffer[3] << 8));
+  m_SourceAid = buffer[4];
+  m_destinationAid = buffer[5];
+  m_allocationStart = buffer[6] | (buffer[7] << 8) | (buffer[8] << 16) | (static_cast<uint32_t> (buffer[9]) << 24);
+  m_allocationBlockDuration = buffer[10] | (buffer[11] << 8);
+  m_numberOfBlocks = buffer[12];
+  m_allocationBlockPeriod = buffer[13] | (buffer[14] << 8);
 }
 
 void
@@ -2537,26 +2569,37 @@ ExtendedScheduleElement::ElementId () const
 uint8_t
 ExtendedScheduleElement::GetInformationFieldSize () const
 {
-  return m_list.size () * 15;
+  return m_list.size () * AllocationField::ALLOCATION_FIELD_SIZE;
 }
 
 void
 ExtendedScheduleElement::SerializeInformationField (Buffer::Iterator start) const
 {
-  for (AllocationFieldList::const_iterator i = m_list.begin (); i != m_list.end () ; i++)
+  /* The size of the information field is at most 255 bytes, so the allocation
+   * fields are laid out on the stack and written to the packet buffer at once */
+  uint8_t buffer[std::numeric_limits<uint8_t>::max ()];
+  NS_ASSERT_MSG (m_list.size () * AllocationField::ALLOCATION_FIELD_SIZE <= sizeof (buffer),
+                 "Too many Allocation fields (" << m_list.size () << ") for a single Extended Schedule element");
+  uint32_t size = 0;
+  for (AllocationFieldList::const_iterator i = m_list.begin (); i != m_list.end (); i++)
     {
-      start = i->Serialize (start);
+      i->Serialize (buffer + size);
+      size += AllocationField::ALLOCATION_FIELD_SIZE;
     }
+  start.Write (buffer, size);
 }
 
 uint8_t
 ExtendedScheduleElement::DeserializeInformationField (Buffer::Iterator start, uint8_t length)
 {
+  uint8_t buffer[std::numeric_limits<uint8_t>::max ()];
+  start.Read (buffer, length);
+  m_list.reserve (m_list.size () + length / AllocationField::ALLOCATION_FIELD_SIZE);
   AllocationField field;
-  Buffer::Iterator i = start;
-  while (i.GetDistanceFrom (start) != length)
+  for (uint32_t offset = 0; offset + AllocationField::ALLOCATION_FIELD_SIZE <= length;
+       offset += AllocationField::ALLOCATION_FIELD_SIZE)
     {
-      i = field.Deserialize (i);
+      field.Deserialize (buffer + offset);
       m_list.push_back (field);
     }
   return length;
@@ -5855,6 +5898,13 @@ EDMGChannelMeasurementFeedbackElement::GetInformationFieldSize () const
 void
 EDMGChannelMeasurementFeedbackElement::SerializeInformationField (Buffer::Iterator start) const
 {
+  /* Lay out the lists in little endian order and write them at once, the information field
+   * size is at most 255 bytes */
+  uint8_t buffer[std::numeric_limits<uint8_t>::max ()];
+  uint32_t size = m_edmgSectorIDOrder_List.size () * 3 + m_brp_CDOWN_List.size () + m_tap_Delay_List.size () * 2;
+  NS_ASSERT_MSG (size < sizeof (buffer), "The lists of " << size << " bytes do not fit in a single "
+                 "EDMG Channel Measurement Feedback element");
+  uint32_t offset = 0;
   for (EDMGSectorIDOrder_ListCI it = m_edmgSectorIDOrder_List.begin (); it != m_edmgSectorIDOrder_List.end (); it++)
     {
       uint16_t value1 = 0;
@@ -5862,17 +5912,20 @@ EDMGChannelMeasurementFeedbackElement::SerializeInformationField (Buffer::Iterat
       value1 |= (it->SectorID & 0x7FF);
       value2 |= (it->TXAntennaID & 0x7);
       value2 |= (it->RXAntennaID & 0x7) << 3;
-      start.WriteHtolsbU16 (value1);
-      start.WriteU8 (value2);
+      buffer[offset++] = value1 & 0xFF;
+      buffer[offset++] = (value1 >> 8) & 0xFF;
+      buffer[offset++] = value2;
     }
   for (BRP_CDOWN_LIST_CI it = m_brp_CDOWN_List.begin (); it != m_brp_CDOWN_List.end (); it++)
     {
-      start.WriteU8 ((*it));
+      buffer[offset++] = (*it);
     }
   for (Tap_Delay_List_CI it = m_tap_Delay_List.begin (); it != m_tap_Delay_List.end (); it++)
     {
-      start.WriteHtolsbU16 ((*it));
+      buffer[offset++] = (*it) & 0xFF;
+      buffer[offset++] = ((*it) >> 8) & 0xFF;
     }
+  start.Write (buffer, offset);
 }
 
 uint8_t
@@ -5983,7 +6036,9 @@ std::istream &operator >> (std::istream &is, EDMGChannelMeasurementFeedbackEleme
 ****************************************************/
 
 EDMGGroupIDSetElement::EDMGGroupIDSetElement ()
-  : m_numEDMGGroups (0)
+  : m_numEDMGGroups (0),
+    m_informationFieldSize (0),
+    m_informationFieldSizeValid (false)
 {
 }
 
@@ -6002,13 +6057,18 @@ EDMGGroupIDSetElement::ElementIdExt () const
 uint8_t
 EDMGGroupIDSetElement::GetInformationFieldSize () const
 {
-  uint8_t size = 0;
-  size += 2;  /* 2 Bytes: Extension Element ID + Number of Groups */
-  for (EDMGGroupTuplesCI it = m_edmgGroupTuples.begin (); it != m_edmgGroupTuples.end (); it++)
+  if (!m_informationFieldSizeValid)
     {
-      size += 2 + it->aidList.size ();
+      uint8_t size = 0;
+      size += 2;  /* 2 Bytes: Extension Element ID + Number of Groups */
+      for (EDMGGroupTuplesCI it = m_edmgGroupTuples.begin (); it != m_edmgGroupTuples.end (); it++)
+        {
+          size += 2 + it->aidList.size ();
+        }
+      m_informationFieldSize = size;
+      m_informationFieldSizeValid = true;
     }
-  return size;
+  return m_informationFieldSize;
 }
 
 void
@@ -6044,6 +6104,7 @@ EDMGGroupIDSetElement::DeserializeInformationField (Buffer::Iterator start, uint
         }
       m_edmgGroupTuples.push_back (tuple);
     }
+  m_informationFieldSizeValid = false;
   return length;
 }
 
@@ -6057,6 +6118,7 @@ void
 EDMGGroupIDSetElement::AddEDMGGroupTuple (EDMGGroupTuple &tuple)
 {
   m_edmgGroupTuples.push_back (tuple);
+  m_informationFieldSizeValid = false;
 }
 
 uint8_t
@@ -6968,7 +7030,9 @@ std::istream &operator >> (std::istream &is, MIMOFeedbackControl &element)
 MIMOSelectionControlElement::MIMOSelectionControlElement ()
   : m_edmgGroupID (0),
     m_numMUConfigurations (0),
-    m_muType (MU_NonReciprocal)
+    m_muType (MU_NonReciprocal),
+    m_informationFieldSize (0),
+    m_informationFieldSizeValid (false)
 {
 }
 
@@ -6987,6 +7051,10 @@ MIMOSelectionControlElement::ElementIdExt () const
 uint8_t
 MIMOSelectionControlElement::GetInformationFieldSize () const
 {
+  if (m_informationFieldSizeValid)
+    {
+      return m_informationFieldSize;
+    }
   uint8_t length;
   length = 3;
   if (m_muType == MU_NonReciprocal)
@@ -7005,6 +7073,8 @@ MIMOSelectionControlElement::GetInformationFieldSize () const
           length+= config.configList.size () * 4;
         }
     }
+  m_informationFieldSize = length;
+  m_informationFieldSizeValid = true;
   return length;
 }
 
@@ -7088,6 +7158,7 @@ MIMOSelectionControlElement::DeserializeInformationField (Buffer::Iterator start
           endLength-= (4 + numUsers * 4);
         }
     }
+  m_informationFieldSizeValid = false;
   return length;
 }
 
@@ -7107,18 +7178,21 @@ void
 MIMOSelectionControlElement::SetMultiUserTransmissionConfigurationType (MultiUserTransmissionConfigType type)
 {
   m_muType = type;
+  m_informationFieldSizeValid = false;
 }
 
 void
 MIMOSelectionControlElement::AddNonReciprocalMUBFTrainingBasedTransmissionConfig (NonReciprocalTransmissionConfig &config)
 {
   m_nonReciprocalConfigList.push_back (config);
+  m_informationFieldSizeValid = false;
 }
 
 void
 MIMOSelectionControlElement::AddReciprocalMUBFTrainingBasedTransmissionConfig (ReciprocalTransmissionConfig &config)
 {
   m_reciprocalConfigList.push_back (config);
+  m_informationFieldSizeValid = false;
 }
 
 uint8_t
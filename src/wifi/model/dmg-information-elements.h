@@ -1055,10 +1055,22 @@ class AllocationField
 public:
   AllocationField ();
 
+  static const uint8_t ALLOCATION_FIELD_SIZE = 15;  //!< Size of the Allocation field in bytes.
+
   void Print (std::ostream &os) const;
   uint32_t GetSerializedSize (void) const;
   Buffer::Iterator Serialize (Buffer::Iterator start) const;
   Buffer::Iterator Deserialize (Buffer::Iterator start);
+  /**
+   * Serialize the Allocation field into a flat array.
+   * \param buffer Pointer to an array of at least ALLOCATION_FIELD_SIZE bytes.
+   */
+  void Serialize (uint8_t *buffer) const;
+  /**
+   * Deserialize the Allocation field from a flat array.
+   * \param buffer Pointer to an array of at least ALLOCATION_FIELD_SIZE bytes.
+   */
+  void Deserialize (const uint8_t *buffer);
 
   /**
    * The Allocation ID field, when set to a nonzero value, identifies an airtime allocation from Source AID to
@@ -2873,6 +2885,8 @@ public:
 private:
   uint8_t m_numEDMGGroups;
   EDMGGroupTuples m_edmgGroupTuples;
+  mutable uint8_t m_informationFieldSize;       //!< Cached size of the information field.
+  mutable bool m_informationFieldSizeValid;     //!< Flag to indicate whether the cached size is up to date.
 
 };
 
@@ -3510,6 +3524,8 @@ private:
   MultiUserTransmissionConfigType m_muType;
   ReciprocalTransmissionConfigList m_reciprocalConfigList;
   NonReciprocalTransmissionConfigList m_nonReciprocalConfigList;
+  mutable uint8_t m_informationFieldSize;       //!< Cached size of the information field.
+  mutable bool m_informationFieldSizeValid;     //!< Flag to indicate whether the cached size is up to date.
 
 };
 
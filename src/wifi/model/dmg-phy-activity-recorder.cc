@@ -0,0 +1,282 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "dmg-phy-activity-recorder.h"
+#include "dmg-wifi-channel.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DmgPhyActivityRecorder");
+
+NS_OBJECT_ENSURE_REGISTERED (DmgPhyActivityRecorder);
+
+/// Size of the header of a recording file in bytes
+static const uint32_t FILE_HEADER_SIZE = 8;
+
+/**
+ * Write an unsigned integer in little endian order.
+ * \param buffer the array to write to.
+ * \param value the value.
+ * \param size the number of bytes to write.
+ */
+static void
+WriteLsb (uint8_t *buffer, uint64_t value, uint32_t size)
+{
+  for (uint32_t i = 0; i < size; i++)
+    {
+      buffer[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+/**
+ * Read an unsigned integer stored in little endian order.
+ * \param buffer the array to read from.
+ * \param size the number of bytes to read.
+ * \return the value.
+ */
+static uint64_t
+ReadLsb (const uint8_t *buffer, uint32_t size)
+{
+  uint64_t value = 0;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      value |= static_cast<uint64_t> (buffer[i]) << (8 * i);
+    }
+  return value;
+}
+
+TypeId
+DmgPhyActivityRecorder::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DmgPhyActivityRecorder")
+    .SetParent<Object> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<DmgPhyActivityRecorder> ()
+    .AddAttribute ("BufferSize",
+                   "The number of records held in the buffer before they are written to the file.",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&DmgPhyActivityRecorder::SetBufferSize,
+                                         &DmgPhyActivityRecorder::GetBufferSize),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+DmgPhyActivityRecorder::DmgPhyActivityRecorder ()
+  : m_bufferSize (0),
+    m_head (0),
+    m_count (0),
+    m_nRecords (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DmgPhyActivityRecorder::~DmgPhyActivityRecorder ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+DmgPhyActivityRecorder::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+  Object::DoDispose ();
+}
+
+void
+DmgPhyActivityRecorder::SetBufferSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  Flush ();
+  m_bufferSize = size;
+  m_buffer.assign (static_cast<std::size_t> (size) * RECORD_SIZE, 0);
+  m_head = 0;
+  m_count = 0;
+}
+
+uint32_t
+DmgPhyActivityRecorder::GetBufferSize (void) const
+{
+  return m_bufferSize;
+}
+
+void
+DmgPhyActivityRecorder::Open (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  Close ();
+  /* The records buffered so far are not part of the new file */
+  m_head = 0;
+  m_count = 0;
+  m_file.open (fileName.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  NS_ABORT_MSG_IF (!m_file.is_open (), "Cannot open " << fileName);
+  uint8_t header[FILE_HEADER_SIZE];
+  WriteLsb (header, FILE_MAGIC, 4);
+  WriteLsb (header + 4, RECORD_SIZE, 4);
+  m_file.write (reinterpret_cast<const char *> (header), FILE_HEADER_SIZE);
+}
+
+void
+DmgPhyActivityRecorder::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file.is_open ())
+    {
+      Flush ();
+      m_file.close ();
+    }
+}
+
+void
+DmgPhyActivityRecorder::Flush (void)
+{
+  NS_LOG_FUNCTION (this << m_count);
+  if (!m_file.is_open () || (m_count == 0))
+    {
+      return;
+    }
+  /* When a file is open the buffer is emptied as soon as it becomes full, so the
+   * records are contiguous unless the buffer size has been changed meanwhile */
+  uint32_t first = std::min (m_count, m_bufferSize - m_head);
+  m_file.write (reinterpret_cast<const char *> (&m_buffer[m_head * RECORD_SIZE]), first * RECORD_SIZE);
+  if (first < m_count)
+    {
+      m_file.write (reinterpret_cast<const char *> (&m_buffer[0]), (m_count - first) * RECORD_SIZE);
+    }
+  m_file.flush ();
+  m_head = 0;
+  m_count = 0;
+}
+
+void
+DmgPhyActivityRecorder::ConnectChannel (Ptr<DmgWifiChannel> channel)
+{
+  NS_LOG_FUNCTION (this << channel);
+  channel->TraceConnectWithoutContext ("PhyActivityTracker",
+                                       MakeCallback (&DmgPhyActivityRecorder::RecordActivity, this));
+}
+
+void
+DmgPhyActivityRecorder::RecordActivity (uint32_t srcId, uint32_t dstId, Time duration, double power,
+                                        uint16_t fieldType, uint16_t activityType)
+{
+  Record record;
+  record.start = Simulator::Now ().GetNanoSeconds ();
+  record.srcId = srcId;
+  record.dstId = dstId;
+  record.duration = duration.GetNanoSeconds ();
+  record.power = power;
+  record.fieldType = fieldType;
+  record.activityType = activityType;
+
+  uint32_t index;
+  if (m_count < m_bufferSize)
+    {
+      index = (m_head + m_count) % m_bufferSize;
+      m_count++;
+    }
+  else
+    {
+      /* The buffer is full and there is no file, so overwrite the oldest record */
+      index = m_head;
+      m_head = (m_head + 1) % m_bufferSize;
+    }
+  Serialize (record, &m_buffer[index * RECORD_SIZE]);
+  m_nRecords++;
+
+  if (m_file.is_open () && (m_count == m_bufferSize))
+    {
+      Flush ();
+    }
+}
+
+uint64_t
+DmgPhyActivityRecorder::GetNRecords (void) const
+{
+  return m_nRecords;
+}
+
+std::vector<DmgPhyActivityRecorder::Record>
+DmgPhyActivityRecorder::GetRecords (void) const
+{
+  std::vector<Record> records;
+  records.reserve (m_count);
+  for (uint32_t i = 0; i < m_count; i++)
+    {
+      records.push_back (Deserialize (&m_buffer[((m_head + i) % m_bufferSize) * RECORD_SIZE]));
+    }
+  return records;
+}
+
+void
+DmgPhyActivityRecorder::Serialize (const Record &record, uint8_t *buffer)
+{
+  uint64_t power;
+  std::memcpy (&power, &record.power, sizeof (power));
+  WriteLsb (buffer, record.start, 8);
+  WriteLsb (buffer + 8, record.srcId, 4);
+  WriteLsb (buffer + 12, record.dstId, 4);
+  WriteLsb (buffer + 16, record.duration, 8);
+  WriteLsb (buffer + 24, power, 8);
+  WriteLsb (buffer + 32, record.fieldType, 2);
+  WriteLsb (buffer + 34, record.activityType, 2);
+}
+
+DmgPhyActivityRecorder::Record
+DmgPhyActivityRecorder::Deserialize (const uint8_t *buffer)
+{
+  Record record;
+  uint64_t power = ReadLsb (buffer + 24, 8);
+  record.start = ReadLsb (buffer, 8);
+  record.srcId = ReadLsb (buffer + 8, 4);
+  record.dstId = ReadLsb (buffer + 12, 4);
+  record.duration = ReadLsb (buffer + 16, 8);
+  std::memcpy (&record.power, &power, sizeof (power));
+  record.fieldType = ReadLsb (buffer + 32, 2);
+  record.activityType = ReadLsb (buffer + 34, 2);
+  return record;
+}
+
+bool
+DmgPhyActivityRecorder::ReadFile (std::string fileName, std::vector<Record> &records)
+{
+  NS_LOG_FUNCTION (fileName);
+  std::ifstream file (fileName.c_str (), std::ios::in | std::ios::binary);
+  if (!file.is_open ())
+    {
+      return false;
+    }
+  uint8_t header[FILE_HEADER_SIZE];
+  file.read (reinterpret_cast<char *> (header), FILE_HEADER_SIZE);
+  if (!file || (ReadLsb (header, 4) != FILE_MAGIC) || (ReadLsb (header + 4, 4) != RECORD_SIZE))
+    {
+      return false;
+    }
+  uint8_t buffer[RECORD_SIZE];
+  while (file.read (reinterpret_cast<char *> (buffer), RECORD_SIZE))
+    {
+      records.push_back (Deserialize (buffer));
+    }
+  return true;
+}
+
+} //namespace ns3
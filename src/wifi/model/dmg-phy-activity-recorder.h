@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DMG_PHY_ACTIVITY_RECORDER_H
+#define DMG_PHY_ACTIVITY_RECORDER_H
+
+#include <fstream>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+class DmgWifiChannel;
+
+/**
+ * \brief Binary recorder of the PHY activities reported by a DmgWifiChannel.
+ * \ingroup wifi
+ *
+ * This class is a sink of the PhyActivityTracker trace source of
+ * DmgWifiChannel. Each PHY activity is stored as a fixed-size binary record
+ * (start time, source node, destination node, duration, power, PLCP field
+ * type and activity type) in a buffer preallocated for BufferSize records,
+ * which avoids the formatting cost of the ASCII PHY activity trace.
+ *
+ * If a file is opened, the buffer is written to the file as a single block
+ * every time it becomes full, and when the recorder is flushed or disposed.
+ * Otherwise, the buffer is used as a ring buffer holding the most recent
+ * BufferSize records, which can be read with GetRecords.
+ *
+ * The file starts with a header made of a magic number and the size of a
+ * record, followed by the records. All the fields are stored in little
+ * endian order. ReadFile reads such a file back, and the
+ * dmg-phy-activity-to-csv program converts it into the CSV format of the
+ * ASCII PHY activity trace.
+ */
+class DmgPhyActivityRecorder : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  DmgPhyActivityRecorder ();
+  virtual ~DmgPhyActivityRecorder ();
+
+  /**
+   * A PHY activity.
+   */
+  struct Record
+  {
+    int64_t start;          //!< The start time of the activity in nanoseconds.
+    uint32_t srcId;         //!< The ID of the transmitting node.
+    uint32_t dstId;         //!< The ID of the receiving node.
+    int64_t duration;       //!< The duration of the activity in nanoseconds.
+    double power;           //!< The power of the transmitted or received part of the PLCP in dBm.
+    uint16_t fieldType;     //!< The type of the PLCP field.
+    uint16_t activityType;  //!< The type of the PHY activity.
+  };
+
+  static const uint32_t RECORD_SIZE = 36;       //!< Size of a serialized record in bytes.
+  static const uint32_t FILE_MAGIC = 0x44504152; //!< Magic number at the start of a recording file.
+
+  /**
+   * Open the file the records are written to, truncating it.
+   * \param fileName the name of the file.
+   */
+  void Open (std::string fileName);
+  /**
+   * Write the buffered records to the file and close it.
+   */
+  void Close (void);
+  /**
+   * Write the buffered records to the file, if a file is open.
+   */
+  void Flush (void);
+  /**
+   * Connect the recorder to the PhyActivityTracker trace source of a channel.
+   * \param channel the channel.
+   */
+  void ConnectChannel (Ptr<DmgWifiChannel> channel);
+  /**
+   * Record a PHY activity starting now. The signature matches the
+   * PhyActivityTracker trace source of DmgWifiChannel.
+   * \param srcId the ID of the transmitting node.
+   * \param dstId the ID of the receiving node.
+   * \param duration the duration of the activity.
+   * \param power the power of the transmitted or received part of the PLCP.
+   * \param fieldType the type of the PLCP field.
+   * \param activityType the type of the PHY activity.
+   */
+  void RecordActivity (uint32_t srcId, uint32_t dstId, Time duration, double power,
+                       uint16_t fieldType, uint16_t activityType);
+  /**
+   * \return the number of records written to the file or held in the buffer since the recorder was created.
+   */
+  uint64_t GetNRecords (void) const;
+  /**
+   * Get the records held in the buffer, from the oldest to the most recent.
+   * If a file is open, these are the records not yet written to the file.
+   * \return the records held in the buffer.
+   */
+  std::vector<Record> GetRecords (void) const;
+
+  /**
+   * Serialize a record.
+   * \param record the record.
+   * \param buffer pointer to an array of at least RECORD_SIZE bytes.
+   */
+  static void Serialize (const Record &record, uint8_t *buffer);
+  /**
+   * Deserialize a record.
+   * \param buffer pointer to an array of at least RECORD_SIZE bytes.
+   * \return the record.
+   */
+  static Record Deserialize (const uint8_t *buffer);
+  /**
+   * Read all the records of a recording file.
+   * \param fileName the name of the file.
+   * \param records the records read from the file.
+   * \return true if the file is a valid recording file, false otherwise.
+   */
+  static bool ReadFile (std::string fileName, std::vector<Record> &records);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Allocate the buffer for BufferSize records.
+   * \param size the number of records.
+   */
+  void SetBufferSize (uint32_t size);
+  /**
+   * \return the number of records the buffer can hold.
+   */
+  uint32_t GetBufferSize (void) const;
+
+  std::vector<uint8_t> m_buffer;   //!< The preallocated buffer of serialized records.
+  uint32_t m_bufferSize;           //!< The number of records the buffer can hold.
+  uint32_t m_head;                 //!< The index of the oldest record in the buffer.
+  uint32_t m_count;                //!< The number of records in the buffer.
+  uint64_t m_nRecords;             //!< The number of records since the recorder was created.
+  std::ofstream m_file;            //!< The file the records are written to.
+};
+
+} //namespace ns3
+
+#endif /* DMG_PHY_ACTIVITY_RECORDER_H */
@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <iostream>
+#include "ns3/abort.h"
+#include "ns3/global-value.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "dmg-profiler.h"
+
+/**
+ * \file
+ * \ingroup wifi
+ * ns3::DmgProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DmgProfiler");
+
+/**
+ * \ingroup wifi
+ * The file the DmgProfiler counters are written to at Simulator::Destroy.
+ */
+static GlobalValue g_dmgProfilerFile = GlobalValue ("DmgProfilerFile",
+                                                    "The file the DMG profiling counters are written to when the "
+                                                    "simulator is destroyed, the standard error output if empty.",
+                                                    StringValue (""),
+                                                    MakeStringChecker ());
+
+DmgProfiler::DmgProfiler ()
+  : m_reportScheduled (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+DmgProfiler::GetIndex (uint32_t context)
+{
+  /* The events without a node context are accounted to the first row */
+  return (context == Simulator::NO_CONTEXT) ? 0 : context + 1;
+}
+
+void
+DmgProfiler::Record (DmgProfilerProbe probe, int64_t nanoSeconds)
+{
+  if (!m_reportScheduled)
+    {
+      Simulator::ScheduleDestroy (&DmgProfiler::Report);
+      m_reportScheduled = true;
+    }
+  uint32_t index = GetIndex (Simulator::GetContext ()) * DMG_PROFILE_PROBES + probe;
+  if (index >= m_counters.size ())
+    {
+      ProbeCounters counters = { 0, 0 };
+      m_counters.resize (index - probe + DMG_PROFILE_PROBES, counters);
+    }
+  m_counters[index].calls++;
+  m_counters[index].time += nanoSeconds;
+}
+
+uint64_t
+DmgProfiler::GetCalls (uint32_t node, DmgProfilerProbe probe) const
+{
+  uint32_t index = GetIndex (node) * DMG_PROFILE_PROBES + probe;
+  return (index < m_counters.size ()) ? m_counters[index].calls : 0;
+}
+
+int64_t
+DmgProfiler::GetTime (uint32_t node, DmgProfilerProbe probe) const
+{
+  uint32_t index = GetIndex (node) * DMG_PROFILE_PROBES + probe;
+  return (index < m_counters.size ()) ? m_counters[index].time : 0;
+}
+
+void
+DmgProfiler::Print (std::ostream &os) const
+{
+  os << "NODE,PROBE,CALLS,TOTAL_US,MEAN_NS" << std::endl;
+  for (uint32_t index = 0; index < m_counters.size (); index++)
+    {
+      const ProbeCounters &counters = m_counters[index];
+      if (counters.calls == 0)
+        {
+          continue;
+        }
+      uint32_t row = index / DMG_PROFILE_PROBES;
+      if (row == 0)
+        {
+          os << "global,";
+        }
+      else
+        {
+          os << row - 1 << ",";
+        }
+      os << GetProbeName (static_cast<DmgProfilerProbe> (index % DMG_PROFILE_PROBES)) << ","
+         << counters.calls << ","
+         << counters.time / 1000 << ","
+         << counters.time / static_cast<int64_t> (counters.calls) << std::endl;
+    }
+}
+
+void
+DmgProfiler::Reset (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_counters.clear ();
+}
+
+void
+DmgProfiler::Report (void)
+{
+  DmgProfiler *profiler = DmgProfiler::Get ();
+  StringValue fileName;
+  g_dmgProfilerFile.GetValue (fileName);
+  if (fileName.Get ().empty ())
+    {
+      profiler->Print (std::cerr);
+    }
+  else
+    {
+      std::ofstream file (fileName.Get ().c_str (), std::ios::out | std::ios::trunc);
+      NS_ABORT_MSG_IF (!file.is_open (), "Cannot open " << fileName.Get ());
+      profiler->Print (file);
+    }
+  profiler->Reset ();
+  profiler->m_reportScheduled = false;
+}
+
+const char *
+DmgProfiler::GetProbeName (DmgProfilerProbe probe)
+{
+  switch (probe)
+    {
+    case DMG_PROFILE_QD_CALC_RX_POWER:
+      return "QdCalcRxPower";
+    case DMG_PROFILE_QD_GET_CHANNEL_GAIN:
+      return "QdGetChannelGain";
+    case DMG_PROFILE_SPECTRUM_PHY_START_RX:
+      return "SpectrumPhyStartRx";
+    case DMG_PROFILE_PHY_START_RECEIVE_PREAMBLE:
+      return "PhyStartReceivePreamble";
+    case DMG_PROFILE_NOISE_INTERFERENCE:
+      return "NoiseInterference";
+    case DMG_PROFILE_CHANNEL_SEND:
+      return "ChannelSend";
+    case DMG_PROFILE_MAC_SLS:
+      return "MacSls";
+    case DMG_PROFILE_MAC_BRP:
+      return "MacBrp";
+    default:
+      return "Unknown";
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DMG_PROFILER_H
+#define DMG_PROFILER_H
+
+#include <stdint.h>
+#include <chrono>
+#include <ostream>
+#include <vector>
+#include "ns3/singleton.h"
+
+/**
+ * \file
+ * \ingroup wifi
+ * ns3::DmgProfiler declaration and the NS_DMG_PROFILE_* macros.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * The hot paths of the DMG stack instrumented by DmgProfiler.
+ */
+enum DmgProfilerProbe
+{
+  DMG_PROFILE_QD_CALC_RX_POWER = 0,           //!< QdPropagationEngine::CalcRxPower
+  DMG_PROFILE_QD_GET_CHANNEL_GAIN,            //!< QdPropagationEngine::GetChannelGain
+  DMG_PROFILE_SPECTRUM_PHY_START_RX,          //!< SpectrumDmgWifiPhy::StartRx
+  DMG_PROFILE_PHY_START_RECEIVE_PREAMBLE,     //!< DmgWifiPhy::StartReceivePreamble
+  DMG_PROFILE_NOISE_INTERFERENCE,             //!< InterferenceHelper::CalculateNoiseInterferenceW
+  DMG_PROFILE_CHANNEL_SEND,                   //!< DmgWifiChannel::Send
+  DMG_PROFILE_MAC_SLS,                        //!< The SLS frame handlers of DmgWifiMac
+  DMG_PROFILE_MAC_BRP,                        //!< The BRP frame handlers of DmgWifiMac
+  DMG_PROFILE_PROBES                          //!< The number of probes
+};
+
+/**
+ * \ingroup wifi
+ * \brief Scoped timers and counters of the hot paths of the DMG stack.
+ *
+ * The profiler accumulates, for each node and each DmgProfilerProbe, the
+ * number of calls and the wall clock time spent in the instrumented
+ * function. The node is given by the context of the running event, so work
+ * done outside of any node context (e.g., at configuration time) is
+ * accounted to a separate "global" row. The time of a probe includes the
+ * time of the probes nested within it, e.g., the time of CalcRxPower
+ * includes the time of GetChannelGain.
+ *
+ * The results are written as CSV lines (node, probe, calls, total time in
+ * microseconds, mean time per call in nanoseconds) when the simulator is
+ * destroyed, to the file given by the DmgProfilerFile global value or to
+ * the standard error output if it is empty, and the counters are reset.
+ *
+ * The instrumentation is compiled only if ns-3 is configured with
+ * \verbatim
+   $ waf configure ... --enable-dmg-profiling \endverbatim
+ * Otherwise, the NS_DMG_PROFILE_* macros expand to nothing and the
+ * instrumented functions are left unchanged.
+ */
+class DmgProfiler : public Singleton<DmgProfiler>
+{
+public:
+  DmgProfiler ();
+
+  /**
+   * Account a call of a probe in the context of the running event.
+   * \param probe the probe.
+   * \param nanoSeconds the wall clock time of the call in nanoseconds.
+   */
+  void Record (DmgProfilerProbe probe, int64_t nanoSeconds);
+  /**
+   * \param node the node ID.
+   * \param probe the probe.
+   * \return the number of calls of the probe within the node.
+   */
+  uint64_t GetCalls (uint32_t node, DmgProfilerProbe probe) const;
+  /**
+   * \param node the node ID.
+   * \param probe the probe.
+   * \return the wall clock time spent in the probe within the node in nanoseconds.
+   */
+  int64_t GetTime (uint32_t node, DmgProfilerProbe probe) const;
+  /**
+   * Print the counters of all the nodes as CSV lines.
+   * \param os the output stream.
+   */
+  void Print (std::ostream &os) const;
+  /**
+   * Reset all the counters.
+   */
+  void Reset (void);
+  /**
+   * \param probe the probe.
+   * \return the name of the probe.
+   */
+  static const char * GetProbeName (DmgProfilerProbe probe);
+
+private:
+  /**
+   * Write the counters to the DmgProfilerFile and reset them, scheduled at
+   * Simulator::Destroy.
+   */
+  static void Report (void);
+
+  /**
+   * The counters of a probe.
+   */
+  struct ProbeCounters
+  {
+    uint64_t calls;   //!< The number of calls.
+    int64_t time;     //!< The accumulated time in nanoseconds.
+  };
+
+  /**
+   * \param context the context of an event.
+   * \return the index of the counters of the context.
+   */
+  static uint32_t GetIndex (uint32_t context);
+
+  std::vector<ProbeCounters> m_counters;  //!< The counters, DMG_PROFILE_PROBES per node plus the global row.
+  bool m_reportScheduled;                 //!< Flag to indicate if the report is scheduled at Simulator::Destroy.
+};
+
+/**
+ * \ingroup wifi
+ * \brief Accounts the time between its construction and its destruction to a DmgProfilerProbe.
+ */
+class DmgProfilerScope
+{
+public:
+  /**
+   * Start timing a probe.
+   * \param probe the probe.
+   */
+  DmgProfilerScope (DmgProfilerProbe probe)
+    : m_probe (probe),
+      m_start (std::chrono::steady_clock::now ())
+  {
+  }
+  ~DmgProfilerScope ()
+  {
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now () - m_start;
+    DmgProfiler::Get ()->Record (m_probe, std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count ());
+  }
+
+private:
+  DmgProfilerProbe m_probe;                          //!< The probe.
+  std::chrono::steady_clock::time_point m_start;     //!< The start of the scope.
+};
+
+} // namespace ns3
+
+#ifdef ENABLE_DMG_PROFILING
+/**
+ * \ingroup wifi
+ * Time the rest of the enclosing scope and account it to a probe.
+ * \param probe the DmgProfilerProbe.
+ */
+#define NS_DMG_PROFILE_SCOPE(probe) \
+  ns3::DmgProfilerScope dmgProfilerScope (probe)
+#else
+#define NS_DMG_PROFILE_SCOPE(probe)
+#endif /* ENABLE_DMG_PROFILING */
+
+#endif /* DMG_PROFILER_H */
@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <tuple>
+#include "ns3/log.h"
+#include "dmg-snr-threshold-table.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DmgSnrThresholdTable");
+
+NS_OBJECT_ENSURE_REGISTERED (DmgSnrThresholdTable);
+
+TypeId
+DmgSnrThresholdTable::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DmgSnrThresholdTable")
+    .SetParent<Object> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<DmgSnrThresholdTable> ()
+  ;
+  return tid;
+}
+
+DmgSnrThresholdTable::Key::Key (uint16_t channelWidth, double ber, SnrUnit unit)
+  : channelWidth (channelWidth),
+    ber (ber),
+    unit (unit)
+{
+}
+
+bool
+operator < (const DmgSnrThresholdTable::Key &a, const DmgSnrThresholdTable::Key &b)
+{
+  return std::tie (a.channelWidth, a.ber, a.unit) < std::tie (b.channelWidth, b.ber, b.unit);
+}
+
+DmgSnrThresholdTable::DmgSnrThresholdTable ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DmgSnrThresholdTable::~DmgSnrThresholdTable ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+DmgSnrThresholdTable::AddSnrThreshold (WifiMode mode, const Key &key, double snr)
+{
+  NS_LOG_FUNCTION (this << mode.GetUniqueName () << key.channelWidth << key.ber << key.unit << snr);
+  Thresholds &thresholds = m_thresholds[key];
+  if (thresholds.find (mode.GetUid ()) == thresholds.end ())
+    {
+      m_modes[key].push_back (mode);
+    }
+  thresholds[mode.GetUid ()] = snr;
+  m_selectionTables.erase (key);
+}
+
+bool
+DmgSnrThresholdTable::HasSnrThreshold (WifiMode mode, const Key &key) const
+{
+  std::map<Key, Thresholds>::const_iterator it = m_thresholds.find (key);
+  return (it != m_thresholds.end ()) && (it->second.find (mode.GetUid ()) != it->second.end ());
+}
+
+double
+DmgSnrThresholdTable::GetSnrThreshold (WifiMode mode, const Key &key) const
+{
+  std::map<Key, Thresholds>::const_iterator it = m_thresholds.find (key);
+  NS_ASSERT_MSG (it != m_thresholds.end (), "No SNR threshold for channel width " << key.channelWidth
+                 << " and BER " << key.ber);
+  Thresholds::const_iterator threshold = it->second.find (mode.GetUid ());
+  NS_ASSERT_MSG (threshold != it->second.end (), "No SNR threshold for " << mode.GetUniqueName ());
+  return threshold->second;
+}
+
+const DmgSnrThresholdTable::SelectionTable&
+DmgSnrThresholdTable::GetSelectionTable (const Key &key)
+{
+  std::map<Key, SelectionTable>::const_iterator it = m_selectionTables.find (key);
+  if (it == m_selectionTables.end ())
+    {
+      it = m_selectionTables.insert (std::make_pair (key, BuildSelectionTable (m_modes[key], key))).first;
+    }
+  return it->second;
+}
+
+DmgSnrThresholdTable::SelectionTable
+DmgSnrThresholdTable::BuildSelectionTable (const WifiModeList &modes, const Key &key) const
+{
+  NS_LOG_FUNCTION (this << modes.size () << key.channelWidth << key.ber << key.unit);
+  // sort the candidate modes by increasing SNR threshold, keeping the order
+  // of the list among modes having the same threshold
+  std::vector<std::pair<double, std::size_t> > candidates;
+  candidates.reserve (modes.size ());
+  for (std::size_t i = 0; i < modes.size (); i++)
+    {
+      candidates.push_back (std::make_pair (GetSnrThreshold (modes[i], key), i));
+    }
+  std::stable_sort (candidates.begin (), candidates.end (),
+                    [] (const std::pair<double, std::size_t> &a, const std::pair<double, std::size_t> &b)
+                    { return a.first < b.first; });
+
+  // add an entry every time the best mode among the modes considered so far changes
+  SelectionTable table;
+  uint64_t bestRate = 0;
+  std::size_t bestIndex = modes.size ();
+  for (auto &candidate : candidates)
+    {
+      uint64_t rate = modes[candidate.second].GetDmgDataRate ();
+      if (bestIndex == modes.size () || rate > bestRate || (rate == bestRate && candidate.second < bestIndex))
+        {
+          bestRate = rate;
+          bestIndex = candidate.second;
+          if (!table.empty () && table.back ().snr == candidate.first)
+            {
+              table.back ().mode = modes[bestIndex];
+            }
+          else
+            {
+              table.push_back ({candidate.first, modes[bestIndex]});
+            }
+        }
+    }
+  return table;
+}
+
+WifiMode
+DmgSnrThresholdTable::Lookup (const SelectionTable &table, double snr, WifiMode defaultMode)
+{
+  // find the first entry whose threshold is not smaller than the SNR
+  SelectionTable::const_iterator it = std::lower_bound (table.begin (), table.end (), snr,
+                                                        [] (const Entry &entry, double value)
+                                                        { return entry.snr < value; });
+  if (it == table.begin ())
+    {
+      return defaultMode;
+    }
+  return (--it)->mode;
+}
+
+} //namespace ns3
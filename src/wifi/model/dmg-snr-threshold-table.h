@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DMG_SNR_THRESHOLD_TABLE_H
+#define DMG_SNR_THRESHOLD_TABLE_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "wifi-mode.h"
+
+namespace ns3 {
+
+/**
+ * \brief SNR thresholds of the DMG/EDMG modes and the derived rate selection tables.
+ * \ingroup wifi
+ *
+ * This class stores the minimum SNR required by each mode to achieve a target
+ * bit error rate. The thresholds depend on the channel width, on the target
+ * BER and on the unit of the SNR, so they are grouped by a Key made of these
+ * three parameters. From the thresholds of a key it derives monotone
+ * selection tables: a selection table is a list of (SNR threshold, mode)
+ * entries sorted by increasing SNR threshold, where each entry holds the mode
+ * with the highest data rate among the modes whose threshold does not exceed
+ * the threshold of the entry. The best mode for a given SNR is then the mode
+ * of the last entry whose threshold is smaller than the SNR, which is found by
+ * binary search instead of scanning all the modes.
+ *
+ * The thresholds are filled by the rate managers, for the modes of their PHY
+ * which are missing, in the unit used by the manager (linear scale for
+ * IdealDmgWifiManager, dB for CbtraaDmgWifiManager). The same object can
+ * therefore be shared by several rate managers, whatever their type, target
+ * BER and channel width (and read by any other component) through their
+ * SnrThresholdTable attribute. The PHYs of the rate managers sharing a table
+ * are expected to use the same error rate model.
+ */
+class DmgSnrThresholdTable : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  DmgSnrThresholdTable ();
+  virtual ~DmgSnrThresholdTable ();
+
+  /**
+   * The unit of the SNR thresholds.
+   */
+  enum SnrUnit
+  {
+    SNR_LINEAR = 0,
+    SNR_DB
+  };
+
+  /**
+   * The parameters the SNR thresholds of the modes depend on.
+   */
+  struct Key
+  {
+    /**
+     * Constructor
+     * \param channelWidth the channel width in MHz
+     * \param ber the target bit error rate
+     * \param unit the unit of the SNR thresholds
+     */
+    Key (uint16_t channelWidth, double ber, SnrUnit unit);
+
+    uint16_t channelWidth;  //!< The channel width in MHz.
+    double ber;             //!< The target bit error rate.
+    SnrUnit unit;           //!< The unit of the SNR thresholds.
+  };
+
+  /**
+   * An entry of a selection table: the SNR threshold and the mode to use
+   * when the SNR is above the threshold.
+   */
+  struct Entry
+  {
+    double snr;     //!< The SNR threshold.
+    WifiMode mode;  //!< The mode with the highest data rate for this threshold.
+  };
+
+  /**
+   * A monotone selection table, sorted by increasing SNR threshold.
+   */
+  typedef std::vector<Entry> SelectionTable;
+
+  /**
+   * Add the SNR threshold of the given mode for the given parameters.
+   * Adding the threshold of a mode invalidates the selection table of
+   * these parameters.
+   *
+   * \param mode the mode
+   * \param key the channel width, target BER and unit of the threshold
+   * \param snr the minimum SNR for the given mode
+   */
+  void AddSnrThreshold (WifiMode mode, const Key &key, double snr);
+  /**
+   * \param mode the mode
+   * \param key the channel width, target BER and unit of the threshold
+   * \return true if the SNR threshold of the given mode has been added for the given parameters
+   */
+  bool HasSnrThreshold (WifiMode mode, const Key &key) const;
+  /**
+   * Return the minimum SNR of the given mode for the given parameters.
+   * The threshold must have been added.
+   *
+   * \param mode the mode
+   * \param key the channel width, target BER and unit of the threshold
+   * \return the minimum SNR for the given mode
+   */
+  double GetSnrThreshold (WifiMode mode, const Key &key) const;
+  /**
+   * Return the selection table built from all the modes whose SNR threshold
+   * has been added for the given parameters.
+   *
+   * \param key the channel width, target BER and unit of the thresholds
+   * \return the selection table
+   */
+  const SelectionTable& GetSelectionTable (const Key &key);
+  /**
+   * Build the selection table restricted to the given modes. Among modes
+   * having the same data rate, the one listed first is preferred. The
+   * thresholds of all the modes must have been added.
+   *
+   * \param modes the candidate modes
+   * \param key the channel width, target BER and unit of the thresholds
+   * \return the selection table
+   */
+  SelectionTable BuildSelectionTable (const WifiModeList &modes, const Key &key) const;
+  /**
+   * Look up the mode with the highest data rate whose SNR threshold is
+   * smaller than the given SNR.
+   *
+   * \param table the selection table
+   * \param snr the SNR
+   * \param defaultMode the mode to return if no threshold is smaller than the SNR
+   * \return the selected mode
+   */
+  static WifiMode Lookup (const SelectionTable &table, double snr, WifiMode defaultMode);
+
+private:
+  /// SNR threshold for each mode, indexed by the unique ID of the mode
+  typedef std::map<uint32_t, double> Thresholds;
+
+  std::map<Key, Thresholds> m_thresholds;          //!< SNR thresholds for each set of parameters.
+  std::map<Key, WifiModeList> m_modes;             //!< Modes for each set of parameters, in insertion order.
+  std::map<Key, SelectionTable> m_selectionTables; //!< Selection table for each set of parameters.
+};
+
+/**
+ * \param a the first set of parameters
+ * \param b the second set of parameters
+ * \return true if the first set of parameters is ordered before the second one
+ */
+bool operator < (const DmgSnrThresholdTable::Key &a, const DmgSnrThresholdTable::Key &b);
+
+} //namespace ns3
+
+#endif /* DMG_SNR_THRESHOLD_TABLE_H */
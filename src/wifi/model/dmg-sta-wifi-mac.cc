@@ -5,6 +5,8 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
@@ -17,13 +19,17 @@
 #include "dmg-capabilities.h"
 #include "dmg-sta-wifi-mac.h"
 #include "dmg-wifi-phy.h"
+#include "error-rate-model.h"
 #include "ext-headers.h"
 #include "mgt-headers.h"
 #include "mac-low.h"
 #include "msdu-aggregator.h"
+#include "qd-propagation-engine.h"
 #include "snr-tag.h"
+#include "dmg-profiler.h"
 #include "wifi-mac-header.h"
 #include "wifi-mac-queue.h"
+#include "wifi-utils.h"
 
 #include <cmath>
 
@@ -33,6 +39,17 @@ NS_LOG_COMPONENT_DEFINE ("DmgStaWifiMac");
 
 NS_OBJECT_ENSURE_REGISTERED (DmgStaWifiMac);
 
+/// Weight of the newest measurement in the averaged SNR of the direct link
+static const double DIRECT_LINK_SNR_WEIGHT = 0.25;
+/// Lowest SNR (dB) considered for the SNR threshold of a mode
+static const double RELAY_THRESHOLD_MIN_SNR = -10;
+/// Highest SNR (dB) considered for the SNR threshold of a mode
+static const double RELAY_THRESHOLD_MAX_SNR = 40;
+/// Step (dB) of the search for the SNR threshold of a mode
+static const double RELAY_THRESHOLD_SNR_STEP = 0.1;
+/// MPDU size (bytes) used to compute the SNR threshold of a mode
+static const uint64_t RELAY_THRESHOLD_MPDU_SIZE = 1500;
+
 TypeId
 DmgStaWifiMac::GetTypeId (void)
 {
@@ -118,6 +135,34 @@ DmgStaWifiMac::GetTypeId (void)
                     UintegerValue (4000),
                     MakeUintegerAccessor (&DmgStaWifiMac::m_relaySecondPeriod),
                     MakeUintegerChecker<uint16_t> (1, std::numeric_limits<uint16_t>::max ()))
+    .AddAttribute ("PredictiveRelaySwitching",
+                   "Whether the source REDS switches to the relay link when the SNR of the direct link "
+                   "is predicted to fall below the SNR threshold of the current mode, instead of waiting "
+                   "for a missed acknowledgment.",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&DmgStaWifiMac::m_predictiveRelaySwitching),
+                    MakeBooleanChecker ())
+    .AddAttribute ("RelayPredictionHorizon",
+                   "The look-ahead interval of the prediction of the direct link SNR.",
+                    TimeValue (MilliSeconds (5)),
+                    MakeTimeAccessor (&DmgStaWifiMac::m_relayPredictionHorizon),
+                    MakeTimeChecker ())
+    .AddAttribute ("RelaySwitchMargin",
+                   "The margin in dB added to the SNR threshold of the current mode.",
+                    DoubleValue (1.0),
+                    MakeDoubleAccessor (&DmgStaWifiMac::m_relaySwitchMargin),
+                    MakeDoubleChecker<double> ())
+    .AddAttribute ("RelayTargetPer",
+                   "The PER of a 1500 bytes MPDU defining the SNR threshold of a mode.",
+                    DoubleValue (0.1),
+                    MakeDoubleAccessor (&DmgStaWifiMac::m_relayTargetPer),
+                    MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("QdPropagationEngine",
+                   "The Q-D propagation engine used to look ahead in the Q-D traces when predicting the "
+                   "direct link SNR. If not set, the prediction extrapolates the trend of the measured SNR.",
+                    PointerValue (),
+                    MakePointerAccessor (&DmgStaWifiMac::m_qdPropagationEngine),
+                    MakePointerChecker<QdPropagationEngine> ())
 
     /* DMG Capabilities */
     .AddAttribute ("SupportSPSH", "Whether the DMG STA supports Spartial Sharing and Interference Mitigation (SPSH)",
@@ -166,6 +211,9 @@ DmgStaWifiMac::GetTypeId (void)
     .AddTraceSource ("TransmissionLinkChanged", "The current transmission link has been changed.",
                      MakeTraceSourceAccessor (&DmgStaWifiMac::m_transmissionLinkChanged),
                      "ns3::DmgStaWifiMac::TransmissionLinkChangedTracedCallback")
+    .AddTraceSource ("RelayLinkOutage", "The outage caused by a change of the transmission link.",
+                     MakeTraceSourceAccessor (&DmgStaWifiMac::m_relayLinkOutage),
+                     "ns3::DmgStaWifiMac::RelayLinkOutageCallback")
   ;
   return tid;
 }
@@ -187,6 +235,8 @@ DmgStaWifiMac::DmgStaWifiMac ()
   /** Initialize Relay Variables **/
   m_relayMode = false;
   m_periodProtected = false;
+  m_hasDirectLinkSnr = false;
+  m_relayOutagePending = false;
   /* Set missed ACK/BlockACK callback */
   for (EdcaQueues::iterator i = m_edca.begin (); i != m_edca.end (); ++i)
     {
@@ -254,6 +304,8 @@ void
 DmgStaWifiMac::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_qdPropagationEngine = 0;
+  m_peerNodes.clear ();
   DmgWifiMac::DoDispose ();
 }
 
@@ -262,6 +314,9 @@ DmgStaWifiMac::SetWifiRemoteStationManager (Ptr<WifiRemoteStationManager> statio
 {
   NS_LOG_FUNCTION (this << stationManager);
   DmgWifiMac::SetWifiRemoteStationManager (stationManager);
+  /* Monitor the frames exchanged during the service periods protected by an RDS */
+  stationManager->TraceConnectWithoutContext ("MacRxOK", MakeCallback (&DmgStaWifiMac::RelayLinkRxOk, this));
+  stationManager->TraceConnectWithoutContext ("MacTxAcked", MakeCallback (&DmgStaWifiMac::RelayLinkTxAcked, this));
 }
 
 void
@@ -1741,6 +1796,7 @@ DmgStaWifiMac::InitiateRelayPeriods (RELAY_LINK_INFO &info)
   NS_LOG_FUNCTION (this);
   m_periodProtected = true;
   m_relayLinkInfo = info;
+  m_lastRelayActivity = Simulator::Now ();
   /* Schedule peridos assoicated to the transmission link */
   if ((m_relayLinkInfo.transmissionLink == RELAY_LINK) && (m_relayLinkInfo.rdsDuplexMode == 0))
     {
@@ -1824,6 +1880,7 @@ DmgStaWifiMac::RelayLinkChangeIntervalTimeout (void)
                   m_relayLinkInfo.transmissionLink = RELAY_LINK;
                 }
               m_transmissionLinkChanged (GetAddress (), m_relayLinkInfo.transmissionLink);
+              NotifyTransmissionLinkSwitched ();
               SteerAntennaToward (m_relayLinkInfo.selectedRelayAddress);
               Simulator::Schedule (MicroSeconds (m_relayLinkInfo.relayDataSensingTime),
                                    &DmgStaWifiMac::ResumeServicePeriodTransmission, this);
@@ -1837,6 +1894,7 @@ DmgStaWifiMac::RelayLinkChangeIntervalTimeout (void)
           /* We are using the direct link and we decided to switch to the relay link */
           m_relayLinkInfo.switchTransmissionLink = false;
           m_relayLinkInfo.transmissionLink = RELAY_LINK;
+          NotifyTransmissionLinkSwitched ();
           SuspendServicePeriodTransmission ();
 
           if (CheckTimeAvailabilityForPeriod (GetRemainingAllocationTime (), MicroSeconds (m_relayLinkInfo.relayFirstPeriod)))
@@ -2068,6 +2126,7 @@ DmgStaWifiMac::RelaySecondPeriodTimeout (void)
        * at the end of the Second Period when the Link Change Interval begins. */
       m_relayLinkInfo.switchTransmissionLink = false;
       m_relayLinkInfo.transmissionLink = DIRECT_LINK;
+      NotifyTransmissionLinkSwitched ();
       SuspendServicePeriodTransmission ();
 
       /* Check how much time left in the current service period protected by the relay */
@@ -2125,8 +2184,210 @@ DmgStaWifiMac::RelayDataSensingTimeout (void)
               SteerAntennaToward (m_relayLinkInfo.srcRedsAddress);
             }
           m_transmissionLinkChanged (GetAddress (), m_relayLinkInfo.transmissionLink);
+          NotifyTransmissionLinkSwitched ();
+        }
+    }
+}
+
+void
+DmgStaWifiMac::NotifyTransmissionLinkSwitched (void)
+{
+  NS_LOG_FUNCTION (this << m_relayLinkInfo.transmissionLink);
+  if ((m_aid != m_relayLinkInfo.srcRedsAid) && (m_aid != m_relayLinkInfo.dstRedsAid))
+    {
+      return;
+    }
+  /* The outage lasts until a frame goes through the new link. If the link changes again before
+   * that, the outage started with the last frame exchanged before the first change. */
+  if (!m_relayOutagePending)
+    {
+      m_relayOutagePending = true;
+      m_relayOutageStart = m_lastRelayActivity;
+    }
+  /* The measurements of the direct link are outdated */
+  m_hasDirectLinkSnr = false;
+}
+
+void
+DmgStaWifiMac::RelayLinkRxOk (WifiMacType type, Mac48Address address, double snr)
+{
+  NS_LOG_FUNCTION (this << type << address << snr);
+  RecordRelayLinkActivity (address);
+}
+
+void
+DmgStaWifiMac::RelayLinkTxAcked (Mac48Address address, double ackSnr, WifiMode dataMode)
+{
+  NS_LOG_FUNCTION (this << address << ackSnr << dataMode);
+  RecordRelayLinkActivity (address);
+  if (m_predictiveRelaySwitching && m_periodProtected
+      && (m_aid == m_relayLinkInfo.srcRedsAid) && (address == m_relayLinkInfo.dstRedsAddress)
+      && (m_relayLinkInfo.transmissionLink == DIRECT_LINK) && !m_relayLinkInfo.switchTransmissionLink
+      && (ackSnr > 0))
+    {
+      PredictDirectLinkQuality (RatioToDb (ackSnr), dataMode);
+    }
+}
+
+void
+DmgStaWifiMac::RecordRelayLinkActivity (Mac48Address address)
+{
+  if (!m_periodProtected)
+    {
+      return;
+    }
+  Mac48Address peerAddress;
+  if (m_aid == m_relayLinkInfo.srcRedsAid)
+    {
+      peerAddress = m_relayLinkInfo.dstRedsAddress;
+    }
+  else if (m_aid == m_relayLinkInfo.dstRedsAid)
+    {
+      peerAddress = m_relayLinkInfo.srcRedsAddress;
+    }
+  else
+    {
+      return;
+    }
+  bool fromPeer = (address == peerAddress);
+  bool fromRelay = (address == m_relayLinkInfo.selectedRelayAddress);
+  if (!fromPeer && !fromRelay)
+    {
+      return;
+    }
+  if (m_relayOutagePending)
+    {
+      /* In HD-DF mode the frames of the relay link are exchanged with the RDS, whereas in FD-AF mode
+       * they are forwarded by the RDS and therefore exchanged with the peer REDS */
+      bool newLinkUsed;
+      if ((m_relayLinkInfo.transmissionLink == DIRECT_LINK) || (m_relayLinkInfo.rdsDuplexMode == 1))
+        {
+          newLinkUsed = fromPeer;
+        }
+      else
+        {
+          newLinkUsed = fromRelay;
+        }
+      if (newLinkUsed)
+        {
+          Time outage = Simulator::Now () - m_relayOutageStart;
+          NS_LOG_DEBUG ("First frame through the new transmission link " << m_relayLinkInfo.transmissionLink
+                        << ", outage=" << outage);
+          m_relayOutagePending = false;
+          m_relayLinkOutage (peerAddress, m_relayLinkInfo.transmissionLink, outage);
         }
     }
+  m_lastRelayActivity = Simulator::Now ();
+}
+
+void
+DmgStaWifiMac::PredictDirectLinkQuality (double snr, WifiMode mode)
+{
+  NS_LOG_FUNCTION (this << snr << mode);
+  Time now = Simulator::Now ();
+  if (!m_hasDirectLinkSnr)
+    {
+      m_hasDirectLinkSnr = true;
+      m_directLinkSnr = snr;
+      m_directLinkSnrSlope = 0;
+      m_directLinkAnchorSnr = snr;
+      m_directLinkAnchorTime = now;
+    }
+  else
+    {
+      m_directLinkSnr = (1 - DIRECT_LINK_SNR_WEIGHT) * m_directLinkSnr + DIRECT_LINK_SNR_WEIGHT * snr;
+      /* Measure the trend over windows as long as the prediction horizon, so that the noise
+       * between two close frame exchanges is not extrapolated */
+      if (now - m_directLinkAnchorTime >= m_relayPredictionHorizon)
+        {
+          m_directLinkSnrSlope = (m_directLinkSnr - m_directLinkAnchorSnr) / (now - m_directLinkAnchorTime).GetSeconds ();
+          m_directLinkAnchorSnr = m_directLinkSnr;
+          m_directLinkAnchorTime = now;
+        }
+    }
+
+  double predictedSnr = m_directLinkSnr + m_directLinkSnrSlope * m_relayPredictionHorizon.GetSeconds ();
+  if (m_qdPropagationEngine != 0)
+    {
+      /* The Q-D traces tell how the channel evolves over the prediction horizon */
+      Ptr<Node> peerNode = GetPeerNode (m_relayLinkInfo.dstRedsAddress);
+      double change;
+      if ((peerNode != 0)
+          && m_qdPropagationEngine->PredictChannelChange (GetDevice ()->GetNode (), peerNode,
+                                                          m_relayPredictionHorizon, change))
+        {
+          predictedSnr = m_directLinkSnr + change;
+        }
+    }
+
+  double threshold = GetRelaySwitchSnrThreshold (mode) + m_relaySwitchMargin;
+  NS_LOG_DEBUG ("Direct link SNR=" << m_directLinkSnr << "dB, predicted SNR=" << predictedSnr
+                << "dB, threshold=" << threshold << "dB");
+  if (predictedSnr < threshold)
+    {
+      NS_LOG_DEBUG ("The SNR of the direct link is predicted to drop below the threshold of "
+                    << mode << " so switch to the relay link");
+      SwitchTransmissionLink (m_relayLinkInfo.srcRedsAid, m_relayLinkInfo.dstRedsAid);
+    }
+}
+
+double
+DmgStaWifiMac::GetRelaySwitchSnrThreshold (WifiMode mode)
+{
+  std::map<uint32_t, double>::const_iterator it = m_relaySnrThresholds.find (mode.GetUid ());
+  if (it != m_relaySnrThresholds.end ())
+    {
+      return it->second;
+    }
+  Ptr<ErrorRateModel> errorRateModel = m_phy->GetErrorRateModel ();
+  NS_ABORT_MSG_IF (errorRateModel == 0, "Predictive relay switching requires an error rate model");
+  WifiTxVector txVector;
+  txVector.SetChannelWidth (m_phy->GetChannelWidth ());
+  txVector.SetMode (mode);
+  double threshold = RELAY_THRESHOLD_MAX_SNR;
+  for (uint32_t i = 0; RELAY_THRESHOLD_MIN_SNR + i * RELAY_THRESHOLD_SNR_STEP < RELAY_THRESHOLD_MAX_SNR; i++)
+    {
+      double snr = RELAY_THRESHOLD_MIN_SNR + i * RELAY_THRESHOLD_SNR_STEP;
+      double psr = errorRateModel->GetChunkSuccessRate (mode, txVector, DbToRatio (snr),
+                                                        8 * RELAY_THRESHOLD_MPDU_SIZE);
+      if (1 - psr <= m_relayTargetPer)
+        {
+          threshold = snr;
+          break;
+        }
+    }
+  NS_LOG_DEBUG ("SNR threshold of " << mode << " is " << threshold << "dB");
+  m_relaySnrThresholds[mode.GetUid ()] = threshold;
+  return threshold;
+}
+
+Ptr<Node>
+DmgStaWifiMac::GetPeerNode (Mac48Address address)
+{
+  std::map<Mac48Address, Ptr<Node> >::const_iterator it = m_peerNodes.find (address);
+  if (it != m_peerNodes.end ())
+    {
+      return it->second;
+    }
+  Ptr<Node> peerNode = 0;
+  for (NodeList::Iterator node = NodeList::Begin (); (node != NodeList::End ()) && (peerNode == 0); node++)
+    {
+      for (uint32_t i = 0; i < (*node)->GetNDevices (); i++)
+        {
+          Address deviceAddress = (*node)->GetDevice (i)->GetAddress ();
+          if (Mac48Address::IsMatchingType (deviceAddress) && (Mac48Address::ConvertFrom (deviceAddress) == address))
+            {
+              peerNode = *node;
+              break;
+            }
+        }
+    }
+  /* The node of the peer station may be created later, so only successful lookups are cached */
+  if (peerNode != 0)
+    {
+      m_peerNodes[address] = peerNode;
+    }
+  return peerNode;
 }
 
 void
@@ -2851,6 +3112,7 @@ DmgStaWifiMac::FrameTxOk (const WifiMacHeader &hdr)
       m_dmgSlsTxop->SLS_BFT_Completed ();
       m_performingBFT = false;
       m_slsResponderStateMachine = SLS_RESPONDER_TXSS_PHASE_COMPELTED;
+      RecordTransmitSectorSweep (address, m_isResponderTXSS);
       m_slsCompleted (SlsCompletionAttrbitutes (hdr.GetAddr1 (), CHANNEL_ACCESS_DTI, BeamformingResponder,
                                                 m_isInitiatorTXSS, m_isResponderTXSS,
                                                 antennaConfig.first, antennaConfig.second, m_maxSnr));
@@ -2892,7 +3154,6 @@ DmgStaWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
   NS_LOG_FUNCTION (this << *mpdu);
 
   const WifiMacHeader* hdr = &mpdu->GetHeader ();
-  Ptr<Packet> packet = mpdu->GetPacket ()->Copy ();
   Mac48Address from = hdr->GetAddr2 ();
 
   if (hdr->GetAddr3 () == GetAddress ())
@@ -2909,7 +3170,7 @@ DmgStaWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
   else if (hdr->GetAddr1 () != GetAddress () && !hdr->GetAddr1 ().IsGroup () && !hdr->IsDMGBeacon ())
     {
       NS_LOG_LOGIC ("packet is not for us");
-      NotifyRxDrop (packet);
+      NotifyRxDrop (mpdu->GetPacket ());
       return;
     }
   else if (m_relayMode && (m_rdsDuplexMode == 0) && hdr->IsData ())
@@ -2917,7 +3178,7 @@ DmgStaWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
       NS_LOG_LOGIC ("Work as relay, forward packet to " << m_relayLinkInfo.dstRedsAddress);
       /* We are the RDS in HD-DF so forward the packet to the destination REDS */
       m_relayReceivedData = true;
-      ForwardDataFrame (*hdr, packet, m_relayLinkInfo.dstRedsAddress);
+      ForwardDataFrame (*hdr, mpdu->GetPacket ()->Copy (), m_relayLinkInfo.dstRedsAddress);
       return;
     }
   else if (hdr->IsData ())
@@ -2925,7 +3186,7 @@ DmgStaWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
       if (!IsAssociated () && hdr->GetAddr2 () != GetBssid ())
         {
           NS_LOG_LOGIC ("Received data frame while not associated: ignore");
-          NotifyRxDrop (packet);
+          NotifyRxDrop (mpdu->GetPacket ());
           return;
         }
 
@@ -2938,20 +3199,24 @@ DmgStaWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
             {
               NS_ASSERT (hdr->GetAddr3 () == GetBssid ());
               DeaggregateAmsduAndForward (mpdu);
-              packet = 0;
             }
           else
             {
-              ForwardUp (packet, hdr->GetAddr3 (), hdr->GetAddr1 ());
+              ForwardUp (mpdu->GetPacket (), hdr->GetAddr3 (), hdr->GetAddr1 ());
             }
         }
       else
         {
-          ForwardUp (packet, hdr->GetAddr3 (), hdr->GetAddr1 ());
+          ForwardUp (mpdu->GetPacket (), hdr->GetAddr3 (), hdr->GetAddr1 ());
         }
       return;
     }
-  else if (hdr->IsProbeReq ()|| hdr->IsAssocReq ())
+
+  /* Data frames are forwarded without being copied, the remaining frames are
+     parsed by removing their headers from a copy of the received packet */
+  Ptr<Packet> packet = mpdu->GetPacket ()->Copy ();
+
+  if (hdr->IsProbeReq ()|| hdr->IsAssocReq ())
     {
       // This is a frame aimed at DMG PCP/AP, so we can safely ignore it.
       NotifyRxDrop (packet);
@@ -3374,7 +3639,7 @@ DmgStaWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
                 {
                    m_oldSnrTxMap = m_stationSnrMap[hdr->GetAddr1 ()].first;
                 }
-              m_stationSnrMap.erase (hdr->GetAddr1 ());
+              RemoveSnrTable (hdr->GetAddr1 ());
 
               /* Beacon Interval Field */
               ExtDMGBeaconIntervalCtrlField beaconInterval = beacon.GetBeaconIntervalControlField ();
@@ -3597,6 +3862,7 @@ DmgStaWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
   else if (hdr->IsSSW_FBCK ())
     {
       NS_LOG_LOGIC ("Responder: Received SSW-FBCK frame from=" << hdr->GetAddr2 ());
+      NS_DMG_PROFILE_SCOPE (DMG_PROFILE_MAC_SLS);
 
       if (m_performingBFT && (m_peerStationAddress != hdr->GetAddr2 ()))
         {
@@ -18,9 +18,14 @@
 #include "ns3/traced-value.h"
 #include "mgt-headers.h"
 
+class PredictiveRelaySwitchTest;
+class QdParallelRxPowerTest;
+
 namespace ns3  {
 
 class UniformRandomVariable;
+class QdPropagationEngine;
+class Node;
 
 /**
  * \ingroup wifi
@@ -102,6 +107,11 @@ typedef Callback<DynamicAllocationInfoField, Mac48Address, BF_Control_Field &> S
 class DmgStaWifiMac : public DmgWifiMac
 {
 public:
+  /// allow PredictiveRelaySwitchTest class access
+  friend class ::PredictiveRelaySwitchTest;
+  /// allow QdParallelRxPowerTest class access
+  friend class ::QdParallelRxPowerTest;
+
   static TypeId GetTypeId (void);
 
   DmgStaWifiMac ();
@@ -437,6 +447,51 @@ protected:
    * This function is called upon the expiration of Relay Data Sensing Timeout.
    */
   void RelayDataSensingTimeout (void);
+  /**
+   * Notify that the transmission link of the service period protected by the RDS has changed
+   * in order to measure the outage caused by the change.
+   */
+  void NotifyTransmissionLinkSwitched (void);
+  /**
+   * Called when a frame has been received from a peer station.
+   * \param type The type of the received frame.
+   * \param address The MAC address of the peer station.
+   * \param snr The SNR of the received frame in linear scale.
+   */
+  void RelayLinkRxOk (WifiMacType type, Mac48Address address, double snr);
+  /**
+   * Called when a data frame or an A-MPDU has been acknowledged by a peer station.
+   * \param address The MAC address of the peer station.
+   * \param ackSnr The SNR of the Ack or BlockAck frame in linear scale.
+   * \param dataMode The mode used to transmit the acknowledged data.
+   */
+  void RelayLinkTxAcked (Mac48Address address, double ackSnr, WifiMode dataMode);
+  /**
+   * Record a successful frame exchange with a peer station during a service period protected by
+   * an RDS, and report the outage of the last link change if the frame went through the new link.
+   * \param address The MAC address of the peer station.
+   */
+  void RecordRelayLinkActivity (Mac48Address address);
+  /**
+   * Update the prediction of the SNR of the direct link with a new measurement and request a switch
+   * to the relay link if the SNR predicted at the end of the prediction horizon is below the SNR
+   * threshold of the current mode.
+   * \param snr The measured SNR of the direct link in dB.
+   * \param mode The mode currently used over the direct link.
+   */
+  void PredictDirectLinkQuality (double snr, WifiMode mode);
+  /**
+   * Get the minimum SNR at which the PER of a mode does not exceed the target PER.
+   * \param mode The mode.
+   * \return The SNR threshold of the mode in dB.
+   */
+  double GetRelaySwitchSnrThreshold (WifiMode mode);
+  /**
+   * Get the node of a peer station. The node is cached once found.
+   * \param address The MAC address of the peer station.
+   * \return Pointer to the node of the peer station, or 0 if not found.
+   */
+  Ptr<Node> GetPeerNode (Mac48Address address);
   /**
    * Switch to Relay Opertional Mode. This method is called by the RDS.
    */
@@ -670,6 +725,23 @@ private:
   bool m_relayReceivedData;                     //!< Flag to indicate if the RDS has received frame in the HD-DF operation mode.
   bool m_periodProtected;                       //!< Flag to indicate if the current SP allocation is protected by relay operation.
 
+  /* Predictive Relay Link Switching */
+  bool m_predictiveRelaySwitching;              //!< Flag to indicate whether the switch to the relay link is triggered by prediction.
+  Time m_relayPredictionHorizon;                //!< The look-ahead interval of the direct link prediction.
+  double m_relaySwitchMargin;                   //!< The margin in dB added to the SNR threshold of the current mode.
+  double m_relayTargetPer;                      //!< The PER defining the SNR threshold of a mode.
+  Ptr<QdPropagationEngine> m_qdPropagationEngine;   //!< The Q-D propagation engine used for look-ahead, if any.
+  bool m_hasDirectLinkSnr;                      //!< Flag to indicate whether the SNR of the direct link has been measured.
+  double m_directLinkSnr;                       //!< The averaged SNR of the direct link in dB.
+  double m_directLinkSnrSlope;                  //!< The trend of the SNR of the direct link in dB per second.
+  double m_directLinkAnchorSnr;                 //!< The averaged SNR of the direct link at the start of the trend window.
+  Time m_directLinkAnchorTime;                  //!< The start time of the trend window.
+  std::map<uint32_t, double> m_relaySnrThresholds;  //!< SNR threshold in dB of each mode, indexed by the unique ID of the mode.
+  std::map<Mac48Address, Ptr<Node> > m_peerNodes;   //!< The nodes of the peer stations found so far.
+  bool m_relayOutagePending;                    //!< Flag to indicate that no frame went through the new link since the last link change.
+  Time m_relayOutageStart;                      //!< The time of the last frame exchanged before the last link change.
+  Time m_lastRelayActivity;                     //!< The time of the last frame exchanged with the peer REDS or the RDS.
+
   ChannelMeasurementInfoList m_channelMeasurementList;    //!< The channel measurement list between the source REDS and the RDS.
   ChannelMeasurementCallback m_channelMeasurementCallback;
 
@@ -687,6 +759,17 @@ private:
   typedef void (* TransmissionLinkChangedCallback)(Mac48Address address, TransmissionLink link);
   TracedCallback<Mac48Address, TransmissionLink> m_transmissionLinkChanged;
 
+  /**
+   * TracedCallback signature for the outage caused by a transmission link change.
+   *
+   * \param address The MAC address of the peer REDS.
+   * \param transmissionLink The new transmission link.
+   * \param outage The time elapsed between the last frame exchanged before the link change
+   * and the first frame exchanged through the new link.
+   */
+  typedef void (* RelayLinkOutageCallback)(Mac48Address address, TransmissionLink link, Time outage);
+  TracedCallback<Mac48Address, TransmissionLink, Time> m_relayLinkOutage;
+
   /**
    * TracedCallback signature for .
    *
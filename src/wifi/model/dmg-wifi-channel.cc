@@ -26,6 +26,7 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/mobility-model.h"
+#include "dmg-profiler.h"
 #include "dmg-wifi-channel.h"
 #include "wifi-utils.h"
 #include <fstream>
@@ -168,6 +169,7 @@ void
 DmgWifiChannel::Send (Ptr<DmgWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const
 {
   NS_LOG_FUNCTION (this << sender << ppdu << txPowerDbm);
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_CHANNEL_SEND);
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
@@ -242,7 +244,11 @@ DmgWifiChannel::Send (Ptr<DmgWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double t
                                           delay, &DmgWifiChannel::Receive,
                                           (*i), copy, rxPowerDbm);
 
-          /* PHY Activity Monitor */
+          /* PHY Activity Monitor, skipped (including the RX activity event) when nothing is connected to the trace source */
+          if (m_phyActivityTrace.IsEmpty ())
+            {
+              continue;
+            }
           uint32_t srcNode = sender->GetDevice ()->GetNode ()->GetId ();
           if (sender->GetStandard () == WIFI_PHY_STANDARD_80211ad)
             {
@@ -90,7 +90,7 @@ public:
    * attempts to deliver the PPDU to all other DmgWifiPhy objects
    * on the channel (except for the sender).
    */
-  void Send (Ptr<DmgWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const;
+  virtual void Send (Ptr<DmgWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const;
   /**
    * Send AGC Subfield
    * \param sender
@@ -155,7 +155,7 @@ public:
    */
   void UpdateSignalStrengthValue (void);
 
-private:
+protected:
   /**
    * A vector of pointers to DmgWifiPhy.
    */
@@ -171,6 +171,12 @@ private:
    * \param txPowerDbm the TX power associated to the packet being sent (dBm)
    */
   static void Receive (Ptr<DmgWifiPhy> receiver, Ptr<WifiPpdu> ppdu, double txPowerDbm);
+
+  PhyList m_phyList;                   //!< List of DmgWifiPhys connected to this DmgWifiChannel
+  Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
+  Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+
+private:
   /**
    * Generic function for receiving any subfield in TRN-Block.
    * \param i
@@ -210,9 +216,6 @@ private:
   void ReceiveTrnSubfield (uint32_t i, Ptr<DmgWifiPhy> sender, WifiTxVector txVector,
                            double txPowerDbm, double txAntennaGainDbi) const;
 
-  PhyList m_phyList;                   //!< List of DmgWifiPhys connected to this DmgWifiChannel
-  Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
-  Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
   double (*m_blockage) ();             //!< Blockage model.
   bool (*m_packetDropper) ();          //!< Packet Dropper Model.
   Ptr<WifiPhy> m_srcWifiPhy;
@@ -9,6 +9,8 @@
 #include "ns3/simulator.h"
 #include "ns3/pointer.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/node.h"
 
 #include "dmg-wifi-mac.h"
 #include "dmg-wifi-phy.h"
@@ -19,6 +21,10 @@
 #include "mgt-headers.h"
 #include "mpdu-aggregator.h"
 #include "msdu-aggregator.h"
+#include "qd-propagation-engine.h"
+#include "spectrum-dmg-wifi-phy.h"
+#include "dmg-profiler.h"
+#include "wifi-net-device.h"
 #include "wifi-mac-queue.h"
 #include "wifi-utils.h"
 
@@ -98,6 +104,29 @@ DmgWifiMac::GetTypeId (void)
                     MakeBooleanAccessor (&DmgWifiMac::m_useRxSectors),
                     MakeBooleanChecker ())
 
+    /* Fast Sector Sweep */
+    .AddAttribute ("FastSectorSweep", "Whether the TXSS in a service period is evaluated through the Q-D propagation engine "
+                   "in a single call instead of transmitting one SSW frame per sector.",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&DmgWifiMac::m_fastSectorSweep),
+                    MakeBooleanChecker ())
+
+    /* Beamforming Cache */
+    .AddAttribute ("BeamformingCache", "Whether to limit a repeated TXSS with a peer station to the neighborhood of the "
+                   "previous best sector when neither the Q-D trace index nor the codebook has changed since.",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&DmgWifiMac::m_beamformingCache),
+                    MakeBooleanChecker ())
+    .AddAttribute ("HierarchicalSectorSweep", "Whether to search the sector hierarchy of the codebook during TXSS: "
+                   "first the wide sectors, then the children of the best wide sector.",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&DmgWifiMac::m_hierarchicalSectorSweep),
+                    MakeBooleanChecker ())
+    .AddAttribute ("BeamformingCacheSectors", "The number of sectors swept on each side of the cached best sector.",
+                    UintegerValue (2),
+                    MakeUintegerAccessor (&DmgWifiMac::m_beamformingCacheSectors),
+                    MakeUintegerChecker<uint8_t> ())
+
     /* Link Maintenance Attributes */
     .AddAttribute ("BeamLinkMaintenanceUnit", "The unit used for dot11BeamLinkMaintenanceTime calculation.",
                    EnumValue (UNIT_32US),
@@ -109,6 +138,47 @@ DmgWifiMac::GetTypeId (void)
                    MakeUintegerAccessor (&DmgWifiMac::m_beamlinkMaintenanceValue),
                    MakeUintegerChecker<uint8_t> (0, 63))
 
+    /* Automatic Fast Session Transfer */
+    .AddAttribute ("AutomaticFst",
+                   "Enable the policy which sets up and executes FST sessions automatically "
+                   "based on the quality of the DMG links. The band changes are reported through "
+                   "the callback registered with RegisterBandChangedCallback.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DmgWifiMac::m_automaticFst),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FstPolicyInterval",
+                   "The interval between two evaluations of the DMG links by the FST policy.",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&DmgWifiMac::m_fstPolicyInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("FstSetupSnrThreshold",
+                   "The DMG link SNR in dB below which an FST session is set up in advance.",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&DmgWifiMac::m_fstSetupSnrThreshold),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("FstSwitchSnrThreshold",
+                   "The DMG link SNR in dB below which the session is transferred to the other band.",
+                   DoubleValue (3.0),
+                   MakeDoubleAccessor (&DmgWifiMac::m_fstSwitchSnrThreshold),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("FstMaxFailedMpdus",
+                   "The number of consecutive MPDUs dropped towards a peer station after which "
+                   "the session is transferred to the other band.",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&DmgWifiMac::m_fstMaxFailedMpdus),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("FstMaxMissedBeacons",
+                   "The number of consecutive DMG Beacons missed from the DMG PCP/AP after which "
+                   "the session is transferred to the other band. A DMG Beacon is missed if it has "
+                   "not been received half a beacon interval after its expected arrival time.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&DmgWifiMac::m_fstMaxMissedBeacons),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("FstSwitch",
+                     "A session has been transferred to another band.",
+                     MakeTraceSourceAccessor (&DmgWifiMac::m_fstSwitchTrace),
+                     "ns3::DmgWifiMac::FstSwitchTracedCallback")
+
     /* Beacon Interval Traces */
     .AddTraceSource ("DTIStarted", "The Data Transmission Interval access period started.",
                      MakeTraceSourceAccessor (&DmgWifiMac::m_dtiStarted),
@@ -214,11 +284,16 @@ DmgWifiMac::DmgWifiMac ()
     m_sswFbckTimeout (),
     m_sswAckTimeoutEvent (),
     m_rssEvent (),
+    m_fastSectorSweep (false),
+    m_beamformingCache (false),
+    m_beamformingCacheSectors (2),
+    m_hierarchicalSectorSweep (false),
     m_suMimoBeamformingTraining (false),
     m_muMimoBeamformingTraining (false),
     m_isMuMimoInitiator (false),
     m_muMimoFbckTimeout (),
-    m_beamLinkMaintenanceTimeout ()
+    m_beamLinkMaintenanceTimeout (),
+    m_automaticFst (false)
 
 {
   NS_LOG_FUNCTION (this);
@@ -263,6 +338,15 @@ DmgWifiMac::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_dmgAtiTxop = 0;
+  m_fstPolicyEvent.Cancel ();
+  m_fstLinks.clear ();
+  for (std::map<Mac48Address, EventId>::iterator it = m_fastSectorSweepTimeouts.begin ();
+       it != m_fastSectorSweepTimeouts.end (); it++)
+    {
+      it->second.Cancel ();
+    }
+  m_fastSectorSweepTimeouts.clear ();
+  m_fastSectorSweepSnrMap.clear ();
   m_codebook->Dispose ();
   m_codebook = 0;
   RegularWifiMac::DoDispose ();
@@ -311,6 +395,10 @@ DmgWifiMac::DoInitialize (void)
 
   /* Initialzie Upper Layers */
   RegularWifiMac::DoInitialize ();
+  if (m_automaticFst)
+    {
+      StartFstPolicy ();
+    }
   if (m_isEdmgSupported && (GetDmgWifiPhy ()->IsSuMimoSupported () || GetDmgWifiPhy ()->IsMuMimoSupported ()))
     {
       GetDmgWifiPhy ()->RegisterEndReceiveMimoTRNCallback (MakeCallback (&DmgWifiMac::EndMimoTrnField, this));
@@ -803,7 +891,7 @@ DmgWifiMac::TXSS_TXOP_Access_Granted (Mac48Address peerAddress, SLS_ROLE slsRole
               if (!m_performingBFT) // This means that we've started TXSS BFT but it failed
                 {
                   /* Remove current Sector Sweep Information with the station we want to perform beamforming training with */
-                  m_stationSnrMap.erase (peerAddress);
+                  RemoveSnrTable (peerAddress);
                   /* Reset variables */
                   m_bfRetryTimes = 0;
                   m_isBeamformingInitiator = true;
@@ -912,8 +1000,7 @@ DmgWifiMac::Initialize_Sector_Sweep_Parameters (Mac48Address peerAddress)
   NS_ASSERT_MSG (peerCapabilities != 0, "To continue beamforming we should have the capabilities of the peer station.");
   m_peerSectors = peerCapabilities->GetNumberOfSectors ();
   m_peerAntennas = peerCapabilities->GetNumberOfRxDmgAntennas ();
-  Time duration = CalculateSectorSweepDuration (m_peerAntennas, m_codebook->GetTotalNumberOfAntennas (),
-                                                m_codebook->GetTotalNumberOfTransmitSectors ());
+  Time duration = CalculateTransmitSectorSweepDuration (peerAddress);
   if (Simulator::Now () + duration <= m_dtiStartTime + m_dtiDuration)
     {
       /* Beamforming Allocation Parameters */
@@ -952,7 +1039,7 @@ DmgWifiMac::StartBeamformingTraining (uint8_t peerAid, Mac48Address peerAddress,
   m_isResponderTXSS = isResponderTXSS;
 
   /* Remove current Sector Sweep Information */
-  m_stationSnrMap.erase (peerAddress);
+  RemoveSnrTable (peerAddress);
 
   /* Reset variables */
   m_bfRetryTimes = 0;
@@ -971,8 +1058,16 @@ DmgWifiMac::StartBeamformingInitiatorPhase (void)
       NS_LOG_INFO ("DMG STA Starting ISS Phase with Initiator Role at " << Simulator::Now ());
       /** We are the Initiator of the Beamforming Phase **/
       /* Schedule Beamforming Responder Phase */
-      Time rssTime = CalculateSectorSweepDuration (m_peerAntennas, m_codebook->GetTotalNumberOfAntennas (),
-                                                   m_codebook->GetTotalNumberOfTransmitSectors ());
+      Time rssTime;
+      if (m_isInitiatorTXSS)
+        {
+          rssTime = CalculateTransmitSectorSweepDuration (m_peerStationAddress);
+        }
+      else
+        {
+          rssTime = CalculateSectorSweepDuration (m_peerAntennas, m_codebook->GetTotalNumberOfAntennas (),
+                                                  m_codebook->GetTotalNumberOfTransmitSectors ());
+        }
       NS_LOG_DEBUG ("Initiator: Schedulled RSS Event at " << Simulator::Now () + rssTime);
       m_rssEvent = Simulator::Schedule (rssTime, &DmgWifiMac::StartBeamformingResponderPhase, this, m_peerStationAddress);
       if (m_isInitiatorTXSS)
@@ -1126,11 +1221,44 @@ DmgWifiMac::StartTransmitSectorSweep (Mac48Address address, BeamformingDirection
 {
   NS_LOG_FUNCTION (this << address << direction);
   NS_LOG_INFO ("DMG STA Starting TXSS at " << Simulator::Now ());
-  /* Inform the codebook to Initiate SLS phase */
-  m_codebook->StartSectorSweeping (address, TransmitSectorSweep, m_peerAntennas);
   /* Calculate the correct duration for the sector sweep frame */
-  m_sectorSweepDuration = CalculateSectorSweepDuration (m_peerAntennas, m_codebook->GetTotalNumberOfAntennas (),
-                                                        m_codebook->GetTotalNumberOfTransmitSectors ());
+  m_sectorSweepDuration = CalculateTransmitSectorSweepDuration (address);
+  /* Inform the codebook to Initiate SLS phase */
+  Antenna2SectorList sectorList;
+  bool partialSweep = GetPartialSectorSweepList (address, sectorList);
+  if (partialSweep)
+    {
+      /* A failed partial sweep falls back to a full (or top level) sweep in the next attempt */
+      BEAMFORMING_CACHE::iterator it = m_beamformingCacheMap.find (address);
+      if (it != m_beamformingCacheMap.end ())
+        {
+          it->second.used = true;
+        }
+      m_hierarchicalSweepMap.erase (address);
+      m_codebook->StartSectorSweeping (address, sectorList, m_peerAntennas);
+    }
+  else
+    {
+      m_codebook->StartSectorSweeping (address, TransmitSectorSweep, m_peerAntennas);
+    }
+  if (m_fastSectorSweep && (m_currentAllocation == SERVICE_PERIOD_ALLOCATION))
+    {
+      if (StartFastTransmitSectorSweep (address, direction))
+        {
+          return;
+        }
+      /* The fast sweep may have walked through the codebook, so restart the same sectors from
+       * the first one. The cache and hierarchy state is already consumed, so the sector list
+       * chosen above is reused to keep the CDOWN values in line with m_sectorSweepDuration. */
+      if (partialSweep)
+        {
+          m_codebook->StartSectorSweeping (address, sectorList, m_peerAntennas);
+        }
+      else
+        {
+          m_codebook->StartSectorSweeping (address, TransmitSectorSweep, m_peerAntennas);
+        }
+    }
   if (direction == BeamformingInitiator)
     {
       SendInitiatorTransmitSectorSweepFrame (address);
@@ -1141,6 +1269,251 @@ DmgWifiMac::StartTransmitSectorSweep (Mac48Address address, BeamformingDirection
     }
 }
 
+bool
+DmgWifiMac::GetQdTraceIndex (uint16_t &traceIndex) const
+{
+  Ptr<SpectrumDmgWifiPhy> phy = DynamicCast<SpectrumDmgWifiPhy> (m_phy);
+  if (phy == 0)
+    {
+      return false;
+    }
+  Ptr<QdPropagationEngine> engine = phy->GetQdPropagationEngine ();
+  if (engine == 0)
+    {
+      return false;
+    }
+  traceIndex = engine->GetCurrentTraceIndex ();
+  return true;
+}
+
+void
+DmgWifiMac::RecordTransmitSectorSweep (Mac48Address address, bool txss)
+{
+  NS_LOG_FUNCTION (this << address << txss);
+  ANTENNA_CONFIGURATION txConfig = std::get<0> (m_bestAntennaConfig[address]);
+  if (!txss || (txConfig.first == NO_ANTENNA_CONFIG))
+    {
+      return;
+    }
+
+  /* Refine the selected sector in the next TXSS if it is a wide sector */
+  if (m_hierarchicalSectorSweep && m_codebook->IsWideSector (txConfig.first, txConfig.second))
+    {
+      m_hierarchicalSweepMap[address] = txConfig;
+    }
+
+  uint16_t traceIndex;
+  if (m_beamformingCache && GetQdTraceIndex (traceIndex))
+    {
+      BeamformingCacheEntry entry;
+      entry.traceIndex = traceIndex;
+      entry.codebookVersion = m_codebook->GetVersion ();
+      entry.txConfig = txConfig;
+      entry.used = false;
+      m_beamformingCacheMap[address] = entry;
+    }
+}
+
+bool
+DmgWifiMac::LookupBeamformingCache (Mac48Address address, ANTENNA_CONFIGURATION &config) const
+{
+  if (!m_beamformingCache)
+    {
+      return false;
+    }
+  BEAMFORMING_CACHE::const_iterator it = m_beamformingCacheMap.find (address);
+  uint16_t traceIndex;
+  if ((it == m_beamformingCacheMap.end ()) || it->second.used || !GetQdTraceIndex (traceIndex)
+      || (it->second.traceIndex != traceIndex) || (it->second.codebookVersion != m_codebook->GetVersion ()))
+    {
+      return false;
+    }
+  config = it->second.txConfig;
+  return true;
+}
+
+bool
+DmgWifiMac::GetPartialSectorSweepList (Mac48Address address, Antenna2SectorList &sectorList)
+{
+  /* A peer with several DMG antennas switches its quasi-omni pattern assuming a full sweep of our sectors */
+  if (m_peerAntennas > 1)
+    {
+      return false;
+    }
+  ANTENNA_CONFIGURATION config;
+  if (LookupBeamformingCache (address, config))
+    {
+      sectorList = m_codebook->GetNeighborSectorList (address, config.first, config.second, m_beamformingCacheSectors);
+      if (!sectorList.empty ())
+        {
+          NS_LOG_INFO ("DMG STA limits TXSS to the neighborhood of AntennaID=" << static_cast<uint16_t> (config.first)
+                       << ", SectorID=" << static_cast<uint16_t> (config.second));
+          return true;
+        }
+    }
+  if (m_hierarchicalSectorSweep && m_codebook->HasSectorHierarchy ())
+    {
+      HIERARCHICAL_SWEEP_MAP::const_iterator it = m_hierarchicalSweepMap.find (address);
+      if (it != m_hierarchicalSweepMap.end ())
+        {
+          NS_LOG_INFO ("DMG STA refines the wide sector AntennaID=" << static_cast<uint16_t> (it->second.first)
+                       << ", SectorID=" << static_cast<uint16_t> (it->second.second));
+          sectorList = m_codebook->GetChildSectorList (it->second.first, it->second.second);
+        }
+      else
+        {
+          NS_LOG_INFO ("DMG STA sweeps the wide sectors");
+          sectorList = m_codebook->GetWideSectorList ();
+        }
+      return !sectorList.empty ();
+    }
+  return false;
+}
+
+Time
+DmgWifiMac::CalculateTransmitSectorSweepDuration (Mac48Address address)
+{
+  Antenna2SectorList sectorList;
+  if (GetPartialSectorSweepList (address, sectorList))
+    {
+      uint8_t sectors = 0;
+      for (Antenna2SectorListCI it = sectorList.begin (); it != sectorList.end (); it++)
+        {
+          sectors += it->second.size ();
+        }
+      return CalculateSectorSweepDuration (m_peerAntennas, sectorList.size (), sectors);
+    }
+  else
+    {
+      return CalculateSectorSweepDuration (m_peerAntennas, m_codebook->GetTotalNumberOfAntennas (),
+                                           m_codebook->GetTotalNumberOfTransmitSectors ());
+    }
+}
+
+bool
+DmgWifiMac::StartFastTransmitSectorSweep (Mac48Address address, BeamformingDirection direction)
+{
+  NS_LOG_FUNCTION (this << address << direction);
+  /* The peer station switches between its quasi-omni patterns in time, keep it simple and support a single one */
+  if (m_peerAntennas > 1)
+    {
+      return false;
+    }
+  Ptr<SpectrumDmgWifiPhy> phy = DynamicCast<SpectrumDmgWifiPhy> (m_phy);
+  if (phy == 0)
+    {
+      return false;
+    }
+
+  /* Find the peer station attached to the same channel */
+  Ptr<Channel> channel = phy->GetChannel ();
+  Ptr<WifiNetDevice> peerDevice;
+  Ptr<DmgWifiMac> peerMac;
+  Ptr<SpectrumDmgWifiPhy> peerPhy;
+  for (std::size_t i = 0; i < channel->GetNDevices (); i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (channel->GetDevice (i));
+      if ((device != 0) && (device->GetMac ()->GetAddress () == address))
+        {
+          peerDevice = device;
+          peerMac = DynamicCast<DmgWifiMac> (device->GetMac ());
+          peerPhy = DynamicCast<SpectrumDmgWifiPhy> (device->GetPhy ());
+          break;
+        }
+    }
+  if ((peerMac == 0) || (peerPhy == 0))
+    {
+      return false;
+    }
+
+  /* Walk through the sectors in the same order as the regular TXSS */
+  AntennaID rxAntennaID = peerPhy->GetCodebook ()->GetActiveAntennaID ();
+  SECTOR_SWEEP_CONFIGURATION_LIST sweep;
+  Time sswTime = (m_isEdmgSupported ? edmgSswTxTime : sswTxTime);
+  Time lastFrameStart = Seconds (0);
+  bool changeAntenna;
+  sweep.push_back (std::make_pair (std::make_pair (m_codebook->GetActiveAntennaID (), m_codebook->GetActiveTxSectorID ()),
+                                   rxAntennaID));
+  while (m_codebook->GetNextSector (changeAntenna))
+    {
+      lastFrameStart += sswTime + (changeAntenna ? m_lbifs : m_sbifs);
+      sweep.push_back (std::make_pair (std::make_pair (m_codebook->GetActiveAntennaID (), m_codebook->GetActiveTxSectorID ()),
+                                       rxAntennaID));
+    }
+
+  std::vector<double> snrList;
+  if (!phy->CalculateSectorSweepSnr (peerPhy, m_stationManager->GetDmgControlTxVector (), sweep, snrList))
+    {
+      /* The caller restarts the codebook from the first sector */
+      return false;
+    }
+
+  /* The last SSW frame is transmitted over the channel and carries its own SNR */
+  SECTOR_SWEEP_SNR_LIST snrValues;
+  for (std::size_t i = 0; i + 1 < sweep.size (); i++)
+    {
+      snrValues.push_back (std::make_pair (sweep[i], snrList[i]));
+    }
+  /* Hand the SNR values over in the context of the peer station, as a received frame would be */
+  Simulator::ScheduleWithContext (peerDevice->GetNode ()->GetId (), Seconds (0), &DmgWifiMac::ReceiveFastSectorSweepSnr,
+                                  peerMac, GetAddress (), snrValues, lastFrameStart + sswTime + GetMbifs ());
+
+  NS_LOG_INFO ("DMG STA evaluated " << sweep.size () << " sectors towards " << address
+               << ", last SSW frame at " << Simulator::Now () + lastFrameStart);
+  if (direction == BeamformingInitiator)
+    {
+      Simulator::Schedule (lastFrameStart, &DmgWifiMac::SendInitiatorTransmitSectorSweepFrame, this, address);
+    }
+  else
+    {
+      Simulator::Schedule (lastFrameStart, &DmgWifiMac::SendRespodnerTransmitSectorSweepFrame, this, address);
+    }
+  return true;
+}
+
+void
+DmgWifiMac::ReceiveFastSectorSweepSnr (Mac48Address address, const SECTOR_SWEEP_SNR_LIST &snrValues, Time timeout)
+{
+  NS_LOG_FUNCTION (this << address << snrValues.size () << timeout);
+  RemoveFastSectorSweepSnr (address);
+  m_fastSectorSweepSnrMap[address] = snrValues;
+  m_fastSectorSweepTimeouts[address] = Simulator::Schedule (timeout, &DmgWifiMac::RemoveFastSectorSweepSnr, this, address);
+}
+
+void
+DmgWifiMac::RemoveFastSectorSweepSnr (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_fastSectorSweepSnrMap.erase (address);
+  std::map<Mac48Address, EventId>::iterator it = m_fastSectorSweepTimeouts.find (address);
+  if (it != m_fastSectorSweepTimeouts.end ())
+    {
+      it->second.Cancel ();
+      m_fastSectorSweepTimeouts.erase (it);
+    }
+}
+
+void
+DmgWifiMac::MapFastSectorSweepSnr (Mac48Address address, uint16_t countDown)
+{
+  NS_LOG_FUNCTION (this << address << countDown);
+  STATION_SECTOR_SWEEP_SNR_MAP::iterator it = m_fastSectorSweepSnrMap.find (address);
+  if (it == m_fastSectorSweepSnrMap.end ())
+    {
+      return;
+    }
+  /* Only the last SSW frame of a fast TXSS is transmitted, any other SSW frame belongs to a regular TXSS */
+  if (countDown == 0)
+    {
+      for (SECTOR_SWEEP_SNR_LIST::const_iterator snrIt = it->second.begin (); snrIt != it->second.end (); snrIt++)
+        {
+          const SECTOR_SWEEP_CONFIGURATION &config = snrIt->first;
+          MapTxSnr (address, config.second, config.first.first, config.first.second, snrIt->second);
+        }
+    }
+  RemoveFastSectorSweepSnr (address);
+}
+
 void
 DmgWifiMac::SendInitiatorTransmitSectorSweepFrame (Mac48Address address)
 {
@@ -1267,6 +1640,7 @@ void
 DmgWifiMac::ReceiveShortSswFrame (Ptr<Packet> packet, double rxSnr)
 {
   NS_LOG_FUNCTION (this << packet);
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_MAC_SLS);
 
   ShortSSW shortSsw;
   packet->RemoveHeader (shortSsw);
@@ -1689,22 +2063,10 @@ void
 DmgWifiMac::MapTxSnr (Mac48Address address, AntennaID RxAntennaID, AntennaID TxAntennaID, SectorID sectorID, double snr)
 {
   NS_LOG_FUNCTION (this << address << uint16_t (RxAntennaID)<< uint16_t (TxAntennaID) << uint16_t (sectorID) << RatioToDb (snr));
-  STATION_SNR_PAIR_MAP_I it = m_stationSnrMap.find (address);
   ANTENNA_CONFIGURATION_COMBINATION config = std::make_tuple (RxAntennaID, TxAntennaID, sectorID);
-  if (it != m_stationSnrMap.end ())
-    {
-      SNR_PAIR *snrPair = (SNR_PAIR *) (&it->second);
-      SNR_MAP_TX *snrMap = (SNR_MAP_TX *) (&snrPair->first);
-      (*snrMap)[config] = snr;
-    }
-  else
-    {
-      SNR_MAP_TX snrTx;
-      SNR_MAP_RX snrRx;
-      snrTx[config] = snr;
-      SNR_PAIR snrPair = std::make_pair (snrTx, snrRx);
-      m_stationSnrMap[address] = snrPair;
-    }
+  SNR_MAP_TX &snrMap = m_stationSnrMap[address].first;
+  snrMap[config] = snr;
+  UpdateBestSnr (m_bestSnrMap[address].first, snrMap, config, snr);
 }
 
 void
@@ -1717,21 +2079,39 @@ void
 DmgWifiMac::MapRxSnr (Mac48Address address, AntennaID antennaID, SectorID sectorID, double snr)
 {
   NS_LOG_FUNCTION (this << address << uint16_t (antennaID) << uint16_t (sectorID) << snr);
-  STATION_SNR_PAIR_MAP::iterator it = m_stationSnrMap.find (address);
   ANTENNA_CONFIGURATION_COMBINATION config = std::make_tuple (m_codebook->GetActiveAntennaID (), antennaID, sectorID);
-  if (it != m_stationSnrMap.end ())
+  SNR_MAP_RX &snrMap = m_stationSnrMap[address].second;
+  snrMap[config] = snr;
+  UpdateBestSnr (m_bestSnrMap[address].second, snrMap, config, snr);
+}
+
+void
+DmgWifiMac::RemoveSnrTable (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_stationSnrMap.erase (address);
+  m_bestSnrMap.erase (address);
+}
+
+void
+DmgWifiMac::UpdateBestSnr (BEST_SNR &best, const SNR_MAP &snrMap, ANTENNA_CONFIGURATION_COMBINATION config, double snr)
+{
+  if ((snrMap.size () == 1) || (snr > best.second) || ((snr == best.second) && (config < best.first)))
     {
-      SNR_PAIR *snrPair = (SNR_PAIR *) (&it->second);
-      SNR_MAP_RX *snrMap = (SNR_MAP_RX *) (&snrPair->second);
-      (*snrMap)[config] = snr;
+      /* First value or new highest SNR, ties are resolved towards the first antenna configuration in the table */
+      best = std::make_pair (config, snr);
     }
-  else
+  else if ((config == best.first) && (snr < best.second))
     {
-      SNR_MAP_TX snrTx;
-      SNR_MAP_RX snrRx;
-      snrRx[config] = snr;
-      SNR_PAIR snrPair = std::make_pair (snrTx, snrRx);
-      m_stationSnrMap[address] = snrPair;
+      /* The SNR of the best antenna configuration dropped, look for the highest SNR again */
+      best = *snrMap.begin ();
+      for (SNR_MAP::const_iterator it = snrMap.begin (); it != snrMap.end (); it++)
+        {
+          if (best.second < it->second)
+            {
+              best = *it;
+            }
+        }
     }
 }
 
@@ -4894,31 +5274,18 @@ DmgWifiMac::GetBestAntennaConfiguration (const Mac48Address stationAddress, bool
 ANTENNA_CONFIGURATION
 DmgWifiMac::GetBestAntennaConfiguration (const Mac48Address stationAddress, bool isTxConfiguration, double &maxSnr)
 {
-  SNR_PAIR snrPair = m_stationSnrMap[stationAddress];
-  SNR_MAP snrMap;
-  if (isTxConfiguration)
-    {
-      snrMap = snrPair.first;
-    }
-  else
+  STATION_SNR_PAIR_MAP_CI tableIt = m_stationSnrMap.find (stationAddress);
+  STATION_BEST_SNR_MAP::const_iterator bestIt = m_bestSnrMap.find (stationAddress);
+  if ((tableIt == m_stationSnrMap.end ()) || (bestIt == m_bestSnrMap.end ())
+      || (isTxConfiguration ? tableIt->second.first.empty () : tableIt->second.second.empty ()))
     {
-      snrMap = snrPair.second;
+      NS_LOG_DEBUG ("No SNR measurements for " << stationAddress);
+      maxSnr = 0;
+      return std::make_pair (NO_ANTENNA_CONFIG, NO_ANTENNA_CONFIG);
     }
-
-  SNR_MAP::iterator highIter = snrMap.begin ();
-  SNR snr = highIter->second;
-  maxSnr = snr;
-  for (SNR_MAP::iterator iter = snrMap.begin (); iter != snrMap.end (); iter++)
-    {
-      if (snr < iter->second)
-        {
-          highIter = iter;
-          snr = highIter->second;
-          maxSnr = snr;
-        }
-    }
-  ANTENNA_CONFIGURATION_COMBINATION config = highIter->first;
-  return std::make_pair (std::get<1> (config), std::get<2> (config));
+  const BEST_SNR &best = (isTxConfiguration ? bestIt->second.first : bestIt->second.second);
+  maxSnr = best.second;
+  return std::make_pair (std::get<1> (best.first), std::get<2> (best.first));
 }
 
 void
@@ -5339,10 +5706,186 @@ DmgWifiMac::TxOk (Ptr<const Packet> currentPacket, const WifiMacHeader &hdr)
   RegularWifiMac::TxOk (currentPacket, hdr);
 }
 
+/**
+ * Functions for the automatic Fast Session Transfer policy.
+ */
+DmgWifiMac::FstLinkState::FstLinkState ()
+  : failedMpdus (0),
+    setupRequested (false),
+    degraded (false)
+{
+}
+
+void
+DmgWifiMac::StartFstPolicy (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stationManager->TraceConnectWithoutContext ("MacTxOK", MakeCallback (&DmgWifiMac::FstTxOk, this));
+  m_stationManager->TraceConnectWithoutContext ("MacTxFinalDataFailed",
+                                                MakeCallback (&DmgWifiMac::FstTxFinalDataFailed, this));
+  if (GetTypeOfStation () == DMG_STA)
+    {
+      TraceConnectWithoutContext ("BeaconArrival", MakeCallback (&DmgWifiMac::FstBeaconArrival, this));
+    }
+  m_fstPolicyEvent = Simulator::Schedule (m_fstPolicyInterval, &DmgWifiMac::EvaluateFstPolicy, this);
+}
+
+void
+DmgWifiMac::EvaluateFstPolicy (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_fstPolicyEvent = Simulator::Schedule (m_fstPolicyInterval, &DmgWifiMac::EvaluateFstPolicy, this);
+
+  /* Check the DMG Beacons received from the DMG PCP/AP, which are only traced while associated */
+  if ((GetTypeOfStation () == DMG_STA) && m_fstLastBeacon.IsStrictlyPositive () && m_beaconInterval.IsStrictlyPositive ()
+      && (GetFstSessionState (GetBssid ()) < FST_TRANSITION_DONE_STATE)
+      && (Simulator::Now () > m_fstLastBeacon + m_beaconInterval * m_fstMaxMissedBeacons + m_beaconInterval / 2))
+    {
+      NS_LOG_DEBUG ("Missed " << m_fstMaxMissedBeacons << " DMG Beacons from " << GetBssid ());
+      TransferSession (GetBssid (), m_fstLastBeacon + m_beaconInterval);
+    }
+
+  /* Check the link SNR of the peer stations, a session transfer removes the state of the link */
+  std::vector<Mac48Address> peers;
+  for (FstLinkStateMap::const_iterator link = m_fstLinks.begin (); link != m_fstLinks.end (); link++)
+    {
+      peers.push_back (link->first);
+    }
+  for (std::vector<Mac48Address>::const_iterator peer = peers.begin (); peer != peers.end (); peer++)
+    {
+      FstLinkStateMap::iterator link = m_fstLinks.find (*peer);
+      if (link == m_fstLinks.end ())
+        {
+          continue;
+        }
+      if (GetFstSessionState (*peer) >= FST_TRANSITION_DONE_STATE)
+        {
+          m_fstLinks.erase (link);
+          continue;
+        }
+      if (link->second.degraded)
+        {
+          TransferSession (*peer, link->second.degradedSince);
+          continue;
+        }
+      double snr = m_stationManager->GetLinkSnr (*peer);
+      if (snr == NO_LINK_SNR)
+        {
+          /* No beamforming training has been completed with the peer station */
+          continue;
+        }
+      if (snr < m_fstSwitchSnrThreshold)
+        {
+          NS_LOG_DEBUG ("Link SNR with " << *peer << " dropped to " << snr << " dB");
+          TransferSession (*peer, Simulator::Now ());
+        }
+      else if ((snr < m_fstSetupSnrThreshold) && !link->second.setupRequested)
+        {
+          NS_LOG_DEBUG ("Link SNR with " << *peer << " dropped to " << snr << " dB, so set up FST session");
+          RequestFstSession (*peer);
+        }
+    }
+}
+
+void
+DmgWifiMac::FstTxOk (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  if (GetFstSessionState (address) < FST_TRANSITION_DONE_STATE)
+    {
+      m_fstLinks[address].failedMpdus = 0;
+    }
+}
+
+void
+DmgWifiMac::FstTxFinalDataFailed (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  if (GetFstSessionState (address) >= FST_TRANSITION_DONE_STATE)
+    {
+      return;
+    }
+  FstLinkState &link = m_fstLinks[address];
+  if (link.failedMpdus == 0)
+    {
+      link.firstFailure = Simulator::Now ();
+    }
+  link.failedMpdus++;
+  if (link.failedMpdus >= m_fstMaxFailedMpdus)
+    {
+      NS_LOG_DEBUG ("Dropped " << link.failedMpdus << " consecutive MPDUs towards " << address);
+      TransferSession (address, link.firstFailure);
+    }
+}
+
+void
+DmgWifiMac::FstBeaconArrival (Time oldValue, Time newValue)
+{
+  NS_LOG_FUNCTION (this << oldValue << newValue);
+  m_fstLastBeacon = newValue;
+}
+
+void
+DmgWifiMac::RequestFstSession (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  FstLinkState &link = m_fstLinks[address];
+  link.setupRequested = true;
+  link.setupTime = Simulator::Now ();
+  SetupFSTSession (address);
+}
+
+void
+DmgWifiMac::TransferSession (Mac48Address address, Time degradedSince)
+{
+  NS_LOG_FUNCTION (this << address << degradedSince);
+  FstLinkState &link = m_fstLinks[address];
+  if (!link.degraded)
+    {
+      link.degraded = true;
+      link.degradedSince = degradedSince;
+    }
+  if (ExecuteFstTransition (address))
+    {
+      return;
+    }
+  /* The session is set up by the FST Setup Response, so we only request it once */
+  if (!link.setupRequested && (GetFstSessionState (address) == FST_INITIAL_STATE))
+    {
+      NS_LOG_DEBUG ("No FST session set up with " << address << ", so request it");
+      RequestFstSession (address);
+    }
+}
+
+void
+DmgWifiMac::ChangeBand (Mac48Address peerStation, BandID bandId, bool isInitiator)
+{
+  NS_LOG_FUNCTION (this << peerStation << bandId << isInitiator);
+  /* Report the switch latency and stop monitoring the link */
+  Time latency = Seconds (0);
+  FstLinkStateMap::iterator link = m_fstLinks.find (peerStation);
+  if (link != m_fstLinks.end ())
+    {
+      if (link->second.degraded)
+        {
+          latency = Simulator::Now () - link->second.degradedSince;
+        }
+      else if (link->second.setupRequested)
+        {
+          latency = Simulator::Now () - link->second.setupTime;
+        }
+      m_fstLinks.erase (link);
+    }
+  NS_LOG_DEBUG ("Session with " << peerStation << " transferred to band " << bandId << " after " << latency);
+  m_fstSwitchTrace (peerStation, bandId, latency);
+  RegularWifiMac::ChangeBand (peerStation, bandId, isInitiator);
+}
+
 void
 DmgWifiMac::ReceiveSectorSweepFrame (Ptr<Packet> packet, const WifiMacHeader *hdr)
 {
   NS_LOG_FUNCTION (this << packet);
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_MAC_SLS);
 
   CtrlDMG_SSW sswFrame;
   packet->RemoveHeader (sswFrame);
@@ -5367,7 +5910,7 @@ DmgWifiMac::ReceiveSectorSweepFrame (Ptr<Packet> packet, const WifiMacHeader *hd
             {
               /* We received the first SSW from the initiator during CBAP allocation, so we initialize variables. */
               /* Remove current Sector Sweep Information with the station we want to perform beamforming training with */
-              m_stationSnrMap.erase (hdr->GetAddr2 ());
+              RemoveSnrTable (hdr->GetAddr2 ());
               /* Initialize some of the BFT variables here */
               m_isInitiatorTXSS = true;
               m_isResponderTXSS = true;
@@ -5394,6 +5937,7 @@ DmgWifiMac::ReceiveSectorSweepFrame (Ptr<Packet> packet, const WifiMacHeader *hd
         {
           /* Initiator is TXSS and we store SNR to report it back to the initiator */
           MapTxSnr (hdr->GetAddr2 (), ssw.GetDMGAntennaID (), ssw.GetSectorID (), m_stationManager->GetRxSnr ());
+          MapFastSectorSweepSnr (hdr->GetAddr2 (), ssw.GetCountDown ());
         }
       else
         {
@@ -5455,6 +5999,7 @@ DmgWifiMac::ReceiveSectorSweepFrame (Ptr<Packet> packet, const WifiMacHeader *hd
         {
           /* Responder is TXSS and we store SNR to report it back to the responder */
           MapTxSnr (hdr->GetAddr2 (), ssw.GetDMGAntennaID (), ssw.GetSectorID (), m_stationManager->GetRxSnr ());
+          MapFastSectorSweepSnr (hdr->GetAddr2 (), ssw.GetCountDown ());
         }
       else
         {
@@ -5485,6 +6030,7 @@ DmgWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
   else if (hdr->IsSSW_ACK ())
     {
       NS_LOG_LOGIC ("Initiator: Received SSW-ACK frame from=" << from);
+      NS_DMG_PROFILE_SCOPE (DMG_PROFILE_MAC_SLS);
 
       /* We are the SLS Initiator */
       CtrlDMG_SSW_ACK sswAck;
@@ -5509,6 +6055,8 @@ DmgWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
       m_stationManager->RecordLinkSnr (address, snr);
       m_slsInitiatorStateMachine = SLS_INITIATOR_TXSS_PHASE_COMPELTED;
 
+      RecordTransmitSectorSweep (address, m_isInitiatorTXSS);
+
       /* Raise a callback indicating we've completed the SLS phase */
       m_slsCompleted (SlsCompletionAttrbitutes (from, CHANNEL_ACCESS_DTI, BeamformingInitiator,
                                                 m_isInitiatorTXSS, m_isResponderTXSS,
@@ -5517,6 +6065,13 @@ DmgWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
       /* Inform DMG SLS TXOP that we've received the SSW-ACK frame */
       m_dmgSlsTxop->SLS_BFT_Completed ();
 
+      /* Refine the selected wide sector right away within a new TXSS TXOP */
+      if ((m_currentAllocation == CBAP_ALLOCATION)
+          && (m_hierarchicalSweepMap.find (address) != m_hierarchicalSweepMap.end ()))
+        {
+          Simulator::ScheduleNow (&DmgWifiMac::Perform_TXSS_TXOP, this, address);
+        }
+
       /* Check if we need to start BRP phase following SLS phase */
       BRP_Request_Field brpRequest = sswAck.GetBrpRequestField ();
       if ((brpRequest.GetL_RX () > 0) || brpRequest.GetTX_TRN_REQ ())
@@ -5583,6 +6138,7 @@ DmgWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
 
             case WifiActionHeader::UNPROTECTED_DMG_BRP:
               {
+                NS_DMG_PROFILE_SCOPE (DMG_PROFILE_MAC_BRP);
                 ExtBrpFrame brpFrame;
                 packet->RemoveHeader (brpFrame);
 
@@ -16,6 +16,7 @@
 #include "wigig-data-types.h"
 #include <queue>
 
+class BestAntennaConfigurationTest;
 
 namespace ns3 {
 
@@ -94,6 +95,23 @@ typedef std::vector<SNR> SNR_LIST;
 typedef SNR_LIST::const_iterator SNR_LIST_ITERATOR;
 //// NINA ////
 
+typedef std::vector<std::pair<SECTOR_SWEEP_CONFIGURATION, SNR> > SECTOR_SWEEP_SNR_LIST;      /* SNR of the SSW frames evaluated without transmitting them. */
+typedef std::map<Mac48Address, SECTOR_SWEEP_SNR_LIST> STATION_SECTOR_SWEEP_SNR_MAP;         /* Map between the initiator of a fast TXSS and its SNR values. */
+
+/**
+ * Result of a previous transmit sector sweep with a peer station. The result remains valid as long as
+ * the Q-D trace index and the version of the codebook did not change.
+ */
+struct BeamformingCacheEntry
+{
+  uint16_t traceIndex;                  //!< The Q-D trace index at the time of the beamforming training.
+  uint32_t codebookVersion;             //!< The version of the codebook at the time of the beamforming training.
+  ANTENNA_CONFIGURATION txConfig;       //!< The best transmit antenna configuration towards the peer station.
+  bool used;                            //!< Flag to indicate whether a shortened sweep has been started with this entry.
+};
+typedef std::map<Mac48Address, BeamformingCacheEntry> BEAMFORMING_CACHE;                   /* Map between a peer station and its cached beamforming result. */
+typedef std::map<Mac48Address, ANTENNA_CONFIGURATION> HIERARCHICAL_SWEEP_MAP;              /* Map between a peer station and the wide sector to refine. */
+
 /* Typedefs for Recording SNR Value for MIMO Beamforming training */
 typedef std::tuple<BRP_CDOWN, RX_ANTENNA_ID, TX_ANTENNA_ID>                 MIMO_CONFIGURATION; /* Typedef to save the MIMO configuration associated with a given SNR measurement */
 typedef std::map<MIMO_CONFIGURATION, SNR_LIST>                              SU_MIMO_SNR_MAP;    /* Map to save all SNR measurements done during SU-MIMO BFT in the SISO Phase */
@@ -286,6 +304,9 @@ class DmgWifiPhy;
 class DmgWifiMac : public RegularWifiMac
 {
 public:
+  /// allow BestAntennaConfigurationTest class access
+  friend class ::BestAntennaConfigurationTest;
+
   static TypeId GetTypeId (void);
 
   DmgWifiMac ();
@@ -974,6 +995,11 @@ protected:
    * \param snr The received Signal to Noise Ration in dB.
    */
   void MapRxSnr (Mac48Address address, AntennaID antennaID, SectorID sectorID, double snr);
+  /**
+   * Remove the SNR table of a specific station together with its highest SNR.
+   * \param address The MAC address of the station.
+   */
+  void RemoveSnrTable (Mac48Address address);
   /**
    * Get the remaining time for the current allocation period.
    * \return The remaining time for the current allocation period.
@@ -1034,6 +1060,70 @@ protected:
    * \param direction Indicate whether we are initiator or responder.
    */
   void StartTransmitSectorSweep (Mac48Address address, BeamformingDirection direction);
+  /**
+   * Evaluate the Transmit Sector Sweep (TXSS) through the Q-D propagation engine instead of transmitting one SSW
+   * frame per sector. The SNR of all the sectors but the last one is handed to the peer station, and only the last
+   * SSW frame is transmitted over the channel at the time it would have been transmitted in a regular TXSS.
+   * \param address The MAC address of the peer DMG STA.
+   * \param direction Indicate whether we are initiator or responder.
+   * \return True if the fast TXSS has been started, false if we need to fall back to a regular TXSS, in which case
+   * the codebook may have been moved past the first sector of the sweep.
+   */
+  bool StartFastTransmitSectorSweep (Mac48Address address, BeamformingDirection direction);
+  /**
+   * Receive the SNR values of the sectors evaluated by the peer station during a fast TXSS. The values are
+   * discarded if the last SSW frame of the fast TXSS is not received before the timeout.
+   * \param address The MAC address of the peer DMG STA performing the TXSS.
+   * \param snrValues The SNR values of all the sectors but the last one.
+   * \param timeout The time left until the reception of the last SSW frame of the fast TXSS.
+   */
+  void ReceiveFastSectorSweepSnr (Mac48Address address, const SECTOR_SWEEP_SNR_LIST &snrValues, Time timeout);
+  /**
+   * Discard the SNR values of the sectors evaluated by the peer station during a fast TXSS.
+   * \param address The MAC address of the peer DMG STA performing the TXSS.
+   */
+  void RemoveFastSectorSweepSnr (Mac48Address address);
+  /**
+   * Store the SNR values of the sectors evaluated by the peer station during a fast TXSS upon the reception of
+   * its last SSW frame. The values are discarded if the SSW frame belongs to a regular TXSS.
+   * \param address The MAC address of the peer DMG STA performing the TXSS.
+   * \param countDown The CDOWN field of the received SSW frame.
+   */
+  void MapFastSectorSweepSnr (Mac48Address address, uint16_t countDown);
+  /**
+   * Get the current trace index of the Q-D propagation engine used by the channel.
+   * \param traceIndex The current Q-D trace index.
+   * \return True if the channel uses the Q-D propagation engine, otherwise false.
+   */
+  bool GetQdTraceIndex (uint16_t &traceIndex) const;
+  /**
+   * Record the result of our TXSS in a completed SLS phase with a peer station in the beamforming cache
+   * and in the state of the hierarchical sector sweep.
+   * \param address The MAC address of the peer DMG STA.
+   * \param txss True if we have performed a TXSS during the SLS phase.
+   */
+  void RecordTransmitSectorSweep (Mac48Address address, bool txss);
+  /**
+   * Look up a valid cached beamforming result with a peer station to shorten the next TXSS.
+   * \param address The MAC address of the peer DMG STA.
+   * \param config The cached best transmit antenna configuration.
+   * \return True if the next TXSS can be limited to the neighborhood of the cached configuration.
+   */
+  bool LookupBeamformingCache (Mac48Address address, ANTENNA_CONFIGURATION &config) const;
+  /**
+   * Calculate the duration of our TXSS with a peer station taking the beamforming cache into account.
+   * \param address The MAC address of the peer DMG STA.
+   * \return The duration of the TXSS.
+   */
+  Time CalculateTransmitSectorSweepDuration (Mac48Address address);
+  /**
+   * Get the subset of transmit sectors to sweep with a peer station, either the neighborhood of a cached
+   * configuration or one level of the sector hierarchy of the codebook.
+   * \param address The MAC address of the peer DMG STA.
+   * \param sectorList The list of antennas with their sectors to sweep.
+   * \return True if a partial TXSS should be used, false for a full TXSS.
+   */
+  bool GetPartialSectorSweepList (Mac48Address address, Antenna2SectorList &sectorList);
   /**
    * Start Receive Sector Sweep (RXSS) with specific station.
    * \param address The MAC address of the peer DMG STA.
@@ -1151,6 +1241,9 @@ protected:
   typedef std::map<Mac48Address, SNR_PAIR>      STATION_SNR_PAIR_MAP;   /* Typedef for Map between stations and their SNR Table. */
   typedef STATION_SNR_PAIR_MAP::iterator        STATION_SNR_PAIR_MAP_I; /* Typedef for iterator over SNR MAPPING Table. */
   typedef STATION_SNR_PAIR_MAP::const_iterator  STATION_SNR_PAIR_MAP_CI;/* Typedef for const iterator over SNR MAPPING Table. */
+  typedef std::pair<ANTENNA_CONFIGURATION_COMBINATION, SNR> BEST_SNR;   /* Typedef for the antenna configuration with the highest SNR. */
+  typedef std::pair<BEST_SNR, BEST_SNR>         BEST_SNR_PAIR;          /* Typedef for the highest TX and RX SNR of a station. */
+  typedef std::map<Mac48Address, BEST_SNR_PAIR> STATION_BEST_SNR_MAP;   /* Typedef for Map between stations and their highest SNR. */
 
   /* Typedefs for Recording Best Antenna Configuration per Station */
   typedef ANTENNA_CONFIGURATION ANTENNA_CONFIGURATION_TX;               /* Typedef for best TX antenna configuration. */
@@ -1232,6 +1325,15 @@ protected:
    * \param maxSnr The SNR value corresponding to the BEst Antenna Configuration.
    */
   ANTENNA_CONFIGURATION GetBestAntennaConfiguration (const Mac48Address stationAddress, bool isTxConfiguration, double &maxSnr);
+  /**
+   * Update the highest SNR of a station after mapping a new SNR value. The SNR table is only scanned again
+   * when the SNR of the current best antenna configuration drops.
+   * \param best The highest SNR of the station.
+   * \param snrMap The SNR table the new value has been mapped to.
+   * \param config The antenna configuration of the new value.
+   * \param snr The new SNR value.
+   */
+  void UpdateBestSnr (BEST_SNR &best, const SNR_MAP &snrMap, ANTENNA_CONFIGURATION_COMBINATION config, double snr);
   /**
    * Update Best Tx AWV ID towards specific station.
    * \param stationAddress The MAC address of the peer station.
@@ -1393,6 +1495,14 @@ protected:
    * \param hdr the header of the packet that we successfully sent
    */
   virtual void TxOk (Ptr<const Packet> packet, const WifiMacHeader &hdr);
+  /**
+   * Change the current operational frequency band, and report the transfer
+   * to the FST policy.
+   * \param peerStation The MAC address of the peer station.
+   * \param bandId The ID of the new band.
+   * \param isInitiator True is we are the initiator of the FST, otherwise false.
+   */
+  virtual void ChangeBand (Mac48Address peerStation, BandID bandId, bool isInitiator);
   /**
    * Get frame Duration in microseconds.
    * \param duration The duration of the frame in nanoseconds.
@@ -1414,6 +1524,7 @@ protected:
 
 protected:
   STATION_SNR_PAIR_MAP m_stationSnrMap;                   //!< Map between peer stations and their SNR Table.
+  STATION_BEST_SNR_MAP m_bestSnrMap;                      //!< Map between peer stations and the highest SNR in their SNR Table.
   STATION_ANTENNA_CONFIG_MAP m_bestAntennaConfig;         //!< Map between peer stations and the best antenna configuration.
   STATION_AWV_MAP m_bestAwvConfig;                        //!< Map between peer stations and the best AWV - to be used together with m_bestAntennaConfig.
   ANTENNA_CONFIGURATION m_feedbackAntennaConfig;          //!< Temporary variable to save the best antenna configuration of the peer station.
@@ -1568,6 +1679,14 @@ protected:
   bool m_antennaPatternReciprocity;             //!< Flag to indicate whether the STA supports antenna pattern reciprocity.
   bool m_performingBFT;                         //!< Flag to indicate whether we are performing BFT.
   bool m_useRxSectors;                          //!< Flag to indicate whether to use Rx beamforming sectors in the station operation.
+  bool m_fastSectorSweep;                       //!< Flag to indicate whether TXSS in SPs is evaluated through the Q-D propagation engine.
+  STATION_SECTOR_SWEEP_SNR_MAP m_fastSectorSweepSnrMap; //!< SNR values of the fast TXSS performed by the peer stations.
+  std::map<Mac48Address, EventId> m_fastSectorSweepTimeouts; //!< Events discarding the SNR values of the fast TXSS.
+  bool m_beamformingCache;                      //!< Flag to indicate whether to shorten repeated TXSS using cached results.
+  uint8_t m_beamformingCacheSectors;            //!< The number of sectors swept on each side of the cached best sector.
+  BEAMFORMING_CACHE m_beamformingCacheMap;      //!< Cached results of the previous TXSS with each peer station.
+  bool m_hierarchicalSectorSweep;               //!< Flag to indicate whether TXSS searches the sector hierarchy of the codebook.
+  HIERARCHICAL_SWEEP_MAP m_hierarchicalSweepMap; //!< Wide sectors waiting to be refined with each peer station.
 
   //// NINA ////
   /* EDMG Beamforming variables */
@@ -1792,6 +1911,42 @@ protected:
   TracedCallback<Mac48Address, uint16_t> m_assocLogger; //!< Trace callback when a station associates.
   TracedCallback<Mac48Address> m_deAssocLogger;         //!< Trace callback when a station deassociates.
 
+  /* Automatic Fast Session Transfer */
+  /**
+   * State of the DMG link with a peer station monitored by the FST policy.
+   */
+  struct FstLinkState
+  {
+    FstLinkState ();
+    uint32_t failedMpdus;   //!< Number of consecutive MPDUs dropped towards the peer station.
+    Time firstFailure;      //!< Time at which the first of the consecutive MPDUs has been dropped.
+    bool setupRequested;    //!< Flag to indicate whether an FST session has been requested.
+    Time setupTime;         //!< Time at which the FST session has been requested.
+    bool degraded;          //!< Flag to indicate whether a degradation of the link has been detected.
+    Time degradedSince;     //!< Time at which the degradation of the link has been detected.
+  };
+  typedef std::map<Mac48Address, FstLinkState> FstLinkStateMap;
+  bool m_automaticFst;                      //!< Flag to indicate whether the FST policy is enabled.
+  Time m_fstPolicyInterval;                 //!< Interval between two evaluations of the DMG links.
+  double m_fstSetupSnrThreshold;            //!< Link SNR (dB) below which an FST session is set up.
+  double m_fstSwitchSnrThreshold;           //!< Link SNR (dB) below which the session is transferred.
+  uint32_t m_fstMaxFailedMpdus;             //!< Number of consecutive dropped MPDUs before the session is transferred.
+  uint32_t m_fstMaxMissedBeacons;           //!< Number of missed DMG Beacons before the session is transferred.
+  FstLinkStateMap m_fstLinks;               //!< State of the monitored DMG links.
+  Time m_fstLastBeacon;                     //!< Arrival time of the last DMG Beacon from the DMG PCP/AP.
+  EventId m_fstPolicyEvent;                 //!< Event for the next evaluation of the DMG links.
+  /**
+   * TracedCallback signature for session transfer events.
+   *
+   * \param address The MAC address of the peer station.
+   * \param newBand The ID of the band the session has been transferred to.
+   * \param latency The time elapsed since the degradation of the DMG link was detected, or
+   * since the FST session was requested if no degradation was detected. Zero if the transfer
+   * was not requested by the FST policy.
+   */
+  typedef void (* FstSwitchTracedCallback)(Mac48Address address, BandID newBand, Time latency);
+  TracedCallback<Mac48Address, BandID, Time> m_fstSwitchTrace; //!< Session transfer trace callback.
+
   /* EMDG MIMO Variables */
   Ptr<EDMGGroupIDSetElement> m_edmgGroupIdSetElement;
   EDMGGroupTuple m_edmgMuGroup; //!< The MU group which is currently being trained in MU-MIMO BFT training.
@@ -1807,6 +1962,46 @@ private:
    * \param hdr The header of the management frame.
    */
   void ManagementTxOk (const WifiMacHeader &hdr);
+  /**
+   * Connect the FST policy to the traces of the station manager and start
+   * the periodic evaluation of the DMG links.
+   */
+  void StartFstPolicy (void);
+  /**
+   * Evaluate the quality of the monitored DMG links and set up or execute
+   * FST sessions accordingly.
+   */
+  void EvaluateFstPolicy (void);
+  /**
+   * Notify the FST policy that an MPDU has been transmitted successfully.
+   * \param address The MAC address of the peer station.
+   */
+  void FstTxOk (Mac48Address address);
+  /**
+   * Notify the FST policy that an MPDU has been dropped after the last retransmission.
+   * \param address The MAC address of the peer station.
+   */
+  void FstTxFinalDataFailed (Mac48Address address);
+  /**
+   * Notify the FST policy that a DMG Beacon has been received from the DMG PCP/AP.
+   * \param oldValue The arrival time of the previous DMG Beacon.
+   * \param newValue The arrival time of the current DMG Beacon.
+   */
+  void FstBeaconArrival (Time oldValue, Time newValue);
+  /**
+   * Request an FST session with a peer station on behalf of the FST policy.
+   * \param address The MAC address of the peer station.
+   */
+  void RequestFstSession (Mac48Address address);
+  /**
+   * Record that the DMG link with the given peer station is degraded and
+   * transfer the session to the other band. If no FST session has been set up
+   * with the peer station yet, the FST session is requested and the transfer is
+   * retried at the next evaluation of the DMG links.
+   * \param address The MAC address of the peer station.
+   * \param degradedSince The time at which the degradation started.
+   */
+  void TransferSession (Mac48Address address, Time degradedSince);
   //// NINA ////
   /**
    * Report SNR Value, this is a callback to be hooked with DmgWifiPhy class.
@@ -36,6 +36,7 @@
 #include "wifi-radio-energy-model.h"
 #include "error-rate-model.h"
 #include "wifi-net-device.h"
+#include "dmg-profiler.h"
 #include "mpdu-aggregator.h"
 #include "wifi-psdu.h"
 #include "wifi-ppdu.h"
@@ -1696,6 +1697,7 @@ void
 DmgWifiPhy::StartReceivePreamble (Ptr<WifiPpdu> ppdu, std::vector<double> rxPowerList)
 {
   NS_LOG_FUNCTION (this << *ppdu);
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_PHY_START_RECEIVE_PREAMBLE);
   WifiTxVector txVector = ppdu->GetTxVector ();
   Time rxDuration = ppdu->GetTxDuration ();
   Ptr<const WifiPsdu> psdu = ppdu->GetPsdu ();
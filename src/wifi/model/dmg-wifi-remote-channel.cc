@@ -0,0 +1,449 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/nstime.h"
+#include "ns3/header.h"
+#include "ns3/address-utils.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#include "dmg-wifi-remote-channel.h"
+#include "wifi-ppdu.h"
+#include "wifi-psdu.h"
+#include "wifi-mac-queue-item.h"
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DmgWifiRemoteChannel");
+
+/**
+ * \ingroup wifi
+ *
+ * The header of a PPDU forwarded to another rank: everything the
+ * receiving rank needs to rebuild the PPDU and to compute its received
+ * power, except the MPDUs, which follow the header.
+ */
+class DmgWifiRemoteTxHeader : public Header
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  uint32_t m_senderNode;            //!< ID of the node of the sender.
+  uint8_t m_channelNumber;          //!< Channel number of the sender.
+  double m_txPowerDbm;              //!< Transmit power in dBm.
+  double m_txGainDbi;               //!< Transmit antenna gain towards the receiver in dBi.
+  Time m_ppduDuration;              //!< Duration of the PPDU.
+  uint16_t m_frequency;             //!< Frequency of the sender in MHz.
+  WifiTxVector m_txVector;          //!< TXVECTOR of the PPDU.
+  bool m_isSingle;                  //!< Whether the PSDU is an S-MPDU.
+  bool m_isShortSsw;                //!< Whether the PSDU is a Short SSW frame, without MAC header.
+  std::vector<uint32_t> m_mpduSizes; //!< Size of each MPDU, MAC header included.
+};
+
+NS_OBJECT_ENSURE_REGISTERED (DmgWifiRemoteTxHeader);
+
+static void
+WriteDouble (Buffer::Iterator &i, double value)
+{
+  uint64_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  i.WriteHtonU64 (bits);
+}
+
+static double
+ReadDouble (Buffer::Iterator &i)
+{
+  uint64_t bits = i.ReadNtohU64 ();
+  double value;
+  std::memcpy (&value, &bits, sizeof (value));
+  return value;
+}
+
+TypeId
+DmgWifiRemoteTxHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DmgWifiRemoteTxHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<DmgWifiRemoteTxHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+DmgWifiRemoteTxHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+DmgWifiRemoteTxHeader::Print (std::ostream &os) const
+{
+  os << "sender=" << m_senderNode
+     << ", channel=" << +m_channelNumber
+     << ", txPower=" << m_txPowerDbm
+     << ", Gtx=" << m_txGainDbi
+     << ", duration=" << m_ppduDuration
+     << ", mpdus=" << m_mpduSizes.size ();
+}
+
+uint32_t
+DmgWifiRemoteTxHeader::GetSerializedSize (void) const
+{
+  return 4 + 1 + 8 + 8 + 8 + 2
+         + 1 + m_txVector.GetMode ().GetUniqueName ().size () /* Mode */
+         + 1 + 6 + 8 + 1 + 2                                  /* Preamble, sender, TRN subfield duration, power level, width */
+         + 20                                                 /* DMG and EDMG fields */
+         + 1 + 1 + 2 + 4 * m_mpduSizes.size ();
+}
+
+void
+DmgWifiRemoteTxHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU32 (m_senderNode);
+  i.WriteU8 (m_channelNumber);
+  WriteDouble (i, m_txPowerDbm);
+  WriteDouble (i, m_txGainDbi);
+  i.WriteHtonU64 (m_ppduDuration.GetNanoSeconds ());
+  i.WriteHtonU16 (m_frequency);
+
+  std::string mode = m_txVector.GetMode ().GetUniqueName ();
+  i.WriteU8 (mode.size ());
+  i.Write (reinterpret_cast<const uint8_t *> (mode.data ()), mode.size ());
+  i.WriteU8 (m_txVector.GetPreambleType ());
+  WriteTo (i, m_txVector.GetSender ());
+  i.WriteHtonU64 (m_txVector.edmgTrnSubfieldDuration.GetNanoSeconds ());
+  i.WriteU8 (m_txVector.GetTxPowerLevel ());
+  i.WriteHtonU16 (m_txVector.GetChannelWidth ());
+
+  i.WriteU8 (m_txVector.GetTrainngFieldLength ());
+  i.WriteU8 (m_txVector.GetPacketType ());
+  i.WriteU8 (m_txVector.IsAggregation ());
+  i.WriteU8 (m_txVector.IsBeamTrackingRequested ());
+  i.WriteU8 (m_txVector.GetLastRssi ());
+  i.WriteU8 (m_txVector.IsControlTrailerPresent ());
+  i.WriteU8 (m_txVector.GetPrimaryChannelNumber ());
+  i.WriteU8 (m_txVector.GetChBandwidth ());
+  i.WriteU8 (m_txVector.GetEDMGTrainingFieldLength ());
+  i.WriteU8 (m_txVector.IsDMGBeacon ());
+  i.WriteU8 (m_txVector.GetBrpCdown ());
+  i.WriteU8 (m_txVector.Get_RxPerTxUnits ());
+  i.WriteU8 (m_txVector.Get_EDMG_TRN_P ());
+  i.WriteU8 (m_txVector.Get_EDMG_TRN_M ());
+  i.WriteU8 (m_txVector.Get_EDMG_TRN_N ());
+  i.WriteU8 (m_txVector.Get_TRN_SEQ_LEN ());
+  i.WriteU8 (m_txVector.GetNumberOfTxChains ());
+  i.WriteU8 (m_txVector.Get_NUM_STS ());
+  i.WriteU8 (m_txVector.GetTrnRxPattern ());
+  i.WriteU8 (m_txVector.GetNss ());
+
+  i.WriteU8 (m_isSingle);
+  i.WriteU8 (m_isShortSsw);
+  i.WriteHtonU16 (m_mpduSizes.size ());
+  for (auto size : m_mpduSizes)
+    {
+      i.WriteHtonU32 (size);
+    }
+}
+
+uint32_t
+DmgWifiRemoteTxHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_senderNode = i.ReadNtohU32 ();
+  m_channelNumber = i.ReadU8 ();
+  m_txPowerDbm = ReadDouble (i);
+  m_txGainDbi = ReadDouble (i);
+  m_ppduDuration = NanoSeconds (i.ReadNtohU64 ());
+  m_frequency = i.ReadNtohU16 ();
+
+  std::string mode (i.ReadU8 (), '\0');
+  i.Read (reinterpret_cast<uint8_t *> (&mode[0]), mode.size ());
+  m_txVector = WifiTxVector ();
+  m_txVector.SetMode (WifiMode (mode));
+  m_txVector.SetPreambleType (static_cast<WifiPreamble> (i.ReadU8 ()));
+  Mac48Address sender;
+  ReadFrom (i, sender);
+  m_txVector.SetSender (sender);
+  m_txVector.edmgTrnSubfieldDuration = NanoSeconds (i.ReadNtohU64 ());
+  m_txVector.SetTxPowerLevel (i.ReadU8 ());
+  m_txVector.SetChannelWidth (i.ReadNtohU16 ());
+
+  m_txVector.SetTrainngFieldLength (i.ReadU8 ());
+  m_txVector.SetPacketType (static_cast<PacketType> (i.ReadU8 ()));
+  m_txVector.SetAggregation (i.ReadU8 ());
+  if (i.ReadU8 ())
+    {
+      m_txVector.RequestBeamTracking ();
+    }
+  m_txVector.SetLastRssi (i.ReadU8 ());
+  m_txVector.SetControlTrailerPresent (i.ReadU8 ());
+  uint8_t primaryChannel = i.ReadU8 ();
+  uint8_t chBandwidth = i.ReadU8 ();
+  WifiModulationClass modulation = m_txVector.GetMode ().GetModulationClass ();
+  if ((modulation == WIFI_MOD_CLASS_EDMG_CTRL) || (modulation == WIFI_MOD_CLASS_EDMG_SC)
+      || (modulation == WIFI_MOD_CLASS_EDMG_OFDM))
+    {
+      m_txVector.SetChannelConfiguration (primaryChannel, chBandwidth);
+    }
+  m_txVector.SetEDMGTrainingFieldLength (i.ReadU8 ());
+  m_txVector.SetDMGBeacon (i.ReadU8 ());
+  m_txVector.SetBrpCdown (i.ReadU8 ());
+  m_txVector.Set_RxPerTxUnits (i.ReadU8 ());
+  m_txVector.Set_EDMG_TRN_P (i.ReadU8 ());
+  m_txVector.Set_EDMG_TRN_M (i.ReadU8 ());
+  m_txVector.Set_EDMG_TRN_N (i.ReadU8 ());
+  m_txVector.Set_TRN_SEQ_LEN (static_cast<TRN_SEQ_LENGTH> (i.ReadU8 ()));
+  m_txVector.SetNumberOfTxChains (i.ReadU8 ());
+  m_txVector.Set_NUM_STS (i.ReadU8 ());
+  m_txVector.SetTrnRxPattern (static_cast<rxPattern> (i.ReadU8 ()));
+  m_txVector.SetNss (i.ReadU8 ());
+
+  m_isSingle = i.ReadU8 ();
+  m_isShortSsw = i.ReadU8 ();
+  m_mpduSizes.resize (i.ReadNtohU16 ());
+  for (auto &size : m_mpduSizes)
+    {
+      size = i.ReadNtohU32 ();
+    }
+  return i.GetDistanceFrom (start);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (DmgWifiRemoteChannel);
+
+TypeId
+DmgWifiRemoteChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DmgWifiRemoteChannel")
+    .SetParent<DmgWifiChannel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<DmgWifiRemoteChannel> ()
+    .AddAttribute ("Delay",
+                   "The minimum propagation delay between a PHY of this rank and a PHY of "
+                   "another rank. The distributed simulators use it as lookahead.",
+                   TimeValue (NanoSeconds (1)),
+                   MakeTimeAccessor (&DmgWifiRemoteChannel::m_lookahead),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("MaxRemoteRange",
+                   "The distance in meters beyond which a PPDU is not forwarded to the PHYs "
+                   "of the other ranks. Zero forwards every PPDU.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&DmgWifiRemoteChannel::m_maxRemoteRange),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+DmgWifiRemoteChannel::DmgWifiRemoteChannel ()
+  : DmgWifiChannel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DmgWifiRemoteChannel::~DmgWifiRemoteChannel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+DmgWifiRemoteChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_remoteDevices.clear ();
+  DmgWifiChannel::DoDispose ();
+}
+
+std::size_t
+DmgWifiRemoteChannel::GetNDevices (void) const
+{
+  return m_phyList.size () + m_remoteDevices.size ();
+}
+
+Ptr<NetDevice>
+DmgWifiRemoteChannel::GetDevice (std::size_t i) const
+{
+  if (i < m_phyList.size ())
+    {
+      return DmgWifiChannel::GetDevice (i);
+    }
+  return m_remoteDevices[i - m_phyList.size ()];
+}
+
+std::size_t
+DmgWifiRemoteChannel::GetNRemoteDevices (void) const
+{
+  return m_remoteDevices.size ();
+}
+
+void
+DmgWifiRemoteChannel::AddRemote (Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  NS_ASSERT (device->GetNode () != 0);
+  m_remoteDevices.push_back (device);
+}
+
+void
+DmgWifiRemoteChannel::EnableMpiReceive (Ptr<DmgWifiPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  Ptr<MpiReceiver> mpiRec = CreateObject<MpiReceiver> ();
+  /* The PHY keeps the channel alive, so the device must not hold a reference to it */
+  mpiRec->SetReceiveCallback (MakeBoundCallback (&DmgWifiRemoteChannel::MpiReceive, this, phy));
+  phy->GetDevice ()->AggregateObject (mpiRec);
+}
+
+void
+DmgWifiRemoteChannel::Send (Ptr<DmgWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const
+{
+  NS_LOG_FUNCTION (this << sender << ppdu << txPowerDbm);
+  DmgWifiChannel::Send (sender, ppdu, txPowerDbm);
+  if (m_remoteDevices.empty ())
+    {
+      return;
+    }
+
+#ifdef NS3_MPI
+  Ptr<MobilityModel> senderMobility = sender->GetMobility ();
+  NS_ASSERT (senderMobility != 0);
+  Vector senderPosition = senderMobility->GetPosition ();
+  Ptr<const WifiPsdu> psdu = ppdu->GetPsdu ();
+
+  DmgWifiRemoteTxHeader header;
+  header.m_senderNode = sender->GetDevice ()->GetNode ()->GetId ();
+  header.m_channelNumber = sender->GetChannelNumber ();
+  header.m_txPowerDbm = txPowerDbm;
+  header.m_ppduDuration = ppdu->GetTxDuration ();
+  header.m_frequency = sender->GetFrequency ();
+  header.m_txVector = ppdu->GetTxVector ();
+  header.m_isSingle = psdu->IsSingle ();
+  header.m_isShortSsw = psdu->IsShortSSW ();
+
+  /* The MPDUs are serialized once and shared by the messages to all the ranks */
+  Ptr<Packet> mpdus = Create<Packet> ();
+  for (auto it = psdu->begin (); it != psdu->end (); ++it)
+    {
+      Ptr<Packet> mpdu = (*it)->GetPacket ()->Copy ();
+      if (!header.m_isShortSsw)
+        {
+          mpdu->AddHeader ((*it)->GetHeader ());
+        }
+      header.m_mpduSizes.push_back (mpdu->GetSize ());
+      mpdus->AddAtEnd (mpdu);
+    }
+
+  for (auto device : m_remoteDevices)
+    {
+      Ptr<MobilityModel> receiverMobility = device->GetNode ()->GetObject<MobilityModel> ();
+      NS_ASSERT (receiverMobility != 0);
+      if ((m_maxRemoteRange > 0) && (senderMobility->GetDistanceFrom (receiverMobility) > m_maxRemoteRange))
+        {
+          continue;
+        }
+      Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      NS_ABORT_MSG_IF (delay < m_lookahead, "Propagation delay " << delay << " towards node "
+                       << device->GetNode ()->GetId () << " is shorter than the lookahead " << m_lookahead);
+      double azimuthTx = CalculateAzimuthAngle (senderPosition, receiverMobility->GetPosition ());
+      header.m_txGainDbi = sender->GetCodebook ()->GetTxGainDbi (azimuthTx);
+
+      Ptr<Packet> message = mpdus->Copy ();
+      message->AddHeader (header);
+      MpiInterface::SendPacket (message, Simulator::Now () + delay,
+                                device->GetNode ()->GetId (), device->GetIfIndex ());
+    }
+#else
+  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
+#endif
+}
+
+void
+DmgWifiRemoteChannel::MpiReceive (DmgWifiRemoteChannel *channel, Ptr<DmgWifiPhy> receiver, Ptr<Packet> message)
+{
+  channel->ReceiveFromRank (receiver, message);
+}
+
+void
+DmgWifiRemoteChannel::ReceiveFromRank (Ptr<DmgWifiPhy> receiver, Ptr<Packet> message) const
+{
+  NS_LOG_FUNCTION (this << receiver << message);
+  DmgWifiRemoteTxHeader header;
+  message->RemoveHeader (header);
+  if (header.m_channelNumber != receiver->GetChannelNumber ())
+    {
+      return;
+    }
+
+  std::vector<Ptr<WifiMacQueueItem>> mpduList;
+  uint32_t offset = 0;
+  for (auto size : header.m_mpduSizes)
+    {
+      Ptr<Packet> mpdu = message->CreateFragment (offset, size);
+      offset += size;
+      if (header.m_isShortSsw)
+        {
+          mpduList.push_back (Create<WifiMacQueueItem> (mpdu));
+        }
+      else
+        {
+          WifiMacHeader macHeader;
+          mpdu->RemoveHeader (macHeader);
+          mpduList.push_back (Create<WifiMacQueueItem> (mpdu, macHeader));
+        }
+    }
+  Ptr<WifiPsdu> psdu;
+  if (mpduList.size () == 1)
+    {
+      psdu = Create<WifiPsdu> (mpduList.front (), header.m_isSingle);
+    }
+  else
+    {
+      psdu = Create<WifiPsdu> (mpduList);
+    }
+  Ptr<WifiPpdu> ppdu = Create<WifiPpdu> (psdu, header.m_txVector, header.m_ppduDuration, header.m_frequency);
+
+  Ptr<MobilityModel> senderMobility = NodeList::GetNode (header.m_senderNode)->GetObject<MobilityModel> ();
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ();
+  NS_ASSERT ((senderMobility != 0) && (receiverMobility != 0));
+  /* Unlike in DmgWifiChannel::Send, the receive antenna gain is evaluated upon arrival, and the blockage and
+   * the packet dropper do not apply, see the class documentation */
+  double azimuthRx = CalculateAzimuthAngle (receiverMobility->GetPosition (), senderMobility->GetPosition ());
+  double rxPowerDbm = m_loss->CalcRxPower (header.m_txPowerDbm, senderMobility, receiverMobility)
+                      + header.m_txGainDbi                                        // Sender's antenna gain.
+                      + receiver->GetCodebook ()->GetRxGainDbi (azimuthRx);       // Receiver's antenna gain.
+  NS_LOG_DEBUG ("PPDU from node " << header.m_senderNode << " of another rank, rxPower=" << rxPowerDbm << "dbm");
+  Receive (receiver, ppdu, rxPowerDbm);
+}
+
+} //namespace ns3
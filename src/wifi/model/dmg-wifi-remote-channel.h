@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DMG_WIFI_REMOTE_CHANNEL_H
+#define DMG_WIFI_REMOTE_CHANNEL_H
+
+#include "dmg-wifi-channel.h"
+
+namespace ns3 {
+
+/**
+ * \brief a DMG channel whose PHYs are spread over several MPI ranks.
+ * \ingroup wifi
+ *
+ * Each rank only holds the DmgWifiPhy objects of its own nodes. The PHYs
+ * of the other ranks are represented by proxy devices installed on the
+ * remote nodes (see DmgWifiPartitionHelper), which only provide the node,
+ * and therefore its mobility model, and the interface index of the real
+ * device on its rank.
+ *
+ * A PPDU sent by a local PHY is delivered to the local PHYs as in
+ * DmgWifiChannel and forwarded through MpiInterface to every proxy in
+ * range. The sender computes the propagation delay and its transmit
+ * antenna gain towards the remote node; the receiving rank adds the
+ * propagation loss and its receive antenna gain. TRN subfields are not
+ * forwarded, so beamforming training cannot span two ranks.
+ *
+ * A forwarded PPDU differs from a local one in two ways. First, the
+ * receive antenna gain is evaluated when the PPDU reaches the remote
+ * PHY, with the receive pattern of its codebook at that time, whereas
+ * DmgWifiChannel evaluates it when the PPDU is sent. The two only differ
+ * if the receiver switches its pattern during the propagation delay.
+ * Second, the blockage, the packet dropper and the experimental mode of
+ * DmgWifiChannel are configured with the PHYs of one rank, so they only
+ * apply between two PHYs of the same rank, and the PHY activity of a
+ * forwarded PPDU is not recorded.
+ *
+ * The "Delay" attribute is the lookahead of the distributed simulators:
+ * it must not exceed the propagation delay between any two PHYs located
+ * on different ranks.
+ */
+class DmgWifiRemoteChannel : public DmgWifiChannel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  DmgWifiRemoteChannel ();
+  virtual ~DmgWifiRemoteChannel ();
+
+  //inherited from Channel.
+  virtual std::size_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
+
+  /**
+   * Add the proxy of a DMG device located on another rank.
+   *
+   * \param device the proxy device, installed on the remote node with
+   *        the same interface index as the real device on its rank.
+   */
+  void AddRemote (Ptr<NetDevice> device);
+  /**
+   * Let the given local PHY receive the PPDUs forwarded by the other
+   * ranks. This aggregates an MpiReceiver to the device of the PHY.
+   *
+   * \param phy the local DmgWifiPhy attached to this channel.
+   */
+  void EnableMpiReceive (Ptr<DmgWifiPhy> phy);
+  /**
+   * \return the number of PHYs of other ranks attached to this channel.
+   */
+  std::size_t GetNRemoteDevices (void) const;
+
+  virtual void Send (Ptr<DmgWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * Called by the MpiReceiver of a local device when a PPDU forwarded by
+   * another rank reaches it.
+   *
+   * \param channel the channel the PPDU was sent on.
+   * \param receiver the local PHY.
+   * \param message the forwarded PPDU.
+   */
+  static void MpiReceive (DmgWifiRemoteChannel *channel, Ptr<DmgWifiPhy> receiver, Ptr<Packet> message);
+  /**
+   * Rebuild a forwarded PPDU and start its reception.
+   *
+   * \param receiver the local PHY.
+   * \param message the forwarded PPDU.
+   */
+  void ReceiveFromRank (Ptr<DmgWifiPhy> receiver, Ptr<Packet> message) const;
+
+  std::vector<Ptr<NetDevice> > m_remoteDevices;   //!< Proxies of the DMG devices of the other ranks.
+  Time m_lookahead;                               //!< Minimum propagation delay towards another rank.
+  double m_maxRemoteRange;                        //!< Distance beyond which PPDUs are not forwarded (0 for no limit).
+};
+
+} //namespace ns3
+
+#endif /* DMG_WIFI_REMOTE_CHANNEL_H */
@@ -933,6 +933,22 @@ BF_Control_Field::Serialize (Buffer::Iterator start) const
 {
   NS_LOG_FUNCTION (this << &start);
   Buffer::Iterator i = start;
+  i.WriteHtolsbU16 (GetBfControl ());
+  return i;
+}
+
+Buffer::Iterator
+BF_Control_Field::Deserialize (Buffer::Iterator start)
+{
+  NS_LOG_FUNCTION (this << &start);
+  Buffer::Iterator i = start;
+  SetBfControl (i.ReadLsbtohU16 ());
+  return i;
+}
+
+uint16_t
+BF_Control_Field::GetBfControl (void) const
+{
   uint16_t value = 0;
 
   /* Common Subfields */
@@ -953,36 +969,28 @@ BF_Control_Field::Serialize (Buffer::Iterator start) const
       value |= ((m_reserved & 0x3F) << 10);
     }
 
-  i.WriteHtolsbU16 (value);
-
-  return i;
+  return value;
 }
 
-Buffer::Iterator
-BF_Control_Field::Deserialize (Buffer::Iterator start)
+void
+BF_Control_Field::SetBfControl (uint16_t value)
 {
-  NS_LOG_FUNCTION (this << &start);
-  Buffer::Iterator i = start;
-  uint8_t value = i.ReadLsbtohU16 ();
-
   m_beamformTraining = value & 0x1;
   m_isInitiatorTXSS = ((value >> 1) & 0x1);
   m_isResponderTXSS = ((value >> 2) & 0x1);
 
   if (m_isInitiatorTXSS && m_isResponderTXSS)
     {
-      m_sectors |= ((value >> 3) & 0x7F);
-      m_antennas |= ((value >> 10) & 0x3);
-      m_reserved |= ((value >> 12) & 0xF);
+      m_sectors = ((value >> 3) & 0x7F);
+      m_antennas = ((value >> 10) & 0x3);
+      m_reserved = ((value >> 12) & 0xF);
     }
   else
     {
-      m_rxssLength |= ((value >> 3) & 0x3F);
-      m_rxssTXRate |= ((value >> 9) & 0x1);
-      m_reserved |= ((value >> 10) & 0x3F);
+      m_rxssLength = ((value >> 3) & 0x3F);
+      m_rxssTXRate = ((value >> 9) & 0x1);
+      m_reserved = ((value >> 10) & 0x3F);
     }
-
-  return i;
 }
 
 void
@@ -378,6 +378,17 @@ public:
   uint8_t GetRXSSLength (void) const;
   bool GetRXSSTxRate (void) const;
 
+  /**
+   * Get the value of the BF Control field as transmitted over the air.
+   * \return the 16 bits of the BF Control field.
+   */
+  uint16_t GetBfControl (void) const;
+  /**
+   * Set the subfields of the BF Control field from the value transmitted over the air.
+   * \param value the 16 bits of the BF Control field.
+   */
+  void SetBfControl (uint16_t value);
+
 private:
   bool m_beamformTraining;
   bool m_isInitiatorTXSS;
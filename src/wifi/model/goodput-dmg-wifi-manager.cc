@@ -0,0 +1,335 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "goodput-dmg-wifi-manager.h"
+#include "error-rate-model.h"
+#include "wifi-phy.h"
+#include "wifi-utils.h"
+
+namespace ns3 {
+
+/**
+ * \brief hold per-remote-station state for the Goodput DMG Wifi manager.
+ *
+ * This struct extends from WifiRemoteStation struct to hold additional
+ * information required by the Goodput DMG Wifi manager
+ */
+struct GoodputDmgWifiRemoteStation : public WifiRemoteStation
+{
+  bool m_hasSnr;             //!< Whether at least one SNR sample has been received.
+  double m_snr;              //!< Moving average of the SNR in dB.
+  double m_lastLinkSnr;      //!< Link SNR (from beamforming training) most recently averaged.
+  uint32_t m_lastSnrIndex;   //!< SNR grid point most recently used to select a rate.
+  uint8_t m_nSupportedModes; //!< Number of supported modes when a rate was last selected.
+  WifiMode m_lastMode;       //!< Mode most recently used to the remote station.
+};
+
+NS_OBJECT_ENSURE_REGISTERED (GoodputDmgWifiManager);
+
+NS_LOG_COMPONENT_DEFINE ("GoodputDmgWifiManager");
+
+TypeId
+GoodputDmgWifiManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::GoodputDmgWifiManager")
+    .SetParent<WifiRemoteStationManager> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<GoodputDmgWifiManager> ()
+    .AddAttribute ("EwmaWeight",
+                   "The weight of the newest SNR sample in the moving average of the SNR",
+                   DoubleValue (0.25),
+                   MakeDoubleAccessor (&GoodputDmgWifiManager::m_ewmaWeight),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("SnrMargin",
+                   "The margin (in dB) subtracted from the average SNR before selecting the mode",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&GoodputDmgWifiManager::m_snrMargin),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MpduLength",
+                   "The MPDU length (in bytes) used to compute the packet error rate",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&GoodputDmgWifiManager::m_mpduLength),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MinSnr",
+                   "The lowest SNR (in dB) for which the expected goodput is computed",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&GoodputDmgWifiManager::m_minSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The highest SNR (in dB) for which the expected goodput is computed",
+                   DoubleValue (40.0),
+                   MakeDoubleAccessor (&GoodputDmgWifiManager::m_maxSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrStep",
+                   "The spacing (in dB) between the SNR values for which the expected goodput is computed",
+                   DoubleValue (0.25),
+                   MakeDoubleAccessor (&GoodputDmgWifiManager::m_snrStep),
+                   MakeDoubleChecker<double> (0.01))
+    .AddTraceSource ("Rate",
+                     "Traced value for MCS changes",
+                     MakeTraceSourceAccessor (&GoodputDmgWifiManager::m_mcsChanged),
+                     "ns3::GoodputDmgWifiManager::McsChangedTracedCallback")
+  ;
+  return tid;
+}
+
+GoodputDmgWifiManager::GoodputDmgWifiManager ()
+  : m_nSnrPoints (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+GoodputDmgWifiManager::~GoodputDmgWifiManager ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+GoodputDmgWifiManager::DoInitialize ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_maxSnr < m_minSnr, "The highest SNR must not be lower than the lowest SNR");
+  Ptr<ErrorRateModel> errorRateModel = GetPhy ()->GetErrorRateModel ();
+  NS_ABORT_MSG_IF (errorRateModel == 0, "The PHY has no error rate model");
+  m_nSnrPoints = static_cast<uint32_t> (std::floor ((m_maxSnr - m_minSnr) / m_snrStep)) + 1;
+  m_goodput.clear ();
+  WifiMode mode;
+  WifiTxVector txVector;
+  uint8_t nModes = GetPhy ()->GetNModes ();
+  for (uint8_t i = 1; i < nModes; i++)
+    {
+      mode = GetPhy ()->GetMode (i);
+      WifiModulationClass modulation = mode.GetModulationClass ();
+      if (modulation != WIFI_MOD_CLASS_DMG_SC && modulation != WIFI_MOD_CLASS_DMG_OFDM
+          && modulation != WIFI_MOD_CLASS_EDMG_SC && modulation != WIFI_MOD_CLASS_EDMG_OFDM)
+        {
+          continue;
+        }
+      txVector.SetChannelWidth (GetPhy ()->GetChannelWidth ());
+      txVector.SetMode (mode);
+      NS_LOG_DEBUG ("Initialize, adding mode = " << mode.GetUniqueName ());
+      GoodputTable &goodput = m_goodput[mode.GetUid ()];
+      goodput.resize (m_nSnrPoints);
+      for (uint32_t j = 0; j < m_nSnrPoints; j++)
+        {
+          double snr = DbToRatio (m_minSnr + j * m_snrStep);
+          double psr = errorRateModel->GetChunkSuccessRate (mode, txVector, snr, 8 * static_cast<uint64_t> (m_mpduLength));
+          goodput[j] = psr * mode.GetDmgDataRate ();
+        }
+    }
+}
+
+WifiRemoteStation *
+GoodputDmgWifiManager::DoCreateStation (void) const
+{
+  NS_LOG_FUNCTION (this);
+  GoodputDmgWifiRemoteStation *station = new GoodputDmgWifiRemoteStation ();
+  station->m_hasSnr = false;
+  station->m_snr = 0;
+  station->m_lastLinkSnr = NO_LINK_SNR;
+  station->m_lastSnrIndex = 0;
+  station->m_nSupportedModes = 0;
+  station->m_lastMode = GetDefaultMode ();
+  return station;
+}
+
+void
+GoodputDmgWifiManager::UpdateSnr (WifiRemoteStation *st, double snr)
+{
+  NS_LOG_FUNCTION (this << st << snr);
+  GoodputDmgWifiRemoteStation *station = static_cast<GoodputDmgWifiRemoteStation*> (st);
+  if (!station->m_hasSnr)
+    {
+      station->m_snr = snr;
+      station->m_hasSnr = true;
+    }
+  else
+    {
+      station->m_snr = (1 - m_ewmaWeight) * station->m_snr + m_ewmaWeight * snr;
+    }
+}
+
+uint32_t
+GoodputDmgWifiManager::GetSnrIndex (double snr) const
+{
+  if (snr <= m_minSnr)
+    {
+      return 0;
+    }
+  uint32_t index = static_cast<uint32_t> (std::floor ((snr - m_minSnr) / m_snrStep));
+  return std::min (index, m_nSnrPoints - 1);
+}
+
+WifiMode
+GoodputDmgWifiManager::GetBestMode (WifiRemoteStation *station, uint32_t snrIndex) const
+{
+  NS_LOG_FUNCTION (this << station << snrIndex);
+  WifiMode maxMode = GetDefaultMode ();
+  double bestGoodput = 0;
+  for (uint8_t i = 1; i < GetNSupported (station); i++)
+    {
+      WifiMode mode = GetSupported (station, i);
+      std::map<uint32_t, GoodputTable>::const_iterator it = m_goodput.find (mode.GetUid ());
+      if (it == m_goodput.end ())
+        {
+          continue;
+        }
+      double goodput = it->second[snrIndex];
+      if (goodput > bestGoodput)
+        {
+          NS_LOG_DEBUG ("Candidate mode = " << mode.GetUniqueName () <<
+                        " expected goodput " << goodput);
+          bestGoodput = goodput;
+          maxMode = mode;
+        }
+    }
+  return maxMode;
+}
+
+void
+GoodputDmgWifiManager::DoReportRxOk (WifiRemoteStation *station, double rxSnr, WifiMode txMode)
+{
+  NS_LOG_FUNCTION (this << station << rxSnr << txMode);
+}
+
+void
+GoodputDmgWifiManager::DoReportRtsFailed (WifiRemoteStation *station)
+{
+  NS_LOG_FUNCTION (this << station);
+}
+
+void
+GoodputDmgWifiManager::DoReportDataFailed (WifiRemoteStation *station)
+{
+  NS_LOG_FUNCTION (this << station);
+}
+
+void
+GoodputDmgWifiManager::DoReportRtsOk (WifiRemoteStation *st,
+                                      double ctsSnr, WifiMode ctsMode, double rtsSnr)
+{
+  NS_LOG_FUNCTION (this << st << ctsSnr << ctsMode.GetUniqueName () << rtsSnr);
+}
+
+void
+GoodputDmgWifiManager::DoReportDataOk (WifiRemoteStation *st, double ackSnr, WifiMode ackMode,
+                                       double dataSnr, uint16_t dataChannelWidth, uint8_t dataNss)
+{
+  NS_LOG_FUNCTION (this << st << ackSnr << ackMode.GetUniqueName () << dataSnr << dataChannelWidth << +dataNss);
+  if (dataSnr == 0)
+    {
+      NS_LOG_WARN ("DataSnr reported to be zero; not saving this report.");
+      return;
+    }
+  UpdateSnr (st, RatioToDb (dataSnr));
+}
+
+void
+GoodputDmgWifiManager::DoReportAmpduTxStatus (WifiRemoteStation *st, uint8_t nSuccessfulMpdus,
+                                              uint8_t nFailedMpdus, double rxSnr, double dataSnr, uint16_t dataChannelWidth, uint8_t dataNss)
+{
+  NS_LOG_FUNCTION (this << st << +nSuccessfulMpdus << +nFailedMpdus << rxSnr << dataSnr << dataChannelWidth << +dataNss);
+  if (dataSnr == 0)
+    {
+      NS_LOG_WARN ("DataSnr reported to be zero; not saving this report.");
+      return;
+    }
+  UpdateSnr (st, RatioToDb (dataSnr));
+}
+
+void
+GoodputDmgWifiManager::DoReportFinalRtsFailed (WifiRemoteStation *station)
+{
+  NS_LOG_FUNCTION (this << station);
+}
+
+void
+GoodputDmgWifiManager::DoReportFinalDataFailed (WifiRemoteStation *st)
+{
+  NS_LOG_FUNCTION (this << st);
+  GoodputDmgWifiRemoteStation *station = static_cast<GoodputDmgWifiRemoteStation*> (st);
+  // the average SNR is no longer reliable, fall back to the default mode
+  // until a new SNR sample is received
+  station->m_hasSnr = false;
+  station->m_nSupportedModes = 0;
+  if (station->m_lastMode.GetMcsValue () != GetDefaultMode ().GetMcsValue ())
+    {
+      station->m_lastMode = GetDefaultMode ();
+      m_mcsChanged (station->m_state->m_address, GetDefaultMode ().GetMcsValue ());
+    }
+}
+
+WifiTxVector
+GoodputDmgWifiManager::DoGetDataTxVector (WifiRemoteStation *st)
+{
+  NS_LOG_FUNCTION (this << st);
+  GoodputDmgWifiRemoteStation *station = static_cast<GoodputDmgWifiRemoteStation*> (st);
+  if (station->m_state->m_linkSnr != station->m_lastLinkSnr)
+    {
+      // a new beamforming training has been completed
+      station->m_lastLinkSnr = station->m_state->m_linkSnr;
+      if (station->m_lastLinkSnr != NO_LINK_SNR)
+        {
+          UpdateSnr (station, station->m_lastLinkSnr);
+        }
+    }
+  WifiMode maxMode = station->m_lastMode;
+  if (station->m_hasSnr)
+    {
+      uint32_t snrIndex = GetSnrIndex (station->m_snr - m_snrMargin);
+      uint8_t nSupported = GetNSupported (station);
+      if (snrIndex != station->m_lastSnrIndex || nSupported != station->m_nSupportedModes)
+        {
+          maxMode = GetBestMode (station, snrIndex);
+          station->m_lastSnrIndex = snrIndex;
+          station->m_nSupportedModes = nSupported;
+          if (station->m_lastMode.GetMcsValue () != maxMode.GetMcsValue ())
+            {
+              NS_LOG_DEBUG ("New DMG MCS-" << +maxMode.GetMcsValue () << " average SNR " << station->m_snr);
+              station->m_lastMode = maxMode;
+              m_mcsChanged (station->m_state->m_address, maxMode.GetMcsValue ());
+            }
+        }
+    }
+  NS_LOG_DEBUG ("Found maxMode: " << maxMode);
+  return WifiTxVector (maxMode, GetDefaultTxPowerLevel (),
+                       GetPreambleForTransmission (maxMode.GetModulationClass (), false, false),
+                       GetPhy ()->GetChannelWidth (), GetAggregation (station));
+}
+
+WifiTxVector
+GoodputDmgWifiManager::DoGetRtsTxVector (WifiRemoteStation *st)
+{
+  NS_LOG_FUNCTION (this << st);
+  WifiMode mode = GetDefaultMode ();
+  return WifiTxVector (mode, GetDefaultTxPowerLevel (),
+                       GetPreambleForTransmission (mode.GetModulationClass (), false, false),
+                       GetPhy ()->GetChannelWidth (), GetAggregation (st));
+}
+
+bool
+GoodputDmgWifiManager::IsLowLatency (void) const
+{
+  return true;
+}
+
+} //namespace ns3
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef GOODPUT_DMG_WIFI_MANAGER_H
+#define GOODPUT_DMG_WIFI_MANAGER_H
+
+#include <map>
+#include "ns3/traced-value.h"
+#include "wifi-remote-station-manager.h"
+
+namespace ns3 {
+
+/**
+ * \brief Goodput maximizing rate control algorithm for DMG/EDMG stations.
+ * \ingroup wifi
+ *
+ * This class selects, for each remote station, the mode that maximizes the
+ * expected goodput (1 - PER) x data rate, where the packet error rate of an
+ * MPDU of the configured length is obtained from the error rate model of the
+ * PHY (e.g., the SNR to BER tables loaded by DmgErrorModel) rather than from
+ * a hard SNR threshold.
+ *
+ * The SNR of the link is tracked with an exponentially weighted moving
+ * average fed by the SNR measured during beamforming training and by the
+ * data SNR reported with Ack and BlockAck frames. A margin is subtracted from
+ * the average before selecting the mode.
+ *
+ * The expected goodput of every mode is precomputed at initialization over a
+ * grid of SNR values, hence selecting a mode only requires a table lookup
+ * per mode when the quantized SNR changes, and no computation otherwise.
+ */
+class GoodputDmgWifiManager : public WifiRemoteStationManager
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  GoodputDmgWifiManager ();
+  virtual ~GoodputDmgWifiManager ();
+
+private:
+  //overridden from base class
+  void DoInitialize (void);
+  WifiRemoteStation* DoCreateStation (void) const;
+  void DoReportRxOk (WifiRemoteStation *station,
+                     double rxSnr, WifiMode txMode);
+  void DoReportRtsFailed (WifiRemoteStation *station);
+  void DoReportDataFailed (WifiRemoteStation *station);
+  void DoReportRtsOk (WifiRemoteStation *station,
+                      double ctsSnr, WifiMode ctsMode, double rtsSnr);
+  void DoReportDataOk (WifiRemoteStation *station, double ackSnr, WifiMode ackMode,
+                       double dataSnr, uint16_t dataChannelWidth, uint8_t dataNss);
+  void DoReportAmpduTxStatus (WifiRemoteStation *station,
+                              uint8_t nSuccessfulMpdus, uint8_t nFailedMpdus,
+                              double rxSnr, double dataSnr, uint16_t dataChannelWidth, uint8_t dataNss);
+  void DoReportFinalRtsFailed (WifiRemoteStation *station);
+  void DoReportFinalDataFailed (WifiRemoteStation *station);
+  WifiTxVector DoGetDataTxVector (WifiRemoteStation *station);
+  WifiTxVector DoGetRtsTxVector (WifiRemoteStation *station);
+  bool IsLowLatency (void) const;
+
+  /**
+   * Update the average SNR of the station with a new sample.
+   *
+   * \param station the remote station
+   * \param snr the SNR sample in dB
+   */
+  void UpdateSnr (WifiRemoteStation *station, double snr);
+  /**
+   * Return the index of the SNR grid point immediately below the given SNR.
+   *
+   * \param snr the SNR in dB
+   * \return the index of the SNR grid point
+   */
+  uint32_t GetSnrIndex (double snr) const;
+  /**
+   * Select, among the modes supported by the station, the one with the
+   * highest expected goodput at the given SNR grid point.
+   *
+   * \param station the remote station
+   * \param snrIndex the index of the SNR grid point
+   * \return the selected mode
+   */
+  WifiMode GetBestMode (WifiRemoteStation *station, uint32_t snrIndex) const;
+
+  /**
+   * Expected goodput (in bps) of a mode at each point of the SNR grid.
+   */
+  typedef std::vector<double> GoodputTable;
+
+  double m_ewmaWeight;                           //!< The weight of the newest SNR sample in the moving average.
+  double m_snrMargin;                            //!< The margin (in dB) subtracted from the average SNR.
+  uint32_t m_mpduLength;                         //!< The MPDU length (in bytes) used to compute the PER.
+  double m_minSnr;                               //!< The lowest SNR (in dB) of the grid.
+  double m_maxSnr;                               //!< The highest SNR (in dB) of the grid.
+  double m_snrStep;                              //!< The spacing (in dB) between the points of the grid.
+  uint32_t m_nSnrPoints;                         //!< The number of points of the grid.
+  std::map<uint32_t, GoodputTable> m_goodput;    //!< Expected goodput of each mode, indexed by the unique ID of the mode.
+  /**
+   * Trace callback for rate change with particular remote station.
+   * \param Mac48Address The MAC address of the remote station.
+   * \param Mcs The new MCS index to use with the remote station for data coomunication.
+   */
+  TracedCallback<Mac48Address, uint16_t> m_mcsChanged;
+
+};
+
+} //namespace ns3
+
+#endif /* GOODPUT_DMG_WIFI_MANAGER_H */
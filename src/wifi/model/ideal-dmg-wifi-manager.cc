@@ -21,6 +21,7 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/pointer.h"
 #include "ideal-dmg-wifi-manager.h"
 #include "wifi-phy.h"
 
@@ -37,6 +38,9 @@ struct IdealDmgWifiRemoteStation : public WifiRemoteStation
   double m_lastSnrObserved;  //!< SNR of most recently reported packet sent to the remote station
   double m_lastSnrCached;    //!< SNR most recently used to select a rate
   WifiMode m_lastMode;       //!< Mode most recently used to the remote station
+  DmgSnrThresholdTable::SelectionTable m_selectionTable;  //!< Selection table restricted to the supported modes
+  WifiModeList m_supportedModes; //!< Supported modes, but the first one, when the selection table was built
+  uint16_t m_channelWidth;   //!< Channel width when the selection table was built
 };
 
 /// To avoid using the cache before a valid value has been cached
@@ -58,6 +62,14 @@ IdealDmgWifiManager::GetTypeId (void)
                    DoubleValue (1e-6),
                    MakeDoubleAccessor (&IdealDmgWifiManager::m_ber),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrThresholdTable",
+                   "The table of the minimum SNR of each mode and of the derived rate selection "
+                   "tables. The thresholds at the BER threshold of this manager, in linear scale, "
+                   "are added to the table for the modes of the PHY which are missing, so the table "
+                   "can be shared with other rate managers.",
+                   PointerValue (),
+                   MakePointerAccessor (&IdealDmgWifiManager::m_thresholdTable),
+                   MakePointerChecker<DmgSnrThresholdTable> ())
     .AddTraceSource ("Rate",
                      "Traced value for MCS changes",
                      MakeTraceSourceAccessor (&IdealDmgWifiManager::m_mcsChanged),
@@ -87,41 +99,74 @@ void
 IdealDmgWifiManager::DoInitialize ()
 {
   NS_LOG_FUNCTION (this);
+  if (m_thresholdTable == 0)
+    {
+      m_thresholdTable = CreateObject<DmgSnrThresholdTable> ();
+    }
+  AddSnrThresholds (GetPhy ()->GetChannelWidth ());
+}
+
+void
+IdealDmgWifiManager::AddSnrThresholds (uint16_t channelWidth)
+{
+  NS_LOG_FUNCTION (this << channelWidth);
+  DmgSnrThresholdTable::Key key (channelWidth, m_ber, DmgSnrThresholdTable::SNR_LINEAR);
   WifiMode mode;
   WifiTxVector txVector;
   uint8_t nModes = GetPhy ()->GetNModes ();
   for (uint8_t i = 1; i < nModes; i++)
     {
       mode = GetPhy ()->GetMode (i);
-      txVector.SetChannelWidth (GetPhy ()->GetChannelWidth ());
+      if (m_thresholdTable->HasSnrThreshold (mode, key))
+        {
+          continue;
+        }
+      txVector.SetChannelWidth (channelWidth);
       txVector.SetMode (mode);
       NS_LOG_DEBUG ("Initialize, adding mode = " << mode.GetUniqueName ());
-      AddSnrThreshold (txVector, GetPhy ()->CalculateSnr (txVector, m_ber));
+      m_thresholdTable->AddSnrThreshold (mode, key, GetPhy ()->CalculateSnr (txVector, m_ber));
     }
 }
 
 double
-IdealDmgWifiManager::GetSnrThreshold (WifiTxVector &txVector) const
+IdealDmgWifiManager::GetSnrThreshold (const WifiTxVector &txVector)
 {
   NS_LOG_FUNCTION (this << txVector.GetMode ().GetUniqueName ());
-  for (Thresholds::const_iterator i = m_thresholds.begin (); i != m_thresholds.end (); i++)
+  DmgSnrThresholdTable::Key key (txVector.GetChannelWidth (), m_ber, DmgSnrThresholdTable::SNR_LINEAR);
+  if (!m_thresholdTable->HasSnrThreshold (txVector.GetMode (), key))
     {
-      NS_LOG_DEBUG ("Checking " << i->second.GetMode ().GetUniqueName ()
-                    << " against TxVector " << txVector.GetMode ().GetUniqueName ());
-      if (txVector.GetMode () == i->second.GetMode ())
-        {
-          return i->first;
-        }
+      AddSnrThresholds (txVector.GetChannelWidth ());
     }
-  NS_ASSERT (false);
-  return 0.0;
+  return m_thresholdTable->GetSnrThreshold (txVector.GetMode (), key);
 }
 
-void
-IdealDmgWifiManager::AddSnrThreshold (WifiTxVector txVector, double snr)
+const DmgSnrThresholdTable::SelectionTable&
+IdealDmgWifiManager::GetSelectionTable (WifiRemoteStation *st, uint16_t channelWidth)
 {
-  NS_LOG_FUNCTION (this << txVector.GetMode ().GetUniqueName () << snr);
-  m_thresholds.push_back (std::make_pair (snr, txVector));
+  NS_LOG_FUNCTION (this << st << channelWidth);
+  IdealDmgWifiRemoteStation *station = static_cast<IdealDmgWifiRemoteStation*> (st);
+  uint8_t nSupported = GetNSupported (station);
+  /* The supported modes can be replaced by others without changing their number */
+  bool changed = (station->m_channelWidth != channelWidth) || (station->m_supportedModes.size () + 1u != nSupported);
+  for (uint8_t i = 1; !changed && (i < nSupported); i++)
+    {
+      changed = !(station->m_supportedModes[i - 1] == GetSupported (station, i));
+    }
+  if (changed)
+    {
+      AddSnrThresholds (channelWidth);
+      WifiModeList modes;
+      for (uint8_t i = 1; i < nSupported; i++)
+        {
+          modes.push_back (GetSupported (station, i));
+        }
+      station->m_selectionTable = m_thresholdTable->BuildSelectionTable (modes, DmgSnrThresholdTable::Key (channelWidth, m_ber, DmgSnrThresholdTable::SNR_LINEAR));
+      station->m_channelWidth = channelWidth;
+      NS_LOG_DEBUG ("Built selection table with " << station->m_selectionTable.size ()
+                    << " entries out of " << modes.size () << " supported modes");
+      station->m_supportedModes.swap (modes);
+    }
+  return station->m_selectionTable;
 }
 
 WifiRemoteStation *
@@ -130,6 +175,7 @@ IdealDmgWifiManager::DoCreateStation (void) const
   NS_LOG_FUNCTION (this);
   IdealDmgWifiRemoteStation *station = new IdealDmgWifiRemoteStation ();
   Reset (station);
+  station->m_channelWidth = 0;
   return station;
 }
 
@@ -223,9 +269,6 @@ IdealDmgWifiManager::DoGetDataTxVector (WifiRemoteStation *st)
   //highest data rate for which the SNR threshold is smaller than m_lastSnr
   //to ensure correct packet delivery.
   WifiMode maxMode = GetDefaultMode ();
-  WifiTxVector txVector;
-  WifiMode mode;
-  uint64_t bestRate = 0;
   if (station->m_lastSnrCached != CACHE_INITIAL_VALUE && station->m_lastSnrObserved == station->m_lastSnrCached)
     {
       // SNR has not changed, so skip the search and use the last
@@ -237,30 +280,14 @@ IdealDmgWifiManager::DoGetDataTxVector (WifiRemoteStation *st)
     }
   else
     {
-      for (uint8_t i = 1; i < GetNSupported (station); i++)
-        {
-          mode = GetSupported (station, i);
-          txVector.SetMode (mode);
-          txVector.SetChannelWidth (GetPhy ()->GetChannelWidth ());
-          double threshold = GetSnrThreshold (txVector);
-          uint64_t dataRate = mode.GetDmgDataRate ();
-          NS_LOG_DEBUG ("mode = " << mode.GetUniqueName () <<
-                        " threshold " << threshold  <<
-                        " last snr observed " <<
-                        station->m_lastSnrObserved);
-          if (dataRate > bestRate && threshold < station->m_lastSnrObserved)
-            {
-              NS_LOG_DEBUG ("Candidate mode = " << mode.GetUniqueName () <<
-                            " data rate " << dataRate <<
-                            " threshold " << threshold  <<
-                            " last snr observed " <<
-                            station->m_lastSnrObserved);
-              bestRate = dataRate;
-              maxMode = mode;
-            }
-          NS_LOG_DEBUG ("Updating cached SNR value for station to " << station->m_lastSnrObserved);
-          station->m_lastSnrCached = station->m_lastSnrObserved;
-        }
+      // the selection table is sorted by increasing SNR threshold and
+      // increasing data rate, hence a binary search finds the mode
+      maxMode = DmgSnrThresholdTable::Lookup (GetSelectionTable (station, GetPhy ()->GetChannelWidth ()),
+                                              station->m_lastSnrObserved, GetDefaultMode ());
+      NS_LOG_DEBUG ("Selected mode = " << maxMode.GetUniqueName () <<
+                    " last snr observed " << station->m_lastSnrObserved);
+      NS_LOG_DEBUG ("Updating cached SNR value for station to " << station->m_lastSnrObserved);
+      station->m_lastSnrCached = station->m_lastSnrObserved;
       if (station->m_lastMode.GetMcsValue () != maxMode.GetMcsValue ())
         {
           NS_LOG_DEBUG ("Updating MCS value for station to " <<  maxMode.GetUniqueName ());
@@ -25,6 +25,7 @@
 #include "interference-helper.h"
 #include "wifi-phy.h"
 #include "error-rate-model.h"
+#include "dmg-profiler.h"
 #include "wifi-utils.h"
 #include "wifi-ppdu.h"
 #include "wifi-psdu.h"
@@ -398,9 +399,16 @@ InterferenceHelper::CalculateSnr (std::vector<double> signalList, double noiseIn
   return snrValues;
 }
 
+std::vector<double>
+InterferenceHelper::CalculateNoiseLimitedSnr (std::vector<double> signalList, WifiTxVector txVector) const
+{
+  return CalculateSnr (signalList, 0, txVector);
+}
+
 double
 InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const
 {
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_NOISE_INTERFERENCE);
   double noiseInterferenceW = m_firstPower;
   auto it = m_niChanges.find (event->GetStartTime ());
   for (; it != m_niChanges.end () && it->first < Simulator::Now (); ++it)
@@ -353,6 +353,16 @@ public:
    * \return struct of SNR and PER
    */
   struct InterferenceHelper::SnrPer CalculateDmgPhyHeaderSnrPer (Ptr<Event> event) const;
+  /**
+   * Calculate the SNR (linear ratio) of a list of signals received without any interference,
+   * i.e. against the noise floor of the receiver only.
+   *
+   * \param signalList List of signals powers in Watts.
+   * \param txVector the TXVECTOR
+   *
+   * \return List of SNR values in linear scale
+   */
+  std::vector<double> CalculateNoiseLimitedSnr (std::vector<double> signalList, WifiTxVector txVector) const;
 
   /**
    * Notify that RX has started.
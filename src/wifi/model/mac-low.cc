@@ -47,6 +47,7 @@
 #include "wifi-net-device.h"
 #include "wifi-mac.h"
 #include <algorithm>
+#include <limits>
 #include "wifi-ack-policy-selector.h"
 #include "control-trailer.h"
 
@@ -578,6 +579,10 @@ MacLow::ResumeTransmission (Time duration, Ptr<Txop> txop)
 
   /* Check if the remaining time is enough to resume previously suspended transmission */
   Time transactionTime = CalculateWiGigTransactionTime (m_currentPacket);
+  if (transactionTime > duration && m_currentPacket->IsAggregate () && TrimAmpduToAllocation (duration))
+    {
+      transactionTime = CalculateWiGigTransactionTime (m_currentPacket);
+    }
   NS_LOG_DEBUG ("TransactionTime=" << transactionTime <<
                 ", RemainingTime=" << txop->GetAllocationRemaining ());
 
@@ -608,6 +613,63 @@ MacLow::ResumeTransmission (Time duration, Ptr<Txop> txop)
   m_allocationPeriodsTable.erase (m_currentAllocationID);
 }
 
+bool
+MacLow::TrimAmpduToAllocation (Time duration)
+{
+  NS_LOG_FUNCTION (this << duration);
+  if (!IsDmgPsduSizeLimitSupported (m_currentTxVector.GetMode ().GetModulationClass ()))
+    {
+      return false;
+    }
+
+  /* Byte budget left for the A-MPDU once the protection and acknowledgement overhead is removed */
+  Time overhead = CalculateWiGigTransactionTime (m_currentPacket)
+    - m_phy->CalculateTxDuration (m_currentPacket->GetSize (), m_currentTxVector, m_phy->GetFrequency ());
+  if (duration <= overhead)
+    {
+      return false;
+    }
+  uint32_t budget = GetDmgPsduSizeLimit (m_currentTxVector, duration - overhead);
+
+  std::vector<Ptr<WifiMacQueueItem>> mpduList (m_currentPacket->begin (), m_currentPacket->end ());
+  std::size_t nMpdus = 0;
+  uint32_t ampduSize = 0;
+  while (nMpdus < mpduList.size ())
+    {
+      uint32_t newSize = MpduAggregator::GetSizeIfAggregated (mpduList[nMpdus]->GetSize (), ampduSize);
+      if (newSize > budget)
+        {
+          break;
+        }
+      ampduSize = newSize;
+      nMpdus++;
+    }
+  /* The transaction time is rounded up to microseconds, so double check the trimmed A-MPDU */
+  while (nMpdus >= 2)
+    {
+      Ptr<WifiPsdu> psdu = Create<WifiPsdu> (std::vector<Ptr<WifiMacQueueItem>> (mpduList.begin (),
+                                                                                 mpduList.begin () + nMpdus));
+      if (CalculateWiGigTransactionTime (psdu) <= duration)
+        {
+          break;
+        }
+      nMpdus--;
+    }
+  if (nMpdus < 2)
+    {
+      NS_LOG_DEBUG ("Not enough time in the allocation for a trimmed A-MPDU");
+      return false;
+    }
+
+  NS_LOG_DEBUG ("Trim the suspended A-MPDU from " << mpduList.size () << " to " << nMpdus << " MPDUs");
+  /* The MPDUs left out are handed to the block ack manager for retransmission */
+  std::vector<Ptr<WifiMacQueueItem>> leftOut (mpduList.begin () + nMpdus, mpduList.end ());
+  m_edca.find (QosUtilsMapTidToAc (leftOut.front ()->GetHeader ().GetQosTid ()))->second->RequeueMpdus (leftOut);
+  mpduList.resize (nMpdus);
+  m_currentPacket = Create<WifiPsdu> (mpduList);
+  return true;
+}
+
 void
 MacLow::ChangeAllocationPacketsAddress (AllocationID allocationId, Mac48Address destAdd)
 {
@@ -1080,6 +1142,18 @@ MacLow::IsWithinSizeAndTimeLimits (uint32_t mpduSize, Mac48Address receiver, uin
   // Get the maximum PPDU Duration based on the preamble type
   Time maxPpduDuration = GetPpduMaxTime (txVector.GetPreambleType ());
 
+  if (IsDmgPsduSizeLimitSupported (modulation))
+    {
+      // The aggregation loops query the same duration limit for growing sizes, so compare
+      // against the (memoized) largest PSDU that fits instead of recomputing the duration
+      if (ppduPayloadSize > GetDmgPsduSizeLimit (txVector, ppduDurationLimit))
+        {
+          NS_LOG_DEBUG ("the frame does not meet the constraint on max PPDU duration");
+          return false;
+        }
+      return true;
+    }
+
   Time txTime = m_phy->CalculateTxDuration (ppduPayloadSize, txVector, m_phy->GetFrequency ());
 
   if ((ppduDurationLimit.IsStrictlyPositive () && txTime > ppduDurationLimit)
@@ -1092,6 +1166,46 @@ MacLow::IsWithinSizeAndTimeLimits (uint32_t mpduSize, Mac48Address receiver, uin
   return true;
 }
 
+uint32_t
+MacLow::GetAmpduByteBudget (Mac48Address receiver, uint8_t tid, WifiTxVector txVector, Time ppduDurationLimit)
+{
+  NS_LOG_FUNCTION (this << receiver << +tid << txVector << ppduDurationLimit);
+  WifiModulationClass modulation = txVector.GetMode ().GetModulationClass ();
+  uint32_t maxAmpduSize = 0;
+  if (GetMpduAggregator ())
+    {
+      maxAmpduSize = GetMpduAggregator ()->GetMaxAmpduSize (receiver, tid, modulation);
+    }
+  if (!IsDmgPsduSizeLimitSupported (modulation))
+    {
+      return maxAmpduSize;
+    }
+  return std::min (maxAmpduSize, GetDmgPsduSizeLimit (txVector, ppduDurationLimit));
+}
+
+bool
+MacLow::IsDmgPsduSizeLimitSupported (WifiModulationClass modulation)
+{
+  return ((modulation == WIFI_MOD_CLASS_DMG_SC) || (modulation == WIFI_MOD_CLASS_DMG_OFDM)
+          || (modulation == WIFI_MOD_CLASS_EDMG_SC) || (modulation == WIFI_MOD_CLASS_EDMG_OFDM));
+}
+
+uint32_t
+MacLow::GetDmgPsduSizeLimit (WifiTxVector txVector, Time ppduDurationLimit) const
+{
+  Time durationLimit = GetPpduMaxTime (txVector.GetPreambleType ());
+  if (ppduDurationLimit.IsStrictlyPositive ()
+      && (!durationLimit.IsStrictlyPositive () || ppduDurationLimit < durationLimit))
+    {
+      durationLimit = ppduDurationLimit;
+    }
+  if (!durationLimit.IsStrictlyPositive ())
+    {
+      return std::numeric_limits<uint32_t>::max ();
+    }
+  return m_phy->GetMaxPsduSize (durationLimit, txVector, m_phy->GetFrequency ());
+}
+
 void
 MacLow::RxStartIndication (WifiTxVector txVector, Time psduDuration)
 {
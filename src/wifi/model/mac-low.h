@@ -38,6 +38,8 @@
 #include "wifi-mpdu-type.h"
 #include "wigig-data-types.h"
 
+class DmgAmpduTrimTest;
+
 namespace ns3 {
 
 class WifiMac;
@@ -62,6 +64,8 @@ class MpduAggregator;
 class MacLow : public Object
 {
 public:
+  /// allow DmgAmpduTrimTest class access
+  friend class ::DmgAmpduTrimTest;
 
   /**
    * typedef for a callback for MacLowRx
@@ -359,6 +363,22 @@ public:
    */
   bool IsWithinSizeAndTimeLimits (uint32_t mpduSize, Mac48Address receiver, uint8_t tid,
                                   WifiTxVector txVector, uint32_t ampduSize, Time ppduDurationLimit);
+  /**
+   * Return the largest A-MPDU, in bytes, that can be sent to the given receiver for
+   * the given TID. For the DMG/EDMG SC and OFDM PHYs the budget also accounts for the
+   * max PPDU duration and the given PPDU duration limit (if strictly positive), e.g.,
+   * the time left in the current service period. It is then the largest PSDU size that
+   * fits in the PPDU duration, found by WifiPhy::GetMaxPsduSize with a galloping and
+   * bisection search over the payload duration and memoized by the PHY. Otherwise, only
+   * the maximum A-MPDU size is returned.
+   *
+   * \param receiver the receiver
+   * \param tid the TID
+   * \param txVector the TX vector used to transmit the A-MPDU
+   * \param ppduDurationLimit the limit on the PPDU duration
+   * \returns the A-MPDU size budget in bytes
+   */
+  uint32_t GetAmpduByteBudget (Mac48Address receiver, uint8_t tid, WifiTxVector txVector, Time ppduDurationLimit);
   /**
    * \param packet to send (does not include the 802.11 MAC header and checksum)
    * \param hdr header associated to the packet to send.
@@ -709,6 +729,30 @@ public:
   Time CalculateWiGigTransactionTime (Ptr<WifiPsdu> psdu);
 
 private:
+  /**
+   * \param modulation the modulation class
+   * \return true if the PSDU size limit of the modulation class can be computed in closed form
+   */
+  static bool IsDmgPsduSizeLimitSupported (WifiModulationClass modulation);
+  /**
+   * Return the largest PSDU that fits within both the max PPDU duration and the given
+   * PPDU duration limit (if strictly positive).
+   *
+   * \param txVector the TX vector used to transmit the PSDU
+   * \param ppduDurationLimit the limit on the PPDU duration
+   * \return the maximum PSDU size in bytes
+   */
+  uint32_t GetDmgPsduSizeLimit (WifiTxVector txVector, Time ppduDurationLimit) const;
+  /**
+   * Shorten the suspended A-MPDU being resumed so that the whole transaction fits
+   * within the given duration. The MPDUs left out are returned to the block ack
+   * manager retransmit queue.
+   *
+   * \param duration the remaining duration of the allocation
+   * \return true if the A-MPDU has been trimmed, false if it cannot be shortened
+   * to at least two MPDUs
+   */
+  bool TrimAmpduToAllocation (Time duration);
   /**
    * Cancel all scheduled events. Called before beginning a transmission
    * or switching channel.
@@ -254,6 +254,10 @@ MpduAggregator::GetNextAmpdu (Ptr<const WifiMacQueueItem> mpdu, WifiTxVector txV
       Ptr<WifiMacQueueItem> nextMpdu;
       uint16_t maxMpdus = edcaIt->second->GetBaBufferSize (recipient, tid);
       uint32_t currentAmpduSize = 0;
+      // In a DMG service period the budget also reflects the time left before the end of the
+      // allocation (the acknowledgement overhead is already removed from the duration limit)
+      uint32_t byteBudget = edcaIt->second->GetLow ()->GetAmpduByteBudget (recipient, tid, txVector,
+                                                                           ppduDurationLimit);
 
       // check if the received MPDU meets the size and duration constraints
       if (edcaIt->second->GetLow ()->IsWithinSizeAndTimeLimits (mpdu, txVector, 0, ppduDurationLimit))
@@ -294,7 +298,13 @@ MpduAggregator::GetNextAmpdu (Ptr<const WifiMacQueueItem> mpdu, WifiTxVector txV
             {
               uint16_t currentSequenceNumber = peekedMpdu->GetHeader ().GetSequenceNumber ();
 
-              if (IsInWindow (currentSequenceNumber, startingSequenceNumber, maxMpdus))
+              if (GetSizeIfAggregated (peekedMpdu->GetSize (), currentAmpduSize) > byteBudget)
+                {
+                  // an A-MSDU built from the peeked MSDU would be even larger
+                  NS_LOG_DEBUG ("No room left for the next MPDU, A-MPDU size = " << currentAmpduSize
+                                << ", budget = " << byteBudget);
+                }
+              else if (IsInWindow (currentSequenceNumber, startingSequenceNumber, maxMpdus))
                 {
                   // dequeue the frame if constraints on size and duration limit are met.
                   // Note that the dequeued MPDU differs from the peeked MPDU if A-MSDU
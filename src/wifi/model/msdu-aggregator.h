@@ -115,6 +115,9 @@ public:
                             WifiModulationClass modulation) const;
 
   /**
+   * Split the given A-MSDU into its MSDUs. Each MSDU is a fragment of the
+   * A-MSDU that shares its buffer, hence no payload byte is copied. The
+   * subframe headers and the padding are removed from the given packet.
    *
    * \param aggregatedPacket the aggregated packet.
    * \returns DeaggregatedMsdus.
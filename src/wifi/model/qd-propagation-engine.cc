@@ -36,7 +36,12 @@
 #include "ns3/simulator.h"
 #include "ns3/node-list.h"
 #include "ns3/string.h"
+#include "ns3/system-condition.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-thread.h"
+#include "ns3/uinteger.h"
 #include "qd-propagation-engine.h"
+#include "dmg-profiler.h"
 #include "spectrum-dmg-wifi-phy.h"
 #include "wifi-mac.h"
 #include "wifi-net-device.h"
@@ -44,6 +49,7 @@
 #include <algorithm>
 #include <fstream>
 #include <string>
+#include <thread>
 
 namespace ns3 {
 
@@ -51,6 +57,307 @@ NS_LOG_COMPONENT_DEFINE ("QdPropagationEngine");
 
 NS_OBJECT_ENSURE_REGISTERED (QdPropagationEngine);
 
+typedef std::set<PatternAngles> PatternAnglesSet;                       //!< Typedef for a set of angles.
+typedef std::map<AntennaID, PatternAnglesSet> PatternAnglesSetMap;      //!< Typedef for the angles seen by each antenna array.
+
+/**
+ * The Q-D traces of a communicating pair parsed from its Q-D file.
+ */
+struct QdPairTraces {
+  std::string fileName;                                     //!< The name of the Q-D file.
+  uint32_t indexTx;                                         //!< The Q-D ID of the Tx node.
+  uint32_t indexRx;                                         //!< The Q-D ID of the Rx node.
+  uint8_t numTxAntennas;                                    //!< The number of antenna arrays of the Tx node.
+  uint8_t numRxAntennas;                                    //!< The number of antenna arrays of the Rx node.
+  uint32_t numTraces;                                       //!< The number of traces in the Q-D file.
+  float2DVector_t rotmAod[8];                               //!< Rotation matrices of the Tx antenna arrays.
+  float2DVector_t rotmAoa[8];                               //!< Rotation matrices of the Rx antenna arrays.
+  std::map<QdChanneldentifier, uint32_t> nbMultipath;       //!< Number of multipaths components.
+  ChannelCoefficientMap delay;                              //!< Delay spread in ns.
+  ChannelCoefficientMap pathLoss;                           //!< PathLoss (dB).
+  ChannelCoefficientMap phase;                              //!< Phase (radians).
+  ChannelCoefficientMap aodElevation;                       //!< AoD Elevation (Degrees).
+  ChannelCoefficientMap aodAzimuth;                         //!< AoD Azimuth (Degrees).
+  ChannelCoefficientMap aoaElevation;                       //!< AoA Elevation (Degrees).
+  ChannelCoefficientMap aoaAzimuth;                         //!< AoA Azimuth (Degrees).
+  PatternAnglesSetMap txAngles;                             //!< The transformed AoDs per Tx antenna array.
+  PatternAnglesSetMap rxAngles;                             //!< The transformed AoAs per Rx antenna array.
+};
+
+/**
+ * The angles at which the array patterns of a codebook must be calculated.
+ */
+struct QdCodebookPatterns {
+  CodebookParametric *codebook;                             //!< The codebook, accessed without reference counting.
+  PatternAnglesSetMap angles;                               //!< The angles seen by each antenna array of the codebook.
+};
+
+/**
+ * The calculation of the channel gain of a link configuration. The job only refers to the shared
+ * state through raw pointers so that it can be processed outside the simulation thread.
+ */
+struct QdChannelGainJob {
+  SpectrumValue *psd;                                       //!< The power spectral density, multiplied in place by the channel gain.
+  uint16_t pathNum;                                         //!< The number of multipath components.
+  QdChanneldentifier chId;                                  //!< The Q-D channel identifier.
+  double time;                                              //!< The time of the calculation in seconds.
+  ParametricPatternConfig *txPattern;                       //!< The transmit pattern configuration.
+  bool txPrecalculated;                                     //!< Whether the array patterns of the Tx codebook are precalculated.
+  ParametricPatternConfig *rxPattern;                       //!< The receive pattern configuration.
+  bool rxPrecalculated;                                     //!< Whether the array patterns of the Rx codebook are precalculated.
+  bool concurrent;                                          //!< Whether the job is processed outside the simulation thread.
+  bool complete;                                            //!< Whether the channel gain has been calculated.
+};
+
+/**
+ * Get the value of an array pattern at the given angles.
+ * \param config The pattern configuration.
+ * \param precalculated Whether the array patterns are precalculated over the 3D space.
+ * \param concurrent Whether the pattern maps must be left untouched.
+ * \param azimuth The azimuth angle in degrees.
+ * \param elevation The elevation angle in degrees.
+ * \param value The value of the array pattern.
+ * \return False if the pattern has not been calculated at these angles and the maps must be left untouched.
+ */
+static bool
+GetArrayPatternValue (ParametricPatternConfig *config, bool precalculated, bool concurrent,
+                      uint16_t azimuth, uint16_t elevation, Complex &value)
+{
+  if (precalculated)
+    {
+      value = config->GetArrayPattern ()[azimuth][elevation];
+      return true;
+    }
+  else if (!concurrent)
+    {
+      value = config->GetArrayPattern (azimuth, elevation);
+      return true;
+    }
+  return config->FindArrayPattern (azimuth, elevation, value);
+}
+
+/**
+ * A pool of system threads processing a list of independent items. The items are
+ * handed out one at a time, so each item is processed by exactly one thread.
+ * Ptr reference counts are not thread-safe, so the job must not copy any Ptr shared
+ * between items.
+ */
+template <typename T>
+class QdWorkerPool
+{
+public:
+  /**
+   * Constructor.
+   * \param items The items to be processed.
+   * \param job The callback processing a single item.
+   */
+  QdWorkerPool (std::vector<T> &items, Callback<void, T &> job)
+    : m_items (items),
+      m_job (job),
+      m_next (0)
+  {
+  }
+  /**
+   * Process all the items and wait for the threads to finish.
+   * \param numThreads The number of threads to use.
+   */
+  void Run (uint32_t numThreads)
+  {
+    m_next = 0;
+    numThreads = std::min<uint32_t> (numThreads, m_items.size ());
+    if (numThreads <= 1)
+      {
+        ProcessItems ();
+        return;
+      }
+    std::vector<Ptr<SystemThread> > threads;
+    for (uint32_t i = 0; i < numThreads; i++)
+      {
+        Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&QdWorkerPool<T>::ProcessItems, this));
+        thread->Start ();
+        threads.push_back (thread);
+      }
+    for (uint32_t i = 0; i < numThreads; i++)
+      {
+        threads[i]->Join ();
+      }
+  }
+
+private:
+  /**
+   * Process items until the list is exhausted.
+   */
+  void ProcessItems (void)
+  {
+    while (true)
+      {
+        uint32_t index;
+        {
+          CriticalSection cs (m_mutex);
+          if (m_next >= m_items.size ())
+            {
+              return;
+            }
+          index = m_next++;
+        }
+        m_job (m_items[index]);
+      }
+  }
+
+  std::vector<T> &m_items;                                  //!< The items to be processed.
+  Callback<void, T &> m_job;                                //!< The callback processing a single item.
+  SystemMutex m_mutex;                                      //!< Mutex protecting the index of the next item.
+  uint32_t m_next;                                          //!< The index of the next item to be processed.
+};
+
+/**
+ * Threads kept alive for the whole simulation, which calculate the channel gains of the
+ * receivers of each transmission. Starting threads for every transmission costs more than
+ * the channel gains of a short SSW frame, so the threads wait for the next batch instead.
+ * The simulation thread processes jobs too, and batches of a single job are processed
+ * by the simulation thread alone.
+ *
+ * The conditions are set while they hold, i.e. while the batch has jobs to hand out or
+ * the threads must exit, and once the batch is complete, so a thread checking them
+ * after they have been signaled does not wait.
+ */
+class QdRxPowerWorkers
+{
+public:
+  /**
+   * Constructor.
+   * \param numThreads The number of threads processing the jobs, the simulation thread included.
+   * \param job The callback processing a single job.
+   */
+  QdRxPowerWorkers (uint32_t numThreads, Callback<void, QdChannelGainJob &> job)
+    : m_job (job),
+      m_jobs (0),
+      m_next (0),
+      m_remaining (0),
+      m_stop (false)
+  {
+    for (uint32_t i = 1; i < numThreads; i++)
+      {
+        Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&QdRxPowerWorkers::Work, this));
+        thread->Start ();
+        m_threads.push_back (thread);
+      }
+  }
+  ~QdRxPowerWorkers ()
+  {
+    {
+      CriticalSection cs (m_mutex);
+      m_stop = true;
+      m_newJobs.SetCondition (true);
+    }
+    m_newJobs.Broadcast ();
+    for (uint32_t i = 0; i < m_threads.size (); i++)
+      {
+        m_threads[i]->Join ();
+      }
+  }
+  /**
+   * Process all the jobs and wait for them to complete.
+   * \param jobs The jobs to be processed.
+   */
+  void Run (std::vector<QdChannelGainJob> &jobs)
+  {
+    if ((jobs.size () < 2) || m_threads.empty ())
+      {
+        for (auto &job : jobs)
+          {
+            m_job (job);
+          }
+        return;
+      }
+    {
+      CriticalSection cs (m_mutex);
+      m_jobs = &jobs;
+      m_next = 0;
+      m_remaining = jobs.size ();
+      m_jobsDone.SetCondition (false);
+      m_newJobs.SetCondition (true);
+    }
+    m_newJobs.Broadcast ();
+    ProcessJobs ();
+    while (true)
+      {
+        {
+          CriticalSection cs (m_mutex);
+          if (m_remaining == 0)
+            {
+              m_jobs = 0;
+              return;
+            }
+        }
+        m_jobsDone.TimedWait (WAIT_TIMEOUT);
+      }
+  }
+
+private:
+  /**
+   * Process jobs of the current batch until none is left.
+   */
+  void ProcessJobs (void)
+  {
+    while (true)
+      {
+        QdChannelGainJob *job;
+        {
+          CriticalSection cs (m_mutex);
+          if ((m_jobs == 0) || (m_next >= m_jobs->size ()))
+            {
+              return;
+            }
+          job = &(*m_jobs)[m_next++];
+          if (m_next == m_jobs->size ())
+            {
+              m_newJobs.SetCondition (false);
+            }
+        }
+        m_job (*job);
+        {
+          CriticalSection cs (m_mutex);
+          if (--m_remaining == 0)
+            {
+              m_jobsDone.SetCondition (true);
+              m_jobsDone.Signal ();
+            }
+        }
+      }
+  }
+  /**
+   * The loop of a worker thread.
+   */
+  void Work (void)
+  {
+    while (true)
+      {
+        m_newJobs.TimedWait (WAIT_TIMEOUT);
+        {
+          CriticalSection cs (m_mutex);
+          if (m_stop)
+            {
+              return;
+            }
+        }
+        ProcessJobs ();
+      }
+  }
+
+  static const uint64_t WAIT_TIMEOUT = 1000000000;          //!< The longest wait for a condition, in nanoseconds.
+
+  Callback<void, QdChannelGainJob &> m_job;                 //!< The callback processing a single job.
+  std::vector<Ptr<SystemThread> > m_threads;                //!< The worker threads.
+  SystemMutex m_mutex;                                      //!< Mutex protecting the state of the batch.
+  SystemCondition m_newJobs;                                //!< Set while the batch has jobs left or the workers must exit.
+  SystemCondition m_jobsDone;                               //!< Set once the batch is complete.
+  std::vector<QdChannelGainJob> *m_jobs;                    //!< The jobs of the current batch.
+  std::size_t m_next;                                       //!< The index of the next job of the batch.
+  std::size_t m_remaining;                                  //!< The number of jobs of the batch not completed yet.
+  bool m_stop;                                              //!< Whether the worker threads must exit.
+};
+
 TypeId
 QdPropagationEngine::GetTypeId (void)
 {
@@ -83,11 +390,26 @@ QdPropagationEngine::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&QdPropagationEngine::m_useCustomIDs),
                    MakeBooleanChecker ())
+    .AddAttribute ("PrecomputeThreads",
+                   "The number of threads used by Precompute to load the Q-D files and to calculate the array patterns."
+                   "If set to zero, we use as many threads as the number of hardware threads.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&QdPropagationEngine::m_precomputeThreads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("RxPowerThreads",
+                   "The number of threads used to calculate in parallel the channel gains of all the receivers of a"
+                   " transmission when it is sent over the channel. This only applies to a static Q-D channel,"
+                   " i.e., if the Interval attribute is zero. If set to zero, the channel gains are calculated"
+                   " one by one when the signal reaches each receiver.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&QdPropagationEngine::m_rxPowerThreads),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
 
 QdPropagationEngine::QdPropagationEngine ()
+  : m_rxPowerWorkers (0)
 {
   NS_LOG_FUNCTION (this);
   m_uniformRv = CreateObject<UniformRandomVariable> ();
@@ -103,6 +425,8 @@ QdPropagationEngine::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_uniformRv = 0;
+  delete m_rxPowerWorkers;
+  m_rxPowerWorkers = 0;
 }
 
 void
@@ -126,97 +450,94 @@ QdPropagationEngine::GetCurrentTraceIndex (void) const
   return m_currentIndex;
 }
 
+uint32_t
+QdPropagationEngine::GetTraceID (Ptr<Node> node) const
+{
+  if (m_useCustomIDs)
+    {
+      return GetQdID (node->GetId ());
+    }
+  else
+    {
+      return node->GetId ();
+    }
+}
+
 void
-QdPropagationEngine::InitializeQDModelParameters (Ptr<const MobilityModel> txMobility, Ptr<const MobilityModel> rxMobility,
-                                                  uint16_t indexTx, uint16_t indexRx) const
+QdPropagationEngine::PrepareQdFile (Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook,
+                                    uint32_t indexTx, uint32_t indexRx, QdPairTraces &traces) const
 {
   NS_LOG_FUNCTION (this << indexTx << indexRx);
-  std::string rayTracingPrefixFile  = m_qdFolder + "QdFiles/Tx";
-  float2DVector_t rotmAod[8];     /* Rotation Matrix used to manage Angles of Departure depending on antenna orientation. */
-  float2DVector_t rotmAoa[8];     /* Rotation Matrix used to manage Angles of Arrival depending on antenna orientation. */
-  uint16_t traceIndex = 0;        /* Used for mobility. */
-
-  Ptr<NetDevice> txDevice = txMobility->GetObject<Node> ()->GetDevice (0);
-  Ptr<NetDevice> rxDevice = rxMobility->GetObject<Node> ()->GetDevice (0);
-  Ptr<WifiNetDevice> wifiTxDevice = DynamicCast<WifiNetDevice> (txDevice);
-  Ptr<WifiNetDevice> wifiRxDevice = DynamicCast<WifiNetDevice> (rxDevice);
-  Ptr<SpectrumDmgWifiPhy> txSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiTxDevice->GetPhy ());
-  Ptr<SpectrumDmgWifiPhy> rxSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiRxDevice->GetPhy ());
-  Ptr<CodebookParametric> txCodebook = DynamicCast<CodebookParametric> (txSpectrum->GetCodebook ());
-  Ptr<CodebookParametric> rxCodebook = DynamicCast<CodebookParametric> (rxSpectrum->GetCodebook ());
-
-  uint8_t numTxAntennas = txCodebook->GetTotalNumberOfAntennas ();
-  uint8_t numRxAntennas = rxCodebook->GetTotalNumberOfAntennas ();
+  traces.indexTx = indexTx;
+  traces.indexRx = indexRx;
+  traces.numTxAntennas = txCodebook->GetTotalNumberOfAntennas ();
+  traces.numRxAntennas = rxCodebook->GetTotalNumberOfAntennas ();
+  traces.numTraces = 0;
 
   if (m_eulerTransform)
     {
-      for (AntennaID i = 1 ; i <= numTxAntennas; i++)
+      for (AntennaID i = 1 ; i <= traces.numTxAntennas; i++)
         {
-          EulerTransform (txSpectrum->GetCodebook ()->GetOrientation (i), rotmAod[i-1]);
+          EulerTransform (txCodebook->GetOrientation (i), traces.rotmAod[i-1]);
         }
-      for (AntennaID i = 1 ; i <= numRxAntennas; i++)
+      for (AntennaID i = 1 ; i <= traces.numRxAntennas; i++)
         {
-          EulerTransform (rxSpectrum->GetCodebook ()->GetOrientation (i), rotmAoa[i-1]);
+          EulerTransform (rxCodebook->GetOrientation (i), traces.rotmAoa[i-1]);
         }
     }
   else
     {
       double antennaOrientationVector[3];
       double referenceVector[3] = {0,0,1};
-      for (AntennaID i = 1 ; i <= numTxAntennas; i++)
+      for (AntennaID i = 1 ; i <= traces.numTxAntennas; i++)
         {
-          Orientation orientation = txSpectrum->GetCodebook ()->GetOrientation (i);
+          Orientation orientation = txCodebook->GetOrientation (i);
           antennaOrientationVector[0] = orientation.x;
           antennaOrientationVector[1] = orientation.y;
           antennaOrientationVector[2] = orientation.z;
-          QuaternionTransform (referenceVector, antennaOrientationVector, rotmAod[i-1]);
+          QuaternionTransform (referenceVector, antennaOrientationVector, traces.rotmAod[i-1]);
         }
 
-      for (AntennaID i = 1; i <= numRxAntennas; i++)
+      for (AntennaID i = 1; i <= traces.numRxAntennas; i++)
         {
-          Orientation orientation = rxSpectrum->GetCodebook ()->GetOrientation (i);
-          double antennaOrientationVector[3];
+          Orientation orientation = rxCodebook->GetOrientation (i);
           antennaOrientationVector[0] = orientation.x;
           antennaOrientationVector[1] = orientation.y;
           antennaOrientationVector[2] = orientation.z;
-          QuaternionTransform (referenceVector, antennaOrientationVector, rotmAoa[i-1]);
+          QuaternionTransform (referenceVector, antennaOrientationVector, traces.rotmAoa[i-1]);
         }
     }
 
-  std::string qdParameterFile;
-  std::ostringstream ssRx;
-  ssRx << indexRx;
-  std::string indexRxStr = ssRx.str ();
-
-  std::ostringstream ssTx;
-  ssTx << indexTx;
-  std::string indexTxStr = ssTx.str ();
-
-  /* Open the QD-model files (generated by Matlab) between transmitter and receiver */
-  qdParameterFile = std::string (rayTracingPrefixFile) + std::string (indexTxStr) + std::string ("Rx")
-      + std::string (indexRxStr) + std::string (".txt");
-  NS_LOG_INFO ("Open Q-D Channel Model File: " << qdParameterFile);
+  /* The Q-D files (generated by Matlab) between transmitter and receiver */
+  std::ostringstream ss;
+  ss << m_qdFolder << "QdFiles/Tx" << indexTx << "Rx" << indexRx << ".txt";
+  traces.fileName = ss.str ();
+}
 
+void
+QdPropagationEngine::ParseQdFile (QdPairTraces &traces) const
+{
   std::ifstream qdFile;
-  qdFile.open (qdParameterFile.c_str (), std::ifstream::in);
+  qdFile.open (traces.fileName.c_str (), std::ifstream::in);
   if (!qdFile.good ())
     {
-      NS_FATAL_ERROR ("Error Opening Q-D Channel Model File: " << qdParameterFile);
+      NS_FATAL_ERROR ("Error Opening Q-D Channel Model File: " << traces.fileName);
     }
 
   std::string line;
   std::string token;
   uint16_t numPath = 0;
-  QdChanneldentifier chId;     /* Q-D Channel Profile Identifier */
+  uint32_t traceIndex = 0;      /* Used for mobility. */
+  QdChanneldentifier chId;      /* Q-D Channel Profile Identifier */
 
   /* Parse each line of the Q-D file */
   while (true)
     {
-      for (AntennaID i = 1 ; i <= numTxAntennas; i++)
+      for (AntennaID i = 1 ; i <= traces.numTxAntennas; i++)
         {
-          for (AntennaID j = 1 ; j <= numRxAntennas; j++)
+          for (AntennaID j = 1 ; j <= traces.numRxAntennas; j++)
             {
-              chId = std::make_tuple (indexTx, indexRx, traceIndex, i, j);
+              chId = std::make_tuple (traces.indexTx, traces.indexRx, traceIndex, i, j);
               for (uint16_t parameterNumber = 0; parameterNumber < 8; parameterNumber++)
                 {
                   std::getline (qdFile, line);
@@ -228,7 +549,7 @@ QdPropagationEngine::InitializeQDModelParameters (Ptr<const MobilityModel> txMob
                   if (parameterNumber == 0)
                     {
                       numPath = std::stoul (line);
-                      nbMultipathTxRx[chId] = numPath;
+                      traces.nbMultipath[chId] = numPath;
                     }
                   if ((numPath > 0) && (parameterNumber > 0))
                     {
@@ -245,67 +566,61 @@ QdPropagationEngine::InitializeQDModelParameters (Ptr<const MobilityModel> txMob
                         {
                           case 1:
                             /* Second parameter is the delay */
-                            delayTxRx[chId] = values;
+                            traces.delay[chId] = values;
                             break;
 
                           case 2:
                             /* Third parameter is the path Loss */
-                            pathLossTxRx[chId] = values;
+                            traces.pathLoss[chId] = values;
                             break;
 
                           case 3:
                             /* Fourth parameter is the phase */
-                            phaseTxRx[chId] = values;
+                            traces.phase[chId] = values;
                             break;
 
                           case 4:
                             /* Fifth parameter is the AoD Elevation */
-                            aodElevationTxRx[chId] = values;
+                            traces.aodElevation[chId] = values;
                             break;
 
                           case 5:
                             /* Sixth parameter is the AoD Azimuth */
-                            aodAzimuthTxRx[chId] = values;
+                            traces.aodAzimuth[chId] = values;
 
                             /* AoD Antenna orientation transformation */
                             float elevationMultipath, azimuthMultipath;
                             AnglesTransformed angles;
                             for (uint16_t k = 0; k < numPath; k++)
                               {
-                                elevationMultipath = DegreesToRadians (aodElevationTxRx[chId].at (k));
-                                azimuthMultipath = DegreesToRadians (aodAzimuthTxRx[chId].at (k));
-                                angles = GetTransformedAngles (elevationMultipath, azimuthMultipath, false, rotmAod[i-1]);
-                                aodElevationTxRx[chId].at (k) = angles.elevation;
-                                aodAzimuthTxRx[chId].at (k) = angles.azimuth;
-                                if (!txCodebook->ArrayPatternsPrecalculated ())
-                                  {
-                                    txCodebook->CalculateArrayPatterns (i, angles.azimuth, angles.elevation);
-                                  }
+                                elevationMultipath = DegreesToRadians (traces.aodElevation[chId].at (k));
+                                azimuthMultipath = DegreesToRadians (traces.aodAzimuth[chId].at (k));
+                                angles = GetTransformedAngles (elevationMultipath, azimuthMultipath, false, traces.rotmAod[i-1]);
+                                traces.aodElevation[chId].at (k) = angles.elevation;
+                                traces.aodAzimuth[chId].at (k) = angles.azimuth;
+                                traces.txAngles[i].insert (std::make_pair (angles.azimuth, angles.elevation));
                               }
 
                             break;
 
                           case 6:
                             /* Seventh parameter is the AoA Elevation */
-                            aoaElevationTxRx[chId] = values;
+                            traces.aoaElevation[chId] = values;
                             break;
 
                           case 7:
                             /* Eighth parameter is the AoA Azimuth */
-                            aoaAzimuthTxRx[chId] = values;
+                            traces.aoaAzimuth[chId] = values;
 
                             /* AoA Antenna orientation transformation */
                             for (uint16_t k = 0; k < numPath; k++)
                               {
-                                elevationMultipath = DegreesToRadians (aoaElevationTxRx[chId].at (k));
-                                azimuthMultipath = DegreesToRadians (aoaAzimuthTxRx[chId].at (k));
-                                angles = GetTransformedAngles (elevationMultipath, azimuthMultipath, false, rotmAoa[j-1]);
-                                aoaElevationTxRx[chId].at (k) = angles.elevation;
-                                aoaAzimuthTxRx[chId].at (k) = angles.azimuth;
-                                if (!rxCodebook->ArrayPatternsPrecalculated ())
-                                  {
-                                    rxCodebook->CalculateArrayPatterns (j, angles.azimuth, angles.elevation);
-                                  }
+                                elevationMultipath = DegreesToRadians (traces.aoaElevation[chId].at (k));
+                                azimuthMultipath = DegreesToRadians (traces.aoaAzimuth[chId].at (k));
+                                angles = GetTransformedAngles (elevationMultipath, azimuthMultipath, false, traces.rotmAoa[j-1]);
+                                traces.aoaElevation[chId].at (k) = angles.elevation;
+                                traces.aoaAzimuth[chId].at (k) = angles.azimuth;
+                                traces.rxAngles[j].insert (std::make_pair (angles.azimuth, angles.elevation));
                               }
 
                             break;
@@ -314,7 +629,7 @@ QdPropagationEngine::InitializeQDModelParameters (Ptr<const MobilityModel> txMob
                   else if ((numPath == 0) && (parameterNumber == 0))
                     {
                       /* Handle a special case when there is no channel between devices/antennas */
-                      nbMultipathTxRx[chId] = 0;
+                      traces.nbMultipath[chId] = 0;
                       break;
                     }
                 }
@@ -324,10 +639,165 @@ QdPropagationEngine::InitializeQDModelParameters (Ptr<const MobilityModel> txMob
     }
 
 closeFile:
-  m_numTraces = traceIndex;
+  traces.numTraces = traceIndex;
   qdFile.close ();
 }
 
+void
+QdPropagationEngine::MergeQdTraces (QdPairTraces &traces) const
+{
+  NS_LOG_FUNCTION (this << traces.indexTx << traces.indexRx);
+  nbMultipathTxRx.insert (traces.nbMultipath.begin (), traces.nbMultipath.end ());
+  delayTxRx.insert (traces.delay.begin (), traces.delay.end ());
+  pathLossTxRx.insert (traces.pathLoss.begin (), traces.pathLoss.end ());
+  phaseTxRx.insert (traces.phase.begin (), traces.phase.end ());
+  aodElevationTxRx.insert (traces.aodElevation.begin (), traces.aodElevation.end ());
+  aodAzimuthTxRx.insert (traces.aodAzimuth.begin (), traces.aodAzimuth.end ());
+  aoaElevationTxRx.insert (traces.aoaElevation.begin (), traces.aoaElevation.end ());
+  aoaAzimuthTxRx.insert (traces.aoaAzimuth.begin (), traces.aoaAzimuth.end ());
+  m_numTraces = traces.numTraces;
+  m_traceFiles.insert (std::make_pair (traces.indexTx, traces.indexRx));
+}
+
+void
+QdPropagationEngine::InitializeQDModelParameters (Ptr<const MobilityModel> txMobility, Ptr<const MobilityModel> rxMobility,
+                                                  uint16_t indexTx, uint16_t indexRx) const
+{
+  NS_LOG_FUNCTION (this << indexTx << indexRx);
+  Ptr<NetDevice> txDevice = txMobility->GetObject<Node> ()->GetDevice (0);
+  Ptr<NetDevice> rxDevice = rxMobility->GetObject<Node> ()->GetDevice (0);
+  Ptr<WifiNetDevice> wifiTxDevice = DynamicCast<WifiNetDevice> (txDevice);
+  Ptr<WifiNetDevice> wifiRxDevice = DynamicCast<WifiNetDevice> (rxDevice);
+  Ptr<SpectrumDmgWifiPhy> txSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiTxDevice->GetPhy ());
+  Ptr<SpectrumDmgWifiPhy> rxSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiRxDevice->GetPhy ());
+  Ptr<CodebookParametric> txCodebook = DynamicCast<CodebookParametric> (txSpectrum->GetCodebook ());
+  Ptr<CodebookParametric> rxCodebook = DynamicCast<CodebookParametric> (rxSpectrum->GetCodebook ());
+
+  QdPairTraces traces;
+  PrepareQdFile (txCodebook, rxCodebook, indexTx, indexRx, traces);
+  NS_LOG_INFO ("Open Q-D Channel Model File: " << traces.fileName);
+  ParseQdFile (traces);
+  MergeQdTraces (traces);
+
+  /* Calculate the array patterns at the angles of the multipath components */
+  if (!txCodebook->ArrayPatternsPrecalculated ())
+    {
+      QdCodebookPatterns patterns;
+      patterns.codebook = PeekPointer (txCodebook);
+      patterns.angles.swap (traces.txAngles);
+      CalculateCodebookPatterns (patterns);
+    }
+  if (!rxCodebook->ArrayPatternsPrecalculated ())
+    {
+      QdCodebookPatterns patterns;
+      patterns.codebook = PeekPointer (rxCodebook);
+      patterns.angles.swap (traces.rxAngles);
+      CalculateCodebookPatterns (patterns);
+    }
+}
+
+void
+QdPropagationEngine::CalculateCodebookPatterns (QdCodebookPatterns &patterns) const
+{
+  for (PatternAnglesSetMap::const_iterator it = patterns.angles.begin (); it != patterns.angles.end (); it++)
+    {
+      for (PatternAnglesSet::const_iterator angle = it->second.begin (); angle != it->second.end (); angle++)
+        {
+          patterns.codebook->CalculateArrayPatterns (it->first, angle->first, angle->second);
+        }
+    }
+}
+
+void
+QdPropagationEngine::Precompute (NodeContainer nodes)
+{
+  NS_LOG_FUNCTION (this << nodes.GetN ());
+  uint32_t numThreads = m_precomputeThreads;
+  if (numThreads == 0)
+    {
+      numThreads = std::max (1u, std::thread::hardware_concurrency ());
+    }
+
+  /* Collect the codebooks and the Q-D IDs of all the nodes in the simulation thread */
+  std::vector<Ptr<CodebookParametric> > codebooks;
+  std::vector<uint32_t> traceIDs;
+  for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); it++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> ((*it)->GetDevice (0));
+      NS_ABORT_MSG_IF (device == 0, "Node " << (*it)->GetId () << " has no WifiNetDevice");
+      Ptr<SpectrumDmgWifiPhy> spectrumPhy = DynamicCast<SpectrumDmgWifiPhy> (device->GetPhy ());
+      NS_ABORT_MSG_IF (spectrumPhy == 0, "Node " << (*it)->GetId () << " has no SpectrumDmgWifiPhy");
+      Ptr<CodebookParametric> codebook = DynamicCast<CodebookParametric> (spectrumPhy->GetCodebook ());
+      NS_ABORT_MSG_IF (codebook == 0, "Node " << (*it)->GetId () << " does not use a parametric codebook");
+      codebooks.push_back (codebook);
+      traceIDs.push_back (GetTraceID (*it));
+    }
+
+  /* Prepare the Q-D files that have not been loaded yet */
+  std::vector<QdPairTraces> pairs;
+  std::vector<std::pair<uint32_t, uint32_t> > pairNodes;
+  for (uint32_t tx = 0; tx < nodes.GetN (); tx++)
+    {
+      for (uint32_t rx = 0; rx < nodes.GetN (); rx++)
+        {
+          if ((tx != rx) && (m_traceFiles.find (std::make_pair (traceIDs[tx], traceIDs[rx])) == m_traceFiles.end ()))
+            {
+              pairNodes.push_back (std::make_pair (tx, rx));
+            }
+        }
+    }
+  pairs.resize (pairNodes.size ());
+  for (uint32_t i = 0; i < pairNodes.size (); i++)
+    {
+      uint32_t tx = pairNodes[i].first;
+      uint32_t rx = pairNodes[i].second;
+      PrepareQdFile (codebooks[tx], codebooks[rx], traceIDs[tx], traceIDs[rx], pairs[i]);
+    }
+
+  /* Parse all the Q-D files in parallel */
+  NS_LOG_INFO ("Loading " << pairs.size () << " Q-D files using " << numThreads << " threads");
+  QdWorkerPool<QdPairTraces> parsePool (pairs, MakeCallback (&QdPropagationEngine::ParseQdFile, this));
+  parsePool.Run (numThreads);
+
+  /* Merge the traces in a deterministic order and gather the angles of each codebook */
+  std::map<Ptr<CodebookParametric>, PatternAnglesSetMap> codebookAngles;
+  for (uint32_t i = 0; i < pairs.size (); i++)
+    {
+      MergeQdTraces (pairs[i]);
+      Ptr<CodebookParametric> txCodebook = codebooks[pairNodes[i].first];
+      Ptr<CodebookParametric> rxCodebook = codebooks[pairNodes[i].second];
+      if (!txCodebook->ArrayPatternsPrecalculated ())
+        {
+          for (PatternAnglesSetMap::const_iterator it = pairs[i].txAngles.begin (); it != pairs[i].txAngles.end (); it++)
+            {
+              codebookAngles[txCodebook][it->first].insert (it->second.begin (), it->second.end ());
+            }
+        }
+      if (!rxCodebook->ArrayPatternsPrecalculated ())
+        {
+          for (PatternAnglesSetMap::const_iterator it = pairs[i].rxAngles.begin (); it != pairs[i].rxAngles.end (); it++)
+            {
+              codebookAngles[rxCodebook][it->first].insert (it->second.begin (), it->second.end ());
+            }
+        }
+    }
+  pairs.clear ();
+
+  /* Calculate the array patterns in parallel, each codebook is owned by exactly one thread */
+  std::vector<QdCodebookPatterns> patterns;
+  for (std::map<Ptr<CodebookParametric>, PatternAnglesSetMap>::iterator it = codebookAngles.begin ();
+       it != codebookAngles.end (); it++)
+    {
+      QdCodebookPatterns entry;
+      entry.codebook = PeekPointer (it->first);
+      entry.angles.swap (it->second);
+      patterns.push_back (entry);
+    }
+  NS_LOG_INFO ("Calculating the array patterns of " << patterns.size () << " codebooks");
+  QdWorkerPool<QdCodebookPatterns> patternPool (patterns, MakeCallback (&QdPropagationEngine::CalculateCodebookPatterns, this));
+  patternPool.Run (numThreads);
+}
+
 void
 QdPropagationEngine::AddCustomID (const uint32_t nodeID, const uint32_t qdID)
 {
@@ -454,12 +924,10 @@ QdPropagationEngine::GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
   HandleMobility ();
 
   CommunicatingPair pair = std::make_pair (indexTx, indexRx);
-  TraceFiles_I trIt = find (m_traceFiles.begin (), m_traceFiles.end (), pair);
-  if (trIt == m_traceFiles.end ())
+  if (m_traceFiles.find (pair) == m_traceFiles.end ())
     {
       /* Load Q-D files in order to fill all the needed parameters to compute channel gain */
       InitializeQDModelParameters (a, b, indexTx, indexRx);
-      m_traceFiles.push_back (pair);
     }
 
   /* Create Q-D channel identifier */
@@ -485,32 +953,76 @@ QdPropagationEngine::GetChannelGain (Ptr<SpectrumValue> rxPsd,
                                      Ptr<PatternConfig> txPattern, Ptr<PatternConfig> rxPattern) const
 {
   NS_LOG_FUNCTION (this << pathNum);
-  double t = Simulator::Now ().GetSeconds ();
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_QD_GET_CHANNEL_GAIN);
   Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue> (rxPsd);
-  Bands::const_iterator fit = tempPsd->ConstBandsBegin ();
+  QdChannelGainJob job;
+  job.psd = PeekPointer (tempPsd);
+  job.pathNum = pathNum;
+  job.chId = chId;
+  job.time = Simulator::Now ().GetSeconds ();
+  job.txPattern = PeekPointer (DynamicCast<ParametricPatternConfig> (txPattern));
+  job.txPrecalculated = txCodebook->ArrayPatternsPrecalculated ();
+  job.rxPattern = PeekPointer (DynamicCast<ParametricPatternConfig> (rxPattern));
+  job.rxPrecalculated = rxCodebook->ArrayPatternsPrecalculated ();
+  job.concurrent = false;
+  CalculateChannelGain (job);
+  return tempPsd;
+}
+
+void
+QdPropagationEngine::CalculateChannelGain (QdChannelGainJob &job) const
+{
+  /* Only const accesses to the channel tables, so that several jobs can run concurrently */
+  const floatVector_t *delays = 0, *pathLosses = 0, *phases = 0, *dopplerShifts = 0;
+  const floatVector_t *aodAzimuths = 0, *aodElevations = 0, *aoaAzimuths = 0, *aoaElevations = 0;
+  if (job.pathNum > 0)
+    {
+      const ChannelCoefficientMap &delayMap = delayTxRx;
+      const ChannelCoefficientMap &pathLossMap = pathLossTxRx;
+      const ChannelCoefficientMap &phaseMap = phaseTxRx;
+      const ChannelCoefficientMap &aodAzimuthMap = aodAzimuthTxRx;
+      const ChannelCoefficientMap &aodElevationMap = aodElevationTxRx;
+      const ChannelCoefficientMap &aoaAzimuthMap = aoaAzimuthTxRx;
+      const ChannelCoefficientMap &aoaElevationMap = aoaElevationTxRx;
+      delays = &delayMap.at (job.chId);
+      pathLosses = &pathLossMap.at (job.chId);
+      phases = &phaseMap.at (job.chId);
+      aodAzimuths = &aodAzimuthMap.at (job.chId);
+      aodElevations = &aodElevationMap.at (job.chId);
+      aoaAzimuths = &aoaAzimuthMap.at (job.chId);
+      aoaElevations = &aoaElevationMap.at (job.chId);
+      if (m_interval.IsStrictlyPositive ())
+        {
+          const ChannelCoefficientMap &dopplerShiftMap = dopplerShiftTxRx;
+          dopplerShifts = &dopplerShiftMap.at (job.chId);
+        }
+    }
+
+  double t = job.time;
+  Bands::const_iterator fit = job.psd->ConstBandsBegin ();
 
   float temp_delay, f_d, temp_Doppler, pathPowerLinear, phase;
   Complex delay, doppler,complexPhase, smallScaleFading, txSum, rxSum;
   uint16_t indexTxAzimuth, indexTxElevation, indexRxAzimuth, indexRxElevation;
 
-  /* Iterate through tempPsd (vectors containing the power corresponding to a subband) to compute the gain */
-  for (Values::iterator vit = tempPsd->ValuesBegin (); vit != tempPsd->ValuesEnd (); vit++, fit++)
+  /* Iterate through the PSD (vectors containing the power corresponding to a subband) to compute the gain */
+  for (Values::iterator vit = job.psd->ValuesBegin (); vit != job.psd->ValuesEnd (); vit++, fit++)
     {
       if ((*vit) != 0.00)
         {
           Complex subsbandGain (0.0, 0.0);
-          if (pathNum > 0)
+          if (job.pathNum > 0)
             {
-              for (uint pathIndex = 0; pathIndex < pathNum; pathIndex++)
+              for (uint pathIndex = 0; pathIndex < job.pathNum; pathIndex++)
                 {
-                  temp_delay = -2 * M_PI * fit->fc * delayTxRx[chId].at (pathIndex);
+                  temp_delay = -2 * M_PI * fit->fc * delays->at (pathIndex);
                   delay = Complex (cos (temp_delay), sin (temp_delay));
 
-                  if (m_interval.IsStrictlyPositive ())
+                  if (dopplerShifts != 0)
                     {
                       /* TODO We are not yet using Doppler */
                       f_d = 0.8;
-                      temp_Doppler = 2*M_PI*t*f_d*dopplerShiftTxRx[chId].at (pathIndex);
+                      temp_Doppler = 2*M_PI*t*f_d*dopplerShifts->at (pathIndex);
                       doppler = Complex (cos (temp_Doppler), sin (temp_Doppler));
                     }
                   else
@@ -518,23 +1030,27 @@ QdPropagationEngine::GetChannelGain (Ptr<SpectrumValue> rxPsd,
                       doppler = Complex (1, 0);
                     }
 
-                  pathPowerLinear = std::pow (10.0, (pathLossTxRx[chId].at (pathIndex))/10.0);
-                  phase = phaseTxRx[chId].at (pathIndex);
+                  pathPowerLinear = std::pow (10.0, (pathLosses->at (pathIndex))/10.0);
+                  phase = phases->at (pathIndex);
                   complexPhase = Complex (cos (phase), sin (phase));
                   smallScaleFading = float (sqrt (pathPowerLinear)) * doppler * delay * complexPhase;
 
                   /* Compute the gain for each band */
-                  indexTxAzimuth = aodAzimuthTxRx[chId].at (pathIndex);
-                  indexTxElevation = aodElevationTxRx[chId].at (pathIndex);
-                  txSum = txCodebook->GetAntennaArrayPattern (txPattern, indexTxAzimuth, indexTxElevation);
-
-                  indexRxAzimuth = aoaAzimuthTxRx[chId].at (pathIndex);
-                  indexRxElevation = aoaElevationTxRx[chId].at (pathIndex);
-                  rxSum = rxCodebook->GetAntennaArrayPattern (rxPattern, indexRxAzimuth, indexRxElevation);
+                  indexTxAzimuth = aodAzimuths->at (pathIndex);
+                  indexTxElevation = aodElevations->at (pathIndex);
+                  indexRxAzimuth = aoaAzimuths->at (pathIndex);
+                  indexRxElevation = aoaElevations->at (pathIndex);
+                  if (!GetArrayPatternValue (job.txPattern, job.txPrecalculated, job.concurrent,
+                                             indexTxAzimuth, indexTxElevation, txSum)
+                      || !GetArrayPatternValue (job.rxPattern, job.rxPrecalculated, job.concurrent,
+                                                indexRxAzimuth, indexRxElevation, rxSum))
+                    {
+                      job.complete = false;
+                      return;
+                    }
 
                   /* Add multipath effect to the subband gain */
                   subsbandGain = subsbandGain + rxSum * txSum * smallScaleFading;
-//                  NS_LOG_DEBUG ("TxSum=" << txSum << ", RxSum=" << rxSum);
                 }
             }
           else
@@ -545,7 +1061,7 @@ QdPropagationEngine::GetChannelGain (Ptr<SpectrumValue> rxPsd,
           *vit = (*vit) * (std::norm (subsbandGain));
         }
     }
-  return tempPsd;
+  job.complete = true;
 }
 
 void
@@ -564,12 +1080,54 @@ QdPropagationEngine::HandleMobility (void) const
     }
 }
 
+Ptr<SpectrumValue>
+QdPropagationEngine::GetLinkRxPower (Ptr<SpectrumValue> txPsd, uint32_t indexTx, uint32_t indexRx,
+                                     Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook,
+                                     const LinkConfiguration &key) const
+{
+  NS_LOG_FUNCTION (this << indexTx << indexRx);
+  ChannelGainMatrix_I it = m_channelGainMatrix.find (key);
+  if (it != m_channelGainMatrix.end ())
+    {
+      /* The channel has already been computed */
+      return it->second;
+    }
+
+  const AntennaConfigTx &antennaConfigTx = std::get<2> (key);
+  const AntennaConfigRx &antennaConfigRx = std::get<3> (key);
+  QdChanneldentifier chId = std::make_tuple (indexTx, indexRx, m_currentIndex,
+                                             antennaConfigTx.first, antennaConfigRx.first);
+  uint16_t pathNum = nbMultipathTxRx[chId];
+
+  /* Doppler effect */
+  if (m_interval.IsStrictlyPositive ())
+    {
+      floatVector_t dopplerShiftVec;
+      for (uint16_t i = 0; i < pathNum; i++)
+        {
+          dopplerShiftVec.push_back (m_uniformRv->GetValue (0, 1));
+        }
+      dopplerShiftTxRx[chId] = dopplerShiftVec;
+    }
+
+  /*
+   * Insert the channel into the Channel matrix to avoid
+   * recomputing the channel every time if there is no Mobility.
+   */
+  Ptr<SpectrumValue> chPsd = GetChannelGain (txPsd, pathNum, chId,
+                                             txCodebook, rxCodebook,
+                                             antennaConfigTx.second, antennaConfigRx.second);
+  m_channelGainMatrix[key] = chPsd;
+  return chPsd;
+}
+
 Ptr<SpectrumValue>
 QdPropagationEngine::CalcRxPower (Ptr<SpectrumSignalParameters> params,
 				  Ptr<const MobilityModel> a,
 				  Ptr<const MobilityModel> b) const
 {
   NS_LOG_FUNCTION (this);
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_QD_CALC_RX_POWER);
 
   uint32_t indexTx, indexRx;
 
@@ -607,44 +1165,207 @@ QdPropagationEngine::CalcRxPower (Ptr<SpectrumSignalParameters> params,
   /* Mobility Management */
   HandleMobility ();
 
-  ChannelGainMatrix_I it = m_channelGainMatrix.find (key);
-  Ptr<SpectrumValue> chPsd;
+  Ptr<SpectrumValue> chPsd = GetLinkRxPower (rxParams->psd, indexTx, indexRx, txCodebook, rxCodebook, key);
+
+  return chPsd;
+}
 
-  /* Check if the channel has already been computed between transmitter and receiver for certain antenna configurations */
-  if (it == m_channelGainMatrix.end ())
+void
+QdPropagationEngine::PrepareRxPower (Ptr<const MobilityModel> a, const SpectrumReceiverList &receivers) const
+{
+  NS_LOG_FUNCTION (this << receivers.size ());
+  /* With mobility, the channel gain depends on the time of the reception and on Doppler shifts drawn in the order of the receptions */
+  if ((m_rxPowerThreads == 0) || m_interval.IsStrictlyPositive ())
+    {
+      return;
+    }
+
+  Ptr<NetDevice> txDevice = a->GetObject<Node> ()->GetDevice (0);
+  Ptr<WifiNetDevice> wifiTxDevice = DynamicCast<WifiNetDevice> (txDevice);
+  Ptr<SpectrumDmgWifiPhy> txSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiTxDevice->GetPhy ());
+  Ptr<CodebookParametric> txCodebook = DynamicCast<CodebookParametric> (txSpectrum->GetCodebook ());
+  uint32_t indexTx = m_useCustomIDs ? GetQdID (txDevice->GetNode ()->GetId ()) : txDevice->GetNode ()->GetId ();
+  double now = Simulator::Now ().GetSeconds ();
+
+  /* Collect the link configurations which have not been computed yet in the simulation thread */
+  std::vector<QdChannelGainJob> jobs;
+  std::vector<LinkConfiguration> keys;
+  std::vector<Ptr<SpectrumValue> > psdList;
+  for (SpectrumReceiverList::const_iterator it = receivers.begin (); it != receivers.end (); it++)
     {
+      Ptr<DmgWifiSpectrumSignalParameters> rxParams = DynamicCast<DmgWifiSpectrumSignalParameters> (it->first);
+      if ((rxParams == 0) || rxParams->isMimo)
+        {
+          continue;
+        }
+      Ptr<NetDevice> rxDevice = it->second->GetObject<Node> ()->GetDevice (0);
+      Ptr<WifiNetDevice> wifiRxDevice = DynamicCast<WifiNetDevice> (rxDevice);
+      Ptr<SpectrumDmgWifiPhy> rxSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiRxDevice->GetPhy ());
+      Ptr<CodebookParametric> rxCodebook = DynamicCast<CodebookParametric> (rxSpectrum->GetCodebook ());
+      uint32_t indexRx = m_useCustomIDs ? GetQdID (rxDevice->GetNode ()->GetId ()) : rxDevice->GetNode ()->GetId ();
+      if (m_traceFiles.find (std::make_pair (indexTx, indexRx)) == m_traceFiles.end ())
+        {
+          continue;
+        }
+
+      AntennaConfigTx antennaConfigTx = std::make_pair (rxParams->antennaId, rxParams->txPatternConfig);
+      AntennaConfigRx antennaConfigRx = std::make_pair (rxCodebook->GetActiveAntennaID (),
+                                                        rxCodebook->GetRxPatternConfig ());
+      LinkConfiguration key = std::make_tuple (txDevice, rxDevice, antennaConfigTx, antennaConfigRx);
+      if (m_channelGainMatrix.find (key) != m_channelGainMatrix.end ())
+        {
+          continue;
+        }
       QdChanneldentifier chId = std::make_tuple (indexTx, indexRx, m_currentIndex,
-                                                 rxParams->antennaId, rxCodebook->GetActiveAntennaID ());
+                                                 antennaConfigTx.first, antennaConfigRx.first);
+      std::map<QdChanneldentifier, uint32_t>::const_iterator pathIt = nbMultipathTxRx.find (chId);
+      if (pathIt == nbMultipathTxRx.end ())
+        {
+          continue;
+        }
 
-      uint16_t pathNum = nbMultipathTxRx[chId];
+      Ptr<SpectrumValue> psd = Copy<SpectrumValue> (rxParams->psd);
+      QdChannelGainJob job;
+      job.psd = PeekPointer (psd);
+      job.pathNum = pathIt->second;
+      job.chId = chId;
+      job.time = now;
+      job.txPattern = PeekPointer (DynamicCast<ParametricPatternConfig> (antennaConfigTx.second));
+      job.txPrecalculated = txCodebook->ArrayPatternsPrecalculated ();
+      job.rxPattern = PeekPointer (DynamicCast<ParametricPatternConfig> (antennaConfigRx.second));
+      job.rxPrecalculated = rxCodebook->ArrayPatternsPrecalculated ();
+      job.concurrent = true;
+      job.complete = false;
+      jobs.push_back (job);
+      keys.push_back (key);
+      psdList.push_back (psd);
+    }
 
-      /* Doppler effect */
-      if (m_interval.IsStrictlyPositive ())
+  /* Calculate the channel gains in parallel and merge them in the order of the receivers */
+  if (m_rxPowerWorkers == 0)
+    {
+      m_rxPowerWorkers = new QdRxPowerWorkers (m_rxPowerThreads,
+                                               MakeCallback (&QdPropagationEngine::CalculateChannelGain, this));
+    }
+  m_rxPowerWorkers->Run (jobs);
+  for (uint32_t i = 0; i < jobs.size (); i++)
+    {
+      /* Otherwise the channel gain is calculated when the signal reaches the receiver */
+      if (jobs[i].complete)
+        {
+          m_channelGainMatrix[keys[i]] = psdList[i];
+        }
+    }
+}
+
+bool
+QdPropagationEngine::GetStrongestPathGain (uint32_t indexTx, uint32_t indexRx, uint32_t traceIndex, double &gain) const
+{
+  bool found = false;
+  /* The channel identifiers of a pair at a given trace index are contiguous, one per pair of antennas */
+  for (ChannelCoefficientMap::const_iterator it = pathLossTxRx.lower_bound (QdChanneldentifier (indexTx, indexRx, traceIndex, 0, 0));
+       (it != pathLossTxRx.end ()) && (std::get<0> (it->first) == indexTx)
+       && (std::get<1> (it->first) == indexRx) && (std::get<2> (it->first) == traceIndex); it++)
+    {
+      for (floatVector_t::const_iterator path = it->second.begin (); path != it->second.end (); path++)
         {
-          floatVector_t dopplerShiftVec;
-          for (uint16_t i = 0; i < pathNum; i++)
+          if (!found || (*path > gain))
             {
-              dopplerShiftVec.push_back (m_uniformRv->GetValue (0, 1));
+              gain = *path;
+              found = true;
             }
-          dopplerShiftTxRx[chId] = dopplerShiftVec;
         }
+    }
+  return found;
+}
 
-      /*
-       * Insert the channel into the Channel matrix to avoid
-       * recomputing the channel every time if there is no Mobility.
-       */
-      chPsd = GetChannelGain (rxParams->psd, pathNum, chId,
-                              txCodebook, rxCodebook,
-                              rxParams->txPatternConfig, rxCodebook->GetRxPatternConfig ());
-      m_channelGainMatrix[key] = chPsd;
+bool
+QdPropagationEngine::PredictChannelChange (Ptr<Node> txNode, Ptr<Node> rxNode, Time lookAhead, double &change) const
+{
+  NS_LOG_FUNCTION (this << txNode->GetId () << rxNode->GetId () << lookAhead);
+  uint32_t indexTx = GetTraceID (txNode);
+  uint32_t indexRx = GetTraceID (rxNode);
+  if (m_traceFiles.find (std::make_pair (indexTx, indexRx)) == m_traceFiles.end ())
+    {
+      return false;
+    }
+
+  HandleMobility ();
+  double currentGain;
+  if (!GetStrongestPathGain (indexTx, indexRx, m_currentIndex, currentGain))
+    {
+      return false;
+    }
+
+  uint32_t futureIndex = m_currentIndex;
+  if (m_interval.IsStrictlyPositive ())
+    {
+      /* We keep using the channel corresponding to the last entry in the Q-D file */
+      futureIndex = m_startIndex + ((Simulator::Now () + lookAhead)/m_interval).GetHigh ();
+      futureIndex = std::min (futureIndex, m_numTraces - 1);
+    }
+  double futureGain;
+  if (GetStrongestPathGain (indexTx, indexRx, futureIndex, futureGain))
+    {
+      change = futureGain - currentGain;
     }
   else
     {
-      /* The channel has already been computed */
-      chPsd = (*it).second;
+      change = -std::numeric_limits<double>::infinity ();
     }
+  NS_LOG_DEBUG ("Predicted channel change between trace index " << m_currentIndex
+                << " and " << futureIndex << " is " << change << " dB");
+  return true;
+}
 
-  return chPsd;
+std::vector<Ptr<SpectrumValue> >
+QdPropagationEngine::CalcSectorSweepRxPower (Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice,
+                                             Ptr<SpectrumValue> txPsd,
+                                             const SECTOR_SWEEP_CONFIGURATION_LIST &sweep) const
+{
+  NS_LOG_FUNCTION (this << txDevice << rxDevice << sweep.size ());
+
+  Ptr<WifiNetDevice> wifiTxDevice = DynamicCast<WifiNetDevice> (txDevice);
+  Ptr<SpectrumDmgWifiPhy> txSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiTxDevice->GetPhy ());
+  Ptr<CodebookParametric> txCodebook = DynamicCast<CodebookParametric> (txSpectrum->GetCodebook ());
+
+  Ptr<WifiNetDevice> wifiRxDevice = DynamicCast<WifiNetDevice> (rxDevice);
+  Ptr<SpectrumDmgWifiPhy> rxSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiRxDevice->GetPhy ());
+  Ptr<CodebookParametric> rxCodebook = DynamicCast<CodebookParametric> (rxSpectrum->GetCodebook ());
+  NS_ABORT_MSG_IF (txCodebook == 0 || rxCodebook == 0, "The Q-D propagation engine requires a parametric codebook");
+
+  uint32_t indexTx = GetTraceID (txDevice->GetNode ());
+  uint32_t indexRx = GetTraceID (rxDevice->GetNode ());
+
+  /* Mobility Management */
+  HandleMobility ();
+
+  /* The traces are loaded lazily in GetDelay when the first frame is exchanged, do the same here */
+  CommunicatingPair pair = std::make_pair (indexTx, indexRx);
+  if (m_traceFiles.find (pair) == m_traceFiles.end ())
+    {
+      InitializeQDModelParameters (txDevice->GetNode ()->GetObject<MobilityModel> (),
+                                   rxDevice->GetNode ()->GetObject<MobilityModel> (),
+                                   indexTx, indexRx);
+    }
+
+  std::vector<Ptr<SpectrumValue> > rxPsdList;
+  rxPsdList.reserve (sweep.size ());
+  for (SECTOR_SWEEP_CONFIGURATION_LIST::const_iterator it = sweep.begin (); it != sweep.end (); it++)
+    {
+      AntennaID txAntennaID = it->first.first;
+      SectorID sectorID = it->first.second;
+      AntennaID rxAntennaID = it->second;
+      Ptr<ParametricAntennaConfig> txAntenna =
+          StaticCast<ParametricAntennaConfig> (txCodebook->m_antennaArrayList[txAntennaID]);
+      Ptr<ParametricAntennaConfig> rxAntenna =
+          StaticCast<ParametricAntennaConfig> (rxCodebook->m_antennaArrayList[rxAntennaID]);
+      AntennaConfigTx antennaConfigTx = std::make_pair (txAntennaID, txAntenna->sectorList[sectorID]);
+      AntennaConfigRx antennaConfigRx = std::make_pair (rxAntennaID, rxAntenna->GetQuasiOmniConfig ());
+      LinkConfiguration key = std::make_tuple (txDevice, rxDevice, antennaConfigTx, antennaConfigRx);
+      rxPsdList.push_back (GetLinkRxPower (txPsd, indexTx, indexRx, txCodebook, rxCodebook, key));
+    }
+  return rxPsdList;
 }
 
 void
@@ -700,40 +1421,7 @@ QdPropagationEngine::CalcMimoRxPower (Ptr<SpectrumSignalParameters> params,
           AntennaConfigRx antennaConfigRx = std::make_pair (rxAntenna.first, rxAntenna.second);
           LinkConfiguration key = std::make_tuple (txDevice, rxDevice, antennaConfigTx, antennaConfigRx);
 
-          ChannelGainMatrix_I it = m_channelGainMatrix.find (key);
-          Ptr<SpectrumValue> chPsd;
-
-          /* Check if the channel has already been computed between transmitter and receiver for certain antenna configurations */
-          if (it == m_channelGainMatrix.end ())
-            {
-              QdChanneldentifier chId = std::make_tuple (indexTx, indexRx, m_currentIndex, txAntenna.first, rxAntenna.first);
-              uint16_t pathNum = nbMultipathTxRx[chId];
-
-              /* Doppler effect */
-              if (m_interval.IsStrictlyPositive ())
-                {
-                  floatVector_t dopplerShiftVec;
-                  for (uint16_t i = 0; i < pathNum; i++)
-                    {
-                      dopplerShiftVec.push_back (m_uniformRv->GetValue (0, 1));
-                    }
-                  dopplerShiftTxRx[chId] = dopplerShiftVec;
-                }
-
-              /*
-               * Insert the channel into the Channel matrix to avoid
-               * recomputing the channel every time if there is no Mobility.
-               */
-              chPsd = GetChannelGain (rxParams->psd, pathNum, chId,
-                                      txCodebook, rxCodebook,
-                                      txAntenna.second, rxAntenna.second);
-              m_channelGainMatrix[key] = chPsd;
-            }
-          else
-            {
-              /* The channel has already been computed */
-              chPsd = (*it).second;
-            }
+          Ptr<SpectrumValue> chPsd = GetLinkRxPower (rxParams->psd, indexTx, indexRx, txCodebook, rxCodebook, key);
           rxParams->psdList.push_back (chPsd);
         }
     }
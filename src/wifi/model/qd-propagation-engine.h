@@ -42,12 +42,17 @@
 
 #include <complex>
 #include <map>
+#include <set>
 #include <tuple>
 
 #include "codebook-parametric.h"
 
+class QdPrecomputeTest;
+
 namespace ns3 {
 
+class QdRxPowerWorkers;
+
 typedef std::vector<float> floatVector_t;
 typedef std::vector<floatVector_t> float2DVector_t;
 
@@ -76,11 +81,14 @@ typedef std::map<LinkConfiguration, Ptr<SpectrumValue> > ChannelGainMatrix;
 typedef ChannelGainMatrix::iterator ChannelGainMatrix_I;                        //!< Typedef for iterator over channel gain matrix.
 typedef ChannelGainMatrix::const_iterator ChannelMatrix_CI;                     //!< Typedef for constant iterator over channel matrix.
 typedef std::pair<uint32_t, uint32_t> CommunicatingPair;                        //!< Typedef for identifying communicating pair.
-typedef std::vector<CommunicatingPair> TraceFiles;                              //!< Check whether trace files have been loaded or not.
+typedef std::set<CommunicatingPair> TraceFiles;                                 //!< Check whether trace files have been loaded or not.
 typedef TraceFiles::iterator TraceFiles_I;                                      //!< Typedef for iterator over traces files.
 
 class DmgWifiSpectrumSignalParameters;
 class NodeContainer;
+struct QdPairTraces;
+struct QdCodebookPatterns;
+struct QdChannelGainJob;
 
 /**
  * Different options for normalizing antenna weights.
@@ -94,6 +102,9 @@ enum WeightsNormlization {
 class QdPropagationEngine : public Object
 {
 public:
+  /// allow QdPrecomputeTest class access
+  friend class ::QdPrecomputeTest;
+
   /**
    * \brief Get the type ID.
    * \return the object TypeId
@@ -131,6 +142,41 @@ public:
   void ReadNodesConfigurationFile (std::string nodesConfugrationFile,
                                    uint16_t &numAPs, NodeContainer &apWifiNodes,
                                    NodeContainer &staWifiNodes, std::vector<NodeContainer> &staNodesGroups);
+  /**
+   * Load the Q-D traces of all the communicating pairs within the given nodes and compute the array patterns
+   * of all the codebook patterns at the angles found in these traces. The Q-D files are parsed and the array
+   * patterns are calculated on a pool of threads (see PrecomputeThreads attribute), the results are then merged
+   * into the tables used by the event loop. This function must be called after installing the codebooks and
+   * before Simulator::Run, otherwise the traces are loaded lazily on the first contact between two nodes.
+   * \param nodes The nodes equipped with DMG devices using a parametric codebook.
+   */
+  void Precompute (NodeContainer nodes);
+  /**
+   * Calculate the received power spectral density of a list of transmit sectors towards a receiver listening
+   * in quasi-omni mode. This evaluates a complete sector sweep in a single call instead of transmitting one
+   * SSW frame per sector over the channel.
+   * \param txDevice Pointer to the transmitting device.
+   * \param rxDevice Pointer to the receiving device.
+   * \param txPsd The power spectral density of the transmitted SSW frames.
+   * \param sweep The list of transmit antenna configurations and receive antennas to evaluate.
+   * \return The received power spectral density of each step of the sweep.
+   */
+  std::vector<Ptr<SpectrumValue> > CalcSectorSweepRxPower (Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice,
+                                                           Ptr<SpectrumValue> txPsd,
+                                                           const SECTOR_SWEEP_CONFIGURATION_LIST &sweep) const;
+  /**
+   * Predict the change of the channel between two nodes over a look-ahead interval using the Q-D traces.
+   * The channel is represented by the power of its strongest multipath component among all the pairs of
+   * antennas, hence the prediction does not depend on the antenna configurations used by the nodes.
+   * \param txNode Pointer to the transmitting node.
+   * \param rxNode Pointer to the receiving node.
+   * \param lookAhead The look-ahead interval.
+   * \param change The predicted change in dB of the power of the strongest multipath component, minus
+   * infinity if no multipath component is left at the end of the look-ahead interval.
+   * \return True if the Q-D traces of the pair have been loaded and contain at least one multipath
+   * component at the current trace index, otherwise false.
+   */
+  bool PredictChannelChange (Ptr<Node> txNode, Ptr<Node> rxNode, Time lookAhead, double &change) const;
 
 protected:
   virtual void DoDispose ();
@@ -173,6 +219,15 @@ protected:
   void CalcMimoRxPower (Ptr<SpectrumSignalParameters> params,
                         Ptr<const MobilityModel> a,
                         Ptr<const MobilityModel> b) const;
+  /**
+   * Calculate in advance the channel gains of all the receivers of a transmission on a pool of threads
+   * (see RxPowerThreads attribute). The channel gains are merged into the channel matrix in the order of
+   * the receivers, so that CalcRxPower finds them when the signal reaches each receiver and returns the
+   * same values as if they were calculated at that time.
+   * \param a sender mobility
+   * \param receivers the signal parameters and the mobility of each receiver of the transmission.
+   */
+  void PrepareRxPower (Ptr<const MobilityModel> a, const SpectrumReceiverList &receivers) const;
 
 private:
   /**
@@ -189,6 +244,62 @@ private:
    */
   void InitializeQDModelParameters (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b,
                                     uint16_t indexTx, uint16_t indexRx) const;
+  /**
+   * Get the power of the strongest multipath component between two nodes among all the pairs of antennas.
+   * \param indexTx The ID of the Tx node.
+   * \param indexRx The ID of the Rx node.
+   * \param traceIndex The index in the Q-D traces.
+   * \param gain The power in dB of the strongest multipath component.
+   * \return True if there is at least one multipath component, otherwise false.
+   */
+  bool GetStrongestPathGain (uint32_t indexTx, uint32_t indexRx, uint32_t traceIndex, double &gain) const;
+  /**
+   * Get the ID used for reading the Q-D files of the given node.
+   * \param node Pointer to the node.
+   * \return The ID of the node in the Q-D files.
+   */
+  uint32_t GetTraceID (Ptr<Node> node) const;
+  /**
+   * Prepare the parsing of the Q-D file between two devices by computing the rotation matrices of their antennas.
+   * \param txCodebook Pointer to the codebook of the Tx device.
+   * \param rxCodebook Pointer to the codebook of the Rx device.
+   * \param indexTx The ID of the Tx node.
+   * \param indexRx The ID of the Rx node.
+   * \param traces The Q-D traces of the pair to be filled by ParseQdFile.
+   */
+  void PrepareQdFile (Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook,
+                      uint32_t indexTx, uint32_t indexRx, QdPairTraces &traces) const;
+  /**
+   * Parse the Q-D file of a communicating pair. This function does not touch any shared state
+   * so it can be executed outside the simulation thread.
+   * \param traces The Q-D traces of the pair prepared by PrepareQdFile.
+   */
+  void ParseQdFile (QdPairTraces &traces) const;
+  /**
+   * Insert the parsed Q-D traces of a communicating pair into the channel tables.
+   * \param traces The parsed Q-D traces of the pair.
+   */
+  void MergeQdTraces (QdPairTraces &traces) const;
+  /**
+   * Calculate the array patterns of all the patterns in a codebook at the given angles. This function only
+   * touches the given codebook so it can be executed outside the simulation thread.
+   * \param patterns The codebook and the angles to calculate the array patterns at.
+   */
+  void CalculateCodebookPatterns (QdCodebookPatterns &patterns) const;
+  /**
+   * Get the received power spectral density for a link configuration, the channel gain is computed only once
+   * per link configuration and Q-D trace index.
+   * \param txPsd The transmitted power spectral density.
+   * \param indexTx The ID of the Tx node.
+   * \param indexRx The ID of the Rx node.
+   * \param txCodebook Pointer to the codebook of the Tx device.
+   * \param rxCodebook Pointer to the codebook of the Rx device.
+   * \param key The link configuration.
+   * \return The received power spectral density.
+   */
+  Ptr<SpectrumValue> GetLinkRxPower (Ptr<SpectrumValue> txPsd, uint32_t indexTx, uint32_t indexRx,
+                                     Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook,
+                                     const LinkConfiguration &key) const;
   /**
    * Compute the channel gain between two devices or antennas.
    * \param rxPsd The received power spectral density.
@@ -204,6 +315,13 @@ private:
                                      uint16_t pathNum, QdChanneldentifier chId,
                                      Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook,
                                      Ptr<PatternConfig> txPattern, Ptr<PatternConfig> rxPattern) const;
+  /**
+   * Multiply a power spectral density by the channel gain of a link configuration. This function only
+   * reads the channel tables and the array patterns if the job is concurrent, so it can be executed
+   * outside the simulation thread.
+   * \param job The channel gain calculation.
+   */
+  void CalculateChannelGain (QdChannelGainJob &job) const;
   /**
    * Euler Transformtion for phased antenna array rotation.
    * \param orientation The orienation of the phased antenna array using Euler angles.
@@ -260,6 +378,9 @@ private:
   std::map<uint32_t, uint32_t> nodeId2QdId; //!< Structure to map node ID to Q-D Channel ID.
   bool m_useCustomIDs;                      //!< Flag to indicate whether we use custom list to map ns-3 nodes IDs to Q-D Software IDs.
   bool m_eulerTransform;                    //!< Flag to indicate whether we Euler angles for rotation or we use Quaternion.
+  uint32_t m_precomputeThreads;             //!< The number of threads used for precomputing the Q-D channel.
+  uint32_t m_rxPowerThreads;                //!< The number of threads used for calculating the channel gains of a transmission.
+  mutable QdRxPowerWorkers *m_rxPowerWorkers; //!< The threads calculating the channel gains of a transmission, started once.
 
 };
 
@@ -60,6 +60,12 @@ QdPropagationLossModel::~QdPropagationLossModel ()
   NS_LOG_FUNCTION (this);
 }
 
+Ptr<QdPropagationEngine>
+QdPropagationLossModel::GetQdPropagationEngine (void) const
+{
+  return m_qdPropagationEngine;
+}
+
 void
 QdPropagationLossModel::DoDispose ()
 {
@@ -97,4 +103,11 @@ QdPropagationLossModel::CalcMimoRxPower (Ptr<SpectrumSignalParameters> rxParams,
   return m_qdPropagationEngine->CalcMimoRxPower (rxParams, a, b);
 }
 
+void
+QdPropagationLossModel::PrepareRxPower (Ptr<const MobilityModel> a,
+                                        const SpectrumReceiverList &receivers) const
+{
+  m_qdPropagationEngine->PrepareRxPower (a, receivers);
+}
+
 } // namespace ns3
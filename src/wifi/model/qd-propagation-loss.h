@@ -54,6 +54,11 @@ public:
    * \param qdPropagationEngine Pointer to the Q-D Propagation Engine class.
    */
   QdPropagationLossModel (Ptr<QdPropagationEngine> qdPropagationEngine);
+  /**
+   * Get the Q-D propagation engine used by this propagation loss model.
+   * \return Pointer to the Q-D propagation engine.
+   */
+  Ptr<QdPropagationEngine> GetQdPropagationEngine (void) const;
 
 protected:
   virtual void DoDispose ();
@@ -93,6 +98,14 @@ private:
   void CalcMimoRxPower (Ptr<SpectrumSignalParameters> params,
                         Ptr<const MobilityModel> a,
                         Ptr<const MobilityModel> b) const;
+  /**
+   * Calculate in advance the received power of all the receivers of a transmission.
+   *
+   * \param a sender mobility
+   * \param receivers the signal parameters and the mobility of each receiver of the transmission.
+   */
+  void PrepareRxPower (Ptr<const MobilityModel> a,
+                       const SpectrumReceiverList &receivers) const;
 
 
 private:
@@ -1857,6 +1857,16 @@ QosTxop::CompleteMpduTx (Ptr<WifiMacQueueItem> mpdu)
     }
 }
 
+void
+QosTxop::RequeueMpdus (const std::vector<Ptr<WifiMacQueueItem>> &mpduList)
+{
+  NS_LOG_FUNCTION (this << mpduList.size ());
+  for (auto it = mpduList.rbegin (); it != mpduList.rend (); it++)
+    {
+      m_baManager->GetRetransmitQueue ()->PushFront (*it);
+    }
+}
+
 bool
 QosTxop::SetupBlockAckIfNeeded (void)
 {
@@ -34,6 +34,7 @@
 class AmpduAggregationTest;
 class TwoLevelAggregationTest;
 class HeAggregationTest;
+class DmgAmpduTrimTest;
 
 namespace ns3 {
 
@@ -86,6 +87,8 @@ public:
   friend class ::TwoLevelAggregationTest;
   /// allow HeAggregationTest class access
   friend class ::HeAggregationTest;
+  /// allow DmgAmpduTrimTest class access
+  friend class ::DmgAmpduTrimTest;
 
   std::map<Mac48Address, bool> m_aMpduEnabled; //!< list containing flags whether A-MPDU is enabled for a given destination address
 
@@ -319,6 +322,13 @@ public:
    * \param mpdu received MPDU.
    */
   void CompleteMpduTx (Ptr<WifiMacQueueItem> mpdu);
+  /**
+   * Return MPDUs that were part of an A-MPDU but are no longer going to be transmitted
+   * with it to the block ack manager retransmit queue, preserving their order.
+   *
+   * \param mpduList the MPDUs to requeue.
+   */
+  void RequeueMpdus (const std::vector<Ptr<WifiMacQueueItem>> &mpduList);
   /**
    * Return whether A-MPDU is used to transmit data to a peer station.
    *
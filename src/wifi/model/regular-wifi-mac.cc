@@ -1027,6 +1027,34 @@ RegularWifiMac::SetupFSTSession (Mac48Address staAddress)
   m_txop->Queue (packet, hdr);
 }
 
+FST_STATES
+RegularWifiMac::GetFstSessionState (Mac48Address staAddress) const
+{
+  FstSessionMap::const_iterator it = m_fstSessionMap.find (staAddress);
+  if (it == m_fstSessionMap.end ())
+    {
+      return FST_INITIAL_STATE;
+    }
+  return it->second.CurrentState;
+}
+
+bool
+RegularWifiMac::ExecuteFstTransition (Mac48Address staAddress)
+{
+  NS_LOG_FUNCTION (this << staAddress);
+  FstSessionMap::iterator it = m_fstSessionMap.find (staAddress);
+  if ((it == m_fstSessionMap.end ()) || (it->second.CurrentState != FST_SETUP_COMPLETION_STATE))
+    {
+      return false;
+    }
+  FstSession *fstSession = &it->second;
+  NS_LOG_LOGIC ("FST: Band change requested before the LLT expiry, so transit to FST_TRANSITION_DONE_STATE");
+  fstSession->LinkLossCountDownEvent.Cancel ();
+  fstSession->CurrentState = FST_TRANSITION_DONE_STATE;
+  ChangeBand (staAddress, fstSession->NewBandId, fstSession->IsInitiator);
+  return true;
+}
+
 void
 RegularWifiMac::SendFstSetupResponse (Mac48Address to, uint8_t token, uint16_t status, SessionTransitionElement sessionTransition)
 {
@@ -256,6 +256,20 @@ public:
    * \param staAddress The address of the sta to establish FST session with it.
    */
   void SetupFSTSession (Mac48Address staAddress);
+  /**
+   * Get the state of the FST session with a peer station.
+   * \param staAddress The address of the peer station.
+   * \return The current state of the FST session, FST_INITIAL_STATE if there is no session.
+   */
+  FST_STATES GetFstSessionState (Mac48Address staAddress) const;
+  /**
+   * Change the band of an established FST session now instead of waiting
+   * for the expiry of the Link Loss Timeout.
+   * \param staAddress The address of the peer station.
+   * \return True if the FST session was in FST_SETUP_COMPLETION_STATE and the band
+   * has been changed, otherwise false.
+   */
+  bool ExecuteFstTransition (Mac48Address staAddress);
   /**
    * Get Type Of Station.
    * \return station type
@@ -330,7 +344,7 @@ protected:
    * \param bandId The ID of the new band.
    * \param isInitiator True is we are the initiator of the FST, otherwise false.
    */
-  void ChangeBand (Mac48Address peerStation, BandID bandId, bool isInitiator);
+  virtual void ChangeBand (Mac48Address peerStation, BandID bandId, bool isInitiator);
   /**
    * MacTxOk
    * \param address
@@ -31,6 +31,9 @@
 #include "ns3/node.h"
 #include "spectrum-dmg-wifi-phy.h"
 #include "dmg-wifi-spectrum-phy-interface.h"
+#include "qd-propagation-engine.h"
+#include "qd-propagation-loss.h"
+#include "dmg-profiler.h"
 #include "wifi-utils.h"
 #include "wifi-ppdu.h"
 #include "wifi-psdu.h"
@@ -237,6 +240,7 @@ void
 SpectrumDmgWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
 {
   NS_LOG_FUNCTION (this << rxParams);
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_SPECTRUM_PHY_START_RX);
   Time rxDuration = rxParams->duration;
   Ptr<SpectrumValue> receivedSignalPsd = rxParams->psd;
   //NS_LOG_DEBUG ("Received signal with PSD " << *receivedSignalPsd << " and duration " << rxDuration.As (Time::NS));
@@ -452,6 +456,59 @@ SpectrumDmgWifiPhy::StartTx (Ptr<WifiPpdu> ppdu)
   m_channel->StartTx (txParams);
 }
 
+Ptr<QdPropagationEngine>
+SpectrumDmgWifiPhy::GetQdPropagationEngine (void) const
+{
+  if (m_channel == 0)
+    {
+      return 0;
+    }
+  Ptr<QdPropagationLossModel> lossModel = DynamicCast<QdPropagationLossModel> (m_channel->GetSpectrumPropagationLossModel ());
+  if (lossModel == 0)
+    {
+      return 0;
+    }
+  return lossModel->GetQdPropagationEngine ();
+}
+
+bool
+SpectrumDmgWifiPhy::CalculateSectorSweepSnr (Ptr<SpectrumDmgWifiPhy> rxPhy, WifiTxVector txVector,
+                                             const SECTOR_SWEEP_CONFIGURATION_LIST &sweep, std::vector<double> &snrList)
+{
+  NS_LOG_FUNCTION (this << rxPhy << sweep.size ());
+  Ptr<QdPropagationEngine> engine = GetQdPropagationEngine ();
+  if (engine == 0)
+    {
+      return false;
+    }
+
+  /* Same transmit power spectral density as in StartTx */
+  double txPowerWatts = DbmToW (GetTxPowerForTransmission (txVector) + GetTxGain ());
+  txPowerWatts /= GetCodebook ()->GetNumberOfActiveRFChains ();
+  Ptr<SpectrumValue> txPowerSpectrum = GetTxPowerSpectralDensity (GetCenterFrequencyForChannelWidth (txVector),
+                                                                  txVector.GetChannelWidth (),
+                                                                  txPowerWatts, txVector.GetMode ().GetModulationClass ());
+  std::vector<Ptr<SpectrumValue> > rxPsdList =
+      engine->CalcSectorSweepRxPower (GetDevice (), rxPhy->GetDevice (), txPowerSpectrum, sweep);
+
+  /* Same filtering as in StartRx and same thermal noise as in the InterferenceHelper of the receiver */
+  Ptr<SpectrumValue> filter = WifiSpectrumValueHelper::CreateRfFilter (rxPhy->GetFrequency (), rxPhy->GetChannelWidth (),
+                                                                       WIGIG_OFDM_SUBCARRIER_SPACING, rxPhy->GetGuardBandwidth ());
+  std::vector<double> signalList;
+  signalList.reserve (rxPsdList.size ());
+  for (std::vector<Ptr<SpectrumValue> >::const_iterator it = rxPsdList.begin (); it != rxPsdList.end (); it++)
+    {
+      signalList.push_back (rxPhy->FilterSignal (filter, *it));
+    }
+  /* The receiver measures the SNR with the TXVECTOR it retrieves from the PPDU, which does not carry the
+   * channel width of a DMG/EDMG PPDU, so use the same TXVECTOR to obtain the same noise power */
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_CTL_DMG_SSW);
+  Ptr<WifiPpdu> ppdu = Create<WifiPpdu> (Create<WifiPsdu> (Create<Packet> (), hdr), txVector, Seconds (0), GetFrequency ());
+  snrList = rxPhy->m_interference.CalculateNoiseLimitedSnr (signalList, ppdu->GetTxVector ());
+  return true;
+}
+
 void
 SpectrumDmgWifiPhy::TxSubfield (WifiTxVector txVector, PLCP_FIELD_TYPE fieldType, Time txDuration)
 {
@@ -35,6 +35,7 @@
 namespace ns3 {
 
 class DmgWifiSpectrumPhyInterface;
+class QdPropagationEngine;
 class WifiPpdu;
 
 /**
@@ -163,6 +164,22 @@ public:
    * channel width).
    */
   uint16_t GetGuardBandwidth (void) const;
+  /**
+   * Calculate the SNR of a complete transmit sector sweep from this PHY towards another PHY without transmitting
+   * the SSW frames over the channel. This is only supported when the channel uses the Q-D propagation engine.
+   * \param rxPhy Pointer to the receiving PHY.
+   * \param txVector The TxVector used for transmitting the SSW frames.
+   * \param sweep The list of transmit antenna configurations and receive quasi-omni antennas to evaluate.
+   * \param snrList The linear SNR of each step of the sweep.
+   * \return True if the SNR values have been calculated, otherwise false.
+   */
+  bool CalculateSectorSweepSnr (Ptr<SpectrumDmgWifiPhy> rxPhy, WifiTxVector txVector,
+                                const SECTOR_SWEEP_CONFIGURATION_LIST &sweep, std::vector<double> &snrList);
+  /**
+   * Get the Q-D propagation engine used by the channel this PHY is attached to.
+   * \return Pointer to the Q-D propagation engine or 0 if the channel does not use the Q-D propagation model.
+   */
+  Ptr<QdPropagationEngine> GetQdPropagationEngine (void) const;
 
   /**
    * Callback invoked when the PHY model starts to process a signal
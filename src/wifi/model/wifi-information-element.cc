@@ -68,18 +68,20 @@ WifiInformationElement::ElementIdExt () const
 Buffer::Iterator
 WifiInformationElement::Serialize (Buffer::Iterator i) const
 {
-  i.WriteU8 (ElementId ());
-  i.WriteU8 (GetInformationFieldSize ());
-  if (ElementId () == IE_EXTENSION)
+  WifiInformationElementId elementId = ElementId ();
+  uint8_t size = GetInformationFieldSize ();
+  i.WriteU8 (elementId);
+  i.WriteU8 (size);
+  if (elementId == IE_EXTENSION)
     {
       i.WriteU8 (ElementIdExt ());
       SerializeInformationField (i);
-      i.Next (GetInformationFieldSize () - 1);
+      i.Next (size - 1);
     }
   else
     {
       SerializeInformationField (i);
-      i.Next (GetInformationFieldSize ());
+      i.Next (size);
     }
   return i;
 }
@@ -151,7 +153,8 @@ WifiInformationElement::operator== (WifiInformationElement const & a) const
       return false;
     }
 
-  if (GetInformationFieldSize () != a.GetInformationFieldSize ())
+  uint32_t ieSize = GetInformationFieldSize ();
+  if (ieSize != a.GetInformationFieldSize ())
     {
       return false;
     }
@@ -161,8 +164,6 @@ WifiInformationElement::operator== (WifiInformationElement const & a) const
       return false;
     }
 
-  uint32_t ieSize = GetInformationFieldSize ();
-
   Buffer myIe, hisIe;
   myIe.AddAtEnd (ieSize);
   hisIe.AddAtEnd (ieSize);
@@ -23,6 +23,7 @@
 
 #include "ns3/simulator.h"
 #include "wifi-mac-queue.h"
+#include <limits>
 #include "qos-blocked-destinations.h"
 
 namespace ns3 {
@@ -72,6 +73,11 @@ WifiMacQueue::~WifiMacQueue ()
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+/// Position key given to the item of an empty queue
+static const uint64_t INITIAL_POSITION_KEY = static_cast<uint64_t> (1) << 62;
+/// Spacing between the position keys of consecutive items
+static const uint64_t POSITION_KEY_GAP = static_cast<uint64_t> (1) << 16;
+
 static std::list<Ptr<WifiMacQueueItem>> g_emptyWifiMacQueue;
 
 const WifiMacQueue::ConstIterator WifiMacQueue::EMPTY = g_emptyWifiMacQueue.end ();
@@ -154,7 +160,13 @@ WifiMacQueue::Insert (ConstIterator pos, Ptr<WifiMacQueueItem> item)
   if (m_dropPolicy == DROP_OLDEST)
     {
       NS_LOG_DEBUG ("Remove the oldest item in the queue");
+      // the oldest item may be the one the new item is inserted before
+      bool insertAtHead = (pos == begin ());
       DoRemove (begin ());
+      if (insertAtHead)
+        {
+          pos = begin ();
+        }
     }
 
   return DoEnqueue (pos, item);
@@ -289,25 +301,14 @@ WifiMacQueue::ConstIterator
 WifiMacQueue::PeekByAddress (Mac48Address dest, ConstIterator pos) const
 {
   NS_LOG_FUNCTION (this << dest);
-  ConstIterator it = (pos != EMPTY ? pos : begin ());
-  while (it != end ())
+  std::map<Mac48Address, QueueIndex>::const_iterator index = m_addressIndex.find (dest);
+  if (index != m_addressIndex.end ())
     {
-      // skip packets that stayed in the queue for too long. They will be
-      // actually removed from the queue by the next call to a non-const method
-      if (Simulator::Now () <= (*it)->GetTimeStamp () + m_maxDelay)
-        {
-          if (((*it)->GetHeader ().IsData () || (*it)->GetHeader ().IsQosData ())
-              && (*it)->GetDestinationAddress () == dest)
-            {
-              return it;
-            }
-        }
-      else
+      ConstIterator it = PeekIndex (index->second, pos);
+      if (it != end ())
         {
-          // signal the presence of expired packets
-          m_expiredPacketsPresent = true;
+          return it;
         }
-      it++;
     }
   NS_LOG_DEBUG ("The queue is empty");
   return end ();
@@ -344,25 +345,14 @@ WifiMacQueue::ConstIterator
 WifiMacQueue::PeekByTidAndAddress (uint8_t tid, Mac48Address dest, ConstIterator pos) const
 {
   NS_LOG_FUNCTION (this << +tid << dest);
-  ConstIterator it = (pos != EMPTY ? pos : begin ());
-  while (it != end ())
+  std::map<ReceiverTidPair, QueueIndex>::const_iterator index = m_tidIndex.find (std::make_pair (dest, tid));
+  if (index != m_tidIndex.end ())
     {
-      // skip packets that stayed in the queue for too long. They will be
-      // actually removed from the queue by the next call to a non-const method
-      if (Simulator::Now () <= (*it)->GetTimeStamp () + m_maxDelay)
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return it;
-            }
-        }
-      else
+      ConstIterator it = PeekIndex (index->second, pos);
+      if (it != end ())
         {
-          // signal the presence of expired packets
-          m_expiredPacketsPresent = true;
+          return it;
         }
-      it++;
     }
   NS_LOG_DEBUG ("The queue is empty");
   return end ();
@@ -473,18 +463,10 @@ WifiMacQueue::GetNPacketsByAddress (Mac48Address dest)
   NS_LOG_FUNCTION (this << dest);
 
   uint32_t nPackets = 0;
-
-  for (ConstIterator it = begin (); it != end (); )
+  std::map<Mac48Address, QueueIndex>::iterator index = m_addressIndex.find (dest);
+  if (index != m_addressIndex.end ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
-            {
-              nPackets++;
-            }
-
-          it++;
-        }
+      nPackets = CountIndex (index->second);
     }
   NS_LOG_DEBUG ("returns " << nPackets);
   return nPackets;
@@ -495,18 +477,10 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
   uint32_t nPackets = 0;
-  for (ConstIterator it = begin (); it != end (); )
+  std::map<ReceiverTidPair, QueueIndex>::iterator index = m_tidIndex.find (std::make_pair (dest, tid));
+  if (index != m_tidIndex.end ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              nPackets++;
-            }
-
-          it++;
-        }
+      nPackets = CountIndex (index->second);
     }
   NS_LOG_DEBUG ("returns " << nPackets);
   return nPackets;
@@ -611,6 +585,188 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, Mac48Address dest)
 //    }
 //}
 
+bool
+WifiMacQueue::DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item)
+{
+  if (!Queue<WifiMacQueueItem>::DoEnqueue (pos, item))
+    {
+      return false;
+    }
+  // the item has been inserted right before the given position
+  AddToIndex (std::prev (pos));
+  return true;
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoDequeue (ConstIterator pos)
+{
+  if (pos != end ())
+    {
+      RemoveFromIndex (pos);
+    }
+  return Queue<WifiMacQueueItem>::DoDequeue (pos);
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoRemove (ConstIterator pos)
+{
+  if (pos != end ())
+    {
+      RemoveFromIndex (pos);
+    }
+  return Queue<WifiMacQueueItem>::DoRemove (pos);
+}
+
+void
+WifiMacQueue::AddToIndex (ConstIterator it)
+{
+  ConstIterator next = std::next (it);
+  uint64_t position;
+  if (it == begin () && next == end ())
+    {
+      position = INITIAL_POSITION_KEY;
+    }
+  else if (it == begin ())
+    {
+      uint64_t nextPosition = GetPositionKey (next);
+      if (nextPosition < POSITION_KEY_GAP)
+        {
+          RebuildIndex ();
+          return;
+        }
+      position = nextPosition - POSITION_KEY_GAP;
+    }
+  else if (next == end ())
+    {
+      uint64_t prevPosition = GetPositionKey (std::prev (it));
+      if (prevPosition > std::numeric_limits<uint64_t>::max () - POSITION_KEY_GAP)
+        {
+          RebuildIndex ();
+          return;
+        }
+      position = prevPosition + POSITION_KEY_GAP;
+    }
+  else
+    {
+      uint64_t prevPosition = GetPositionKey (std::prev (it));
+      uint64_t nextPosition = GetPositionKey (next);
+      if (nextPosition - prevPosition < 2)
+        {
+          RebuildIndex ();
+          return;
+        }
+      position = prevPosition + (nextPosition - prevPosition) / 2;
+    }
+  StoreInIndex (it, position);
+}
+
+void
+WifiMacQueue::StoreInIndex (ConstIterator it, uint64_t position)
+{
+  const WifiMacHeader &hdr = (*it)->GetHeader ();
+  IndexEntry entry;
+  entry.position = position;
+  entry.isData = hdr.IsData ();
+  entry.isQosData = hdr.IsQosData ();
+  entry.receiver = (*it)->GetDestinationAddress ();
+  entry.tid = (entry.isQosData ? hdr.GetQosTid () : 0);
+  bool inserted = m_items.insert (std::make_pair (PeekPointer (*it), entry)).second;
+  NS_ASSERT_MSG (inserted, "The item is already stored in the queue");
+  if (entry.isData)
+    {
+      m_addressIndex[entry.receiver][position] = it;
+    }
+  if (entry.isQosData)
+    {
+      m_tidIndex[std::make_pair (entry.receiver, entry.tid)][position] = it;
+    }
+}
+
+void
+WifiMacQueue::RemoveFromIndex (ConstIterator it)
+{
+  std::unordered_map<const WifiMacQueueItem *, IndexEntry>::iterator entry = m_items.find (PeekPointer (*it));
+  NS_ASSERT_MSG (entry != m_items.end (), "The item is not indexed");
+  if (entry->second.isData)
+    {
+      m_addressIndex[entry->second.receiver].erase (entry->second.position);
+    }
+  if (entry->second.isQosData)
+    {
+      m_tidIndex[std::make_pair (entry->second.receiver, entry->second.tid)].erase (entry->second.position);
+    }
+  m_items.erase (entry);
+}
+
+void
+WifiMacQueue::RebuildIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_items.clear ();
+  for (auto &index : m_addressIndex)
+    {
+      index.second.clear ();
+    }
+  for (auto &index : m_tidIndex)
+    {
+      index.second.clear ();
+    }
+  uint64_t position = INITIAL_POSITION_KEY;
+  for (ConstIterator it = begin (); it != end (); it++, position += POSITION_KEY_GAP)
+    {
+      StoreInIndex (it, position);
+    }
+}
+
+uint64_t
+WifiMacQueue::GetPositionKey (ConstIterator pos) const
+{
+  if (pos == end ())
+    {
+      return std::numeric_limits<uint64_t>::max ();
+    }
+  std::unordered_map<const WifiMacQueueItem *, IndexEntry>::const_iterator entry = m_items.find (PeekPointer (*pos));
+  NS_ASSERT_MSG (entry != m_items.end (), "The item is not indexed");
+  return entry->second.position;
+}
+
+WifiMacQueue::ConstIterator
+WifiMacQueue::PeekIndex (const QueueIndex &index, ConstIterator pos) const
+{
+  QueueIndex::const_iterator it = (pos != EMPTY ? index.lower_bound (GetPositionKey (pos)) : index.begin ());
+  while (it != index.end ())
+    {
+      // skip packets that stayed in the queue for too long. They will be
+      // actually removed from the queue by the next call to a non-const method
+      if (Simulator::Now () <= (*it->second)->GetTimeStamp () + m_maxDelay)
+        {
+          return it->second;
+        }
+      // signal the presence of expired packets
+      m_expiredPacketsPresent = true;
+      it++;
+    }
+  return end ();
+}
+
+uint32_t
+WifiMacQueue::CountIndex (QueueIndex &index)
+{
+  uint32_t nPackets = 0;
+  QueueIndex::iterator it = index.begin ();
+  while (it != index.end ())
+    {
+      // move on before checking the lifetime, an expired item is erased from the index
+      ConstIterator queueIt = it->second;
+      it++;
+      if (!TtlExceeded (queueIt))
+        {
+          nPackets++;
+        }
+    }
+  return nPackets;
+}
+
 bool
 WifiMacQueue::IsEmpty (void)
 {
@@ -26,6 +26,8 @@
 
 #include "wifi-mac-queue-item.h"
 #include "ns3/queue.h"
+#include <map>
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -53,6 +55,12 @@ extern template class Queue<WifiMacQueueItem>;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * Data frames are additionally indexed by receiver address and by
+ * (receiver address, TID), following the FIFO order of the queue. Searches
+ * and counts by destination therefore only visit the packets queued for
+ * that destination, which matters for a DMG PCP/AP serving one peer per
+ * service period out of a queue shared by many stations.
  */
 class WifiMacQueue : public Queue<WifiMacQueueItem>
 {
@@ -303,6 +311,96 @@ public:
 
 
 private:
+  /**
+   * Insert the item before the given position and add it to the indexes.
+   * Shadows Queue::DoEnqueue.
+   *
+   * \param pos the position before which the item is inserted
+   * \param item the item to enqueue
+   * \return true if success, false if the packet has been dropped
+   */
+  bool DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item);
+  /**
+   * Dequeue the item at the given position and remove it from the indexes.
+   * Shadows Queue::DoDequeue.
+   *
+   * \param pos the position of the item to dequeue
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> DoDequeue (ConstIterator pos);
+  /**
+   * Drop the item at the given position and remove it from the indexes.
+   * Shadows Queue::DoRemove.
+   *
+   * \param pos the position of the item to remove
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> DoRemove (ConstIterator pos);
+
+  /// Items of an index sorted by their position key
+  typedef std::map<uint64_t, ConstIterator> QueueIndex;
+  /// Receiver address and TID pair
+  typedef std::pair<Mac48Address, uint8_t> ReceiverTidPair;
+
+  /// Index bookkeeping for a queued item
+  struct IndexEntry
+  {
+    uint64_t position;      //!< Position key, increasing along the queue
+    bool isData;            //!< Whether the item is stored in the receiver index
+    bool isQosData;         //!< Whether the item is stored in the receiver/TID index
+    Mac48Address receiver;  //!< Receiver address of the item
+    uint8_t tid;            //!< TID of the item
+  };
+
+  /**
+   * Add the item pointed to by the given iterator (which has just been inserted
+   * in the queue) to the indexes, assigning it a position key between the keys
+   * of its neighbours. If there is no room between them, the keys of the whole
+   * queue are reassigned.
+   *
+   * \param it the iterator pointing to the inserted item
+   */
+  void AddToIndex (ConstIterator it);
+  /**
+   * Remove the item pointed to by the given iterator from the indexes.
+   *
+   * \param it the iterator pointing to the item
+   */
+  void RemoveFromIndex (ConstIterator it);
+  /**
+   * Store the item pointed to by the given iterator in the indexes with the
+   * given position key.
+   *
+   * \param it the iterator pointing to the item
+   * \param position the position key of the item
+   */
+  void StoreInIndex (ConstIterator it, uint64_t position);
+  /**
+   * Rebuild the indexes from scratch, spacing the position keys evenly.
+   */
+  void RebuildIndex (void);
+  /**
+   * \param pos a position in the queue
+   * \return the position key of the item at the given position
+   */
+  uint64_t GetPositionKey (ConstIterator pos) const;
+  /**
+   * Return the first item of the given index, not older than the maximum delay,
+   * that is located at or after the given position in the queue.
+   *
+   * \param index the index to search
+   * \param pos the iterator pointing to the packet the search starts from
+   * \return an iterator pointing to the item, or end () if none
+   */
+  ConstIterator PeekIndex (const QueueIndex &index, ConstIterator pos) const;
+  /**
+   * Remove the expired items of the given index and count the remaining ones.
+   *
+   * \param index the index
+   * \return the number of items in the index that are not expired
+   */
+  uint32_t CountIndex (QueueIndex &index);
+
   /**
    * Remove the item pointed to by the iterator <i>it</i> if it has been in the
    * queue for too long. If the item is removed, the iterator is updated to
@@ -317,6 +415,11 @@ private:
   DropPolicy m_dropPolicy;                  //!< Drop behavior of queue
   mutable bool m_expiredPacketsPresent;     //!< True if expired packets are in the queue
 
+  /* Indexes are never erased once created, so that they can be walked while their items expire */
+  std::map<Mac48Address, QueueIndex> m_addressIndex;                //!< Data frames per receiver
+  std::map<ReceiverTidPair, QueueIndex> m_tidIndex;                 //!< QoS Data frames per receiver and TID
+  std::unordered_map<const WifiMacQueueItem *, IndexEntry> m_items; //!< Index bookkeeping of the queued items
+
   /// Traced callback: fired when a packet is dropped due to lifetime expiration
   TracedCallback<Ptr<const WifiMacQueueItem> > m_traceExpired;
 
@@ -822,6 +822,12 @@ WifiPhy::SetErrorRateModel (const Ptr<ErrorRateModel> rate)
   m_interference.SetNumberOfReceiveAntennas (GetNumberOfAntennas ());
 }
 
+Ptr<ErrorRateModel>
+WifiPhy::GetErrorRateModel (void) const
+{
+  return m_interference.GetErrorRateModel ();
+}
+
 void
 WifiPhy::SetPostReceptionErrorModel (const Ptr<ErrorModel> em)
 {
@@ -2269,411 +2275,46 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
   WifiMode payloadMode = txVector.GetMode ();
   NS_LOG_FUNCTION (size << payloadMode);
 
-  if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_CTRL)
+  if ((payloadMode.GetModulationClass () >= WIFI_MOD_CLASS_DMG_CTRL)
+      && (payloadMode.GetModulationClass () <= WIFI_MOD_CLASS_EDMG_SC))
     {
-      uint32_t Ncw;                       /* Number of LDPC codewords. */
-      uint32_t Ldpcw;                     /* Number of bits in the second and any subsequent codeword except the last. */
-      uint32_t Ldplcw;                    /* Number of bits in the last codeword. */
-      uint32_t DencodedSymmbols;          /* Number of differentailly encoded payload symbols. */
-      uint32_t Chips;                     /* Number of chips (After spreading using Ga32 Golay Sequence). */
-      uint32_t Nbits = (size - 8) * 8;    /* Number of bits in the payload part. */
-
-      Ncw = 1 + (uint32_t) ceil ((double (size) - 6) * 8/168);
-      Ldpcw = (uint32_t) ceil ((double (size) - 6) * 8/(Ncw - 1));
-      Ldplcw = (size - 6) * 8 - (Ncw - 2) * Ldpcw;
-      DencodedSymmbols = (672 - (504 - Ldpcw)) * (Ncw - 2) + (672 - (504 - Ldplcw));
-      //      DencodedSymmbols = (Ldpcw + 168) * (Ncw-2) + Ldplcw + 168;
-      Chips = DencodedSymmbols * 32;
-      /* Make sure the result is in nanoseconds. */
-      double ret = double (Chips)/1.76;
-      NS_LOG_DEBUG ("bits " << Nbits << " Diff encoded Symmbols " << DencodedSymmbols << " rate " << payloadMode.GetDataRate() << " Payload Time " << ret << " ns");
-
-      return NanoSeconds (ceil (ret));
+      return CalculateDmgPayloadDuration (size, txVector);
     }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_LP_SC)
-    {
-      //        uint32_t Nbits = (size * 8);  /* Number of bits in the payload part. */
-      //        uint32_t Nrsc;                /* The total number of Reed Solomon codewords */
-      //        uint32_t Nrses;               /* The total number of Reed Solomon encoded symbols */
-      //        Nrsc = (uint32_t) ceil(Nbits/208);
-      //        Nrses = Nbits + Nrsc * 16;
-
-      //        uint32_t Nsbc;                 /* Short Block code Size */
-      //        if (payloadMode.GetCodeRate() == WIFI_CODE_RATE_13_28)
-      //          Nsbc = 16;
-      //        else if (payloadMode.GetCodeRate() == WIFI_CODE_RATE_13_21)
-      //          Nsbc = 12;
-      //        else if (payloadMode.GetCodeRate() == WIFI_CODE_RATE_52_63)
-      //          Nsbc = 9;
-      //        else if (payloadMode.GetCodeRate() == WIFI_CODE_RATE_13_14)
-      //          Nsbc = 8;
-      //        else
-      //          NS_FATAL_ERROR("unsupported code rate");
 
-      //        uint32_t Ncbps;               /* Ncbps = Number of coded bits per symbol. Check Table 21-21 for different constellations. */
-      //        if (payloadMode.GetConstellationSize() == 2)
-      //          Ncbps = 336;
-      //        else if (payloadMode.GetConstellationSize() == 4)
-      //          Ncbps = 2 * 336;
-      //          NS_FATAL_ERROR("unsupported constellation size");
+  double stbc = 1;
+  if (txVector.IsStbc ()
+      && (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_HT
+          || payloadMode.GetModulationClass () == WIFI_MOD_CLASS_VHT))
+    {
+      stbc = 2;
+    }
 
-      //        uint32_t Neb;                 /* Total number of encoded bits */
-      //        uint32_t Nblks;               /* Total number of 512 blocks containing 392 data symbols */
-      //        Neb = Nsbc * Nrses;
-      //        Nblks = (uint32_t) ceil(neb/());
-      return NanoSeconds (0);
+  double Nes = 1;
+  //todo: improve logic to reduce the number of if cases
+  //todo: extend to NSS > 4 for VHT rates
+  if (payloadMode == GetHtMcs21 ()
+      || payloadMode == GetHtMcs22 ()
+      || payloadMode == GetHtMcs23 ()
+      || payloadMode == GetHtMcs28 ()
+      || payloadMode == GetHtMcs29 ()
+      || payloadMode == GetHtMcs30 ()
+      || payloadMode == GetHtMcs31 ())
+    {
+      Nes = 2;
     }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_SC)
+  if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_VHT)
     {
-      /* 21.3.4 Timeing Related Parameters, Table 21-4 TData = (Nblks * 512 + 64) * Tc. */
-      /* 21.6.3.2.3.3 (4), Compute Nblks = The number of symbol blocks. */
-
-      uint32_t Ncbpb; // Ncbpb = Number of coded bits per symbol block. Check Table 21-20 for different constellations.
-      if (payloadMode.GetConstellationSize () == 2)
-        Ncbpb = 448;
-      else if (payloadMode.GetConstellationSize () == 4)
-        Ncbpb = 2 * 448;
-      else if (payloadMode.GetConstellationSize () == 16)
-        Ncbpb = 4 * 448;
-      else if (payloadMode.GetConstellationSize () == 64)
-        Ncbpb = 6 * 448;
-      else
-        NS_FATAL_ERROR ("unsupported constellation size");
-
-      uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
-      uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
-
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_4)
-        Ncbits = Nbits * 4;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-        Ncbits = Nbits * 2;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 7);
-      else
-        NS_FATAL_ERROR ("unsupported code rate");
-
-      uint16_t Lcw; /* The LDPC codeword length. */
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
-        Lcw = 624;
-      else
-        Lcw = 672;
-
-      uint32_t Ncw = (uint32_t) ceil (double (Ncbits) / double (Lcw));  /* Ncw = The number of LDPC codewords. */
-      uint32_t Nblks = (uint32_t) ceil (double (Ncw) * double (Lcw) / Ncbpb);  /* Nblks = The number of symbol blocks. */
-
-      /* Make sure the result is in nanoseconds. */
-      uint32_t tData = lrint (ceil ((double (Nblks) * 512 + 64) / 1.76)); /* The duration of the data part */
-      NS_LOG_DEBUG ("bits " << Nbits << " cbits " << Ncbits
-                    << " Ncw " << Ncw
-                    << " Nblks " << Nblks
-                    << " rate " << payloadMode.GetDataRate() << " Payload Time " << tData << " ns");
-
-      if (txVector.GetTrainngFieldLength () != 0)
+      if (txVector.GetChannelWidth () == 40
+          && txVector.GetNss () == 3
+          && payloadMode.GetMcsValue () >= 8)
         {
-          if (tData < OFDMSCMin)
-            tData = OFDMSCMin;
+          Nes = 2;
         }
-      return NanoSeconds (tData);
-    }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_OFDM)
-    {
-      /* 21.3.4 Timeing Related Parameters, Table 21-4 TData = Nsym * Tsys(OFDM) */
-      /* 21.5.3.2.3.3 (5), Compute Nsym = Number of OFDM Symbols */
-
-      uint32_t Ncbps; // Ncbps = Number of coded bits per symbol. Check Table 21-20 for different constellations.
-      if (payloadMode.GetConstellationSize () == 2)
-        Ncbps = 336;
-      else if (payloadMode.GetConstellationSize () == 4)
-        Ncbps = 2 * 336;
-      else if (payloadMode.GetConstellationSize () == 16)
-        Ncbps = 4 * 336;
-      else if (payloadMode.GetConstellationSize () == 64)
-        Ncbps = 6 * 336;
-      else
-        NS_FATAL_ERROR ("unsupported constellation size");
-
-      uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
-      uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
-
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_4)
-        Ncbits = Nbits * 4;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-        Ncbits = Nbits * 2;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
-      else
-        NS_FATAL_ERROR ("unsupported code rate");
-
-      uint32_t Ncw = (uint32_t) ceil (double (Ncbits) / 672.0);         /* Ncw = The number of LDPC codewords.  */
-      uint32_t Nsym = (uint32_t) ceil (double (Ncw * 672.0) / Ncbps);   /* Nsym = Number of OFDM Symbols. */
-
-      /* Make sure the result is in nanoseconds */
-      uint32_t tData;       /* The duration of the data part */
-      tData = Nsym * 242;   /* Tsys(OFDM) = 242ns */
-      NS_LOG_DEBUG ("bits " << Nbits << " cbits " << Ncbits << " rate " << payloadMode.GetDataRate() << " Payload Time " << tData << " ns");
-
-      if (txVector.GetTrainngFieldLength () != 0)
+      if (txVector.GetChannelWidth () == 80
+          && txVector.GetNss () == 2
+          && payloadMode.GetMcsValue () >= 7)
         {
-          if (tData < OFDMBRPMin)
-            tData = OFDMBRPMin;
-        }
-      return NanoSeconds (tData);
-    }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_CTRL)
-    {
-      uint32_t Ncw;                       /* Number of LDPC codewords. */
-      uint32_t Ldpcw;                     /* Number of bits in the second and any subsequent codeword except the last. */
-      uint32_t Ldplcw;                    /* Number of bits in the last codeword. */
-      uint32_t DencodedSymmbols;          /* Number of differentailly encoded payload symbols. */
-      uint32_t Chips;                     /* Number of chips (After spreading using Ga32 Golay Sequence). */
-      uint32_t Nbits = (size - 8) * 8;    /* Number of bits in the payload part. */
-
-      Ncw = 1 + (uint32_t) ceil ((double (size) + L_EDMG_Header_A2) * 8/168);
-      Ldpcw = (uint32_t) ceil ((double (size) + L_EDMG_Header_A2) * 8/(Ncw - 1));
-      Ldplcw = (size + L_EDMG_Header_A2) * 8 - (Ncw - 2) * Ldpcw;
-      //DencodedSymmbols = (672 - (504 - Ldpcw)) * (Ncw - 3) + (672 - (504 - Ldplcw));
-      // Change to Ncw-3 once the duration of Header A is calculated properly
-      DencodedSymmbols = (Ldpcw + 168) * (Ncw-2) + (Ldplcw +168);
-      Chips = DencodedSymmbols * 32;
-
-      /* Make sure the result is in nanoseconds. */
-      double ret = double (Chips)/1.76;
-      NS_LOG_DEBUG ("bits " << Nbits << " Diff encoded Symmbols " << DencodedSymmbols << " rate " << payloadMode.GetDataRate() << " Payload Time " << ret << " ns");
-
-      return NanoSeconds (ceil (ret));
-    }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_SC)
-    {
-      /* 29.12.3.3 TXTIME calculation for EDMG SC mode, TData = (Nblks * 512 + Ngi) * Tc. */
-      /* 29.5.9.4 (d4), Compute Nblks = The number of symbol blocks. */
-
-      //Once multiple users are enabled - calculate Nblcks for each user - then set Nblks to the maximum Nblks from all users - for loop for all users
-      uint16_t Nspb;  /* Number of symbols per SC symbol block for GI length. */
-
-      if (txVector.GetGaurdIntervalType () == GI_SHORT)
-        Nspb = 480 * txVector.GetNCB ();
-      else if (txVector.GetGaurdIntervalType () == GI_NORMAL)
-        Nspb = 448 * txVector.GetNCB ();
-      else if (txVector.GetGaurdIntervalType () == GI_LONG)
-        Nspb = 384 * txVector.GetNCB ();
-      else
-        NS_FATAL_ERROR ("Unsupported guard interval length");
-
-      // For now we are assuming that the same MCS is used for all STS
-      uint32_t Ncbps; // Ncbps = Number of coded bits per symbol. Check Table 21-20 for different constellations.
-      if (payloadMode.GetConstellationSize () == 2)
-        Ncbps = 1;
-      else if (payloadMode.GetConstellationSize () == 4)
-        Ncbps = 2;
-      else if (payloadMode.GetConstellationSize () == 16)
-        Ncbps = 4;
-      else if (payloadMode.GetConstellationSize () == 64)
-        Ncbps = 6;
-      else
-        NS_FATAL_ERROR ("unsupported constellation size");
-
-      Ncbps = Ncbps * txVector.Get_NUM_STS ();
-
-      uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
-      uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
-
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_4)
-        Ncbits = Nbits * 4;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-        Ncbits = Nbits * 2;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 7);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_2_3)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 3.0 / 2);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_6)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 6.0 / 5);
-      else
-        NS_FATAL_ERROR ("unsupported code rate");
-
-      uint16_t Lcw; /* The LDPC codeword length. */
-
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_2_3 || payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_6)
-        Lcw = 504;
-      else
-        Lcw = 672;
-      if (txVector.GetLdcpCwLength ())
-        {
-          Lcw = Lcw * 2;
-        }
-
-      uint32_t Ncw = (uint32_t) ceil (double (Ncbits) / double (Lcw));  /* Ncw = The number of LDPC codewords. */
-      uint32_t Nblks = (uint32_t) ceil ((double (Ncw) * double (Lcw)) / (Ncbps * Nspb));  /* Nblks = The number of symbol blocks. */
-
-      if (txVector.GetEDMGTrainingFieldLength () != 0)
-        {
-          if (Nblks < aBRPminSCblocks)
-            Nblks = aBRPminSCblocks;
-        }
-
-      uint8_t Ngi = 0; /* the size of the guard interval */
-
-      if (txVector.GetGaurdIntervalType () == GI_LONG)
-        Ngi = 128;
-      else if (txVector.GetGaurdIntervalType () == GI_NORMAL)
-        Ngi = 64;
-      else if (txVector.GetGaurdIntervalType () == GI_SHORT)
-        {
-          if ((txVector.GetNumUsers () == 1) && ((txVector.GetTransmitMask () != CH_BANDWIDTH_216) || (txVector.Get_NUM_STS () != 1)))
-            Ngi = 32;
-          else
-            Ngi = 64;
-        }
-
-      /* Make sure the result is in nanoseconds. */
-      uint32_t tData = lrint (ceil ((double (Nblks) * 512 + Ngi) / 1.76)); /* The duration of the data part */
-      NS_LOG_DEBUG ("bits " << Nbits << " cbits " << Ncbits
-                    << " Ncw " << Ncw
-                    << " Nblks " << Nblks
-                    << " rate " << payloadMode.GetDataRate() << " Payload Time " << tData << " ns");
-
-      return NanoSeconds (tData);
-    }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_OFDM)
-    {
-      /* 29.12.3.4 TXTIME calculation for EDMG OFDM mode, TData = (Nsym * (512 + Ngi)) * Ts */
-      /* 21.5.3.2.3.3 (5), Compute Nsym = Number of OFDM Symbols */
-
-      //Once multiple users are enabled - calculate Nsym for each user - then set Nsym to the maximum Nsym from all users - for loop for all users
-
-      uint32_t Nsd; // Nsd = Number of data subcarriers.
-      if (txVector.GetNCB () == 1)
-        Nsd = 336;
-      else if (txVector.GetNCB () == 2)
-        Nsd = 734;
-      else if (txVector.GetNCB () == 3)
-        Nsd = 1134;
-      else if (txVector.GetNCB () == 4)
-        Nsd = 1532;
-      else
-        NS_FATAL_ERROR("Unsupported number of continous channels");
-
-      // Once multimple space-time streams are enabled - sum the Nbpsc for all space-time streams.
-      uint32_t Nbpsc; // Nbpsc = Number of coded bits per constellation point Check Table 115 (ayD4) for different constellations.
-      if (payloadMode.GetConstellationSize () == 2)
-        Nbpsc = 1;
-      else if (payloadMode.GetConstellationSize () == 4)
-        Nbpsc = 2;
-      else if (payloadMode.GetConstellationSize () == 16)
-        Nbpsc = 4;
-      else if (payloadMode.GetConstellationSize () == 64)
-        Nbpsc = 6;
-      else
-        NS_FATAL_ERROR ("unsupported constellation size");
-
-      // For MIMO case
-      Nbpsc = Nbpsc * txVector.Get_NUM_STS ();
-
-      uint32_t Ncbps; // Ncbps = Number of coded bits per symbol. Check Table 21-20 for different constellations.
-      Ncbps = Nsd * Nbpsc;
-
-      uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
-      uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
-
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-        Ncbits = Nbits * 2;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 7);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
-        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
-      else
-        NS_FATAL_ERROR ("unsupported code rate");
-
-      uint16_t Lcw; /* The LDPC codeword length. */
-      Lcw = 672;
-      if (txVector.GetLdcpCwLength ())
-        {
-          Lcw = Lcw * 2;
-        }
-
-      uint32_t Ncw = (uint32_t) ceil (double (Ncbits) / double (Lcw)); /* Ncw = The number of LDPC codewords.  */
-      uint32_t Nsym = (uint32_t) ceil (double (Ncw * Lcw) / Ncbps);    /* Nsym = Number of OFDM Symbols. */
-
-      if (txVector.GetEDMGTrainingFieldLength () != 0)
-        {
-          if (Nsym < aBRPminOFDMblocks)
-            Nsym = aBRPminOFDMblocks;
-        }
-
-      uint8_t Ngi = 0; /* the size of the guard interval */
-      if (txVector.GetGaurdIntervalType () == GI_LONG)
-        Ngi = 192;
-      else if (txVector.GetGaurdIntervalType () == GI_NORMAL)
-        Ngi = 96;
-      else if (txVector.GetGaurdIntervalType () == GI_SHORT)
-        Ngi = 48;
-
-      /* Make sure the result is in nanoseconds */
-      uint32_t tData;       /* The duration of the data part */
-      tData = lrint (ceil ((double (Nsym * (512 + Ngi)) / 2.64))); /* The duration of the data part */
-      NS_LOG_DEBUG ("bits " << Nbits << " cbits " << Ncbits << " rate " << payloadMode.GetDataRate() << " Payload Time " << tData << " ns");
-
-      if (txVector.GetTrainngFieldLength () != 0)
-        {
-          if (tData < OFDMBRPMin)
-            tData = OFDMBRPMin;
-        }
-      return NanoSeconds (tData);
-    }
-
-  double stbc = 1;
-  if (txVector.IsStbc ()
-      && (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_HT
-          || payloadMode.GetModulationClass () == WIFI_MOD_CLASS_VHT))
-    {
-      stbc = 2;
-    }
-
-  double Nes = 1;
-  //todo: improve logic to reduce the number of if cases
-  //todo: extend to NSS > 4 for VHT rates
-  if (payloadMode == GetHtMcs21 ()
-      || payloadMode == GetHtMcs22 ()
-      || payloadMode == GetHtMcs23 ()
-      || payloadMode == GetHtMcs28 ()
-      || payloadMode == GetHtMcs29 ()
-      || payloadMode == GetHtMcs30 ()
-      || payloadMode == GetHtMcs31 ())
-    {
-      Nes = 2;
-    }
-  if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_VHT)
-    {
-      if (txVector.GetChannelWidth () == 40
-          && txVector.GetNss () == 3
-          && payloadMode.GetMcsValue () >= 8)
-        {
-          Nes = 2;
-        }
-      if (txVector.GetChannelWidth () == 80
-          && txVector.GetNss () == 2
-          && payloadMode.GetMcsValue () >= 7)
-        {
-          Nes = 2;
+          Nes = 2;
         }
       if (txVector.GetChannelWidth () == 80
           && txVector.GetNss () == 3
@@ -2903,6 +2544,501 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
     }
 }
 
+WifiPhy::DmgDurationKey
+WifiPhy::GetDmgDurationKey (uint32_t size, WifiTxVector txVector)
+{
+  return std::make_tuple (size, txVector.GetMode ().GetUid (),
+                          txVector.GetTrainngFieldLength () != 0, txVector.GetEDMGTrainingFieldLength () != 0,
+                          static_cast<uint8_t> (txVector.GetGaurdIntervalType ()), txVector.GetNCB (),
+                          txVector.Get_NUM_STS (), txVector.GetNumUsers (),
+                          static_cast<uint8_t> (txVector.GetTransmitMask ()), txVector.GetLdcpCwLength ());
+}
+
+Time
+WifiPhy::GetDmgPayloadDuration (uint32_t size, WifiTxVector txVector)
+{
+  DmgDurationKey key = GetDmgDurationKey (size, txVector);
+  DmgDurationCache::const_iterator it = m_dmgDurationCache.find (key);
+  if (it != m_dmgDurationCache.end ())
+    {
+      return it->second;
+    }
+  Time duration = CalculateDmgPayloadDuration (size, txVector);
+  /* Bound the memory used by the cache, sizes are arbitrary so it can grow without limit */
+  if (m_dmgDurationCache.size () >= 65536)
+    {
+      m_dmgDurationCache.clear ();
+    }
+  m_dmgDurationCache[key] = duration;
+  return duration;
+}
+
+Time
+WifiPhy::CalculateDmgPayloadDuration (uint32_t size, WifiTxVector txVector)
+{
+  WifiMode payloadMode = txVector.GetMode ();
+  NS_LOG_FUNCTION (size << payloadMode);
+
+  if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_CTRL)
+    {
+      uint32_t Ncw;                       /* Number of LDPC codewords. */
+      uint32_t Ldpcw;                     /* Number of bits in the second and any subsequent codeword except the last. */
+      uint32_t Ldplcw;                    /* Number of bits in the last codeword. */
+      uint32_t DencodedSymmbols;          /* Number of differentailly encoded payload symbols. */
+      uint32_t Chips;                     /* Number of chips (After spreading using Ga32 Golay Sequence). */
+      uint32_t Nbits = (size - 8) * 8;    /* Number of bits in the payload part. */
+
+      Ncw = 1 + (uint32_t) ceil ((double (size) - 6) * 8/168);
+      Ldpcw = (uint32_t) ceil ((double (size) - 6) * 8/(Ncw - 1));
+      Ldplcw = (size - 6) * 8 - (Ncw - 2) * Ldpcw;
+      DencodedSymmbols = (672 - (504 - Ldpcw)) * (Ncw - 2) + (672 - (504 - Ldplcw));
+      //      DencodedSymmbols = (Ldpcw + 168) * (Ncw-2) + Ldplcw + 168;
+      Chips = DencodedSymmbols * 32;
+      /* Make sure the result is in nanoseconds. */
+      double ret = double (Chips)/1.76;
+      NS_LOG_DEBUG ("bits " << Nbits << " Diff encoded Symmbols " << DencodedSymmbols << " rate " << payloadMode.GetDataRate() << " Payload Time " << ret << " ns");
+
+      return NanoSeconds (ceil (ret));
+    }
+  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_LP_SC)
+    {
+      //        uint32_t Nbits = (size * 8);  /* Number of bits in the payload part. */
+      //        uint32_t Nrsc;                /* The total number of Reed Solomon codewords */
+      //        uint32_t Nrses;               /* The total number of Reed Solomon encoded symbols */
+      //        Nrsc = (uint32_t) ceil(Nbits/208);
+      //        Nrses = Nbits + Nrsc * 16;
+
+      //        uint32_t Nsbc;                 /* Short Block code Size */
+      //        if (payloadMode.GetCodeRate() == WIFI_CODE_RATE_13_28)
+      //          Nsbc = 16;
+      //        else if (payloadMode.GetCodeRate() == WIFI_CODE_RATE_13_21)
+      //          Nsbc = 12;
+      //        else if (payloadMode.GetCodeRate() == WIFI_CODE_RATE_52_63)
+      //          Nsbc = 9;
+      //        else if (payloadMode.GetCodeRate() == WIFI_CODE_RATE_13_14)
+      //          Nsbc = 8;
+      //        else
+      //          NS_FATAL_ERROR("unsupported code rate");
+
+      //        uint32_t Ncbps;               /* Ncbps = Number of coded bits per symbol. Check Table 21-21 for different constellations. */
+      //        if (payloadMode.GetConstellationSize() == 2)
+      //          Ncbps = 336;
+      //        else if (payloadMode.GetConstellationSize() == 4)
+      //          Ncbps = 2 * 336;
+      //          NS_FATAL_ERROR("unsupported constellation size");
+
+      //        uint32_t Neb;                 /* Total number of encoded bits */
+      //        uint32_t Nblks;               /* Total number of 512 blocks containing 392 data symbols */
+      //        Neb = Nsbc * Nrses;
+      //        Nblks = (uint32_t) ceil(neb/());
+      return NanoSeconds (0);
+    }
+  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_SC)
+    {
+      /* 21.3.4 Timeing Related Parameters, Table 21-4 TData = (Nblks * 512 + 64) * Tc. */
+      /* 21.6.3.2.3.3 (4), Compute Nblks = The number of symbol blocks. */
+
+      uint32_t Ncbpb; // Ncbpb = Number of coded bits per symbol block. Check Table 21-20 for different constellations.
+      if (payloadMode.GetConstellationSize () == 2)
+        Ncbpb = 448;
+      else if (payloadMode.GetConstellationSize () == 4)
+        Ncbpb = 2 * 448;
+      else if (payloadMode.GetConstellationSize () == 16)
+        Ncbpb = 4 * 448;
+      else if (payloadMode.GetConstellationSize () == 64)
+        Ncbpb = 6 * 448;
+      else
+        NS_FATAL_ERROR ("unsupported constellation size");
+
+      uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
+      uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
+
+      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_4)
+        Ncbits = Nbits * 4;
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
+        Ncbits = Nbits * 2;
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 7);
+      else
+        NS_FATAL_ERROR ("unsupported code rate");
+
+      uint16_t Lcw; /* The LDPC codeword length. */
+      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
+        Lcw = 624;
+      else
+        Lcw = 672;
+
+      uint32_t Ncw = (uint32_t) ceil (double (Ncbits) / double (Lcw));  /* Ncw = The number of LDPC codewords. */
+      uint32_t Nblks = (uint32_t) ceil (double (Ncw) * double (Lcw) / Ncbpb);  /* Nblks = The number of symbol blocks. */
+
+      /* Make sure the result is in nanoseconds. */
+      uint32_t tData = lrint (ceil ((double (Nblks) * 512 + 64) / 1.76)); /* The duration of the data part */
+      NS_LOG_DEBUG ("bits " << Nbits << " cbits " << Ncbits
+                    << " Ncw " << Ncw
+                    << " Nblks " << Nblks
+                    << " rate " << payloadMode.GetDataRate() << " Payload Time " << tData << " ns");
+
+      if (txVector.GetTrainngFieldLength () != 0)
+        {
+          if (tData < OFDMSCMin)
+            tData = OFDMSCMin;
+        }
+      return NanoSeconds (tData);
+    }
+  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_OFDM)
+    {
+      /* 21.3.4 Timeing Related Parameters, Table 21-4 TData = Nsym * Tsys(OFDM) */
+      /* 21.5.3.2.3.3 (5), Compute Nsym = Number of OFDM Symbols */
+
+      uint32_t Ncbps; // Ncbps = Number of coded bits per symbol. Check Table 21-20 for different constellations.
+      if (payloadMode.GetConstellationSize () == 2)
+        Ncbps = 336;
+      else if (payloadMode.GetConstellationSize () == 4)
+        Ncbps = 2 * 336;
+      else if (payloadMode.GetConstellationSize () == 16)
+        Ncbps = 4 * 336;
+      else if (payloadMode.GetConstellationSize () == 64)
+        Ncbps = 6 * 336;
+      else
+        NS_FATAL_ERROR ("unsupported constellation size");
+
+      uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
+      uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
+
+      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_4)
+        Ncbits = Nbits * 4;
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
+        Ncbits = Nbits * 2;
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
+      else
+        NS_FATAL_ERROR ("unsupported code rate");
+
+      uint32_t Ncw = (uint32_t) ceil (double (Ncbits) / 672.0);         /* Ncw = The number of LDPC codewords.  */
+      uint32_t Nsym = (uint32_t) ceil (double (Ncw * 672.0) / Ncbps);   /* Nsym = Number of OFDM Symbols. */
+
+      /* Make sure the result is in nanoseconds */
+      uint32_t tData;       /* The duration of the data part */
+      tData = Nsym * 242;   /* Tsys(OFDM) = 242ns */
+      NS_LOG_DEBUG ("bits " << Nbits << " cbits " << Ncbits << " rate " << payloadMode.GetDataRate() << " Payload Time " << tData << " ns");
+
+      if (txVector.GetTrainngFieldLength () != 0)
+        {
+          if (tData < OFDMBRPMin)
+            tData = OFDMBRPMin;
+        }
+      return NanoSeconds (tData);
+    }
+  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_CTRL)
+    {
+      uint32_t Ncw;                       /* Number of LDPC codewords. */
+      uint32_t Ldpcw;                     /* Number of bits in the second and any subsequent codeword except the last. */
+      uint32_t Ldplcw;                    /* Number of bits in the last codeword. */
+      uint32_t DencodedSymmbols;          /* Number of differentailly encoded payload symbols. */
+      uint32_t Chips;                     /* Number of chips (After spreading using Ga32 Golay Sequence). */
+      uint32_t Nbits = (size - 8) * 8;    /* Number of bits in the payload part. */
+
+      Ncw = 1 + (uint32_t) ceil ((double (size) + L_EDMG_Header_A2) * 8/168);
+      Ldpcw = (uint32_t) ceil ((double (size) + L_EDMG_Header_A2) * 8/(Ncw - 1));
+      Ldplcw = (size + L_EDMG_Header_A2) * 8 - (Ncw - 2) * Ldpcw;
+      //DencodedSymmbols = (672 - (504 - Ldpcw)) * (Ncw - 3) + (672 - (504 - Ldplcw));
+      // Change to Ncw-3 once the duration of Header A is calculated properly
+      DencodedSymmbols = (Ldpcw + 168) * (Ncw-2) + (Ldplcw +168);
+      Chips = DencodedSymmbols * 32;
+
+      /* Make sure the result is in nanoseconds. */
+      double ret = double (Chips)/1.76;
+      NS_LOG_DEBUG ("bits " << Nbits << " Diff encoded Symmbols " << DencodedSymmbols << " rate " << payloadMode.GetDataRate() << " Payload Time " << ret << " ns");
+
+      return NanoSeconds (ceil (ret));
+    }
+  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_SC)
+    {
+      /* 29.12.3.3 TXTIME calculation for EDMG SC mode, TData = (Nblks * 512 + Ngi) * Tc. */
+      /* 29.5.9.4 (d4), Compute Nblks = The number of symbol blocks. */
+
+      //Once multiple users are enabled - calculate Nblcks for each user - then set Nblks to the maximum Nblks from all users - for loop for all users
+      uint16_t Nspb;  /* Number of symbols per SC symbol block for GI length. */
+
+      if (txVector.GetGaurdIntervalType () == GI_SHORT)
+        Nspb = 480 * txVector.GetNCB ();
+      else if (txVector.GetGaurdIntervalType () == GI_NORMAL)
+        Nspb = 448 * txVector.GetNCB ();
+      else if (txVector.GetGaurdIntervalType () == GI_LONG)
+        Nspb = 384 * txVector.GetNCB ();
+      else
+        NS_FATAL_ERROR ("Unsupported guard interval length");
+
+      // For now we are assuming that the same MCS is used for all STS
+      uint32_t Ncbps; // Ncbps = Number of coded bits per symbol. Check Table 21-20 for different constellations.
+      if (payloadMode.GetConstellationSize () == 2)
+        Ncbps = 1;
+      else if (payloadMode.GetConstellationSize () == 4)
+        Ncbps = 2;
+      else if (payloadMode.GetConstellationSize () == 16)
+        Ncbps = 4;
+      else if (payloadMode.GetConstellationSize () == 64)
+        Ncbps = 6;
+      else
+        NS_FATAL_ERROR ("unsupported constellation size");
+
+      Ncbps = Ncbps * txVector.Get_NUM_STS ();
+
+      uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
+      uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
+
+      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_4)
+        Ncbits = Nbits * 4;
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
+        Ncbits = Nbits * 2;
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 7);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_2_3)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 3.0 / 2);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_6)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 6.0 / 5);
+      else
+        NS_FATAL_ERROR ("unsupported code rate");
+
+      uint16_t Lcw; /* The LDPC codeword length. */
+
+      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_2_3 || payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_6)
+        Lcw = 504;
+      else
+        Lcw = 672;
+      if (txVector.GetLdcpCwLength ())
+        {
+          Lcw = Lcw * 2;
+        }
+
+      uint32_t Ncw = (uint32_t) ceil (double (Ncbits) / double (Lcw));  /* Ncw = The number of LDPC codewords. */
+      uint32_t Nblks = (uint32_t) ceil ((double (Ncw) * double (Lcw)) / (Ncbps * Nspb));  /* Nblks = The number of symbol blocks. */
+
+      if (txVector.GetEDMGTrainingFieldLength () != 0)
+        {
+          if (Nblks < aBRPminSCblocks)
+            Nblks = aBRPminSCblocks;
+        }
+
+      uint8_t Ngi = 0; /* the size of the guard interval */
+
+      if (txVector.GetGaurdIntervalType () == GI_LONG)
+        Ngi = 128;
+      else if (txVector.GetGaurdIntervalType () == GI_NORMAL)
+        Ngi = 64;
+      else if (txVector.GetGaurdIntervalType () == GI_SHORT)
+        {
+          if ((txVector.GetNumUsers () == 1) && ((txVector.GetTransmitMask () != CH_BANDWIDTH_216) || (txVector.Get_NUM_STS () != 1)))
+            Ngi = 32;
+          else
+            Ngi = 64;
+        }
+
+      /* Make sure the result is in nanoseconds. */
+      uint32_t tData = lrint (ceil ((double (Nblks) * 512 + Ngi) / 1.76)); /* The duration of the data part */
+      NS_LOG_DEBUG ("bits " << Nbits << " cbits " << Ncbits
+                    << " Ncw " << Ncw
+                    << " Nblks " << Nblks
+                    << " rate " << payloadMode.GetDataRate() << " Payload Time " << tData << " ns");
+
+      return NanoSeconds (tData);
+    }
+  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_OFDM)
+    {
+      /* 29.12.3.4 TXTIME calculation for EDMG OFDM mode, TData = (Nsym * (512 + Ngi)) * Ts */
+      /* 21.5.3.2.3.3 (5), Compute Nsym = Number of OFDM Symbols */
+
+      //Once multiple users are enabled - calculate Nsym for each user - then set Nsym to the maximum Nsym from all users - for loop for all users
+
+      uint32_t Nsd; // Nsd = Number of data subcarriers.
+      if (txVector.GetNCB () == 1)
+        Nsd = 336;
+      else if (txVector.GetNCB () == 2)
+        Nsd = 734;
+      else if (txVector.GetNCB () == 3)
+        Nsd = 1134;
+      else if (txVector.GetNCB () == 4)
+        Nsd = 1532;
+      else
+        NS_FATAL_ERROR("Unsupported number of continous channels");
+
+      // Once multimple space-time streams are enabled - sum the Nbpsc for all space-time streams.
+      uint32_t Nbpsc; // Nbpsc = Number of coded bits per constellation point Check Table 115 (ayD4) for different constellations.
+      if (payloadMode.GetConstellationSize () == 2)
+        Nbpsc = 1;
+      else if (payloadMode.GetConstellationSize () == 4)
+        Nbpsc = 2;
+      else if (payloadMode.GetConstellationSize () == 16)
+        Nbpsc = 4;
+      else if (payloadMode.GetConstellationSize () == 64)
+        Nbpsc = 6;
+      else
+        NS_FATAL_ERROR ("unsupported constellation size");
+
+      // For MIMO case
+      Nbpsc = Nbpsc * txVector.Get_NUM_STS ();
+
+      uint32_t Ncbps; // Ncbps = Number of coded bits per symbol. Check Table 21-20 for different constellations.
+      Ncbps = Nsd * Nbpsc;
+
+      uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
+      uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
+
+      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
+        Ncbits = Nbits * 2;
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 7);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
+      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
+        Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
+      else
+        NS_FATAL_ERROR ("unsupported code rate");
+
+      uint16_t Lcw; /* The LDPC codeword length. */
+      Lcw = 672;
+      if (txVector.GetLdcpCwLength ())
+        {
+          Lcw = Lcw * 2;
+        }
+
+      uint32_t Ncw = (uint32_t) ceil (double (Ncbits) / double (Lcw)); /* Ncw = The number of LDPC codewords.  */
+      uint32_t Nsym = (uint32_t) ceil (double (Ncw * Lcw) / Ncbps);    /* Nsym = Number of OFDM Symbols. */
+
+      if (txVector.GetEDMGTrainingFieldLength () != 0)
+        {
+          if (Nsym < aBRPminOFDMblocks)
+            Nsym = aBRPminOFDMblocks;
+        }
+
+      uint8_t Ngi = 0; /* the size of the guard interval */
+      if (txVector.GetGaurdIntervalType () == GI_LONG)
+        Ngi = 192;
+      else if (txVector.GetGaurdIntervalType () == GI_NORMAL)
+        Ngi = 96;
+      else if (txVector.GetGaurdIntervalType () == GI_SHORT)
+        Ngi = 48;
+
+      /* Make sure the result is in nanoseconds */
+      uint32_t tData;       /* The duration of the data part */
+      tData = lrint (ceil ((double (Nsym * (512 + Ngi)) / 2.64))); /* The duration of the data part */
+      NS_LOG_DEBUG ("bits " << Nbits << " cbits " << Ncbits << " rate " << payloadMode.GetDataRate() << " Payload Time " << tData << " ns");
+
+      if (txVector.GetTrainngFieldLength () != 0)
+        {
+          if (tData < OFDMBRPMin)
+            tData = OFDMBRPMin;
+        }
+      return NanoSeconds (tData);
+    }
+
+  NS_FATAL_ERROR ("unsupported modulation class");
+  return Seconds (0);
+}
+
+uint32_t
+WifiPhy::GetMaxPsduSize (Time duration, WifiTxVector txVector, uint16_t frequency)
+{
+  NS_LOG_FUNCTION (duration << txVector << frequency);
+  WifiModulationClass modulation = txVector.GetMode ().GetModulationClass ();
+  NS_ASSERT_MSG ((modulation == WIFI_MOD_CLASS_DMG_SC) || (modulation == WIFI_MOD_CLASS_DMG_OFDM)
+                 || (modulation == WIFI_MOD_CLASS_EDMG_SC) || (modulation == WIFI_MOD_CLASS_EDMG_OFDM),
+                 "Maximum PSDU size is only available for DMG/EDMG SC and OFDM modes");
+
+  /* The payload duration is monotonic in the PSDU size, so the answer is the largest size whose
+   * payload duration fits in what remains after the preamble and the headers. The answer only
+   * depends on that budget and on the fields of the payload duration key, which leaves out the
+   * fields that only change the preamble and the headers. */
+  const uint32_t maxPsduSize = 4194303; /* aPSDUMaxLength for EDMG */
+  Time budget = duration - CalculatePhyPreambleAndHeaderDuration (txVector);
+  std::pair<Time, DmgDurationKey> query = std::make_pair (budget, GetDmgDurationKey (0, txVector));
+  DmgMaxPsduCache::const_iterator it = m_dmgMaxPsduCache.find (query);
+  if (it != m_dmgMaxPsduCache.end ())
+    {
+      return it->second;
+    }
+
+  uint32_t fit = 0;
+  if (!budget.IsNegative () && GetDmgPayloadDuration (1, txVector) <= budget)
+    {
+      /* Closed-form estimate from the PHY data rate, then gallop around it to bracket the answer */
+      uint64_t dataRate = txVector.GetMode ().GetDmgDataRate () * txVector.Get_NUM_STS ();
+      uint64_t estimate = static_cast<uint64_t> (budget.GetSeconds () * dataRate / 8);
+      uint32_t low = 0;
+      uint32_t high = maxPsduSize + 1;
+      uint32_t step = std::max<uint32_t> (1, static_cast<uint32_t> (estimate / 64));
+      uint32_t probe = static_cast<uint32_t> (std::min<uint64_t> (std::max<uint64_t> (estimate, 1), maxPsduSize));
+      if (GetDmgPayloadDuration (probe, txVector) <= budget)
+        {
+          low = probe;
+          while (low < maxPsduSize)
+            {
+              probe = static_cast<uint32_t> (std::min<uint64_t> (uint64_t (low) + step, maxPsduSize));
+              if (GetDmgPayloadDuration (probe, txVector) > budget)
+                {
+                  high = probe;
+                  break;
+                }
+              low = probe;
+              step *= 2;
+            }
+        }
+      else
+        {
+          high = probe;
+          while (high > 0)
+            {
+              probe = (high > step) ? high - step : 0;
+              if ((probe == 0) || (GetDmgPayloadDuration (probe, txVector) <= budget))
+                {
+                  low = probe;
+                  break;
+                }
+              high = probe;
+              step *= 2;
+            }
+        }
+      /* Binary search with low fitting and high not fitting */
+      while (high - low > 1)
+        {
+          uint32_t middle = low + (high - low) / 2;
+          if (GetDmgPayloadDuration (middle, txVector) <= budget)
+            {
+              low = middle;
+            }
+          else
+            {
+              high = middle;
+            }
+        }
+      fit = low;
+    }
+  if (m_dmgMaxPsduCache.size () >= 4096)
+    {
+      m_dmgMaxPsduCache.clear ();
+    }
+  m_dmgMaxPsduCache[query] = fit;
+  return fit;
+}
+
 //// WIGIG ////
 Time
 WifiPhy::GetEDMGPreambleDuration (WifiTxVector txVector)
@@ -30,6 +30,7 @@
 #include "interference-helper.h"
 #include "wifi-phy-state-helper.h"
 #include "wigig-data-types.h"
+#include <tuple>
 
 namespace ns3 {
 
@@ -466,6 +467,20 @@ public:
    * \return the duration of the EDMG header B
    */
   static Time GetEDMG_HeaderB_Duration (WifiTxVector txVector);
+  /**
+   * Return the largest PSDU that fits within the given PPDU duration. The size is first
+   * estimated from the data rate of the MCS and then corrected against the exact payload
+   * duration, so the result is consistent with CalculateTxDuration. The answers and the
+   * payload durations tried along the way are memoized by this PHY. Only the DMG/EDMG SC
+   * and OFDM modulation classes are supported.
+   *
+   * \param duration the maximum duration of the PPDU
+   * \param txVector the TXVECTOR used for the transmission of the PPDU
+   * \param frequency the channel center frequency (MHz)
+   *
+   * \return the maximum PSDU size in bytes, or zero if not even an empty PSDU fits
+   */
+  uint32_t GetMaxPsduSize (Time duration, WifiTxVector txVector, uint16_t frequency);
   //// WIGIG ////
 
   /**
@@ -1687,6 +1702,12 @@ public:
    * \param rate the error rate model
    */
   void SetErrorRateModel (const Ptr<ErrorRateModel> rate);
+  /**
+   * Get the error rate model.
+   *
+   * \return the error rate model
+   */
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
   /**
    * Attach a receive ErrorModel to the WifiPhy.
    *
@@ -2145,6 +2166,44 @@ protected:
   typedef std::map<ChannelNumberStandardPair,FrequencyWidthPair> ChannelToFrequencyWidthMap; //!< channel to frequency width map typedef
   static ChannelToFrequencyWidthMap m_channelToFrequencyWidth;                               //!< the channel to frequency width map
 
+  /**
+   * The DMG/EDMG payload duration depends only on the PSDU size, the MCS and a handful
+   * of TXVECTOR fields, so the durations are memoized using the tuple (size, mode UID,
+   * TRN present, EDMG TRN present, guard interval, NCB, NSTS, number of users,
+   * transmit mask, LDPC codeword length) as key.
+   */
+  typedef std::tuple<uint32_t, uint32_t, bool, bool, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, bool> DmgDurationKey;
+  typedef std::map<DmgDurationKey, Time> DmgDurationCache;                     //!< Typedef for the DMG payload duration cache
+  typedef std::map<std::pair<Time, DmgDurationKey>, uint32_t> DmgMaxPsduCache; //!< Typedef for the maximum PSDU size cache
+  DmgDurationCache m_dmgDurationCache;                                         //!< Memoized DMG/EDMG payload durations
+  DmgMaxPsduCache m_dmgMaxPsduCache;                                           //!< Memoized maximum PSDU sizes per payload duration budget
+
+  /**
+   * \param size the number of bytes in the PSDU
+   * \param txVector the TXVECTOR used for the transmission of the PSDU
+   *
+   * \return the key identifying the payload duration in the DMG duration cache
+   */
+  static DmgDurationKey GetDmgDurationKey (uint32_t size, WifiTxVector txVector);
+  /**
+   * Return the payload duration of a DMG/EDMG PSDU, served from the duration cache of this PHY if possible.
+   *
+   * \param size the number of bytes in the PSDU
+   * \param txVector the TXVECTOR used for the transmission of the PSDU
+   *
+   * \return the duration of the payload
+   */
+  Time GetDmgPayloadDuration (uint32_t size, WifiTxVector txVector);
+  /**
+   * Calculate the payload duration of a DMG/EDMG PSDU from the LDPC codeword and block structure.
+   *
+   * \param size the number of bytes in the PSDU
+   * \param txVector the TXVECTOR used for the transmission of the PSDU
+   *
+   * \return the duration of the payload
+   */
+  static Time CalculateDmgPayloadDuration (uint32_t size, WifiTxVector txVector);
+
   std::vector<uint16_t> m_supportedChannelWidthSet; //!< Supported channel width set (MHz)
   uint8_t               m_channelNumber;            //!< Operating channel number
   uint8_t               m_initialChannelNumber;     //!< Initial channel number
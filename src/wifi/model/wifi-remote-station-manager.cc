@@ -122,6 +122,10 @@ WifiRemoteStationManager::GetTypeId (void)
                      "The reception of an MPDU packet by the MAC layer has successed",
                      MakeTraceSourceAccessor (&WifiRemoteStationManager::m_macRxOk),
                      "ns3::WifiRemoteStationManager::MacRxOkTracedCallback")
+    .AddTraceSource ("MacTxAcked",
+                     "A data frame or an A-MPDU has been acknowledged by the remote station",
+                     MakeTraceSourceAccessor (&WifiRemoteStationManager::m_macTxAcked),
+                     "ns3::WifiRemoteStationManager::MacTxAckedCallback")
     //// WIGIG ////
   ;
   return tid;
@@ -930,6 +934,7 @@ WifiRemoteStationManager::ReportDataOk (Mac48Address address, const WifiMacHeade
     }
   m_macTxOk (address);
   m_txCallbackOk (address);
+  m_macTxAcked (address, ackSnr, dataTxVector.GetMode ());
   DoReportDataOk (station, ackSnr, ackMode, dataSnr, dataTxVector.GetChannelWidth (), dataTxVector.GetNss ());
 }
 
@@ -993,6 +998,10 @@ WifiRemoteStationManager::ReportAmpduTxStatus (Mac48Address address,
     {
       m_macTxDataFailed (address);
     }
+  if (nSuccessfulMpdus > 0)
+    {
+      m_macTxAcked (address, rxSnr, dataTxVector.GetMode ());
+    }
   DoReportAmpduTxStatus (Lookup (address), nSuccessfulMpdus, nFailedMpdus, rxSnr, dataSnr, dataTxVector.GetChannelWidth (), dataTxVector.GetNss ());
 }
 
@@ -1346,7 +1355,7 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_qosSupported = false;
   state->m_dmgSupported = false;
   state->m_edmgSupported = false;
-  state->m_linkSnr = -100;
+  state->m_linkSnr = NO_LINK_SNR;
   const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
   NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning new state");
   return state;
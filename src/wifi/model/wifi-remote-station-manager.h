@@ -39,6 +39,8 @@
 #include "wifi-mac-header.h"
 //// WIGIG ////
 
+#define NO_LINK_SNR -100  //!< The SNR in dB of a link with no beamforming training completed yet.
+
 namespace ns3 {
 
 class WifiPhy;
@@ -769,7 +771,8 @@ public:
    * Return the latest SNR value after performing beamforming training with a the specified station.
    *
    * \param address The MAC address of the peer station.
-   * \return The SNR in dB of the link after performing beamforming training.
+   * \return The SNR in dB of the link after performing beamforming training, or NO_LINK_SNR if no
+   * beamforming training has been completed with the station.
    */
   double GetLinkSnr (Mac48Address address) const;
   //// WIGIG ////
@@ -1491,6 +1494,18 @@ private:
    * \param snr The snr value in linear scale.
    */
   typedef void (* MacRxOkCallback)(WifiMacType type, Mac48Address address, double snr);
+  /**
+   * The trace source fired when a data frame or an A-MPDU has been acknowledged.
+   */
+  TracedCallback<Mac48Address, double, WifiMode> m_macTxAcked;
+  /**
+   * TracedCallback signature for acknowledged data transmissions.
+   *
+   * \param address The MAC address of the station.
+   * \param ackSnr The SNR of the Ack or BlockAck frame in linear scale.
+   * \param dataMode The mode used to transmit the acknowledged data.
+   */
+  typedef void (* MacTxAckedCallback)(Mac48Address address, double ackSnr, WifiMode dataMode);
   //// WIGIG ////
 };
 
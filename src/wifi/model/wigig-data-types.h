@@ -29,6 +29,9 @@ typedef std::vector<AWV_CONFIGURATION>            MIMO_AWV_CONFIGURATION;
 typedef std::vector<MIMO_AWV_CONFIGURATION>       MIMO_AWV_CONFIGURATIONS;           //!< Typedef for a vector of antenna combinations used for MIMO
 //// NINA ////
 
+typedef std::pair<ANTENNA_CONFIGURATION, AntennaID>   SECTOR_SWEEP_CONFIGURATION;       //!< Typedef for a sector sweep step (Tx (AntennaID, SectorID), Rx quasi-omni AntennaID).
+typedef std::vector<SECTOR_SWEEP_CONFIGURATION>       SECTOR_SWEEP_CONFIGURATION_LIST;  //!< Typedef for the list of steps of a complete sector sweep.
+
 typedef enum  {
   SERVICE_PERIOD_ALLOCATION = 0,
   CBAP_ALLOCATION = 1
@@ -33,6 +33,7 @@
 #include "ns3/packet-socket-helper.h"
 #include "ns3/config.h"
 #include "ns3/pointer.h"
+#include "ns3/block-ack-scoreboard.h"
 
 using namespace ns3;
 
@@ -546,6 +547,109 @@ OriginatorBlockAckWindowTest::DoRun (void)
 }
 
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test for the scoreboard of the outstanding MPDUs
+ */
+class BlockAckScoreboardTest : public TestCase
+{
+public:
+  BlockAckScoreboardTest ();
+private:
+  virtual void DoRun ();
+  /**
+   * Create a QoS Data frame
+   * \param seq the sequence number
+   * \param frag the fragment number
+   * \return the QoS Data frame
+   */
+  Ptr<WifiMacQueueItem> CreateMpdu (uint16_t seq, uint8_t frag);
+};
+
+BlockAckScoreboardTest::BlockAckScoreboardTest ()
+  : TestCase ("Check the correctness of the scoreboard of the outstanding MPDUs")
+{
+}
+
+Ptr<WifiMacQueueItem>
+BlockAckScoreboardTest::CreateMpdu (uint16_t seq, uint8_t frag)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetSequenceNumber (seq);
+  hdr.SetFragmentNumber (frag);
+  return Create<WifiMacQueueItem> (Create<Packet> (), hdr);
+}
+
+void
+BlockAckScoreboardTest::DoRun (void)
+{
+  BlockAckScoreboard scoreboard;
+  scoreboard.Init (1024);
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetCapacity (), 1024, "Incorrect number of slots");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsEmpty (), true, "Scoreboard not empty after initialization");
+
+  // store a full EDMG window of MPDUs across the sequence number wrap-around,
+  // in reverse order
+  uint16_t startingSeq = 3500;
+  for (uint16_t i = 1024; i > 0; i--)
+    {
+      NS_TEST_EXPECT_MSG_EQ (scoreboard.Insert (CreateMpdu ((startingSeq + i - 1) % SEQNO_SPACE_SIZE, 0)),
+                             true, "MPDU not stored");
+    }
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetNMpdus (), 1024, "Incorrect number of MPDUs");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetCapacity (), 1024, "The scoreboard should not have been resized");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.Insert (CreateMpdu (startingSeq + 10, 0)), false, "Duplicate MPDU stored");
+
+  // MPDUs are returned in increasing order of sequence number
+  std::vector<Ptr<WifiMacQueueItem>> mpdus = scoreboard.GetMpdus ();
+  NS_TEST_EXPECT_MSG_EQ (mpdus.size (), 1024, "Incorrect number of MPDUs");
+  for (uint16_t i = 0; i < mpdus.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (mpdus[i]->GetHeader ().GetSequenceNumber (), (startingSeq + i) % SEQNO_SPACE_SIZE,
+                             "Incorrect order of MPDUs");
+    }
+
+  // remove every other MPDU
+  for (uint16_t i = 0; i < 1024; i += 2)
+    {
+      scoreboard.Remove ((startingSeq + i) % SEQNO_SPACE_SIZE);
+    }
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetNMpdus (), 512, "Incorrect number of MPDUs");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetFront ()->GetHeader ().GetSequenceNumber (), startingSeq + 1,
+                         "Incorrect MPDU at the front");
+
+  // the span would exceed the number of slots, which are doubled
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.Insert (CreateMpdu ((startingSeq + 1500) % SEQNO_SPACE_SIZE, 0)),
+                         true, "MPDU not stored");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetCapacity (), 2048, "Incorrect number of slots");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetNMpdus (), 513, "Incorrect number of MPDUs");
+  mpdus = scoreboard.GetMpdus ();
+  NS_TEST_EXPECT_MSG_EQ (mpdus.back ()->GetHeader ().GetSequenceNumber (), (startingSeq + 1500) % SEQNO_SPACE_SIZE,
+                         "Incorrect MPDU at the back");
+
+  // fragments of the same MSDU are counted once and sorted by fragment number
+  scoreboard.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsEmpty (), true, "Scoreboard not empty after being cleared");
+  scoreboard.Insert (CreateMpdu (10, 2));
+  scoreboard.Insert (CreateMpdu (10, 0));
+  scoreboard.Insert (CreateMpdu (10, 1));
+  scoreboard.Insert (CreateMpdu (8, 0));
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetNMpdus (), 4, "Incorrect number of MPDUs");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetNSequenceNumbers (), 2, "Incorrect number of sequence numbers");
+  scoreboard.RemoveFront ();
+  for (uint8_t frag = 0; frag < 3; frag++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (+scoreboard.GetFront ()->GetHeader ().GetFragmentNumber (), +frag,
+                             "Incorrect order of fragments");
+      scoreboard.RemoveFront ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsEmpty (), true, "Scoreboard not empty after removing all the MPDUs");
+}
+
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -950,6 +1054,7 @@ BlockAckTestSuite::BlockAckTestSuite ()
   AddTestCase (new PacketBufferingCaseA, TestCase::QUICK);
   AddTestCase (new PacketBufferingCaseB, TestCase::QUICK);
   AddTestCase (new OriginatorBlockAckWindowTest, TestCase::QUICK);
+  AddTestCase (new BlockAckScoreboardTest, TestCase::QUICK);
   AddTestCase (new CtrlBAckResponseHeaderTest, TestCase::QUICK);
   AddTestCase (new BlockAckAggregationDisabledTest (false), TestCase::QUICK);
   AddTestCase (new BlockAckAggregationDisabledTest (true), TestCase::QUICK);
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/packet.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/dmg-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/codebook-analytical.h"
+#include "ns3/dmg-wifi-mac.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/mac-low.h"
+#include "ns3/qos-txop.h"
+#include "ns3/wifi-psdu.h"
+#include "ns3/wifi-mac-queue.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgAggregationTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Trimming of a suspended A-MPDU to the remaining allocation
+ *
+ * A suspended A-MPDU is resumed with less time left in the service period
+ * than its whole transaction needs. For every remaining duration between the
+ * transaction times of its prefixes, MacLow::TrimAmpduToAllocation must keep
+ * the longest prefix whose transaction fits, and QosTxop::RequeueMpdus must put
+ * the MPDUs left out at the head of the block ack retransmit queue, in their
+ * original order and ahead of the MPDUs already waiting there. An A-MPDU that
+ * cannot be trimmed to two MPDUs must be left untouched.
+ */
+class DmgAmpduTrimTest : public TestCase
+{
+public:
+  DmgAmpduTrimTest ();
+  virtual ~DmgAmpduTrimTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create a QoS Data MPDU for the peer station.
+   * \param sequence the sequence number of the MPDU
+   * \return the MPDU
+   */
+  Ptr<WifiMacQueueItem> CreateMpdu (uint16_t sequence) const;
+
+  Mac48Address m_address;  //!< Address of the transmitter
+  Mac48Address m_peer;     //!< Address of the receiver
+};
+
+DmgAmpduTrimTest::DmgAmpduTrimTest ()
+  : TestCase ("Check that a suspended A-MPDU is trimmed to the remaining allocation")
+{
+}
+
+DmgAmpduTrimTest::~DmgAmpduTrimTest ()
+{
+}
+
+Ptr<WifiMacQueueItem>
+DmgAmpduTrimTest::CreateMpdu (uint16_t sequence) const
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  hdr.SetAddr1 (m_peer);
+  hdr.SetAddr2 (m_address);
+  hdr.SetSequenceNumber (sequence);
+  hdr.SetFragmentNumber (0);
+  hdr.SetNoMoreFragments ();
+  hdr.SetNoRetry ();
+  return Create<WifiMacQueueItem> (Create<Packet> (1500), hdr);
+}
+
+void
+DmgAmpduTrimTest::DoRun (void)
+{
+  const uint16_t nMpdus = 10;
+  const uint16_t retransmitSequence = 4000;
+
+  DmgWifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+
+  DmgWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("DMG_MCS4"));
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (SIMPLE_CODEBOOK),
+                    "Antennas", UintegerValue (1),
+                    "Sectors", UintegerValue (8));
+
+  NodeContainer wifiNodes;
+  wifiNodes.Create (2);
+
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgAdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, wifiNodes);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiNodes);
+
+  Ptr<DmgWifiMac> mac = StaticCast<DmgWifiMac> (StaticCast<WifiNetDevice> (devices.Get (0))->GetMac ());
+  m_address = mac->GetAddress ();
+  m_peer = StaticCast<WifiNetDevice> (devices.Get (1))->GetMac ()->GetAddress ();
+  Ptr<QosTxop> edca = mac->GetBEQueue ();
+  Ptr<MacLow> low = edca->GetLow ();
+  Ptr<WifiMacQueue> retransmitQueue = edca->m_baManager->GetRetransmitQueue ();
+
+  std::vector<Ptr<WifiMacQueueItem>> mpduList;
+  for (uint16_t i = 0; i < nMpdus; i++)
+    {
+      mpduList.push_back (CreateMpdu (i));
+    }
+  low->m_currentTxVector = low->GetDataTxVector (mpduList.front ());
+  NS_TEST_ASSERT_MSG_EQ (low->m_currentTxVector.GetMode ().GetModulationClass (), WIFI_MOD_CLASS_DMG_SC,
+                         "The A-MPDU must be sent with a DMG SC mode");
+  low->m_txParams = MacLowTransmissionParameters ();
+  low->m_txParams.EnableBlockAck (BlockAckType::COMPRESSED_BLOCK_ACK);
+
+  /* Transaction time of each prefix of the A-MPDU, including the BlockAck */
+  std::vector<Time> transactionTimes (nMpdus + 1);
+  for (uint16_t n = 1; n <= nMpdus; n++)
+    {
+      Ptr<WifiPsdu> psdu = Create<WifiPsdu> (std::vector<Ptr<WifiMacQueueItem>> (mpduList.begin (),
+                                                                                 mpduList.begin () + n));
+      transactionTimes[n] = low->CalculateWiGigTransactionTime (psdu);
+      if (n > 1)
+        {
+          NS_TEST_ASSERT_MSG_GT (transactionTimes[n], transactionTimes[n - 1],
+                                 "The transaction time must grow with the number of MPDUs");
+        }
+    }
+
+  /* The remaining duration falls halfway between two prefixes */
+  for (uint16_t expected = 2; expected < nMpdus; expected++)
+    {
+      Time duration = (transactionTimes[expected] + transactionTimes[expected + 1]) / 2;
+      retransmitQueue->Flush ();
+      retransmitQueue->Enqueue (CreateMpdu (retransmitSequence));
+      low->m_currentPacket = Create<WifiPsdu> (mpduList);
+
+      NS_TEST_ASSERT_MSG_EQ (low->TrimAmpduToAllocation (duration), true,
+                             "The A-MPDU must be trimmed to " << expected << " MPDUs");
+      NS_TEST_ASSERT_MSG_EQ (low->m_currentPacket->GetNMpdus (), expected,
+                             "Wrong number of MPDUs left in the A-MPDU for a duration of " << duration);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (low->CalculateWiGigTransactionTime (low->m_currentPacket), duration,
+                                   "The trimmed A-MPDU must fit in the allocation");
+      for (uint16_t i = 0; i < expected; i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (low->m_currentPacket->GetHeader (i).GetSequenceNumber (), i,
+                                 "Wrong MPDU kept in the A-MPDU");
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (retransmitQueue->GetNPackets (), static_cast<uint32_t> (nMpdus - expected + 1),
+                             "The MPDUs left out must be requeued for retransmission");
+      for (uint16_t i = expected; i < nMpdus; i++)
+        {
+          Ptr<WifiMacQueueItem> mpdu = retransmitQueue->Dequeue ();
+          NS_TEST_EXPECT_MSG_EQ (mpdu, mpduList[i], "Wrong order of the requeued MPDUs");
+        }
+      NS_TEST_EXPECT_MSG_EQ (retransmitQueue->Dequeue ()->GetHeader ().GetSequenceNumber (), retransmitSequence,
+                             "The requeued MPDUs must precede the pending retransmissions");
+    }
+
+  /* Not even two MPDUs fit in the allocation */
+  low->m_currentPacket = Create<WifiPsdu> (mpduList);
+  NS_TEST_ASSERT_MSG_EQ (low->TrimAmpduToAllocation (transactionTimes[2] - MicroSeconds (1)), false,
+                         "An A-MPDU cannot be trimmed to less than two MPDUs");
+  NS_TEST_ASSERT_MSG_EQ (low->m_currentPacket->GetNMpdus (), nMpdus, "The A-MPDU must be left untouched");
+  NS_TEST_ASSERT_MSG_EQ (retransmitQueue->GetNPackets (), 0u, "No MPDU must be requeued");
+
+  low->m_currentPacket = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG Aggregation Test Suite
+ */
+class DmgAggregationTestSuite : public TestSuite
+{
+public:
+  DmgAggregationTestSuite ();
+};
+
+DmgAggregationTestSuite::DmgAggregationTestSuite ()
+  : TestSuite ("dmg-aggregation", UNIT)
+{
+  AddTestCase (new DmgAmpduTrimTest, TestCase::QUICK);
+}
+
+static DmgAggregationTestSuite dmgAggregationTestSuite; ///< the test suite
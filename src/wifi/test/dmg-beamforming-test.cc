@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/dmg-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/codebook-analytical.h"
+#include "ns3/dmg-wifi-mac.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-utils.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgBeamformingTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Best antenna configuration of the SNR tables
+ *
+ * A random sequence of SLS measurements is stored in the SNR tables of a DMG
+ * station for several peers: TX and RX SNRs of random antenna configurations,
+ * taken from a few values so that ties and drops of the best SNR are frequent,
+ * and removals of the SNR table of a peer. After each operation, the antenna
+ * configuration and the SNR returned by GetBestAntennaConfiguration for every
+ * peer must be those of the first antenna configuration with the highest SNR
+ * found by a linear scan of the SNR table of the peer.
+ */
+class BestAntennaConfigurationTest : public TestCase
+{
+public:
+  BestAntennaConfigurationTest ();
+  virtual ~BestAntennaConfigurationTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Apply a random operation to the SNR tables and check the best antenna configurations afterwards.
+   * \param step the number of the operation
+   */
+  void DoOperation (uint32_t step);
+  /**
+   * Check the best antenna configurations of every peer against a linear scan of its SNR table.
+   * \param step the number of the operation applied last
+   */
+  void CheckBestConfigurations (uint32_t step);
+
+  Ptr<DmgWifiMac> m_mac;                        //!< The MAC storing the SNR tables
+  std::vector<Mac48Address> m_peers;            //!< Peers of the SLS measurements
+  Ptr<UniformRandomVariable> m_random;          //!< Random variable driving the operations
+  uint32_t m_nRemovals;                         //!< Number of SNR tables removed
+};
+
+BestAntennaConfigurationTest::BestAntennaConfigurationTest ()
+  : TestCase ("Check the best antenna configuration against a linear scan of the SNR table"),
+    m_nRemovals (0)
+{
+}
+
+BestAntennaConfigurationTest::~BestAntennaConfigurationTest ()
+{
+}
+
+void
+BestAntennaConfigurationTest::DoOperation (uint32_t step)
+{
+  Mac48Address peer = m_peers[m_random->GetInteger (0, m_peers.size () - 1)];
+  AntennaID antennaID = m_random->GetInteger (1, 2);
+  SectorID sectorID = m_random->GetInteger (1, 8);
+  double snr = DbToRatio (m_random->GetInteger (0, 5));
+  uint32_t operation = m_random->GetInteger (0, 99);
+  if (operation < 60)
+    {
+      m_mac->MapTxSnr (peer, m_random->GetInteger (1, 2), antennaID, sectorID, snr);
+    }
+  else if (operation < 95)
+    {
+      m_mac->MapRxSnr (peer, antennaID, sectorID, snr);
+    }
+  else
+    {
+      m_mac->RemoveSnrTable (peer);
+      m_nRemovals++;
+    }
+  CheckBestConfigurations (step);
+}
+
+void
+BestAntennaConfigurationTest::CheckBestConfigurations (uint32_t step)
+{
+  for (const auto &peer : m_peers)
+    {
+      for (bool isTx : {true, false})
+        {
+          /* First antenna configuration with the highest SNR, found by a linear scan */
+          ANTENNA_CONFIGURATION expected = std::make_pair (NO_ANTENNA_CONFIG, NO_ANTENNA_CONFIG);
+          double expectedSnr = 0;
+          DmgWifiMac::STATION_SNR_PAIR_MAP_CI it = m_mac->m_stationSnrMap.find (peer);
+          if (it != m_mac->m_stationSnrMap.end ())
+            {
+              const DmgWifiMac::SNR_MAP &snrMap = (isTx ? it->second.first : it->second.second);
+              for (DmgWifiMac::SNR_MAP::const_iterator snrIt = snrMap.begin (); snrIt != snrMap.end (); snrIt++)
+                {
+                  if ((snrIt == snrMap.begin ()) || (expectedSnr < snrIt->second))
+                    {
+                      expected = std::make_pair (std::get<1> (snrIt->first), std::get<2> (snrIt->first));
+                      expectedSnr = snrIt->second;
+                    }
+                }
+            }
+
+          double maxSnr;
+          ANTENNA_CONFIGURATION config = m_mac->GetBestAntennaConfiguration (peer, isTx, maxSnr);
+          NS_TEST_ASSERT_MSG_EQ (+config.first, +expected.first, "Wrong " << (isTx ? "TX" : "RX") << " antenna for "
+                                 << peer << " after operation " << step);
+          NS_TEST_ASSERT_MSG_EQ (+config.second, +expected.second, "Wrong " << (isTx ? "TX" : "RX") << " sector for "
+                                 << peer << " after operation " << step);
+          NS_TEST_ASSERT_MSG_EQ (maxSnr, expectedSnr, "Wrong " << (isTx ? "TX" : "RX") << " SNR for "
+                                 << peer << " after operation " << step);
+        }
+    }
+}
+
+void
+BestAntennaConfigurationTest::DoRun (void)
+{
+  const uint32_t nOperations = 2000;
+
+  DmgWifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+
+  DmgWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("DMG_MCS12"));
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (SIMPLE_CODEBOOK),
+                    "Antennas", UintegerValue (2),
+                    "Sectors", UintegerValue (8));
+
+  NodeContainer wifiNodes;
+  wifiNodes.Create (1);
+
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgAdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, wifiNodes);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiNodes);
+
+  m_mac = StaticCast<DmgWifiMac> (StaticCast<WifiNetDevice> (devices.Get (0))->GetMac ());
+  m_peers.push_back (Mac48Address ("00:00:00:00:00:11"));
+  m_peers.push_back (Mac48Address ("00:00:00:00:00:12"));
+  m_peers.push_back (Mac48Address ("00:00:00:00:00:13"));
+
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+
+  /* The operations run once the codebook of the station is initialized */
+  for (uint32_t step = 0; step < nOperations; step++)
+    {
+      Simulator::Schedule (MicroSeconds (10 * (step + 1)), &BestAntennaConfigurationTest::DoOperation, this, step);
+    }
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_GT (m_nRemovals, 0, "No SNR table was removed");
+
+  m_mac = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG Beamforming Test Suite
+ */
+class DmgBeamformingTestSuite : public TestSuite
+{
+public:
+  DmgBeamformingTestSuite ();
+};
+
+DmgBeamformingTestSuite::DmgBeamformingTestSuite ()
+  : TestSuite ("dmg-beamforming", UNIT)
+{
+  AddTestCase (new BestAntennaConfigurationTest, TestCase::QUICK);
+}
+
+static DmgBeamformingTestSuite dmgBeamformingTestSuite; ///< the test suite
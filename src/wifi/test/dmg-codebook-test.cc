@@ -0,0 +1,309 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/dmg-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/codebook-analytical.h"
+#include "ns3/dmg-sta-wifi-mac.h"
+#include "ns3/dmg-ap-wifi-mac.h"
+#include "ns3/ctrl-headers.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/ssid.h"
+#include <fstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgCodebookTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Sector hierarchy of a codebook file
+ *
+ * Loads an analytical codebook whose file declares two wide sectors refined by
+ * two narrow sectors each, and checks the hierarchy. Loading the file again
+ * must not duplicate the children, and loading a file without a hierarchy must
+ * remove it. The trailing lines of a file without the hierarchy section marker
+ * are not part of a hierarchy.
+ */
+class SectorHierarchyLoadTest : public TestCase
+{
+public:
+  SectorHierarchyLoadTest ();
+  virtual ~SectorHierarchyLoadTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write an analytical codebook with one antenna array of six sectors.
+   * \param filename The name of the codebook file.
+   * \param hierarchy The sector hierarchy appended to the file.
+   */
+  void WriteCodebook (std::string filename, std::string hierarchy);
+};
+
+SectorHierarchyLoadTest::SectorHierarchyLoadTest ()
+  : TestCase ("Check the sector hierarchy read from a codebook file")
+{
+}
+
+SectorHierarchyLoadTest::~SectorHierarchyLoadTest ()
+{
+}
+
+void
+SectorHierarchyLoadTest::WriteCodebook (std::string filename, std::string hierarchy)
+{
+  std::ofstream file (filename.c_str ());
+  /* Antenna ID, orientation and quasi-omni gain */
+  file << "1\n1\n0\n0\n6\n";
+  /* Two wide sectors followed by four narrow sectors */
+  for (uint16_t sector = 1; sector <= 6; sector++)
+    {
+      double width = (sector <= 2 ? M_PI : M_PI / 2);
+      double steering = (sector <= 2 ? (sector - 1) * M_PI : (sector - 3) * M_PI / 2);
+      file << sector << "\n" << TX_RX_SECTOR << "\n" << (sector <= 2 ? BHI_SLS_SECTOR : SLS_SECTOR) << "\n"
+           << steering << "\n" << width << "\n";
+    }
+  file << hierarchy;
+  file.close ();
+}
+
+void
+SectorHierarchyLoadTest::DoRun (void)
+{
+  std::string hierarchyFile = CreateTempDirFilename ("sector-hierarchy-codebook.txt");
+  std::string flatFile = CreateTempDirFilename ("flat-codebook.txt");
+  WriteCodebook (hierarchyFile, "\n" SECTOR_HIERARCHY_MARKER "\r\n1,1,3,4\n\n 1, 2 ,5,6\r\n");
+  WriteCodebook (flatFile, "\nGenerated for the DMG codebook tests, 1,2\n");
+
+  Ptr<CodebookAnalytical> codebook = CreateObject<CodebookAnalytical> ();
+  for (uint8_t load = 0; load < 2; load++)
+    {
+      uint32_t version = codebook->GetVersion ();
+      codebook->SetAttribute ("FileName", StringValue (hierarchyFile));
+      codebook->SetAttribute ("CodebookType", EnumValue (CUSTOM_CODEBOOK));
+      NS_TEST_ASSERT_MSG_NE (codebook->GetVersion (), version, "Loading a hierarchy must change the codebook version");
+      NS_TEST_ASSERT_MSG_EQ (codebook->HasSectorHierarchy (), true, "The codebook has a sector hierarchy");
+
+      Antenna2SectorList wideList = codebook->GetWideSectorList ();
+      NS_TEST_ASSERT_MSG_EQ (wideList.size (), 1, "The wide sectors belong to a single antenna array");
+      NS_TEST_ASSERT_MSG_EQ (wideList[1].size (), 2, "Wrong number of wide sectors");
+      NS_TEST_ASSERT_MSG_EQ (uint16_t (wideList[1][0]), 1, "Wrong first wide sector");
+      NS_TEST_ASSERT_MSG_EQ (uint16_t (wideList[1][1]), 2, "Wrong second wide sector");
+      NS_TEST_ASSERT_MSG_EQ (codebook->IsWideSector (1, 2), true, "Sector 2 is a wide sector");
+      NS_TEST_ASSERT_MSG_EQ (codebook->IsWideSector (1, 3), false, "Sector 3 is a narrow sector");
+
+      for (SectorID wide = 1; wide <= 2; wide++)
+        {
+          Antenna2SectorList childList = codebook->GetChildSectorList (1, wide);
+          /* Loading the file again replaces the hierarchy instead of appending to it */
+          NS_TEST_ASSERT_MSG_EQ (childList[1].size (), 2, "Wrong number of children of wide sector " << uint16_t (wide));
+          NS_TEST_ASSERT_MSG_EQ (uint16_t (childList[1][0]), 2 * wide + 1, "Wrong first child of wide sector " << uint16_t (wide));
+          NS_TEST_ASSERT_MSG_EQ (uint16_t (childList[1][1]), 2 * wide + 2, "Wrong second child of wide sector " << uint16_t (wide));
+        }
+    }
+
+  codebook->SetAttribute ("FileName", StringValue (flatFile));
+  codebook->SetAttribute ("CodebookType", EnumValue (CUSTOM_CODEBOOK));
+  NS_TEST_ASSERT_MSG_EQ (codebook->HasSectorHierarchy (), false, "The hierarchy of the previous file must be removed");
+  NS_TEST_ASSERT_MSG_EQ (codebook->GetWideSectorList ().empty (), true, "No wide sector without a hierarchy");
+  codebook->Dispose ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief CDOWN of a hierarchical sector sweep
+ *
+ * A DMG STA with a codebook of eight sectors, where the odd sectors are wide
+ * sectors refined by their two neighbors, starts a TXSS with its DMG PCP/AP in
+ * a CBAP. The first TXSS must only sweep the four wide sectors, and the TXSS
+ * that follows it must only sweep the two children of the best wide sector. The
+ * CDOWN of the SSW frames must count down to zero over the swept sectors only.
+ */
+class HierarchicalSectorSweepTest : public TestCase
+{
+public:
+  HierarchicalSectorSweepTest ();
+  virtual ~HierarchicalSectorSweepTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Record an SSW frame transmitted by the DMG STA as initiator of a TXSS.
+   * \param packet The transmitted packet.
+   * \param txPowerW The transmit power in Watts.
+   */
+  void PhyTxBegin (Ptr<const Packet> packet, double txPowerW);
+  /**
+   * Start recording the SSW frames.
+   */
+  void StartRecording (void);
+
+  bool m_recording;                     //!< Whether the SSW frames are recorded.
+  std::vector<uint16_t> m_cdown;        //!< CDOWN of the recorded SSW frames.
+  std::vector<uint16_t> m_sectors;      //!< Sector ID of the recorded SSW frames.
+};
+
+HierarchicalSectorSweepTest::HierarchicalSectorSweepTest ()
+  : TestCase ("Check the CDOWN of the SSW frames of a hierarchical sector sweep"),
+    m_recording (false)
+{
+}
+
+HierarchicalSectorSweepTest::~HierarchicalSectorSweepTest ()
+{
+}
+
+void
+HierarchicalSectorSweepTest::PhyTxBegin (Ptr<const Packet> packet, double txPowerW)
+{
+  WifiMacHeader hdr;
+  Ptr<Packet> copy = packet->Copy ();
+  copy->RemoveHeader (hdr);
+  if (!m_recording || !hdr.IsSSW ())
+    {
+      return;
+    }
+  CtrlDMG_SSW sswFrame;
+  copy->RemoveHeader (sswFrame);
+  DMG_SSW_Field ssw = sswFrame.GetSswField ();
+  if (ssw.GetDirection () == BeamformingInitiator)
+    {
+      m_cdown.push_back (ssw.GetCountDown ());
+      m_sectors.push_back (ssw.GetSectorID ());
+    }
+}
+
+void
+HierarchicalSectorSweepTest::StartRecording (void)
+{
+  m_recording = true;
+}
+
+void
+HierarchicalSectorSweepTest::DoRun (void)
+{
+  DmgWifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+
+  DmgWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  wifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("DMG_MCS12"));
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (SIMPLE_CODEBOOK),
+                    "Antennas", UintegerValue (1),
+                    "Sectors", UintegerValue (8));
+
+  NodeContainer wifiNodes;
+  wifiNodes.Create (2);
+
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  Ssid ssid = Ssid ("HierarchicalSweep");
+  wifiMac.SetType ("ns3::DmgApWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                   "BeaconInterval", TimeValue (MicroSeconds (102400)));
+  NetDeviceContainer apDevice = wifi.Install (wifiPhy, wifiMac, wifiNodes.Get (0));
+  wifiMac.SetType ("ns3::DmgStaWifiMac",
+                   "Ssid", SsidValue (ssid), "ActiveProbing", BooleanValue (false),
+                   "HierarchicalSectorSweep", BooleanValue (true));
+  NetDeviceContainer staDevice = wifi.Install (wifiPhy, wifiMac, wifiNodes.Get (1));
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, +1.0, 0.0));
+  positionAlloc->Add (Vector (0.0, -1.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiNodes);
+
+  Ptr<WifiNetDevice> staNetDevice = StaticCast<WifiNetDevice> (staDevice.Get (0));
+  Ptr<DmgApWifiMac> apMac = StaticCast<DmgApWifiMac> (StaticCast<WifiNetDevice> (apDevice.Get (0))->GetMac ());
+  Ptr<DmgStaWifiMac> staMac = StaticCast<DmgStaWifiMac> (staNetDevice->GetMac ());
+
+  /* The odd sectors are wide sectors refined by their two neighbors */
+  Ptr<Codebook> codebook = staMac->GetCodebook ();
+  for (SectorID wide = 1; wide <= 7; wide += 2)
+    {
+      codebook->AppendChildSector (1, wide, (wide == 1) ? 8 : wide - 1);
+      codebook->AppendChildSector (1, wide, wide + 1);
+    }
+
+  staNetDevice->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin",
+                                                       MakeCallback (&HierarchicalSectorSweepTest::PhyTxBegin, this));
+  /* Only record the TXSS in the DTI, after the association in the A-BFT */
+  Simulator::Schedule (MilliSeconds (250), &HierarchicalSectorSweepTest::StartRecording, this);
+  Simulator::Schedule (MilliSeconds (250), &DmgWifiMac::Perform_TXSS_TXOP, staMac, apMac->GetAddress ());
+  Simulator::Stop (MilliSeconds (300));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_cdown.size (), 6, "Four wide sectors and two narrow sectors must be swept");
+  for (uint8_t i = 0; i < 4; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_cdown[i], 3 - i, "Wrong CDOWN of SSW frame " << uint16_t (i) << " of the wide sweep");
+      NS_TEST_ASSERT_MSG_EQ (m_sectors[i] % 2, 1, "The wide sweep must only use the wide sectors");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_cdown[4], 1, "Wrong CDOWN of the first SSW frame of the refinement");
+  NS_TEST_ASSERT_MSG_EQ (m_cdown[5], 0, "Wrong CDOWN of the last SSW frame of the refinement");
+  NS_TEST_ASSERT_MSG_EQ (m_sectors[4] % 2, 0, "The refinement must only use the narrow sectors");
+  NS_TEST_ASSERT_MSG_EQ (m_sectors[5] % 2, 0, "The refinement must only use the narrow sectors");
+  /* The children of a wide sector are its two neighbors, modulo eight */
+  NS_TEST_ASSERT_MSG_EQ ((m_sectors[5] - m_sectors[4] + 8) % 8, 2, "The refinement must sweep the children of one wide sector");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Codebook Test Suite
+ */
+class DmgCodebookTestSuite : public TestSuite
+{
+public:
+  DmgCodebookTestSuite ();
+};
+
+DmgCodebookTestSuite::DmgCodebookTestSuite ()
+  : TestSuite ("dmg-codebook", UNIT)
+{
+  AddTestCase (new SectorHierarchyLoadTest, TestCase::QUICK);
+  AddTestCase (new HierarchicalSectorSweepTest, TestCase::QUICK);
+}
+
+static DmgCodebookTestSuite dmgCodebookTestSuite; ///< the test suite
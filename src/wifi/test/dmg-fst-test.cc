@@ -0,0 +1,236 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/dmg-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/codebook-analytical.h"
+#include "ns3/dmg-sta-wifi-mac.h"
+#include "ns3/dmg-ap-wifi-mac.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/ssid.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgFstTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Automatic Fast Session Transfer
+ *
+ * A DMG STA associates with a DMG PCP/AP. The FST policy of the DMG STA finds
+ * the link SNR reported by the beamforming training below its thresholds, so it
+ * sets up an FST session with the DMG PCP/AP and transfers the session to the
+ * 5 GHz band as soon as the session is set up, before the expiry of the Link
+ * Loss Timeout. Without the policy, the session is never transferred.
+ */
+class FstPolicyTransferTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param automaticFst Whether the FST policy of the DMG STA is enabled.
+   */
+  FstPolicyTransferTest (bool automaticFst);
+  virtual ~FstPolicyTransferTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record a session transfer reported by the FST policy of the DMG STA.
+   * \param address The MAC address of the peer station.
+   * \param newBand The ID of the new band.
+   * \param latency The latency of the transfer.
+   */
+  void FstSwitch (Mac48Address address, BandID newBand, Time latency);
+  /**
+   * Record a band change of the DMG STA.
+   * \param standard The standard of the new band.
+   * \param address The MAC address of the peer station.
+   * \param isInitiator Whether the DMG STA is the initiator of the FST session.
+   */
+  void BandChanged (WifiPhyStandard standard, Mac48Address address, bool isInitiator);
+
+  bool m_automaticFst;              //!< Whether the FST policy of the DMG STA is enabled.
+  uint32_t m_switches;              //!< Number of session transfers reported by the FST policy.
+  Mac48Address m_switchAddress;     //!< Peer station of the last session transfer.
+  BandID m_switchBand;              //!< New band of the last session transfer.
+  Time m_switchTime;                //!< Time of the last session transfer.
+  Time m_switchLatency;             //!< Latency of the last session transfer.
+  uint32_t m_bandChanges;           //!< Number of band changes of the DMG STA.
+  WifiPhyStandard m_bandStandard;   //!< Standard of the last band change.
+  bool m_bandInitiator;             //!< Initiator flag of the last band change.
+};
+
+FstPolicyTransferTest::FstPolicyTransferTest (bool automaticFst)
+  : TestCase (automaticFst ? "Check that the FST policy transfers the session when the DMG link degrades"
+                           : "Check that the session is not transferred without the FST policy"),
+    m_automaticFst (automaticFst),
+    m_switches (0),
+    m_switchBand (Band_60GHz),
+    m_bandChanges (0),
+    m_bandStandard (WIFI_PHY_STANDARD_80211ad),
+    m_bandInitiator (false)
+{
+}
+
+FstPolicyTransferTest::~FstPolicyTransferTest ()
+{
+}
+
+void
+FstPolicyTransferTest::FstSwitch (Mac48Address address, BandID newBand, Time latency)
+{
+  m_switches++;
+  m_switchAddress = address;
+  m_switchBand = newBand;
+  m_switchTime = Simulator::Now ();
+  m_switchLatency = latency;
+}
+
+void
+FstPolicyTransferTest::BandChanged (WifiPhyStandard standard, Mac48Address address, bool isInitiator)
+{
+  m_bandChanges++;
+  m_bandStandard = standard;
+  m_bandInitiator = isInitiator;
+}
+
+static void
+IgnoreBandChange (WifiPhyStandard standard, Mac48Address address, bool isInitiator)
+{
+}
+
+void
+FstPolicyTransferTest::DoRun (void)
+{
+  DmgWifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+
+  DmgWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  wifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("DMG_MCS12"));
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (SIMPLE_CODEBOOK),
+                    "Antennas", UintegerValue (1),
+                    "Sectors", UintegerValue (8));
+
+  NodeContainer wifiNodes;
+  wifiNodes.Create (2);
+
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  Ssid ssid = Ssid ("FstPolicy");
+  wifiMac.SetType ("ns3::DmgApWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                   "BeaconInterval", TimeValue (MicroSeconds (102400)));
+  NetDeviceContainer apDevice = wifi.Install (wifiPhy, wifiMac, wifiNodes.Get (0));
+
+  /* Any measured link SNR is below the thresholds, and the Link Loss Timeout
+   * (1000 x 32 us) is longer than the interval between two evaluations */
+  wifiMac.SetType ("ns3::DmgStaWifiMac",
+                   "Ssid", SsidValue (ssid), "ActiveProbing", BooleanValue (false),
+                   "LLT", UintegerValue (1000),
+                   "AutomaticFst", BooleanValue (m_automaticFst),
+                   "FstPolicyInterval", TimeValue (MilliSeconds (5)),
+                   "FstSetupSnrThreshold", DoubleValue (1000),
+                   "FstSwitchSnrThreshold", DoubleValue (1000));
+  NetDeviceContainer staDevice = wifi.Install (wifiPhy, wifiMac, wifiNodes.Get (1));
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, +1.0, 0.0));
+  positionAlloc->Add (Vector (0.0, -1.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiNodes);
+
+  Ptr<DmgApWifiMac> apMac = StaticCast<DmgApWifiMac> (StaticCast<WifiNetDevice> (apDevice.Get (0))->GetMac ());
+  Ptr<DmgStaWifiMac> staMac = StaticCast<DmgStaWifiMac> (StaticCast<WifiNetDevice> (staDevice.Get (0))->GetMac ());
+  apMac->RegisterBandChangedCallback (MakeCallback (&IgnoreBandChange));
+  staMac->RegisterBandChangedCallback (MakeCallback (&FstPolicyTransferTest::BandChanged, this));
+  staMac->TraceConnectWithoutContext ("FstSwitch", MakeCallback (&FstPolicyTransferTest::FstSwitch, this));
+
+  Simulator::Stop (MilliSeconds (300));
+  Simulator::Run ();
+
+  if (m_automaticFst)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_switches, 1, "The session must be transferred once");
+      NS_TEST_ASSERT_MSG_EQ (m_switchAddress, apMac->GetAddress (), "The session with the DMG PCP/AP must be transferred");
+      NS_TEST_ASSERT_MSG_EQ (m_switchBand, Band_4_9GHz, "The session must be transferred to the 5 GHz band");
+      NS_TEST_ASSERT_MSG_GT (m_switchLatency, Seconds (0), "The degradation must precede the transfer");
+      NS_TEST_ASSERT_MSG_LT (m_switchLatency, MicroSeconds (32000),
+                             "The policy must transfer the session before the Link Loss Timeout");
+      NS_TEST_ASSERT_MSG_EQ (m_bandChanges, 1, "The band of the DMG STA must change once");
+      NS_TEST_ASSERT_MSG_EQ (m_bandStandard, WIFI_PHY_STANDARD_80211n_5GHZ, "Wrong standard of the new band");
+      NS_TEST_ASSERT_MSG_EQ (m_bandInitiator, true, "The DMG STA is the initiator of the FST session");
+      NS_TEST_ASSERT_MSG_EQ (staMac->GetFstSessionState (apMac->GetAddress ()), FST_TRANSITION_DONE_STATE,
+                             "The FST session of the DMG STA must be in the Transition Done state");
+      NS_TEST_ASSERT_MSG_NE (apMac->GetFstSessionState (staMac->GetAddress ()), FST_INITIAL_STATE,
+                             "The DMG PCP/AP must have accepted the FST session");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_switches, 0, "No session must be transferred without the FST policy");
+      NS_TEST_ASSERT_MSG_EQ (m_bandChanges, 0, "The band must not change without the FST policy");
+      NS_TEST_ASSERT_MSG_EQ (staMac->GetFstSessionState (apMac->GetAddress ()), FST_INITIAL_STATE,
+                             "No FST session must be set up without the FST policy");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Fast Session Transfer Test Suite
+ */
+class DmgFstTestSuite : public TestSuite
+{
+public:
+  DmgFstTestSuite ();
+};
+
+DmgFstTestSuite::DmgFstTestSuite ()
+  : TestSuite ("dmg-fst", UNIT)
+{
+  AddTestCase (new FstPolicyTransferTest (true), TestCase::QUICK);
+  AddTestCase (new FstPolicyTransferTest (false), TestCase::QUICK);
+}
+
+static DmgFstTestSuite dmgFstTestSuite; ///< the test suite
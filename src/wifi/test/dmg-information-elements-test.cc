@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/buffer.h"
+#include "ns3/fields-headers.h"
+#include "ns3/dmg-information-elements.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgInformationElementsTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Beamforming Control field round trip
+ *
+ * Every 16-bit value of the BF Control field is decoded, encoded again,
+ * serialized on its own and serialized as part of the Allocation fields of
+ * an Extended Schedule element, whose allocation fields are laid out in a
+ * flat array before being written to the buffer. The value read back must
+ * be the original one in all cases, together with the other subfields of the
+ * Allocation field.
+ */
+class BfControlRoundTripTest : public TestCase
+{
+public:
+  BfControlRoundTripTest ();
+  virtual ~BfControlRoundTripTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BfControlRoundTripTest::BfControlRoundTripTest ()
+  : TestCase ("Check the round trip of all the 16-bit values of the BF Control field")
+{
+}
+
+BfControlRoundTripTest::~BfControlRoundTripTest ()
+{
+}
+
+void
+BfControlRoundTripTest::DoRun (void)
+{
+  /* Largest number of Allocation fields within the 255 bytes of the information field */
+  const uint32_t allocationsPerElement = 255 / AllocationField::ALLOCATION_FIELD_SIZE;
+  const uint32_t nValues = 1 << 16;
+  for (uint32_t first = 0; first < nValues; first += allocationsPerElement)
+    {
+      ExtendedScheduleElement element;
+      for (uint32_t value = first; (value < nValues) && (value < first + allocationsPerElement); value++)
+        {
+          BF_Control_Field bfControl;
+          bfControl.SetBfControl (value);
+          NS_TEST_ASSERT_MSG_EQ (bfControl.GetBfControl (), value, "Wrong BF Control value after decoding");
+
+          Buffer buffer;
+          buffer.AddAtStart (bfControl.GetSerializedSize ());
+          bfControl.Serialize (buffer.Begin ());
+          BF_Control_Field bfControlCopy;
+          bfControlCopy.Deserialize (buffer.Begin ());
+          NS_TEST_ASSERT_MSG_EQ (bfControlCopy.GetBfControl (), value, "Wrong deserialized BF Control field");
+
+          AllocationField field;
+          field.SetAllocationID (value % 16);
+          field.SetBfControl (bfControl);
+          field.SetSourceAid (value & 0xFF);
+          field.SetDestinationAid (value >> 8);
+          field.SetAllocationStart (value * 65537);
+          field.SetAllocationBlockDuration (1 + value % 32767);
+          field.SetNumberOfBlocks (value >> 8);
+          field.SetAllocationBlockPeriod (~value);
+          element.AddAllocationField (field);
+        }
+
+      Buffer buffer;
+      buffer.AddAtStart (element.GetSerializedSize ());
+      element.Serialize (buffer.Begin ());
+      ExtendedScheduleElement elementCopy;
+      Buffer::Iterator end = elementCopy.Deserialize (buffer.Begin ());
+      NS_TEST_ASSERT_MSG_EQ (end.GetDistanceFrom (buffer.Begin ()), element.GetSerializedSize (),
+                             "Wrong size of the deserialized Extended Schedule element");
+
+      AllocationFieldList list = element.GetAllocationFieldList ();
+      AllocationFieldList listCopy = elementCopy.GetAllocationFieldList ();
+      NS_TEST_ASSERT_MSG_EQ (listCopy.size (), list.size (), "Wrong number of deserialized Allocation fields");
+      for (std::size_t i = 0; i < list.size (); i++)
+        {
+          uint32_t value = first + i;
+          NS_TEST_ASSERT_MSG_EQ (listCopy[i].GetBfControl ().GetBfControl (), value,
+                                 "Wrong BF Control field in the Allocation field");
+          NS_TEST_ASSERT_MSG_EQ (+listCopy[i].GetAllocationID (), +list[i].GetAllocationID (), "Wrong Allocation ID");
+          NS_TEST_ASSERT_MSG_EQ (+listCopy[i].GetSourceAid (), +list[i].GetSourceAid (), "Wrong Source AID");
+          NS_TEST_ASSERT_MSG_EQ (+listCopy[i].GetDestinationAid (), +list[i].GetDestinationAid (), "Wrong Destination AID");
+          NS_TEST_ASSERT_MSG_EQ (listCopy[i].GetAllocationStart (), list[i].GetAllocationStart (), "Wrong Allocation Start");
+          NS_TEST_ASSERT_MSG_EQ (listCopy[i].GetAllocationBlockDuration (), list[i].GetAllocationBlockDuration (),
+                                 "Wrong Allocation Block Duration");
+          NS_TEST_ASSERT_MSG_EQ (+listCopy[i].GetNumberOfBlocks (), +list[i].GetNumberOfBlocks (), "Wrong Number of Blocks");
+          NS_TEST_ASSERT_MSG_EQ (listCopy[i].GetAllocationBlockPeriod (), list[i].GetAllocationBlockPeriod (),
+                                 "Wrong Allocation Block Period");
+        }
+    }
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG Information Elements Test Suite
+ */
+class DmgInformationElementsTestSuite : public TestSuite
+{
+public:
+  DmgInformationElementsTestSuite ();
+};
+
+DmgInformationElementsTestSuite::DmgInformationElementsTestSuite ()
+  : TestSuite ("dmg-information-elements", UNIT)
+{
+  AddTestCase (new BfControlRoundTripTest, TestCase::QUICK);
+}
+
+static DmgInformationElementsTestSuite dmgInformationElementsTestSuite; ///< the test suite
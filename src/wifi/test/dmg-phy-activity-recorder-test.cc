@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/dmg-phy-activity-recorder.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgPhyActivityRecorderTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Binary PHY activity recorder
+ *
+ * Records more PHY activities than the buffer of the recorder can hold. In
+ * ring buffer mode, the recorder must hold the most recent activities, from
+ * the oldest to the most recent one. In file mode, the recorder writes the
+ * buffer to the file every time it is full and when it is closed, and
+ * ReadFile must return all the activities in the order they were recorded.
+ */
+class PhyActivityRecorderTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param fileMode Whether the records are written to a file, or kept in a ring buffer.
+   */
+  PhyActivityRecorderTest (bool fileMode);
+  virtual ~PhyActivityRecorderTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Build the expected record of the given PHY activity.
+   * \param index The index of the PHY activity.
+   * \return The record of the PHY activity.
+   */
+  DmgPhyActivityRecorder::Record GetRecord (uint32_t index) const;
+  /**
+   * Record a PHY activity.
+   * \param recorder The recorder.
+   * \param index The index of the PHY activity.
+   */
+  void RecordActivity (Ptr<DmgPhyActivityRecorder> recorder, uint32_t index);
+  /**
+   * Check a record against the expected record of a PHY activity.
+   * \param record The record.
+   * \param index The index of the PHY activity.
+   */
+  void CheckRecord (const DmgPhyActivityRecorder::Record &record, uint32_t index);
+
+  bool m_fileMode;  //!< Whether the records are written to a file.
+};
+
+PhyActivityRecorderTest::PhyActivityRecorderTest (bool fileMode)
+  : TestCase (fileMode ? "Check the PHY activities written to a file and read back"
+                       : "Check the PHY activities kept in the ring buffer"),
+    m_fileMode (fileMode)
+{
+}
+
+PhyActivityRecorderTest::~PhyActivityRecorderTest ()
+{
+}
+
+DmgPhyActivityRecorder::Record
+PhyActivityRecorderTest::GetRecord (uint32_t index) const
+{
+  DmgPhyActivityRecorder::Record record;
+  record.start = MicroSeconds (10 * index).GetNanoSeconds ();
+  record.srcId = index;
+  record.dstId = 0xFFFFFFFF - index;
+  record.duration = NanoSeconds (1000 + index).GetNanoSeconds ();
+  record.power = -60.25 - index;
+  record.fieldType = index % 7;
+  record.activityType = index % 2;
+  return record;
+}
+
+void
+PhyActivityRecorderTest::RecordActivity (Ptr<DmgPhyActivityRecorder> recorder, uint32_t index)
+{
+  DmgPhyActivityRecorder::Record record = GetRecord (index);
+  recorder->RecordActivity (record.srcId, record.dstId, NanoSeconds (record.duration), record.power,
+                            record.fieldType, record.activityType);
+}
+
+void
+PhyActivityRecorderTest::CheckRecord (const DmgPhyActivityRecorder::Record &record, uint32_t index)
+{
+  DmgPhyActivityRecorder::Record expected = GetRecord (index);
+  NS_TEST_EXPECT_MSG_EQ (record.start, expected.start, "Wrong start time of PHY activity " << index);
+  NS_TEST_EXPECT_MSG_EQ (record.srcId, expected.srcId, "Wrong source node of PHY activity " << index);
+  NS_TEST_EXPECT_MSG_EQ (record.dstId, expected.dstId, "Wrong destination node of PHY activity " << index);
+  NS_TEST_EXPECT_MSG_EQ (record.duration, expected.duration, "Wrong duration of PHY activity " << index);
+  NS_TEST_EXPECT_MSG_EQ (record.power, expected.power, "Wrong power of PHY activity " << index);
+  NS_TEST_EXPECT_MSG_EQ (record.fieldType, expected.fieldType, "Wrong field type of PHY activity " << index);
+  NS_TEST_EXPECT_MSG_EQ (record.activityType, expected.activityType, "Wrong activity type of PHY activity " << index);
+}
+
+void
+PhyActivityRecorderTest::DoRun (void)
+{
+  const uint32_t bufferSize = 4;
+  const uint32_t nActivities = 10;
+  std::string fileName = CreateTempDirFilename ("phy-activity.bin");
+
+  Ptr<DmgPhyActivityRecorder> recorder = CreateObject<DmgPhyActivityRecorder> ();
+  recorder->SetAttribute ("BufferSize", UintegerValue (bufferSize));
+  if (m_fileMode)
+    {
+      recorder->Open (fileName);
+    }
+  for (uint32_t i = 0; i < nActivities; i++)
+    {
+      Simulator::Schedule (MicroSeconds (10 * i), &PhyActivityRecorderTest::RecordActivity, this, recorder, i);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (recorder->GetNRecords (), nActivities, "Wrong number of recorded PHY activities");
+  std::vector<DmgPhyActivityRecorder::Record> records = recorder->GetRecords ();
+  if (m_fileMode)
+    {
+      /* Two full buffers have been written to the file */
+      NS_TEST_ASSERT_MSG_EQ (records.size (), nActivities % bufferSize, "Wrong number of buffered PHY activities");
+      for (uint32_t i = 0; i < records.size (); i++)
+        {
+          CheckRecord (records[i], nActivities - records.size () + i);
+        }
+      recorder->Close ();
+      NS_TEST_ASSERT_MSG_EQ (recorder->GetRecords ().size (), 0, "The buffer must be written to the file when closed");
+
+      records.clear ();
+      NS_TEST_ASSERT_MSG_EQ (DmgPhyActivityRecorder::ReadFile (fileName, records), true, "Cannot read the recording");
+      NS_TEST_ASSERT_MSG_EQ (records.size (), nActivities, "Wrong number of PHY activities in the recording");
+      for (uint32_t i = 0; i < records.size (); i++)
+        {
+          CheckRecord (records[i], i);
+        }
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (records.size (), bufferSize, "The ring buffer must hold the most recent PHY activities");
+      for (uint32_t i = 0; i < records.size (); i++)
+        {
+          CheckRecord (records[i], nActivities - bufferSize + i);
+        }
+      recorder->Close ();
+      std::vector<DmgPhyActivityRecorder::Record> fileRecords;
+      NS_TEST_ASSERT_MSG_EQ (DmgPhyActivityRecorder::ReadFile (fileName, fileRecords), false,
+                             "Nothing must be written without a file");
+    }
+
+  /* Any other file is rejected */
+  std::ofstream file (fileName.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  file << "start,srcId,dstId,duration,power,fieldType,activityType\n";
+  file.close ();
+  records.clear ();
+  NS_TEST_ASSERT_MSG_EQ (DmgPhyActivityRecorder::ReadFile (fileName, records), false,
+                         "A file without the magic number must be rejected");
+
+  recorder->Dispose ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief PHY Activity Recorder Test Suite
+ */
+class DmgPhyActivityRecorderTestSuite : public TestSuite
+{
+public:
+  DmgPhyActivityRecorderTestSuite ();
+};
+
+DmgPhyActivityRecorderTestSuite::DmgPhyActivityRecorderTestSuite ()
+  : TestSuite ("dmg-phy-activity-recorder", UNIT)
+{
+  AddTestCase (new PhyActivityRecorderTest (false), TestCase::QUICK);
+  AddTestCase (new PhyActivityRecorderTest (true), TestCase::QUICK);
+}
+
+static DmgPhyActivityRecorderTestSuite dmgPhyActivityRecorderTestSuite; ///< the test suite
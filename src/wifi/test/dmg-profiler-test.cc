@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/dmg-profiler.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgProfilerTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Counters of the DMG profiler
+ *
+ * Scopes timed with NS_DMG_PROFILE_SCOPE run in events of two nodes and out
+ * of any node context, each one busy waiting for a known duration. The
+ * DmgProfiler must count the calls of each probe within the right node, and
+ * account at least the waited time to each of them, including the time of the
+ * nested scopes to the enclosing one. When the simulator is destroyed, the
+ * counters must be written to the DmgProfilerFile, one line per node and
+ * probe called, and reset.
+ */
+class DmgProfilerScopeTest : public TestCase
+{
+public:
+  DmgProfilerScopeTest ();
+  virtual ~DmgProfilerScopeTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Busy wait for the given duration.
+   * \param duration the duration to wait for.
+   */
+  static void Wait (std::chrono::microseconds duration);
+  /**
+   * Time a scope which waits for the duration of a single scope.
+   */
+  void TimeSlsScope (void);
+  /**
+   * Time a scope enclosing two nested scopes, each one waiting for the
+   * duration of a single scope.
+   */
+  void TimeNestedScopes (void);
+  /**
+   * Time a scope of the channel gain, which waits for the duration of a single scope.
+   */
+  void TimeChannelGainScope (void);
+  /**
+   * Time a BRP scope, which waits for the duration of a single scope.
+   */
+  void TimeBrpScope (void);
+
+  static const std::chrono::microseconds SCOPE_DURATION;  //!< The time waited by a single scope.
+};
+
+const std::chrono::microseconds DmgProfilerScopeTest::SCOPE_DURATION = std::chrono::microseconds (500);
+
+DmgProfilerScopeTest::DmgProfilerScopeTest ()
+  : TestCase ("Check the calls and the time recorded by the DMG profiler scopes")
+{
+}
+
+DmgProfilerScopeTest::~DmgProfilerScopeTest ()
+{
+}
+
+void
+DmgProfilerScopeTest::Wait (std::chrono::microseconds duration)
+{
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now () + duration;
+  while (std::chrono::steady_clock::now () < end)
+    {
+    }
+}
+
+void
+DmgProfilerScopeTest::TimeSlsScope (void)
+{
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_MAC_SLS);
+  Wait (SCOPE_DURATION);
+}
+
+void
+DmgProfilerScopeTest::TimeChannelGainScope (void)
+{
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_QD_GET_CHANNEL_GAIN);
+  Wait (SCOPE_DURATION);
+}
+
+void
+DmgProfilerScopeTest::TimeNestedScopes (void)
+{
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_QD_CALC_RX_POWER);
+  TimeChannelGainScope ();
+  TimeChannelGainScope ();
+}
+
+void
+DmgProfilerScopeTest::TimeBrpScope (void)
+{
+  NS_DMG_PROFILE_SCOPE (DMG_PROFILE_MAC_BRP);
+  Wait (SCOPE_DURATION);
+}
+
+void
+DmgProfilerScopeTest::DoRun (void)
+{
+  const int64_t scopeTime = std::chrono::duration_cast<std::chrono::nanoseconds> (SCOPE_DURATION).count ();
+  DmgProfiler *profiler = DmgProfiler::Get ();
+  profiler->Reset ();
+  std::string fileName = CreateTempDirFilename ("dmg-profiler.csv");
+  Config::SetGlobal ("DmgProfilerFile", StringValue (fileName));
+
+  /* Node 0 runs three SLS scopes, node 2 runs two scopes enclosing two nested scopes each */
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Simulator::ScheduleWithContext (0, MicroSeconds (i + 1), &DmgProfilerScopeTest::TimeSlsScope, this);
+    }
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Simulator::ScheduleWithContext (2, MicroSeconds (i + 1), &DmgProfilerScopeTest::TimeNestedScopes, this);
+    }
+  /* A scope out of any event is accounted to the global row */
+  TimeBrpScope ();
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (profiler->GetCalls (0, DMG_PROFILE_MAC_SLS), 3, "Wrong number of SLS scopes of node 0");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (profiler->GetTime (0, DMG_PROFILE_MAC_SLS), 3 * scopeTime,
+                               "The time of the SLS scopes of node 0 must include the waited time");
+  NS_TEST_ASSERT_MSG_EQ (profiler->GetCalls (1, DMG_PROFILE_MAC_SLS), 0, "Node 1 ran no scope");
+  NS_TEST_ASSERT_MSG_EQ (profiler->GetCalls (2, DMG_PROFILE_MAC_SLS), 0, "Node 2 ran no SLS scope");
+
+  NS_TEST_ASSERT_MSG_EQ (profiler->GetCalls (2, DMG_PROFILE_QD_CALC_RX_POWER), 2, "Wrong number of enclosing scopes of node 2");
+  NS_TEST_ASSERT_MSG_EQ (profiler->GetCalls (2, DMG_PROFILE_QD_GET_CHANNEL_GAIN), 4, "Wrong number of nested scopes of node 2");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (profiler->GetTime (2, DMG_PROFILE_QD_GET_CHANNEL_GAIN), 4 * scopeTime,
+                               "The time of the nested scopes of node 2 must include the waited time");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (profiler->GetTime (2, DMG_PROFILE_QD_CALC_RX_POWER),
+                               profiler->GetTime (2, DMG_PROFILE_QD_GET_CHANNEL_GAIN),
+                               "The time of the enclosing scopes must include the time of the nested scopes");
+
+  NS_TEST_ASSERT_MSG_EQ (profiler->GetCalls (Simulator::NO_CONTEXT, DMG_PROFILE_MAC_BRP), 1,
+                         "The scope out of any event must be accounted to the global row");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (profiler->GetTime (Simulator::NO_CONTEXT, DMG_PROFILE_MAC_BRP), scopeTime,
+                               "The time of the global scope must include the waited time");
+  NS_TEST_ASSERT_MSG_EQ (profiler->GetCalls (0, DMG_PROFILE_MAC_BRP), 0, "The global scope must not be accounted to node 0");
+
+  Simulator::Destroy ();
+  Config::SetGlobal ("DmgProfilerFile", StringValue (""));
+
+  NS_TEST_ASSERT_MSG_EQ (profiler->GetCalls (0, DMG_PROFILE_MAC_SLS), 0, "The counters must be reset once reported");
+  std::ifstream file (fileName.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (file.is_open (), true, "Cannot open " << fileName);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      lines.push_back (line);
+    }
+  NS_TEST_ASSERT_MSG_EQ (lines.size (), 5, "The report must hold a header and one line per node and probe called");
+  NS_TEST_EXPECT_MSG_EQ (lines[1].find ("global,MacBrp,1,"), 0, "Wrong report of the global scope");
+  NS_TEST_EXPECT_MSG_EQ (lines[2].find ("0,MacSls,3,"), 0, "Wrong report of the SLS scopes of node 0");
+  NS_TEST_EXPECT_MSG_EQ (lines[3].find ("2,QdCalcRxPower,2,"), 0, "Wrong report of the enclosing scopes of node 2");
+  NS_TEST_EXPECT_MSG_EQ (lines[4].find ("2,QdGetChannelGain,4,"), 0, "Wrong report of the nested scopes of node 2");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG Profiler Test Suite
+ */
+class DmgProfilerTestSuite : public TestSuite
+{
+public:
+  DmgProfilerTestSuite ();
+};
+
+DmgProfilerTestSuite::DmgProfilerTestSuite ()
+  : TestSuite ("dmg-profiler", UNIT)
+{
+  AddTestCase (new DmgProfilerScopeTest, TestCase::QUICK);
+}
+
+static DmgProfilerTestSuite dmgProfilerTestSuite; ///< the test suite
@@ -0,0 +1,861 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/dmg-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/codebook-parametric-helper.h"
+#include "ns3/qd-propagation-engine.h"
+#include "ns3/qd-propagation-loss.h"
+#include "ns3/qd-propagation-delay.h"
+#include "ns3/spectrum-dmg-wifi-phy.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/ssid.h"
+#include "ns3/ctrl-headers.h"
+#include "ns3/dmg-wifi-mac.h"
+#include "ns3/dmg-sta-wifi-mac.h"
+#include "ns3/dmg-ap-wifi-mac.h"
+#include "ns3/codebook-parametric.h"
+#include "ns3/system-path.h"
+#include "ns3/wifi-spectrum-value-helper.h"
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgQdChannelTest");
+
+/**
+ * Write a parametric codebook of a single uniform linear array, whose sectors
+ * steer the main lobe towards evenly spaced azimuth angles.
+ * \param filename The name of the codebook file.
+ * \param elements The number of antenna elements.
+ * \param sectors The number of sectors.
+ */
+static void
+WriteLinearArrayCodebook (std::string filename, uint16_t elements, uint8_t sectors)
+{
+  std::ofstream file (filename.c_str ());
+  /* One RF chain connected to one phased antenna array */
+  file << "1\n1\n";
+  /* Antenna ID, RF chain ID, orientation, elements and quantization bits */
+  file << "1\n1\n0\n0\n" << elements << "\n2\n0\n";
+  /* Isotropic antenna elements */
+  for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
+    {
+      for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
+        {
+          file << (n == 0 ? "" : ",") << "1";
+        }
+      file << "\n";
+    }
+  /* Half-wavelength spacing along the y axis */
+  for (uint16_t l = 0; l < elements; l++)
+    {
+      for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
+        {
+          for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
+            {
+              double elevation = (n - 90.0) * M_PI / 180;
+              double phase = M_PI * l * std::sin (m * M_PI / 180) * std::cos (elevation);
+              file << (n == 0 ? "" : ",") << "1," << phase;
+            }
+          file << "\n";
+        }
+    }
+  /* Quasi-omni weights: a single element */
+  for (uint16_t l = 0; l < elements; l++)
+    {
+      file << (l == 0 ? "" : ",") << (l == 0 ? 1 : 0) << ",0";
+    }
+  file << "\n" << uint16_t (sectors) << "\n";
+  for (uint8_t sector = 0; sector < sectors; sector++)
+    {
+      double azimuth = 2 * M_PI * sector / sectors;
+      file << sector + 1 << "\n" << TX_RX_SECTOR << "\n" << BHI_SLS_SECTOR << "\n";
+      for (uint16_t l = 0; l < elements; l++)
+        {
+          file << (l == 0 ? "" : ",") << "1," << -M_PI * l * std::sin (azimuth);
+        }
+      file << "\n";
+    }
+  file.close ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Received powers of a static Q-D channel with parallel channel gains
+ *
+ * Runs the same static Q-D scenario, a DMG AP and three DMG STAs doing beacon
+ * transmission and beamforming training, once with the channel gains calculated
+ * when the signal reaches each receiver and once with the channel gains of all
+ * the receivers of a transmission calculated by a pool of threads. The two runs
+ * must see the same received powers.
+ */
+class QdParallelRxPowerTest : public TestCase
+{
+public:
+  QdParallelRxPowerTest ();
+  virtual ~QdParallelRxPowerTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /// A signal arrival: time, receiver, sender and received power in dBm
+  typedef std::tuple<int64_t, uint32_t, uint32_t, double> SignalArrival;
+
+  /**
+   * Run the scenario.
+   * \param rxPowerThreads The value of the RxPowerThreads attribute of the Q-D engine.
+   * \return The signals received by all the nodes, in the order of their arrival.
+   */
+  std::vector<SignalArrival> RunScenario (uint32_t rxPowerThreads);
+  /**
+   * Record a signal arrival.
+   * \param context The node ID of the receiver.
+   * \param signalType Whether the signal is a WiFi signal.
+   * \param senderNodeId The node ID of the sender.
+   * \param rxPower The received power in dBm.
+   * \param duration The duration of the signal.
+   */
+  void SignalArrived (std::string context, bool signalType, uint32_t senderNodeId, double rxPower, Time duration);
+  /**
+   * Assign fixed streams to the A-BFT variables of the DMG STAs, which are
+   * created when the DMG STAs are initialized.
+   * \param devices The devices of the DMG STAs.
+   * \param stream The first stream index to use.
+   */
+  void AssignAbftStreams (NetDeviceContainer devices, int64_t stream);
+
+  std::string m_codebookFile;                 //!< The codebook of all the devices.
+  std::vector<SignalArrival> m_arrivals;      //!< The signals received in the current run.
+};
+
+QdParallelRxPowerTest::QdParallelRxPowerTest ()
+  : TestCase ("Check that the parallel channel gains of a static Q-D channel do not change the received powers")
+{
+}
+
+QdParallelRxPowerTest::~QdParallelRxPowerTest ()
+{
+}
+
+void
+QdParallelRxPowerTest::SignalArrived (std::string context, bool signalType, uint32_t senderNodeId,
+                                      double rxPower, Time duration)
+{
+  m_arrivals.push_back (std::make_tuple (Simulator::Now ().GetTimeStep (), std::stoul (context), senderNodeId, rxPower));
+}
+
+void
+QdParallelRxPowerTest::AssignAbftStreams (NetDeviceContainer devices, int64_t stream)
+{
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Ptr<DmgStaWifiMac> mac = StaticCast<DmgStaWifiMac> (StaticCast<WifiNetDevice> (devices.Get (i))->GetMac ());
+      mac->m_abftSlot->SetStream (stream++);
+      mac->m_rssBackoffVariable->SetStream (stream++);
+    }
+}
+
+std::vector<QdParallelRxPowerTest::SignalArrival>
+QdParallelRxPowerTest::RunScenario (uint32_t rxPowerThreads)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  m_arrivals.clear ();
+
+  Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
+  Ptr<QdPropagationEngine> qdPropagationEngine = CreateObject<QdPropagationEngine> ();
+  qdPropagationEngine->SetAttribute ("QDModelFolder", StringValue ("DmgFiles/QdChannel/DenseScenario/"));
+  qdPropagationEngine->SetAttribute ("RxPowerThreads", UintegerValue (rxPowerThreads));
+  Ptr<QdPropagationLossModel> lossModelRaytracing = CreateObject<QdPropagationLossModel> (qdPropagationEngine);
+  Ptr<QdPropagationDelayModel> propagationDelayRayTracing = CreateObject<QdPropagationDelayModel> (qdPropagationEngine);
+  spectrumChannel->AddSpectrumPropagationLossModel (lossModelRaytracing);
+  spectrumChannel->SetPropagationDelayModel (propagationDelayRayTracing);
+
+  SpectrumDmgWifiPhyHelper spectrumWifiPhy = SpectrumDmgWifiPhyHelper::Default ();
+  spectrumWifiPhy.SetChannel (spectrumChannel);
+  spectrumWifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
+  spectrumWifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
+  spectrumWifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  spectrumWifiPhy.Set ("ChannelNumber", UintegerValue (2));
+
+  /* The node IDs index the Q-D traces, the AP is node 0 */
+  NodeContainer apWifiNode;
+  apWifiNode.Create (1);
+  NodeContainer staWifiNodes;
+  staWifiNodes.Create (3);
+
+  DmgWifiHelper wifi;
+  DmgWifiMacHelper wifiMacHelper = DmgWifiMacHelper::Default ();
+  Ssid ssid = Ssid ("DenseScenario");
+  wifiMacHelper.SetType ("ns3::DmgApWifiMac",
+                         "Ssid", SsidValue (ssid),
+                         "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                         "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                         "ATIPresent", BooleanValue (false));
+  NetDeviceContainer apDevice = wifi.Install (spectrumWifiPhy, wifiMacHelper, apWifiNode, false);
+  wifiMacHelper.SetType ("ns3::DmgStaWifiMac",
+                         "Ssid", SsidValue (ssid), "ActiveProbing", BooleanValue (false));
+  NetDeviceContainer staDevices = wifi.Install (spectrumWifiPhy, wifiMacHelper, staWifiNodes, false);
+
+  CodebookParametricHelper codebookHelper;
+  codebookHelper.SetCodebookParameters ("FileName", StringValue (m_codebookFile));
+  codebookHelper.Install (apDevice);
+  codebookHelper.Install (staDevices);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apWifiNode);
+  mobility.Install (staWifiNodes);
+
+  NetDeviceContainer devices (apDevice, staDevices);
+  /* The stream numbers are not reset between the runs of the test */
+  int64_t stream = 100 + wifi.AssignStreams (devices, 100);
+  /* Scheduled after the initialization of the nodes */
+  Simulator::Schedule (Seconds (0), &QdParallelRxPowerTest::AssignAbftStreams, this, staDevices, stream);
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Ptr<WifiNetDevice> device = StaticCast<WifiNetDevice> (devices.Get (i));
+      device->GetPhy ()->TraceConnect ("SignalArrival", std::to_string (device->GetNode ()->GetId ()),
+                                       MakeCallback (&QdParallelRxPowerTest::SignalArrived, this));
+    }
+
+  Simulator::Stop (MilliSeconds (250));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_arrivals;
+}
+
+void
+QdParallelRxPowerTest::DoRun (void)
+{
+  m_codebookFile = CreateTempDirFilename ("qd-parallel-rx-power-codebook.txt");
+  WriteLinearArrayCodebook (m_codebookFile, 4, 8);
+
+  std::vector<SignalArrival> sequential = RunScenario (0);
+  std::vector<SignalArrival> parallel = RunScenario (4);
+
+  NS_TEST_ASSERT_MSG_GT (sequential.size (), 0, "No signal has been received");
+  NS_TEST_ASSERT_MSG_EQ (parallel.size (), sequential.size (), "The number of received signals differs");
+  for (uint32_t i = 0; i < sequential.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (std::get<0> (parallel[i]), std::get<0> (sequential[i]), "Different arrival time of signal " << i);
+      NS_TEST_ASSERT_MSG_EQ (std::get<1> (parallel[i]), std::get<1> (sequential[i]), "Different receiver of signal " << i);
+      NS_TEST_ASSERT_MSG_EQ (std::get<2> (parallel[i]), std::get<2> (sequential[i]), "Different sender of signal " << i);
+      /* The same operations in the same order, so the powers are identical */
+      NS_TEST_ASSERT_MSG_EQ (std::get<3> (parallel[i]), std::get<3> (sequential[i]), "Different power of signal " << i);
+    }
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Beamforming cache of a Q-D channel
+ *
+ * A DMG STA with the beamforming cache enabled repeats a TXSS with its DMG
+ * PCP/AP in a CBAP over a Q-D channel of two identical traces. A TXSS that
+ * follows a completed TXSS in the same trace, with the same codebook, must only
+ * sweep the neighborhood of the cached sector. A change of the codebook or of
+ * the trace index must bring back a full sweep.
+ */
+class QdBeamformingCacheTest : public TestCase
+{
+public:
+  QdBeamformingCacheTest ();
+  virtual ~QdBeamformingCacheTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record an SSW frame transmitted by the DMG STA as initiator of a TXSS.
+   * \param packet The transmitted packet.
+   * \param txPowerW The transmit power in Watts.
+   */
+  void PhyTxBegin (Ptr<const Packet> packet, double txPowerW);
+  /**
+   * Change the weights of the first sector of a codebook to their current values.
+   * \param codebook The codebook.
+   */
+  void UpdateCodebook (Ptr<CodebookParametric> codebook);
+
+  std::vector<uint16_t> m_sweeps;     //!< Number of sectors of each TXSS of the DMG STA.
+  uint16_t m_sectors;                 //!< Number of sectors swept so far in the current TXSS.
+};
+
+QdBeamformingCacheTest::QdBeamformingCacheTest ()
+  : TestCase ("Check that the beamforming cache narrows a repeated TXSS until the codebook or the trace changes"),
+    m_sectors (0)
+{
+}
+
+QdBeamformingCacheTest::~QdBeamformingCacheTest ()
+{
+}
+
+void
+QdBeamformingCacheTest::PhyTxBegin (Ptr<const Packet> packet, double txPowerW)
+{
+  WifiMacHeader hdr;
+  Ptr<Packet> copy = packet->Copy ();
+  copy->RemoveHeader (hdr);
+  if (!hdr.IsSSW ())
+    {
+      return;
+    }
+  CtrlDMG_SSW sswFrame;
+  copy->RemoveHeader (sswFrame);
+  DMG_SSW_Field ssw = sswFrame.GetSswField ();
+  if (ssw.GetDirection () == BeamformingInitiator)
+    {
+      m_sectors++;
+      if (ssw.GetCountDown () == 0)
+        {
+          m_sweeps.push_back (m_sectors);
+          m_sectors = 0;
+        }
+    }
+}
+
+void
+QdBeamformingCacheTest::UpdateCodebook (Ptr<CodebookParametric> codebook)
+{
+  /* The first sector of the linear array steers towards 0 degrees, where all the weights are equal */
+  WeightsVector weights (4, Complex (0.5, 0));
+  codebook->UpdateSectorWeights (1, 1, weights);
+}
+
+void
+QdBeamformingCacheTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  /* Two identical traces of the link between the first two nodes of the dense scenario */
+  std::string folder = CreateTempDirFilename ("qd-beamforming-cache/");
+  SystemPath::MakeDirectories (folder + "QdFiles");
+  for (std::string link : {"Tx0Rx1", "Tx1Rx0"})
+    {
+      std::ifstream source ("DmgFiles/QdChannel/DenseScenario/QdFiles/" + link + ".txt");
+      std::stringstream trace;
+      trace << source.rdbuf ();
+      std::ofstream file (folder + "QdFiles/" + link + ".txt");
+      file << trace.str () << trace.str ();
+    }
+  std::string codebookFile = CreateTempDirFilename ("qd-beamforming-cache-codebook.txt");
+  WriteLinearArrayCodebook (codebookFile, 4, 8);
+
+  Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
+  Ptr<QdPropagationEngine> qdPropagationEngine = CreateObject<QdPropagationEngine> ();
+  qdPropagationEngine->SetAttribute ("QDModelFolder", StringValue (folder));
+  qdPropagationEngine->SetAttribute ("Interval", TimeValue (MilliSeconds (300)));
+  Ptr<QdPropagationLossModel> lossModelRaytracing = CreateObject<QdPropagationLossModel> (qdPropagationEngine);
+  Ptr<QdPropagationDelayModel> propagationDelayRayTracing = CreateObject<QdPropagationDelayModel> (qdPropagationEngine);
+  spectrumChannel->AddSpectrumPropagationLossModel (lossModelRaytracing);
+  spectrumChannel->SetPropagationDelayModel (propagationDelayRayTracing);
+
+  SpectrumDmgWifiPhyHelper spectrumWifiPhy = SpectrumDmgWifiPhyHelper::Default ();
+  spectrumWifiPhy.SetChannel (spectrumChannel);
+  spectrumWifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
+  spectrumWifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
+  spectrumWifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  spectrumWifiPhy.Set ("ChannelNumber", UintegerValue (2));
+
+  NodeContainer apWifiNode;
+  apWifiNode.Create (1);
+  NodeContainer staWifiNode;
+  staWifiNode.Create (1);
+
+  DmgWifiHelper wifi;
+  DmgWifiMacHelper wifiMacHelper = DmgWifiMacHelper::Default ();
+  Ssid ssid = Ssid ("BeamformingCache");
+  wifiMacHelper.SetType ("ns3::DmgApWifiMac",
+                         "Ssid", SsidValue (ssid),
+                         "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                         "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                         "ATIPresent", BooleanValue (false));
+  NetDeviceContainer apDevice = wifi.Install (spectrumWifiPhy, wifiMacHelper, apWifiNode, false);
+  wifiMacHelper.SetType ("ns3::DmgStaWifiMac",
+                         "Ssid", SsidValue (ssid), "ActiveProbing", BooleanValue (false),
+                         "BeamformingCache", BooleanValue (true),
+                         "BeamformingCacheSectors", UintegerValue (1));
+  NetDeviceContainer staDevice = wifi.Install (spectrumWifiPhy, wifiMacHelper, staWifiNode, false);
+
+  CodebookParametricHelper codebookHelper;
+  codebookHelper.SetCodebookParameters ("FileName", StringValue (codebookFile));
+  codebookHelper.Install (apDevice);
+  codebookHelper.Install (staDevice);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apWifiNode);
+  mobility.Install (staWifiNode);
+
+  wifi.AssignStreams (NetDeviceContainer (apDevice, staDevice), 100);
+
+  Ptr<WifiNetDevice> staNetDevice = StaticCast<WifiNetDevice> (staDevice.Get (0));
+  Ptr<DmgWifiMac> apMac = StaticCast<DmgWifiMac> (StaticCast<WifiNetDevice> (apDevice.Get (0))->GetMac ());
+  Ptr<DmgWifiMac> staMac = StaticCast<DmgWifiMac> (staNetDevice->GetMac ());
+  staNetDevice->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&QdBeamformingCacheTest::PhyTxBegin, this));
+
+  /* The TXSS are started in the DTI of the beacon intervals, away from their BHI */
+  Mac48Address apAddress = apMac->GetAddress ();
+  Simulator::Schedule (MilliSeconds (150), &DmgWifiMac::Perform_TXSS_TXOP, staMac, apAddress);
+  Simulator::Schedule (MilliSeconds (170), &DmgWifiMac::Perform_TXSS_TXOP, staMac, apAddress);
+  Simulator::Schedule (MilliSeconds (190), &QdBeamformingCacheTest::UpdateCodebook, this,
+                       DynamicCast<CodebookParametric> (staMac->GetCodebook ()));
+  Simulator::Schedule (MilliSeconds (200), &DmgWifiMac::Perform_TXSS_TXOP, staMac, apAddress);
+  Simulator::Schedule (MilliSeconds (230), &DmgWifiMac::Perform_TXSS_TXOP, staMac, apAddress);
+  /* The second trace starts at 300 ms, and the DMG Beacons at 307.2 ms move the engine to it */
+  Simulator::Schedule (MilliSeconds (350), &DmgWifiMac::Perform_TXSS_TXOP, staMac, apAddress);
+  Simulator::Stop (MilliSeconds (400));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_sweeps.size (), 5, "Wrong number of TXSS");
+  NS_TEST_ASSERT_MSG_EQ (m_sweeps[0], 8, "The first TXSS must sweep all the sectors");
+  NS_TEST_ASSERT_MSG_EQ (m_sweeps[1], 3, "A cache hit must limit the TXSS to the cached sector and its two neighbors");
+  NS_TEST_ASSERT_MSG_EQ (m_sweeps[2], 8, "A codebook change must invalidate the cache");
+  NS_TEST_ASSERT_MSG_EQ (m_sweeps[3], 3, "The full TXSS must refill the cache");
+  NS_TEST_ASSERT_MSG_EQ (m_sweeps[4], 8, "A trace index change must invalidate the cache");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Fast sector sweep over a Q-D channel
+ *
+ * A DMG PCP/AP allocates a beamforming service period with a DMG STA once the
+ * DMG STA is associated, in which both of them do a TXSS. The scenario runs
+ * once with regular TXSS and once with fast TXSS, where the SNR of all the
+ * sectors but the last one is evaluated through the Q-D propagation engine. The
+ * fast TXSS must transmit fewer SSW frames, and both stations must select the
+ * same sectors as with regular TXSS.
+ */
+class QdFastSectorSweepTest : public TestCase
+{
+public:
+  QdFastSectorSweepTest ();
+  virtual ~QdFastSectorSweepTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /// The antenna and the sector selected by each station, indexed by the name of the station
+  typedef std::map<std::string, std::pair<AntennaID, SectorID> > SelectedSectors;
+
+  /**
+   * Run the scenario.
+   * \param fastSectorSweep Whether the TXSS in a service period is a fast TXSS.
+   */
+  void RunScenario (bool fastSectorSweep);
+  /**
+   * Allocate the beamforming service period once the DMG STA is associated.
+   * \param address The address of the DMG PCP/AP.
+   * \param aid The AID of the DMG STA.
+   */
+  void StationAssociated (Mac48Address address, uint16_t aid);
+  /**
+   * Record the sector selected by a station at the end of an SLS.
+   * \param context The name of the station.
+   * \param attributes The attributes of the completed SLS.
+   */
+  void SlsCompleted (std::string context, SlsCompletionAttrbitutes attributes);
+  /**
+   * Count the SSW frames transmitted in the service period.
+   * \param packet The transmitted packet.
+   * \param txPowerW The transmit power in Watts.
+   */
+  void PhyTxBegin (Ptr<const Packet> packet, double txPowerW);
+
+  std::string m_codebookFile;           //!< The codebook of all the devices.
+  Ptr<DmgApWifiMac> m_apMac;            //!< The MAC of the DMG PCP/AP.
+  Ptr<DmgStaWifiMac> m_staMac;          //!< The MAC of the DMG STA.
+  SelectedSectors m_sectors;            //!< The sectors selected in the service period of the current run.
+  uint32_t m_sswFrames;                 //!< Number of SSW frames transmitted in the current run.
+};
+
+QdFastSectorSweepTest::QdFastSectorSweepTest ()
+  : TestCase ("Check that a fast TXSS selects the same sectors as a regular TXSS"),
+    m_sswFrames (0)
+{
+}
+
+QdFastSectorSweepTest::~QdFastSectorSweepTest ()
+{
+}
+
+void
+QdFastSectorSweepTest::StationAssociated (Mac48Address address, uint16_t aid)
+{
+  m_apMac->StorePeerDmgCapabilities (m_staMac);
+  m_staMac->StorePeerDmgCapabilities (m_apMac);
+  m_apMac->AllocateBeamformingServicePeriod (AID_AP, aid, 0, true);
+}
+
+void
+QdFastSectorSweepTest::SlsCompleted (std::string context, SlsCompletionAttrbitutes attributes)
+{
+  if (attributes.accessPeriod == CHANNEL_ACCESS_DTI)
+    {
+      m_sectors[context] = std::make_pair (attributes.antennaID, attributes.sectorID);
+    }
+}
+
+void
+QdFastSectorSweepTest::PhyTxBegin (Ptr<const Packet> packet, double txPowerW)
+{
+  WifiMacHeader hdr;
+  packet->PeekHeader (hdr);
+  if (hdr.IsSSW ())
+    {
+      m_sswFrames++;
+    }
+}
+
+void
+QdFastSectorSweepTest::RunScenario (bool fastSectorSweep)
+{
+  m_sectors.clear ();
+  m_sswFrames = 0;
+
+  Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
+  Ptr<QdPropagationEngine> qdPropagationEngine = CreateObject<QdPropagationEngine> ();
+  qdPropagationEngine->SetAttribute ("QDModelFolder", StringValue ("DmgFiles/QdChannel/DenseScenario/"));
+  Ptr<QdPropagationLossModel> lossModelRaytracing = CreateObject<QdPropagationLossModel> (qdPropagationEngine);
+  Ptr<QdPropagationDelayModel> propagationDelayRayTracing = CreateObject<QdPropagationDelayModel> (qdPropagationEngine);
+  spectrumChannel->AddSpectrumPropagationLossModel (lossModelRaytracing);
+  spectrumChannel->SetPropagationDelayModel (propagationDelayRayTracing);
+
+  SpectrumDmgWifiPhyHelper spectrumWifiPhy = SpectrumDmgWifiPhyHelper::Default ();
+  spectrumWifiPhy.SetChannel (spectrumChannel);
+  spectrumWifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
+  spectrumWifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
+  spectrumWifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  spectrumWifiPhy.Set ("ChannelNumber", UintegerValue (2));
+
+  NodeContainer apWifiNode;
+  apWifiNode.Create (1);
+  NodeContainer staWifiNode;
+  staWifiNode.Create (1);
+
+  DmgWifiHelper wifi;
+  DmgWifiMacHelper wifiMacHelper = DmgWifiMacHelper::Default ();
+  Ssid ssid = Ssid ("FastSectorSweep");
+  wifiMacHelper.SetType ("ns3::DmgApWifiMac",
+                         "Ssid", SsidValue (ssid),
+                         "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                         "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                         "ATIPresent", BooleanValue (false),
+                         "FastSectorSweep", BooleanValue (fastSectorSweep));
+  NetDeviceContainer apDevice = wifi.Install (spectrumWifiPhy, wifiMacHelper, apWifiNode, false);
+  wifiMacHelper.SetType ("ns3::DmgStaWifiMac",
+                         "Ssid", SsidValue (ssid), "ActiveProbing", BooleanValue (false),
+                         "FastSectorSweep", BooleanValue (fastSectorSweep));
+  NetDeviceContainer staDevice = wifi.Install (spectrumWifiPhy, wifiMacHelper, staWifiNode, false);
+
+  CodebookParametricHelper codebookHelper;
+  codebookHelper.SetCodebookParameters ("FileName", StringValue (m_codebookFile));
+  codebookHelper.Install (apDevice);
+  codebookHelper.Install (staDevice);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apWifiNode);
+  mobility.Install (staWifiNode);
+
+  NetDeviceContainer devices (apDevice, staDevice);
+  wifi.AssignStreams (devices, 100);
+  m_apMac = StaticCast<DmgApWifiMac> (StaticCast<WifiNetDevice> (apDevice.Get (0))->GetMac ());
+  m_staMac = StaticCast<DmgStaWifiMac> (StaticCast<WifiNetDevice> (staDevice.Get (0))->GetMac ());
+  m_staMac->TraceConnectWithoutContext ("Assoc", MakeCallback (&QdFastSectorSweepTest::StationAssociated, this));
+  m_apMac->TraceConnect ("SLSCompleted", "DMG PCP/AP", MakeCallback (&QdFastSectorSweepTest::SlsCompleted, this));
+  m_staMac->TraceConnect ("SLSCompleted", "DMG STA", MakeCallback (&QdFastSectorSweepTest::SlsCompleted, this));
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      StaticCast<WifiNetDevice> (devices.Get (i))->GetPhy ()->TraceConnectWithoutContext (
+        "PhyTxBegin", MakeCallback (&QdFastSectorSweepTest::PhyTxBegin, this));
+    }
+
+  Simulator::Stop (MilliSeconds (500));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_apMac = 0;
+  m_staMac = 0;
+}
+
+void
+QdFastSectorSweepTest::DoRun (void)
+{
+  m_codebookFile = CreateTempDirFilename ("qd-fast-sector-sweep-codebook.txt");
+  WriteLinearArrayCodebook (m_codebookFile, 4, 8);
+
+  RunScenario (false);
+  SelectedSectors regularSectors = m_sectors;
+  uint32_t regularSswFrames = m_sswFrames;
+  RunScenario (true);
+
+  NS_TEST_ASSERT_MSG_EQ (regularSectors.size (), 2, "Both stations must complete the SLS of the service period");
+  NS_TEST_ASSERT_MSG_LT (m_sswFrames, regularSswFrames, "The fast TXSS must transmit fewer SSW frames");
+  NS_TEST_ASSERT_MSG_EQ (m_sectors.size (), regularSectors.size (), "Both stations must complete the fast SLS");
+  for (SelectedSectors::const_iterator it = regularSectors.begin (); it != regularSectors.end (); it++)
+    {
+      SelectedSectors::const_iterator fastIt = m_sectors.find (it->first);
+      NS_TEST_ASSERT_MSG_EQ ((fastIt != m_sectors.end ()), true, "No fast SLS completed by " << it->first);
+      NS_TEST_EXPECT_MSG_EQ (+fastIt->second.first, +it->second.first, "Different antenna selected by " << it->first);
+      NS_TEST_EXPECT_MSG_EQ (+fastIt->second.second, +it->second.second, "Different sector selected by " << it->first);
+    }
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Precomputed Q-D tables
+ *
+ * Builds the same network of three nodes of the dense scenario twice, each
+ * one with its own Q-D propagation engine. The first engine loads the Q-D
+ * traces and calculates the array patterns of all the pairs of nodes through
+ * QdPropagationEngine::Precompute, the second one loads them lazily on the
+ * first contact between two nodes. For every pair of nodes, both engines must
+ * return the same propagation delay, the same received power for every
+ * transmit sector towards a receiver in quasi-omni mode, and the same channel
+ * gain for every pair of transmit and receive sectors.
+ */
+class QdPrecomputeTest : public TestCase
+{
+public:
+  QdPrecomputeTest ();
+  virtual ~QdPrecomputeTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create the network of a Q-D propagation engine.
+   * \param engine The Q-D propagation engine.
+   * \param codebookFile The codebook of all the devices.
+   * \return The nodes of the network.
+   */
+  NodeContainer CreateNetwork (Ptr<QdPropagationEngine> engine, std::string codebookFile);
+  /**
+   * Check that two power spectral densities are identical.
+   * \param precomputed The power spectral density given by the engine with precomputed tables.
+   * \param lazy The power spectral density given by the engine with lazy evaluation.
+   * \param what The description of the power spectral density.
+   */
+  void CheckPsd (Ptr<const SpectrumValue> precomputed, Ptr<const SpectrumValue> lazy, std::string what);
+};
+
+QdPrecomputeTest::QdPrecomputeTest ()
+  : TestCase ("Check that the precomputed Q-D tables give the same channel as lazy evaluation")
+{
+}
+
+QdPrecomputeTest::~QdPrecomputeTest ()
+{
+}
+
+NodeContainer
+QdPrecomputeTest::CreateNetwork (Ptr<QdPropagationEngine> engine, std::string codebookFile)
+{
+  Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
+  engine->SetAttribute ("QDModelFolder", StringValue ("DmgFiles/QdChannel/DenseScenario/"));
+  engine->SetAttribute ("UseCustomIDs", BooleanValue (true));
+  engine->SetAttribute ("PrecomputeThreads", UintegerValue (2));
+  Ptr<QdPropagationLossModel> lossModelRaytracing = CreateObject<QdPropagationLossModel> (engine);
+  Ptr<QdPropagationDelayModel> propagationDelayRayTracing = CreateObject<QdPropagationDelayModel> (engine);
+  spectrumChannel->AddSpectrumPropagationLossModel (lossModelRaytracing);
+  spectrumChannel->SetPropagationDelayModel (propagationDelayRayTracing);
+
+  SpectrumDmgWifiPhyHelper spectrumWifiPhy = SpectrumDmgWifiPhyHelper::Default ();
+  spectrumWifiPhy.SetChannel (spectrumChannel);
+  spectrumWifiPhy.Set ("ChannelNumber", UintegerValue (2));
+
+  /* Both networks use the first three nodes of the Q-D files, whatever their ns-3 IDs */
+  NodeContainer nodes;
+  nodes.Create (3);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      engine->AddCustomID (nodes.Get (i)->GetId (), i);
+    }
+
+  DmgWifiHelper wifi;
+  DmgWifiMacHelper wifiMacHelper = DmgWifiMacHelper::Default ();
+  wifiMacHelper.SetType ("ns3::DmgAdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (spectrumWifiPhy, wifiMacHelper, nodes, false);
+
+  CodebookParametricHelper codebookHelper;
+  codebookHelper.SetCodebookParameters ("FileName", StringValue (codebookFile));
+  codebookHelper.Install (devices);
+  /* The codebooks are initialized when the simulation starts, activate their first antenna array now */
+  for (NetDeviceContainer::Iterator it = devices.Begin (); it != devices.End (); it++)
+    {
+      StaticCast<SpectrumDmgWifiPhy> (StaticCast<WifiNetDevice> (*it)->GetPhy ())->GetCodebook ()->Initialize ();
+    }
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  return nodes;
+}
+
+void
+QdPrecomputeTest::CheckPsd (Ptr<const SpectrumValue> precomputed, Ptr<const SpectrumValue> lazy, std::string what)
+{
+  NS_TEST_ASSERT_MSG_EQ (precomputed->GetValuesN (), lazy->GetValuesN (), "Wrong number of bands of the " << what);
+  for (size_t i = 0; i < precomputed->GetValuesN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((*precomputed)[i], (*lazy)[i], "Wrong band " << i << " of the " << what);
+    }
+}
+
+void
+QdPrecomputeTest::DoRun (void)
+{
+  std::string codebookFile = CreateTempDirFilename ("qd-precompute-codebook.txt");
+  WriteLinearArrayCodebook (codebookFile, 4, 8);
+
+  Ptr<QdPropagationEngine> precomputedEngine = CreateObject<QdPropagationEngine> ();
+  NodeContainer precomputedNodes = CreateNetwork (precomputedEngine, codebookFile);
+  precomputedEngine->Precompute (precomputedNodes);
+  Ptr<QdPropagationEngine> lazyEngine = CreateObject<QdPropagationEngine> ();
+  NodeContainer lazyNodes = CreateNetwork (lazyEngine, codebookFile);
+
+  Ptr<SpectrumValue> txPsd = WifiSpectrumValueHelper::CreateWigigSingleCarrierTxPowerSpectralDensity (60480, 2160, 0.01, 0);
+  for (uint32_t tx = 0; tx < 3; tx++)
+    {
+      for (uint32_t rx = 0; rx < 3; rx++)
+        {
+          if (tx == rx)
+            {
+              continue;
+            }
+          Ptr<MobilityModel> precomputedTxMobility = precomputedNodes.Get (tx)->GetObject<MobilityModel> ();
+          Ptr<MobilityModel> precomputedRxMobility = precomputedNodes.Get (rx)->GetObject<MobilityModel> ();
+          Ptr<MobilityModel> lazyTxMobility = lazyNodes.Get (tx)->GetObject<MobilityModel> ();
+          Ptr<MobilityModel> lazyRxMobility = lazyNodes.Get (rx)->GetObject<MobilityModel> ();
+          Ptr<CodebookParametric> precomputedTxCodebook = DynamicCast<CodebookParametric> (
+            StaticCast<SpectrumDmgWifiPhy> (StaticCast<WifiNetDevice> (precomputedNodes.Get (tx)->GetDevice (0))->GetPhy ())->GetCodebook ());
+          Ptr<CodebookParametric> precomputedRxCodebook = DynamicCast<CodebookParametric> (
+            StaticCast<SpectrumDmgWifiPhy> (StaticCast<WifiNetDevice> (precomputedNodes.Get (rx)->GetDevice (0))->GetPhy ())->GetCodebook ());
+          Ptr<CodebookParametric> lazyTxCodebook = DynamicCast<CodebookParametric> (
+            StaticCast<SpectrumDmgWifiPhy> (StaticCast<WifiNetDevice> (lazyNodes.Get (tx)->GetDevice (0))->GetPhy ())->GetCodebook ());
+          Ptr<CodebookParametric> lazyRxCodebook = DynamicCast<CodebookParametric> (
+            StaticCast<SpectrumDmgWifiPhy> (StaticCast<WifiNetDevice> (lazyNodes.Get (rx)->GetDevice (0))->GetPhy ())->GetCodebook ());
+
+          /* The channel asks for the delay first, which loads the traces of the pair in the lazy engine */
+          NS_TEST_EXPECT_MSG_EQ (precomputedEngine->GetDelay (precomputedTxMobility, precomputedRxMobility),
+                                 lazyEngine->GetDelay (lazyTxMobility, lazyRxMobility),
+                                 "Wrong propagation delay from node " << tx << " to node " << rx);
+
+          /* Received power of each transmit sector towards a receiver in quasi-omni mode */
+          precomputedRxCodebook->SetActiveRxSectorID (1, 1);
+          precomputedRxCodebook->SetReceivingInQuasiOmniMode (1);
+          lazyRxCodebook->SetActiveRxSectorID (1, 1);
+          lazyRxCodebook->SetReceivingInQuasiOmniMode (1);
+          for (SectorID sector = 1; sector <= 8; sector++)
+            {
+              precomputedTxCodebook->SetActiveTxSectorID (1, sector);
+              lazyTxCodebook->SetActiveTxSectorID (1, sector);
+              Ptr<DmgWifiSpectrumSignalParameters> precomputedParams = Create<DmgWifiSpectrumSignalParameters> ();
+              precomputedParams->psd = txPsd;
+              precomputedParams->antennaId = 1;
+              precomputedParams->txPatternConfig = precomputedTxCodebook->GetTxPatternConfig ();
+              Ptr<DmgWifiSpectrumSignalParameters> lazyParams = Create<DmgWifiSpectrumSignalParameters> ();
+              lazyParams->psd = txPsd;
+              lazyParams->antennaId = 1;
+              lazyParams->txPatternConfig = lazyTxCodebook->GetTxPatternConfig ();
+              std::ostringstream what;
+              what << "received power of sector " << +sector << " from node " << tx << " to node " << rx;
+              CheckPsd (precomputedEngine->CalcRxPower (precomputedParams, precomputedTxMobility, precomputedRxMobility),
+                        lazyEngine->CalcRxPower (lazyParams, lazyTxMobility, lazyRxMobility), what.str ());
+            }
+
+          /* Channel gain of each pair of transmit and receive sectors */
+          QdChanneldentifier chId = std::make_tuple (tx, rx, precomputedEngine->m_currentIndex, 1, 1);
+          NS_TEST_ASSERT_MSG_EQ (precomputedEngine->nbMultipathTxRx[chId], lazyEngine->nbMultipathTxRx[chId],
+                                 "Wrong number of multipath components from node " << tx << " to node " << rx);
+          NS_TEST_ASSERT_MSG_GT (precomputedEngine->nbMultipathTxRx[chId], 0,
+                                 "No multipath component from node " << tx << " to node " << rx);
+          uint16_t pathNum = precomputedEngine->nbMultipathTxRx[chId];
+          for (SectorID txSector = 1; txSector <= 8; txSector++)
+            {
+              precomputedTxCodebook->SetActiveTxSectorID (1, txSector);
+              lazyTxCodebook->SetActiveTxSectorID (1, txSector);
+              for (SectorID rxSector = 1; rxSector <= 8; rxSector++)
+                {
+                  precomputedRxCodebook->SetActiveRxSectorID (1, rxSector);
+                  lazyRxCodebook->SetActiveRxSectorID (1, rxSector);
+                  std::ostringstream what;
+                  what << "channel gain of sectors " << +txSector << " and " << +rxSector
+                       << " from node " << tx << " to node " << rx;
+                  CheckPsd (precomputedEngine->GetChannelGain (txPsd, pathNum, chId,
+                                                               precomputedTxCodebook, precomputedRxCodebook,
+                                                               precomputedTxCodebook->GetTxPatternConfig (),
+                                                               precomputedRxCodebook->GetRxPatternConfig ()),
+                            lazyEngine->GetChannelGain (txPsd, pathNum, chId, lazyTxCodebook, lazyRxCodebook,
+                                                        lazyTxCodebook->GetTxPatternConfig (),
+                                                        lazyRxCodebook->GetRxPatternConfig ()),
+                            what.str ());
+                }
+            }
+        }
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Q-D Channel Test Suite
+ */
+class DmgQdChannelTestSuite : public TestSuite
+{
+public:
+  DmgQdChannelTestSuite ();
+};
+
+DmgQdChannelTestSuite::DmgQdChannelTestSuite ()
+  : TestSuite ("dmg-qd-channel", UNIT)
+{
+  AddTestCase (new QdParallelRxPowerTest, TestCase::QUICK);
+  AddTestCase (new QdBeamformingCacheTest, TestCase::QUICK);
+  AddTestCase (new QdFastSectorSweepTest, TestCase::QUICK);
+  AddTestCase (new QdPrecomputeTest, TestCase::QUICK);
+}
+
+static DmgQdChannelTestSuite dmgQdChannelTestSuite; ///< the test suite
@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/dmg-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/codebook-analytical.h"
+#include "ns3/dmg-sta-wifi-mac.h"
+#include "ns3/dmg-wifi-phy.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/wifi-utils.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgRelayTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Predictive switch to the relay link
+ *
+ * The source REDS of a service period protected by an RDS, with predictive
+ * relay switching enabled, receives the acknowledgments of the destination
+ * REDS over the direct link once per millisecond. If the SNR of the
+ * acknowledgments drops steadily, the source REDS must request the switch to
+ * the relay link while the measured SNR is still above the SNR threshold of
+ * the data mode, i.e. before the direct link fails. If the SNR is stable and
+ * above the threshold plus the margin, the transmission link must not change.
+ *
+ * The lookup of the node of the peer REDS, used with a Q-D propagation engine,
+ * is also checked: a peer whose node does not exist yet must be found once its
+ * node is created.
+ */
+class PredictiveRelaySwitchTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param fading Whether the SNR of the direct link drops over time.
+   */
+  PredictiveRelaySwitchTest (bool fading);
+  virtual ~PredictiveRelaySwitchTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Report the acknowledgment of a data frame sent over the direct link.
+   * \param snr The SNR of the acknowledgment in dB.
+   */
+  void ReportAck (double snr);
+
+  bool m_fading;                    //!< Whether the SNR of the direct link drops over time.
+  Ptr<DmgStaWifiMac> m_mac;         //!< The MAC of the source REDS.
+  Mac48Address m_peer;              //!< The MAC address of the destination REDS.
+  WifiMode m_dataMode;              //!< The mode used over the direct link.
+  bool m_switched;                  //!< Whether the switch to the relay link has been requested.
+  double m_switchSnr;               //!< SNR of the acknowledgment which triggered the switch, in dB.
+};
+
+PredictiveRelaySwitchTest::PredictiveRelaySwitchTest (bool fading)
+  : TestCase (fading ? "Check that a fading direct link is switched to the relay link before it fails"
+                     : "Check that a stable direct link is not switched to the relay link"),
+    m_fading (fading),
+    m_switched (false),
+    m_switchSnr (0)
+{
+}
+
+PredictiveRelaySwitchTest::~PredictiveRelaySwitchTest ()
+{
+}
+
+void
+PredictiveRelaySwitchTest::ReportAck (double snr)
+{
+  if (m_switched)
+    {
+      return;
+    }
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  hdr.SetAddr1 (m_peer);
+  hdr.SetAddr2 (m_mac->GetAddress ());
+  WifiTxVector txVector;
+  txVector.SetMode (m_dataMode);
+  m_mac->GetWifiRemoteStationManager ()->ReportDataOk (m_peer, &hdr, DbToRatio (snr), DmgWifiPhy::GetDMG_MCS1 (),
+                                                       DbToRatio (snr), txVector, 1500);
+  if (m_mac->m_relayLinkInfo.switchTransmissionLink)
+    {
+      m_switched = true;
+      m_switchSnr = snr;
+    }
+}
+
+void
+PredictiveRelaySwitchTest::DoRun (void)
+{
+  DmgWifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+
+  DmgWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("DMG_MCS12"));
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (SIMPLE_CODEBOOK),
+                    "Antennas", UintegerValue (1),
+                    "Sectors", UintegerValue (8));
+
+  NodeContainer wifiNodes;
+  wifiNodes.Create (1);
+
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgStaWifiMac",
+                   "ActiveProbing", BooleanValue (false),
+                   "PredictiveRelaySwitching", BooleanValue (true),
+                   "RelayPredictionHorizon", TimeValue (MilliSeconds (5)),
+                   "RelaySwitchMargin", DoubleValue (1.0));
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, wifiNodes);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiNodes);
+
+  m_mac = StaticCast<DmgStaWifiMac> (StaticCast<WifiNetDevice> (devices.Get (0))->GetMac ());
+  m_peer = Mac48Address::Allocate ();
+  m_dataMode = DmgWifiPhy::GetDMG_MCS12 ();
+
+  /* The node of the destination REDS is created after a first lookup */
+  NS_TEST_ASSERT_MSG_EQ (m_mac->GetPeerNode (m_peer), 0, "The destination REDS has no node yet");
+  Ptr<Node> peerNode = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> peerDevice = CreateObject<SimpleNetDevice> ();
+  peerDevice->SetAddress (m_peer);
+  peerNode->AddDevice (peerDevice);
+  NS_TEST_ASSERT_MSG_EQ (m_mac->GetPeerNode (m_peer), peerNode, "The node of the destination REDS must be found");
+
+  /* The DMG STA is the source REDS of a service period protected by an RDS, using the direct link */
+  RELAY_LINK_INFO info;
+  info.rdsDuplexMode = 0;
+  info.switchTransmissionLink = false;
+  info.srcRedsAid = 1;
+  info.dstRedsAid = 2;
+  info.selectedRelayAid = 3;
+  info.srcRedsAddress = m_mac->GetAddress ();
+  info.dstRedsAddress = m_peer;
+  info.selectedRelayAddress = Mac48Address::Allocate ();
+  info.transmissionLink = DIRECT_LINK;
+  m_mac->m_aid = info.srcRedsAid;
+  m_mac->m_relayLinkMap[std::make_pair (info.srcRedsAid, info.dstRedsAid)] = info;
+  m_mac->m_relayLinkInfo = info;
+  m_mac->m_periodProtected = true;
+
+  double threshold = m_mac->GetRelaySwitchSnrThreshold (m_dataMode);
+  double startSnr = threshold + 10;
+  /* A fading SNR drops by 0.5 dB per millisecond, so it reaches the threshold after 20 ms */
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      double snr = (m_fading ? startSnr - 0.5 * i : threshold + 5);
+      Simulator::Schedule (MilliSeconds (1 + i), &PredictiveRelaySwitchTest::ReportAck, this, snr);
+    }
+  Simulator::Stop (MilliSeconds (50));
+  Simulator::Run ();
+
+  if (m_fading)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_switched, true, "The switch to the relay link must be requested");
+      NS_TEST_ASSERT_MSG_GT (m_switchSnr, threshold, "The switch must be requested before the direct link fails");
+      NS_TEST_ASSERT_MSG_LT (m_switchSnr, startSnr, "The switch must follow the drop of the SNR");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_switched, false, "A stable direct link must not be switched to the relay link");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_mac->m_relayLinkInfo.transmissionLink, DIRECT_LINK,
+                         "The transmission link only changes at the next Link Change Interval");
+
+  m_mac = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG Relay Test Suite
+ */
+class DmgRelayTestSuite : public TestSuite
+{
+public:
+  DmgRelayTestSuite ();
+};
+
+DmgRelayTestSuite::DmgRelayTestSuite ()
+  : TestSuite ("dmg-relay", UNIT)
+{
+  AddTestCase (new PredictiveRelaySwitchTest (true), TestCase::QUICK);
+  AddTestCase (new PredictiveRelaySwitchTest (false), TestCase::QUICK);
+}
+
+static DmgRelayTestSuite dmgRelayTestSuite; ///< the test suite
@@ -0,0 +1,545 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/enum.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/dmg-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/dmg-wifi-phy.h"
+#include "ns3/codebook-analytical.h"
+#include "ns3/dmg-snr-threshold-table.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-utils.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/error-rate-model.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgWifiManagerTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG SNR threshold table lookup
+ *
+ * Fills an SNR threshold table with random thresholds, including ties, for the
+ * DMG modes, and checks that the binary search in the selection table built
+ * from a list of candidate modes returns the same mode as the linear scan the
+ * DMG rate managers used to do over the candidate modes, for SNRs around and
+ * exactly at the thresholds.
+ */
+class SnrThresholdTableLookupTest : public TestCase
+{
+public:
+  SnrThresholdTableLookupTest ();
+  virtual ~SnrThresholdTableLookupTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Select the mode with the highest data rate whose SNR threshold is
+   * smaller than the given SNR by scanning all the candidate modes.
+   *
+   * \param table the SNR threshold table
+   * \param modes the candidate modes
+   * \param key the parameters of the SNR thresholds
+   * \param snr the SNR
+   * \param defaultMode the mode to return if no threshold is smaller than the SNR
+   * \return the selected mode
+   */
+  WifiMode LinearScan (Ptr<DmgSnrThresholdTable> table, const WifiModeList &modes,
+                       const DmgSnrThresholdTable::Key &key, double snr, WifiMode defaultMode);
+};
+
+SnrThresholdTableLookupTest::SnrThresholdTableLookupTest ()
+  : TestCase ("Check the SNR threshold table lookup against a linear scan of the modes")
+{
+}
+
+SnrThresholdTableLookupTest::~SnrThresholdTableLookupTest ()
+{
+}
+
+WifiMode
+SnrThresholdTableLookupTest::LinearScan (Ptr<DmgSnrThresholdTable> table, const WifiModeList &modes,
+                                         const DmgSnrThresholdTable::Key &key, double snr, WifiMode defaultMode)
+{
+  WifiMode maxMode = defaultMode;
+  uint64_t bestRate = 0;
+  for (WifiModeList::const_iterator mode = modes.begin (); mode != modes.end (); mode++)
+    {
+      uint64_t dataRate = mode->GetDmgDataRate ();
+      if (dataRate > bestRate && table->GetSnrThreshold (*mode, key) < snr)
+        {
+          bestRate = dataRate;
+          maxMode = *mode;
+        }
+    }
+  return maxMode;
+}
+
+void
+SnrThresholdTableLookupTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+
+  WifiModeList allModes;
+  for (uint8_t index = 1; index <= 31; index++)
+    {
+      allModes.push_back (DmgWifiPhy::GetDmgMcs (index));
+    }
+  WifiMode defaultMode = DmgWifiPhy::GetDMG_MCS0 ();
+
+  Ptr<DmgSnrThresholdTable> table = CreateObject<DmgSnrThresholdTable> ();
+  DmgSnrThresholdTable::Key key (2160, 1e-6, DmgSnrThresholdTable::SNR_DB);
+  std::vector<double> snrs;
+  for (WifiModeList::const_iterator mode = allModes.begin (); mode != allModes.end (); mode++)
+    {
+      /* Half dB steps, so that several modes share the same threshold */
+      double threshold = std::floor (random->GetValue (-5, 25) * 2) / 2;
+      table->AddSnrThreshold (*mode, key, threshold);
+      snrs.push_back (threshold);
+      snrs.push_back (threshold + 0.25);
+    }
+  snrs.push_back (-100);
+  snrs.push_back (100);
+
+  /* All the modes, all the modes in the reverse order and random subsets of the modes */
+  std::vector<WifiModeList> candidates;
+  candidates.push_back (allModes);
+  candidates.push_back (WifiModeList (allModes.rbegin (), allModes.rend ()));
+  for (uint8_t i = 0; i < 20; i++)
+    {
+      WifiModeList modes;
+      for (WifiModeList::const_iterator mode = allModes.begin (); mode != allModes.end (); mode++)
+        {
+          if (random->GetValue () < 0.5)
+            {
+              modes.push_back (*mode);
+            }
+        }
+      candidates.push_back (modes);
+    }
+
+  for (std::vector<WifiModeList>::const_iterator modes = candidates.begin (); modes != candidates.end (); modes++)
+    {
+      DmgSnrThresholdTable::SelectionTable selectionTable = table->BuildSelectionTable (*modes, key);
+      for (std::vector<double>::const_iterator snr = snrs.begin (); snr != snrs.end (); snr++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (DmgSnrThresholdTable::Lookup (selectionTable, *snr, defaultMode),
+                                 LinearScan (table, *modes, key, *snr, defaultMode),
+                                 "Wrong mode selected at SNR " << *snr << " among " << modes->size () << " modes");
+        }
+    }
+
+  /* The selection table of all the modes added for the key */
+  const DmgSnrThresholdTable::SelectionTable &selectionTable = table->GetSelectionTable (key);
+  for (std::vector<double>::const_iterator snr = snrs.begin (); snr != snrs.end (); snr++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (DmgSnrThresholdTable::Lookup (selectionTable, *snr, defaultMode),
+                             LinearScan (table, allModes, key, *snr, defaultMode),
+                             "Wrong mode selected at SNR " << *snr << " among all the modes");
+    }
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG SNR threshold table shared by several rate managers
+ *
+ * Three DMG stations share the same SNR threshold table: two of them use the
+ * IdealDmgWifiManager with different BER thresholds and the third one uses
+ * the CbtraaDmgWifiManager. Checks that the table holds the thresholds of each
+ * rate manager, at its own BER and in its own unit, once they are initialized.
+ */
+class SharedSnrThresholdTableTest : public TestCase
+{
+public:
+  SharedSnrThresholdTableTest ();
+  virtual ~SharedSnrThresholdTableTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SharedSnrThresholdTableTest::SharedSnrThresholdTableTest ()
+  : TestCase ("Check the SNR thresholds of rate managers sharing the same table")
+{
+}
+
+SharedSnrThresholdTableTest::~SharedSnrThresholdTableTest ()
+{
+}
+
+void
+SharedSnrThresholdTableTest::DoRun (void)
+{
+  Ptr<DmgSnrThresholdTable> table = CreateObject<DmgSnrThresholdTable> ();
+
+  DmgWifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+
+  DmgWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (SIMPLE_CODEBOOK),
+                    "Antennas", UintegerValue (1),
+                    "Sectors", UintegerValue (8));
+
+  NodeContainer wifiNodes;
+  wifiNodes.Create (3);
+
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgAdhocWifiMac");
+
+  NetDeviceContainer devices;
+  wifi.SetRemoteStationManager ("ns3::IdealDmgWifiManager",
+                                "BerThreshold", DoubleValue (1e-6),
+                                "SnrThresholdTable", PointerValue (table));
+  devices.Add (wifi.Install (wifiPhy, wifiMac, wifiNodes.Get (0)));
+  wifi.SetRemoteStationManager ("ns3::IdealDmgWifiManager",
+                                "BerThreshold", DoubleValue (1e-9),
+                                "SnrThresholdTable", PointerValue (table));
+  devices.Add (wifi.Install (wifiPhy, wifiMac, wifiNodes.Get (1)));
+  wifi.SetRemoteStationManager ("ns3::CbtraaDmgWifiManager",
+                                "BerThreshold", DoubleValue (1e-6),
+                                "SnrThresholdTable", PointerValue (table));
+  devices.Add (wifi.Install (wifiPhy, wifiMac, wifiNodes.Get (2)));
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiNodes);
+
+  Simulator::Stop (MilliSeconds (1));
+  Simulator::Run ();
+
+  Ptr<WifiPhy> phy = StaticCast<WifiNetDevice> (devices.Get (0))->GetPhy ();
+  uint16_t channelWidth = phy->GetChannelWidth ();
+  DmgSnrThresholdTable::Key idealKey (channelWidth, 1e-6, DmgSnrThresholdTable::SNR_LINEAR);
+  DmgSnrThresholdTable::Key strictKey (channelWidth, 1e-9, DmgSnrThresholdTable::SNR_LINEAR);
+  DmgSnrThresholdTable::Key cbtraaKey (channelWidth, 1e-6, DmgSnrThresholdTable::SNR_DB);
+  for (uint8_t i = 1; i < phy->GetNModes (); i++)
+    {
+      WifiMode mode = phy->GetMode (i);
+      WifiTxVector txVector;
+      txVector.SetChannelWidth (channelWidth);
+      txVector.SetMode (mode);
+      NS_TEST_ASSERT_MSG_EQ (table->HasSnrThreshold (mode, idealKey), true, "Missing threshold of " << mode);
+      NS_TEST_ASSERT_MSG_EQ (table->HasSnrThreshold (mode, strictKey), true, "Missing threshold of " << mode);
+      NS_TEST_ASSERT_MSG_EQ (table->HasSnrThreshold (mode, cbtraaKey), true, "Missing threshold of " << mode);
+      NS_TEST_ASSERT_MSG_EQ_TOL (table->GetSnrThreshold (mode, idealKey), phy->CalculateSnr (txVector, 1e-6),
+                                 1e-9, "Wrong threshold of " << mode << " at a BER of 1e-6");
+      NS_TEST_ASSERT_MSG_EQ_TOL (table->GetSnrThreshold (mode, strictKey), phy->CalculateSnr (txVector, 1e-9),
+                                 1e-9, "Wrong threshold of " << mode << " at a BER of 1e-9");
+      NS_TEST_ASSERT_MSG_EQ_TOL (table->GetSnrThreshold (mode, cbtraaKey), RatioToDb (phy->CalculateSnr (txVector, 1e-6)),
+                                 1e-9, "Wrong threshold of " << mode << " in dB");
+      NS_TEST_ASSERT_MSG_LT (table->GetSnrThreshold (mode, idealKey), table->GetSnrThreshold (mode, strictKey),
+                             "A lower BER must need a higher SNR with " << mode);
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Mode selected by the goodput maximizing DMG rate manager
+ *
+ * A DMG station using the GoodputDmgWifiManager, without SNR margin, learns
+ * the link SNR of a peer station from beamforming training. For several SNR
+ * values, checks that the selected mode is the one with the highest expected
+ * goodput (1 - PER) x data rate, computed from the error rate model of the PHY
+ * for all the DMG modes, and that the selected data rate grows with the SNR.
+ * When no mode can be used, the default mode must be selected.
+ */
+class GoodputDmgWifiManagerTest : public TestCase
+{
+public:
+  GoodputDmgWifiManagerTest ();
+  virtual ~GoodputDmgWifiManagerTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GoodputDmgWifiManagerTest::GoodputDmgWifiManagerTest ()
+  : TestCase ("Check the mode selected by the goodput DMG rate manager against the highest expected goodput")
+{
+}
+
+GoodputDmgWifiManagerTest::~GoodputDmgWifiManagerTest ()
+{
+}
+
+void
+GoodputDmgWifiManagerTest::DoRun (void)
+{
+  const uint32_t mpduLength = 1500;
+
+  DmgWifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+
+  DmgWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (SIMPLE_CODEBOOK),
+                    "Antennas", UintegerValue (1),
+                    "Sectors", UintegerValue (8));
+  wifi.SetRemoteStationManager ("ns3::GoodputDmgWifiManager",
+                                "SnrMargin", DoubleValue (0),
+                                "MpduLength", UintegerValue (mpduLength));
+
+  NodeContainer wifiNodes;
+  wifiNodes.Create (1);
+
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgAdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, wifiNodes);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiNodes);
+
+  Simulator::Stop (MilliSeconds (1));
+  Simulator::Run ();
+
+  Ptr<WifiNetDevice> device = StaticCast<WifiNetDevice> (devices.Get (0));
+  Ptr<WifiPhy> phy = device->GetPhy ();
+  Ptr<WifiRemoteStationManager> manager = device->GetRemoteStationManager ();
+  Ptr<ErrorRateModel> errorRateModel = phy->GetErrorRateModel ();
+
+  /* SNR values (in dB) on the grid of the rate manager */
+  double snrs[] = {-5.0, 0.0, 2.5, 5.0, 7.75, 10.0, 15.0, 20.0};
+  uint64_t lastDataRate = 0;
+  for (uint8_t i = 0; i < sizeof (snrs) / sizeof (snrs[0]); i++)
+    {
+      /* A new peer station for each SNR, so that the SNR is not averaged with the previous ones */
+      Mac48Address peer = Mac48Address::Allocate ();
+      for (uint8_t j = 0; j < phy->GetNModes (); j++)
+        {
+          manager->AddSupportedMode (peer, phy->GetMode (j));
+        }
+      manager->RecordLinkSnr (peer, snrs[i]);
+      WifiMacHeader hdr;
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetAddr1 (peer);
+      WifiMode selectedMode = manager->GetDataTxVector (hdr).GetMode ();
+
+      WifiTxVector txVector;
+      txVector.SetChannelWidth (phy->GetChannelWidth ());
+      double bestGoodput = 0;
+      double selectedGoodput = -1;
+      for (uint8_t j = 0; j < phy->GetNModes (); j++)
+        {
+          WifiMode mode = phy->GetMode (j);
+          if (mode.GetModulationClass () != WIFI_MOD_CLASS_DMG_SC && mode.GetModulationClass () != WIFI_MOD_CLASS_DMG_OFDM)
+            {
+              continue;
+            }
+          txVector.SetMode (mode);
+          double goodput = errorRateModel->GetChunkSuccessRate (mode, txVector, DbToRatio (snrs[i]), 8 * mpduLength)
+            * mode.GetDmgDataRate ();
+          bestGoodput = std::max (bestGoodput, goodput);
+          if (mode == selectedMode)
+            {
+              selectedGoodput = goodput;
+            }
+        }
+      if (bestGoodput == 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (selectedMode, manager->GetDefaultMode (),
+                                 "The default mode must be selected when no mode can be used at " << snrs[i] << " dB");
+          continue;
+        }
+      NS_TEST_ASSERT_MSG_EQ_TOL (selectedGoodput, bestGoodput, bestGoodput * 1e-9,
+                                 "The goodput of " << selectedMode << " is not the highest one at " << snrs[i] << " dB");
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (selectedMode.GetDmgDataRate (), lastDataRate,
+                                   "The data rate must not decrease when the SNR increases to " << snrs[i] << " dB");
+      lastDataRate = selectedMode.GetDmgDataRate ();
+    }
+  NS_TEST_ASSERT_MSG_GT (lastDataRate, DmgWifiPhy::GetDMG_MCS1 ().GetDmgDataRate (),
+                         "A faster mode than DMG MCS1 must be selected at a high SNR");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Selection table of the supported modes of a peer station
+ *
+ * A DMG station using an SNR threshold based rate manager selects a mode for a
+ * peer station supporting DMG MCS1 to DMG MCS4 at a high SNR. DMG MCS2 to
+ * DMG MCS4 are then replaced by DMG MCS6 to DMG MCS8, so the number of
+ * supported modes does not change. The mode selected at a high SNR must be the
+ * fastest one of the new supported modes.
+ */
+class SelectionTableUpdateTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param managerType The type of the rate manager.
+   */
+  SelectionTableUpdateTest (std::string managerType);
+  virtual ~SelectionTableUpdateTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Record the SNR of the peer station and select a mode for it.
+   * \param manager The rate manager.
+   * \param peer The address of the peer station.
+   * \param snr The SNR in dB.
+   * \return The selected mode.
+   */
+  WifiMode SelectMode (Ptr<WifiRemoteStationManager> manager, Mac48Address peer, double snr);
+
+  std::string m_managerType;  //!< The type of the rate manager.
+};
+
+SelectionTableUpdateTest::SelectionTableUpdateTest (std::string managerType)
+  : TestCase ("Check that the " + managerType + " selects a mode among the current supported modes"),
+    m_managerType (managerType)
+{
+}
+
+SelectionTableUpdateTest::~SelectionTableUpdateTest ()
+{
+}
+
+WifiMode
+SelectionTableUpdateTest::SelectMode (Ptr<WifiRemoteStationManager> manager, Mac48Address peer, double snr)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  hdr.SetAddr1 (peer);
+  /* The SNR of the link in dB, and of the last acknowledged data frame as a ratio */
+  manager->RecordLinkSnr (peer, snr);
+  WifiTxVector txVector;
+  txVector.SetMode (DmgWifiPhy::GetDMG_MCS1 ());
+  manager->ReportDataOk (peer, &hdr, DbToRatio (snr), DmgWifiPhy::GetDMG_MCS1 (), DbToRatio (snr), txVector, 1500);
+  return manager->GetDataTxVector (hdr).GetMode ();
+}
+
+void
+SelectionTableUpdateTest::DoRun (void)
+{
+  DmgWifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+
+  DmgWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (SIMPLE_CODEBOOK),
+                    "Antennas", UintegerValue (1),
+                    "Sectors", UintegerValue (8));
+  wifi.SetRemoteStationManager (m_managerType);
+
+  NodeContainer wifiNodes;
+  wifiNodes.Create (1);
+
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgAdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, wifiNodes);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiNodes);
+
+  Simulator::Stop (MilliSeconds (1));
+  Simulator::Run ();
+
+  Ptr<WifiRemoteStationManager> manager = StaticCast<WifiNetDevice> (devices.Get (0))->GetRemoteStationManager ();
+  Mac48Address peer = Mac48Address::Allocate ();
+  /* DMG MCS1 is the default mode, which is always supported */
+  manager->AddSupportedMode (peer, DmgWifiPhy::GetDMG_MCS2 ());
+  manager->AddSupportedMode (peer, DmgWifiPhy::GetDMG_MCS3 ());
+  manager->AddSupportedMode (peer, DmgWifiPhy::GetDMG_MCS4 ());
+  NS_TEST_ASSERT_MSG_EQ (SelectMode (manager, peer, 30), DmgWifiPhy::GetDMG_MCS4 (),
+                         "The fastest supported mode must be selected at a high SNR");
+
+  /* The same number of supported modes, but faster ones */
+  manager->RemoveAllSupportedModes (peer);
+  manager->AddSupportedMode (peer, manager->GetDefaultMode ());
+  manager->AddSupportedMode (peer, DmgWifiPhy::GetDMG_MCS6 ());
+  manager->AddSupportedMode (peer, DmgWifiPhy::GetDMG_MCS7 ());
+  manager->AddSupportedMode (peer, DmgWifiPhy::GetDMG_MCS8 ());
+  NS_TEST_ASSERT_MSG_EQ (SelectMode (manager, peer, 31), DmgWifiPhy::GetDMG_MCS8 (),
+                         "The fastest of the new supported modes must be selected at a high SNR");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG Rate Managers Test Suite
+ */
+class DmgWifiManagerTestSuite : public TestSuite
+{
+public:
+  DmgWifiManagerTestSuite ();
+};
+
+DmgWifiManagerTestSuite::DmgWifiManagerTestSuite ()
+  : TestSuite ("dmg-wifi-manager", UNIT)
+{
+  AddTestCase (new SnrThresholdTableLookupTest, TestCase::QUICK);
+  AddTestCase (new SharedSnrThresholdTableTest, TestCase::QUICK);
+  AddTestCase (new GoodputDmgWifiManagerTest, TestCase::QUICK);
+  AddTestCase (new SelectionTableUpdateTest ("ns3::IdealDmgWifiManager"), TestCase::QUICK);
+  AddTestCase (new SelectionTableUpdateTest ("ns3::CbtraaDmgWifiManager"), TestCase::QUICK);
+}
+
+static DmgWifiManagerTestSuite dmgWifiManagerTestSuite; ///< the test suite
@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/yans-wifi-phy.h"
+#include "ns3/dmg-wifi-phy.h"
 
 using namespace ns3;
 
@@ -29,6 +30,7 @@ NS_LOG_COMPONENT_DEFINE ("InterferenceHelperTxDurationTest");
 
 static const uint16_t CHANNEL_1_MHZ  = 2412; // a 2.4 GHz center frequency (MHz)
 static const uint16_t CHANNEL_36_MHZ = 5180; // a 5 GHz center frequency (MHz)
+static const uint16_t CHANNEL_2_MHZ = 60480; // a 60 GHz center frequency (MHz)
 
 /**
  * \ingroup wifi-test
@@ -426,6 +428,107 @@ TxDurationTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (retval, true, "an 802.11ax duration failed");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Maximum DMG/EDMG PSDU size within a PPDU duration
+ *
+ * Compares WifiPhy::GetMaxPsduSize, memoized by a PHY, with the largest PSDU size whose transmit
+ * duration, as returned by WifiPhy::CalculateTxDuration, fits in the PPDU
+ * duration. The TXVECTORs differ in their preamble type, which changes the
+ * duration of the preamble and the headers, and in their guard interval, and are
+ * queried with the same durations one after the
+ * other, so that a stale memoized answer shows up as a mismatch.
+ */
+class DmgMaxPsduSizeTest : public TestCase
+{
+public:
+  DmgMaxPsduSizeTest ();
+  virtual ~DmgMaxPsduSizeTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Find the largest PSDU size that fits in a PPDU duration by trying all the sizes.
+   *
+   * @param duration the maximum duration of the PPDU
+   * @param txVector the TXVECTOR of the PPDU
+   *
+   * @return the maximum PSDU size in bytes, or zero if not even a PSDU of one byte fits
+   */
+  uint32_t GetMaxPsduSizeBruteForce (Time duration, WifiTxVector txVector);
+};
+
+DmgMaxPsduSizeTest::DmgMaxPsduSizeTest ()
+  : TestCase ("Check the maximum DMG and EDMG PSDU sizes against all the PSDU sizes")
+{
+}
+
+DmgMaxPsduSizeTest::~DmgMaxPsduSizeTest ()
+{
+}
+
+uint32_t
+DmgMaxPsduSizeTest::GetMaxPsduSizeBruteForce (Time duration, WifiTxVector txVector)
+{
+  uint32_t size = 0;
+  while (WifiPhy::CalculateTxDuration (size + 1, txVector, CHANNEL_2_MHZ) <= duration)
+    {
+      size++;
+    }
+  return size;
+}
+
+void
+DmgMaxPsduSizeTest::DoRun (void)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  std::vector<WifiTxVector> txVectors;
+  WifiTxVector txVector;
+  txVector.SetChannelWidth (2160);
+  txVector.SetNss (1);
+  for (WifiMode mode : {DmgWifiPhy::GetDMG_MCS1 (), DmgWifiPhy::GetDMG_MCS12 ()})
+    {
+      txVector.SetMode (mode);
+      txVector.SetPreambleType (WIFI_PREAMBLE_DMG_SC);
+      txVectors.push_back (txVector);
+    }
+  txVector.SetMode (DmgWifiPhy::GetDMG_MCS13 ());
+  txVector.SetPreambleType (WIFI_PREAMBLE_DMG_OFDM);
+  txVectors.push_back (txVector);
+  for (WifiMode mode : {DmgWifiPhy::GetEDMG_SC_MCS1 (), DmgWifiPhy::GetEDMG_SC_MCS12 ()})
+    {
+      txVector.SetMode (mode);
+      txVector.SetPreambleType (WIFI_PREAMBLE_EDMG_SC);
+      for (GuardIntervalLength gi : {GI_SHORT, GI_NORMAL, GI_LONG})
+        {
+          txVector.SetGaurdIntervalType (gi);
+          txVectors.push_back (txVector);
+        }
+    }
+
+  /* From shorter than the preamble to a few thousand symbol blocks */
+  std::vector<Time> durations = {NanoSeconds (500), MicroSeconds (2), MicroSeconds (3), NanoSeconds (3333),
+                                 MicroSeconds (5), MicroSeconds (12), MicroSeconds (20)};
+  for (uint8_t pass = 0; pass < 2; pass++)
+    {
+      /* The second pass only sees memoized answers */
+      for (std::vector<Time>::const_iterator duration = durations.begin (); duration != durations.end (); duration++)
+        {
+          for (std::vector<WifiTxVector>::const_iterator it = txVectors.begin (); it != txVectors.end (); it++)
+            {
+              uint32_t expected = GetMaxPsduSizeBruteForce (*duration, *it);
+              NS_TEST_ASSERT_MSG_EQ (phy->GetMaxPsduSize (*duration, *it, CHANNEL_2_MHZ), expected,
+                                     "Wrong maximum PSDU size for " << it->GetMode () << " with preamble "
+                                     << it->GetPreambleType () << " and guard interval "
+                                     << static_cast<uint16_t> (it->GetGaurdIntervalType ()) << " in " << *duration);
+            }
+        }
+    }
+}
+
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -442,6 +545,7 @@ TxDurationTestSuite::TxDurationTestSuite ()
   : TestSuite ("wifi-devices-tx-duration", UNIT)
 {
   AddTestCase (new TxDurationTest, TestCase::QUICK);
+  AddTestCase (new DmgMaxPsduSizeTest, TestCase::QUICK);
 }
 
 static TxDurationTestSuite g_txDurationTestSuite; ///< the test suite
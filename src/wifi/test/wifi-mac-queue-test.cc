@@ -0,0 +1,327 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/enum.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-mac-queue.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WifiMacQueueTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Consistency of the WifiMacQueue indexes
+ *
+ * A random sequence of operations is applied to a WifiMacQueue holding QoS
+ * Data, non-QoS Data and Management frames for several receivers: Enqueue,
+ * PushFront, Insert in the middle of the queue (including bursts of insertions
+ * at the same position, which exhaust the gap between position keys), Dequeue,
+ * DequeueByAddress, DequeueByTidAndAddress, the Remove variants and Flush.
+ * Simulation time advances between the operations, so that the items expire
+ * while they are queued. After each operation, the items returned by walking
+ * the receiver and receiver/TID indexes must be the unexpired items found by a
+ * linear scan of the queue, in the same order, and the per receiver and per
+ * receiver/TID counts must match.
+ */
+class WifiMacQueueIndexTest : public TestCase
+{
+public:
+  WifiMacQueueIndexTest ();
+  virtual ~WifiMacQueueIndexTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create a random item for one of the receivers.
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> CreateItem (void);
+  /**
+   * Return the position of a random queued item, found through the indexes.
+   * \return an iterator pointing to the item, or end () if none was found
+   */
+  WifiMacQueue::ConstIterator PeekItem (void);
+  /**
+   * Apply a random operation to the queue and check the indexes afterwards.
+   * \param step the number of the operation
+   */
+  void DoOperation (uint32_t step);
+  /**
+   * Check that the indexes of the queue match a linear scan of the queue.
+   * \param step the number of the operation applied last
+   */
+  void CheckIndexes (uint32_t step);
+  /**
+   * Trace the items that expired in the queue.
+   * \param item the expired item
+   */
+  void NotifyExpired (Ptr<const WifiMacQueueItem> item);
+
+  static const uint8_t N_TIDS = 4;              //!< Number of TIDs used
+  std::vector<Mac48Address> m_receivers;        //!< Receivers of the queued frames
+  Ptr<WifiMacQueue> m_queue;                    //!< The queue under test
+  Ptr<UniformRandomVariable> m_random;          //!< Random variable driving the operations
+  uint32_t m_nExpired;                          //!< Number of items that expired in the queue
+  uint32_t m_nFlushed;                          //!< Number of times the queue was flushed
+};
+
+WifiMacQueueIndexTest::WifiMacQueueIndexTest ()
+  : TestCase ("Check the receiver and receiver-TID indexes of the WifiMacQueue"),
+    m_nExpired (0),
+    m_nFlushed (0)
+{
+}
+
+WifiMacQueueIndexTest::~WifiMacQueueIndexTest ()
+{
+}
+
+void
+WifiMacQueueIndexTest::NotifyExpired (Ptr<const WifiMacQueueItem> item)
+{
+  m_nExpired++;
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueueIndexTest::CreateItem (void)
+{
+  WifiMacHeader hdr;
+  uint32_t type = m_random->GetInteger (0, 9);
+  if (type < 7)
+    {
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetQosTid (m_random->GetInteger (0, N_TIDS - 1));
+    }
+  else if (type < 9)
+    {
+      hdr.SetType (WIFI_MAC_DATA);
+    }
+  else
+    {
+      hdr.SetType (WIFI_MAC_MGT_ACTION);
+    }
+  hdr.SetAddr1 (m_receivers[m_random->GetInteger (0, m_receivers.size () - 1)]);
+  return Create<WifiMacQueueItem> (Create<Packet> (100), hdr);
+}
+
+WifiMacQueue::ConstIterator
+WifiMacQueueIndexTest::PeekItem (void)
+{
+  Mac48Address receiver = m_receivers[m_random->GetInteger (0, m_receivers.size () - 1)];
+  uint8_t tid = m_random->GetInteger (0, N_TIDS - 1);
+  WifiMacQueue::ConstIterator it = m_queue->PeekByTidAndAddress (tid, receiver);
+  if (it == m_queue->end ())
+    {
+      it = m_queue->PeekByAddress (receiver);
+    }
+  return it;
+}
+
+void
+WifiMacQueueIndexTest::DoOperation (uint32_t step)
+{
+  uint32_t operation = m_random->GetInteger (0, 99);
+  if (operation < 40)
+    {
+      m_queue->Enqueue (CreateItem ());
+    }
+  else if (operation < 48)
+    {
+      m_queue->PushFront (CreateItem ());
+    }
+  else if (operation < 58)
+    {
+      m_queue->Insert (PeekItem (), CreateItem ());
+    }
+  else if (operation < 60)
+    {
+      /* Every insertion halves the gap between the position keys around the position */
+      WifiMacQueue::ConstIterator it = PeekItem ();
+      for (uint8_t i = 0; i < 20; i++)
+        {
+          m_queue->Insert (it, CreateItem ());
+        }
+    }
+  else if (operation < 68)
+    {
+      m_queue->Dequeue ();
+    }
+  else if (operation < 72)
+    {
+      m_queue->DequeueByAddress (m_receivers[m_random->GetInteger (0, m_receivers.size () - 1)]);
+    }
+  else if (operation < 82)
+    {
+      m_queue->DequeueByTidAndAddress (m_random->GetInteger (0, N_TIDS - 1),
+                                       m_receivers[m_random->GetInteger (0, m_receivers.size () - 1)]);
+    }
+  else if (operation < 87)
+    {
+      WifiMacQueue::ConstIterator it = PeekItem ();
+      if (it != m_queue->end ())
+        {
+          m_queue->Remove ((*it)->GetPacket ());
+        }
+    }
+  else if (operation < 95)
+    {
+      WifiMacQueue::ConstIterator it = PeekItem ();
+      if (it != m_queue->end ())
+        {
+          m_queue->Remove (it, m_random->GetInteger (0, 1) == 1);
+        }
+    }
+  else if (operation < 99)
+    {
+      m_queue->Remove ();
+    }
+  else
+    {
+      m_queue->Flush ();
+      m_nFlushed++;
+    }
+  CheckIndexes (step);
+}
+
+void
+WifiMacQueueIndexTest::CheckIndexes (uint32_t step)
+{
+  Time now = Simulator::Now ();
+  Time maxDelay = m_queue->GetMaxDelay ();
+  for (const auto &receiver : m_receivers)
+    {
+      /* Unexpired items in the queue, found by a linear scan */
+      std::vector<const WifiMacQueueItem *> dataItems;
+      std::vector<std::vector<const WifiMacQueueItem *> > qosDataItems (N_TIDS);
+      for (WifiMacQueue::ConstIterator it = m_queue->begin (); it != m_queue->end (); it++)
+        {
+          if (now > (*it)->GetTimeStamp () + maxDelay
+              || !(*it)->GetHeader ().IsData () || (*it)->GetHeader ().GetAddr1 () != receiver)
+            {
+              continue;
+            }
+          dataItems.push_back (PeekPointer (*it));
+          if ((*it)->GetHeader ().IsQosData ())
+            {
+              qosDataItems[(*it)->GetHeader ().GetQosTid ()].push_back (PeekPointer (*it));
+            }
+        }
+
+      /* Items found by walking the indexes */
+      std::vector<const WifiMacQueueItem *> indexedItems;
+      for (WifiMacQueue::ConstIterator it = m_queue->PeekByAddress (receiver); it != m_queue->end ();
+           it = m_queue->PeekByAddress (receiver, std::next (it)))
+        {
+          indexedItems.push_back (PeekPointer (*it));
+        }
+      NS_TEST_ASSERT_MSG_EQ ((indexedItems == dataItems), true,
+                             "Wrong Data frames for " << receiver << " after operation " << step);
+      for (uint8_t tid = 0; tid < N_TIDS; tid++)
+        {
+          indexedItems.clear ();
+          for (WifiMacQueue::ConstIterator it = m_queue->PeekByTidAndAddress (tid, receiver); it != m_queue->end ();
+               it = m_queue->PeekByTidAndAddress (tid, receiver, std::next (it)))
+            {
+              indexedItems.push_back (PeekPointer (*it));
+            }
+          NS_TEST_ASSERT_MSG_EQ ((indexedItems == qosDataItems[tid]), true,
+                                 "Wrong QoS Data frames for " << receiver << " and TID " << +tid
+                                 << " after operation " << step);
+        }
+
+      /* Counting removes the expired items from the queue and from the indexes */
+      NS_TEST_ASSERT_MSG_EQ (m_queue->GetNPacketsByAddress (receiver), dataItems.size (),
+                             "Wrong number of Data frames for " << receiver << " after operation " << step);
+      for (uint8_t tid = 0; tid < N_TIDS; tid++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (tid, receiver), qosDataItems[tid].size (),
+                                 "Wrong number of QoS Data frames for " << receiver << " and TID " << +tid
+                                 << " after operation " << step);
+        }
+    }
+}
+
+void
+WifiMacQueueIndexTest::DoRun (void)
+{
+  const uint32_t nOperations = 3000;
+
+  m_receivers.push_back (Mac48Address ("00:00:00:00:00:01"));
+  m_receivers.push_back (Mac48Address ("00:00:00:00:00:02"));
+  m_receivers.push_back (Mac48Address ("00:00:00:00:00:03"));
+
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+
+  /* The queue fills up, so that stale items are removed and the oldest items
+     are dropped to make room for the new ones */
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetAttribute ("MaxSize", StringValue ("100p"));
+  m_queue->SetAttribute ("MaxDelay", TimeValue (MilliSeconds (20)));
+  m_queue->SetAttribute ("DropPolicy", EnumValue (WifiMacQueue::DROP_OLDEST));
+  m_queue->TraceConnectWithoutContext ("Expired", MakeCallback (&WifiMacQueueIndexTest::NotifyExpired, this));
+
+  for (uint32_t step = 0; step < nOperations; step++)
+    {
+      Simulator::Schedule (MicroSeconds (100 * step), &WifiMacQueueIndexTest::DoOperation, this, step);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_GT (m_nExpired, 0, "No item expired in the queue");
+  NS_TEST_EXPECT_MSG_GT (m_nFlushed, 0, "The queue was never flushed");
+
+  m_queue->Flush ();
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (), 0, "The queue is not empty after a flush");
+  for (const auto &receiver : m_receivers)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((m_queue->PeekByAddress (receiver) == m_queue->end ()), true,
+                             "Data frames indexed for " << receiver << " after a flush");
+    }
+  m_queue->Dispose ();
+  m_queue = 0;
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief WifiMacQueue Test Suite
+ */
+class WifiMacQueueTestSuite : public TestSuite
+{
+public:
+  WifiMacQueueTestSuite ();
+};
+
+WifiMacQueueTestSuite::WifiMacQueueTestSuite ()
+  : TestSuite ("wifi-mac-queue", UNIT)
+{
+  AddTestCase (new WifiMacQueueIndexTest, TestCase::QUICK);
+}
+
+static WifiMacQueueTestSuite g_wifiMacQueueTestSuite; ///< the test suite
@@ -0,0 +1,302 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the insertion of events from
+// other threads into the simulator. It compares the lock-free MpscQueue
+// with a list protected by a mutex and swapped by the consumer, which is
+// how DefaultSimulatorImpl used to queue the events with context, and
+// measures Simulator::ScheduleWithContext called from other threads.
+// Sample usage:  ./waf --run 'bench-context-queue --n=1000000 --threads=4'
+
+#include "ns3/command-line.h"
+#include "ns3/mpsc-queue.h"
+#include "ns3/simulator.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <stdlib.h> // for exit ()
+#include <thread>
+#include <vector>
+
+using namespace ns3;
+
+/** An event with context, as queued by DefaultSimulatorImpl. */
+struct BenchItem
+{
+  uint32_t context;   //!< The event context.
+  uint64_t timestamp; //!< The event delay.
+  void *event;        //!< The event implementation.
+};
+
+/** The queue of events with context used by DefaultSimulatorImpl before the lock-free queue. */
+class MutexListQueue
+{
+public:
+  MutexListQueue ()
+    : m_empty (true)
+  {
+  }
+  /**
+   * Append an item.
+   * \param item the item
+   */
+  void Push (const BenchItem &item)
+  {
+    CriticalSection cs (m_mutex);
+    m_items.push_back (item);
+    m_empty = false;
+  }
+  /**
+   * Move all the items to the consumer.
+   * \param items the list receiving the items
+   */
+  void Swap (std::list<BenchItem> &items)
+  {
+    if (m_empty)
+      {
+        return;
+      }
+    CriticalSection cs (m_mutex);
+    m_items.swap (items);
+    m_empty = true;
+  }
+
+private:
+  std::list<BenchItem> m_items;   //!< The items.
+  std::atomic<bool> m_empty;      //!< Whether the list is empty.
+  SystemMutex m_mutex;            //!< The mutex protecting the list.
+};
+
+/** The state shared by the producers and the consumer of a benchmark. */
+struct BenchContext
+{
+  uint32_t perThread;                //!< The number of items pushed by each producer.
+  MpscQueue<BenchItem> *mpscQueue;   //!< The lock-free queue.
+  MutexListQueue *mutexQueue;        //!< The mutex-based queue.
+  std::atomic<uint32_t> done;        //!< The number of producers done.
+};
+
+static void
+ProduceMpsc (BenchContext *context)
+{
+  for (uint32_t i = 0; i < context->perThread; i++)
+    {
+      BenchItem item = { i, i, 0 };
+      while (!context->mpscQueue->Push (item))
+        {
+          std::this_thread::yield ();
+        }
+    }
+  context->done++;
+}
+
+static void
+ProduceMutex (BenchContext *context)
+{
+  for (uint32_t i = 0; i < context->perThread; i++)
+    {
+      BenchItem item = { i, i, 0 };
+      context->mutexQueue->Push (item);
+    }
+  context->done++;
+}
+
+static void
+DoNothing (void)
+{
+}
+
+static void
+ProduceEvents (BenchContext *context)
+{
+  for (uint32_t i = 0; i < context->perThread; i++)
+    {
+      Simulator::ScheduleWithContext (i, Seconds (0), &DoNothing);
+    }
+  context->done++;
+}
+
+/**
+ * Start the producers.
+ * \param context the benchmark state
+ * \param threads the number of producers
+ * \param producer the function run by each producer
+ * \return the producers
+ */
+static std::vector<Ptr<SystemThread> >
+StartProducers (BenchContext *context, uint32_t threads, void (*producer) (BenchContext *))
+{
+  std::vector<Ptr<SystemThread> > producers;
+  for (uint32_t i = 0; i < threads; i++)
+    {
+      producers.push_back (Create<SystemThread> (MakeBoundCallback (producer, context)));
+      producers.back ()->Start ();
+    }
+  return producers;
+}
+
+static void
+JoinProducers (std::vector<Ptr<SystemThread> > &producers)
+{
+  for (uint32_t i = 0; i < producers.size (); i++)
+    {
+      producers[i]->Join ();
+    }
+}
+
+static uint64_t
+benchMpsc (uint32_t n, uint32_t threads)
+{
+  MpscQueue<BenchItem> queue (1024);
+  BenchContext context;
+  context.perThread = n / threads;
+  context.mpscQueue = &queue;
+  context.done = 0;
+  uint64_t total = static_cast<uint64_t> (context.perThread) * threads;
+
+  SystemWallClockMs time;
+  time.Start ();
+  std::vector<Ptr<SystemThread> > producers = StartProducers (&context, threads, &ProduceMpsc);
+  uint64_t received = 0;
+  BenchItem item;
+  while (received < total)
+    {
+      if (queue.Pop (item))
+        {
+          received++;
+        }
+      else
+        {
+          std::this_thread::yield ();
+        }
+    }
+  JoinProducers (producers);
+  return time.End ();
+}
+
+static uint64_t
+benchMutex (uint32_t n, uint32_t threads)
+{
+  MutexListQueue queue;
+  BenchContext context;
+  context.perThread = n / threads;
+  context.mutexQueue = &queue;
+  context.done = 0;
+  uint64_t total = static_cast<uint64_t> (context.perThread) * threads;
+
+  SystemWallClockMs time;
+  time.Start ();
+  std::vector<Ptr<SystemThread> > producers = StartProducers (&context, threads, &ProduceMutex);
+  uint64_t received = 0;
+  std::list<BenchItem> items;
+  while (received < total)
+    {
+      queue.Swap (items);
+      if (items.empty ())
+        {
+          std::this_thread::yield ();
+        }
+      while (!items.empty ())
+        {
+          items.pop_front ();
+          received++;
+        }
+    }
+  JoinProducers (producers);
+  return time.End ();
+}
+
+/**
+ * Keep the simulator running until all the producers are done.
+ * \param context the benchmark state
+ * \param threads the number of producers
+ */
+static void
+Poll (BenchContext *context, uint32_t threads)
+{
+  if (context->done < threads)
+    {
+      Simulator::Schedule (NanoSeconds (1), &Poll, context, threads);
+    }
+}
+
+static uint64_t
+benchSimulator (uint32_t n, uint32_t threads)
+{
+  BenchContext context;
+  context.perThread = n / threads;
+  context.done = 0;
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Schedule (NanoSeconds (1), &Poll, &context, threads);
+  std::vector<Ptr<SystemThread> > producers = StartProducers (&context, threads, &ProduceEvents);
+  Simulator::Run ();
+  JoinProducers (producers);
+  Simulator::Destroy ();
+  return time.End ();
+}
+
+static void
+runBench (uint64_t (*bench) (uint32_t, uint32_t), uint32_t n, uint32_t threads, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      uint64_t delay = (*bench) (n, threads);
+      minDelay = std::min (minDelay, delay);
+    }
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max<uint64_t> (minDelay, 1);
+  std::cout << ps << " events/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t threads = 4;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the insertion of events from other threads into the simulator");
+  cmd.AddValue ("n", "number of events", n);
+  cmd.AddValue ("threads", "number of producer threads", threads);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || threads == 0)
+    {
+      std::cerr << "Error-- number of events must be specified " <<
+        "by command-line argument --n=(number of events)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-context-queue with n=" << n << " and " << threads << " producer threads" << std::endl;
+
+  runBench (&benchMpsc, n, threads, minIterations, "lock-free MPSC queue (1024 items)");
+  runBench (&benchMutex, n, threads, minIterations, "list protected by a mutex");
+  runBench (&benchSimulator, n, threads, minIterations, "Simulator::ScheduleWithContext");
+
+  return 0;
+}
@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the serialization/deserialization
+// of the DMG/EDMG information elements carried by beacons, announce frames
+// and BRP frames, for various numbers of elements 'n'
+// Sample usage:  ./waf --run 'bench-dmg-information-elements --n=100000'
+
+#include "ns3/buffer.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/dmg-information-elements.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <limits>
+#include <algorithm>
+
+using namespace ns3;
+
+/**
+ * Serialize an information element into a new buffer and deserialize it
+ * into a new element of the same type.
+ *
+ * \param element the element to serialize
+ * \param copy the element to deserialize into
+ */
+static void
+SerializeDeserialize (const WifiInformationElement &element, WifiInformationElement &copy)
+{
+  Buffer buffer;
+  buffer.AddAtStart (element.GetSerializedSize ());
+  element.Serialize (buffer.Begin ());
+  copy.Deserialize (buffer.Begin ());
+}
+
+/**
+ * Create an Extended Schedule element announcing the maximum number of allocations.
+ *
+ * \return the Extended Schedule element
+ */
+static ExtendedScheduleElement
+CreateExtendedSchedule (void)
+{
+  ExtendedScheduleElement element;
+  for (uint8_t i = 0; i < 17; i++)
+    {
+      AllocationField field;
+      field.SetAllocationID (i + 1);
+      field.SetAllocationType (SERVICE_PERIOD_ALLOCATION);
+      field.SetSourceAid (i + 1);
+      field.SetDestinationAid (i + 2);
+      field.SetAllocationStart (1000 * i);
+      field.SetAllocationBlockDuration (1000);
+      field.SetNumberOfBlocks (1);
+      field.SetAllocationBlockPeriod (0);
+      element.AddAllocationField (field);
+    }
+  return element;
+}
+
+static void
+benchExtendedSchedule (uint32_t n)
+{
+  ExtendedScheduleElement element = CreateExtendedSchedule ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      ExtendedScheduleElement copy;
+      SerializeDeserialize (element, copy);
+    }
+}
+
+static void
+benchBeamRefinement (uint32_t n)
+{
+  BeamRefinementElement element;
+  element.SetAsBeamRefinementInitiator (true);
+  element.SetTxTrainResponse (true);
+  element.SetBsFbck (10);
+  element.SetSnrPresent (true);
+  element.SetNumberOfMeasurements (32);
+  element.SetEdmgExtensionFlag (true);
+  element.SetExtendedNumberOfMeasurements (64);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      BeamRefinementElement copy;
+      SerializeDeserialize (element, copy);
+    }
+}
+
+static void
+benchEdmgChannelMeasurementFeedback (uint32_t n)
+{
+  EDMGChannelMeasurementFeedbackElement element;
+  for (uint16_t i = 0; i < 32; i++)
+    {
+      EDMGSectorIDOrder order;
+      order.SectorID = i;
+      order.TXAntennaID = i % 4;
+      order.RXAntennaID = 0;
+      element.Add_EDMG_SectorIDOrder (order);
+      element.Add_BRP_CDOWN (i);
+    }
+  for (uint16_t i = 0; i < 63; i++)
+    {
+      element.Add_Tap_Delay (i);
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      EDMGChannelMeasurementFeedbackElement copy;
+      copy.SetSectorIdOrderSize (32);
+      copy.SetBrpCdownSize (32);
+      copy.SetTapsDelaySize (TAPS_63);
+      SerializeDeserialize (element, copy);
+    }
+}
+
+static void
+benchMimoSelectionControl (uint32_t n)
+{
+  MIMOSelectionControlElement element;
+  element.SetEDMGGroupID (1);
+  element.SetNumberOfMultiUserConfigurations (4);
+  element.SetMultiUserTransmissionConfigurationType (MU_Reciprocal);
+  for (uint8_t i = 0; i < 4; i++)
+    {
+      ReciprocalTransmissionConfig config;
+      config.reciprocalConfigGroupUserMask = 0xF;
+      for (uint8_t j = 0; j < 4; j++)
+        {
+          ReciprocalConfigData user;
+          user.ConfigurationAWVFeedbackID = i * 4 + j;
+          user.ConfigurationBRPCDOWN = j;
+          user.ConfigurationRXAntennaID = 0;
+          config.configList.push_back (user);
+        }
+      element.AddReciprocalMUBFTrainingBasedTransmissionConfig (config);
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      MIMOSelectionControlElement copy;
+      SerializeDeserialize (element, copy);
+    }
+}
+
+static uint64_t
+runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  (*bench) (n);
+  uint64_t deltaMs = time.End ();
+  return deltaMs;
+}
+
+static void
+runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      uint64_t delay = runBenchOneIteration (bench, n);
+      minDelay = std::min (minDelay, delay);
+    }
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max<uint64_t> (minDelay, 1);
+  std::cout << ps << " elements/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the serialization of the DMG/EDMG information elements");
+  cmd.AddValue ("n", "number of iterations", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of elements must be specified " <<
+        "by command-line argument --n=(number of elements)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-dmg-information-elements with n=" << n << std::endl;
+  std::cout << "Each iteration serializes an element into a buffer and deserializes it." << std::endl;
+
+  runBench (&benchExtendedSchedule, n, minIterations, "Extended Schedule element (17 allocations)");
+  runBench (&benchBeamRefinement, n, minIterations, "Beam Refinement element");
+  runBench (&benchEdmgChannelMeasurementFeedback, n, minIterations, "EDMG Channel Measurement Feedback element (32 sectors, 63 taps)");
+  runBench (&benchMimoSelectionControl, n, minIterations, "MIMO Selection Control element (4 configurations)");
+
+  return 0;
+}
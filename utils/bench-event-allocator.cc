@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the allocation of the simulation
+// events. It reproduces the event pattern of a BRP sweep: every TRN
+// subfield is a separate event measuring one AWV, and every subfield
+// restarts the timeout of the BRP feedback, cancelling the previous one.
+// The sweep is run with the EventAllocator free lists disabled, as every
+// event used to be allocated, and enabled.
+// Sample usage:  ./waf --run 'bench-event-allocator --n=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/event-allocator.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/** The measurement of a TRN subfield. */
+class TrnMeasurement : public SimpleRefCount<TrnMeasurement>
+{
+public:
+  /**
+   * \param awv the AWV the TRN subfield is received with.
+   */
+  TrnMeasurement (uint8_t awv)
+    : awv (awv)
+  {
+  }
+  uint8_t awv;  //!< The AWV.
+};
+
+/** A receiver sweeping its AWVs over the TRN subfields of BRP packets. */
+class BrpSweep
+{
+public:
+  /**
+   * \param subfields the number of TRN subfields to receive.
+   */
+  BrpSweep (uint32_t subfields)
+    : m_subfields (subfields),
+      m_received (0),
+      m_timeouts (0),
+      m_snr (0)
+  {
+  }
+  /** Start receiving the next TRN subfield. */
+  void StartTrnSubfield (void)
+  {
+    Ptr<TrnMeasurement> measurement = Create<TrnMeasurement> (m_received % 64);
+    Simulator::Schedule (NanoSeconds (291), &BrpSweep::EndTrnSubfield, this, measurement, 10.0);
+    m_feedbackTimeout.Cancel ();
+    m_feedbackTimeout = Simulator::Schedule (MicroSeconds (10), &BrpSweep::FeedbackTimeout, this);
+  }
+  /**
+   * Record the SNR of a TRN subfield.
+   * \param measurement the measurement of the subfield.
+   * \param snr the SNR of the subfield.
+   */
+  void EndTrnSubfield (Ptr<TrnMeasurement> measurement, double snr)
+  {
+    m_snr += snr + measurement->awv;
+    m_received++;
+    if (m_received < m_subfields)
+      {
+        StartTrnSubfield ();
+      }
+  }
+  /** The BRP feedback was not received in time. */
+  void FeedbackTimeout (void)
+  {
+    m_timeouts++;
+  }
+
+  uint32_t m_subfields;        //!< The number of TRN subfields to receive.
+  uint32_t m_received;         //!< The number of TRN subfields received.
+  uint32_t m_timeouts;         //!< The number of feedback timeouts.
+  double m_snr;                //!< The sum of the SNRs.
+  EventId m_feedbackTimeout;   //!< The timeout of the BRP feedback.
+};
+
+/** The result of a sweep. */
+struct SweepResult
+{
+  uint64_t delay;            //!< The wall clock time in milliseconds.
+  uint64_t heapAllocations;  //!< The number of events allocated from the heap.
+  uint64_t poolAllocations;  //!< The number of events allocated from the free lists.
+};
+
+static SweepResult
+benchSweep (uint32_t n, bool pool)
+{
+  EventAllocator::SetEnabled (pool);
+  EventAllocator::Release ();
+  EventAllocator::ResetCounters ();
+  BrpSweep sweep (n);
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::ScheduleNow (&BrpSweep::StartTrnSubfield, &sweep);
+  Simulator::Run ();
+  SweepResult result;
+  result.delay = time.End ();
+  result.heapAllocations = EventAllocator::GetHeapAllocations ();
+  result.poolAllocations = EventAllocator::GetPoolAllocations ();
+  Simulator::Destroy ();
+  if (sweep.m_received != n || sweep.m_timeouts != 1)
+    {
+      std::cerr << "Error-- the sweep did not complete" << std::endl;
+      exit (1);
+    }
+  return result;
+}
+
+static void
+runBench (uint32_t n, bool pool, uint32_t minIterations, char const *name)
+{
+  SweepResult best;
+  best.delay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      SweepResult result = benchSweep (n, pool);
+      if (result.delay < best.delay)
+        {
+          best = result;
+        }
+    }
+  // each subfield schedules its measurement and its feedback timeout
+  double ps = 2.0 * n;
+  ps *= 1000;
+  ps /= std::max<uint64_t> (best.delay, 1);
+  std::cout << ps << " events/s"
+            << " (" << best.delay << " ms elapsed, "
+            << best.heapAllocations << " heap allocations, "
+            << best.poolAllocations << " reused)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the allocation of the events of a BRP sweep");
+  cmd.AddValue ("n", "number of TRN subfields", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of TRN subfields must be specified " <<
+        "by command-line argument --n=(number of subfields)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-event-allocator with n=" << n << std::endl;
+
+  bool enabled = EventAllocator::IsEnabled ();
+  runBench (n, false, minIterations, "heap allocated events");
+  runBench (n, true, minIterations, "EventAllocator free lists");
+  EventAllocator::SetEnabled (enabled);
+
+  return 0;
+}
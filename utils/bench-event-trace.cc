@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program replays the event trace of a simulation against the
+// schedulers, to measure their throughput on the events of a real
+// simulation without running the model code. The trace is recorded by
+// running any simulation with the EventTraceFile global value set, e.g.:
+//  ./waf --run 'wifi-dmg-benchmarks --benchmarks=mu-mimo --EventTraceFile=mu-mimo.evt'
+// Sample usage:
+//  ./waf --run 'bench-event-trace --file=mu-mimo.evt'
+//  ./waf --run 'bench-event-trace --file=mu-mimo.evt --schedulers=ns3::MapScheduler,ns3::BucketHeapScheduler'
+
+#include "ns3/command-line.h"
+#include "ns3/event-trace-scheduler.h"
+#include "ns3/object-factory.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Replay a trace against a scheduler.
+ * \param records the records of the trace
+ * \param factory the factory of the scheduler
+ * \param mismatches the number of events run in a different order than recorded
+ * \return the wall clock time of the replay in milliseconds
+ */
+static uint64_t
+replay (const std::vector<EventTraceRecord> &records, ObjectFactory &factory, uint64_t &mismatches)
+{
+  Ptr<Scheduler> scheduler;
+  mismatches = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (std::vector<EventTraceRecord>::const_iterator i = records.begin (); i != records.end (); i++)
+    {
+      switch (i->type)
+        {
+        case EventTraceRecord::BEGIN:
+          scheduler = factory.Create<Scheduler> ();
+          break;
+        case EventTraceRecord::INSERT:
+          {
+            Scheduler::Event ev;
+            ev.impl = 0;
+            ev.key.m_ts = i->ts;
+            ev.key.m_uid = i->uid;
+            ev.key.m_context = i->context;
+            scheduler->Insert (ev);
+            break;
+          }
+        case EventTraceRecord::REMOVE_NEXT:
+          if (scheduler->RemoveNext ().key.m_uid != i->uid)
+            {
+              mismatches++;
+            }
+          break;
+        case EventTraceRecord::REMOVE:
+          {
+            Scheduler::Event ev;
+            ev.impl = 0;
+            ev.key.m_ts = i->ts;
+            ev.key.m_uid = i->uid;
+            ev.key.m_context = 0;
+            scheduler->Remove (ev);
+            break;
+          }
+        }
+    }
+  return time.End ();
+}
+
+/**
+ * Print the composition of a trace.
+ * \param records the records of the trace
+ */
+static void
+printStatistics (const std::vector<EventTraceRecord> &records)
+{
+  uint64_t simulations = 0;
+  uint64_t inserts = 0;
+  uint64_t sameTimestamp = 0;
+  uint64_t now = 0;
+  uint64_t run = 0;
+  uint64_t cancelled = 0;
+  uint64_t removed = 0;
+  uint64_t lastTs = std::numeric_limits<uint64_t>::max ();
+  for (std::vector<EventTraceRecord>::const_iterator i = records.begin (); i != records.end (); i++)
+    {
+      switch (i->type)
+        {
+        case EventTraceRecord::BEGIN:
+          simulations++;
+          lastTs = std::numeric_limits<uint64_t>::max ();
+          break;
+        case EventTraceRecord::INSERT:
+          inserts++;
+          sameTimestamp += (i->ts == lastTs) ? 1 : 0;
+          now += (i->ts == i->now) ? 1 : 0;
+          lastTs = i->ts;
+          break;
+        case EventTraceRecord::REMOVE_NEXT:
+          run++;
+          cancelled += i->cancelled ? 1 : 0;
+          break;
+        case EventTraceRecord::REMOVE:
+          removed++;
+          break;
+        }
+    }
+  std::cout << simulations << " simulations, "
+            << inserts << " events scheduled ("
+            << now << " for now, "
+            << sameTimestamp << " with the timestamp of the previous one), "
+            << run << " removed by the simulator ("
+            << cancelled << " cancelled), "
+            << removed << " removed by the model" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string fileName;
+  std::string schedulers = "ns3::MapScheduler,ns3::HeapScheduler,ns3::CalendarScheduler,"
+    "ns3::PriorityQueueScheduler,ns3::BucketHeapScheduler";
+  uint32_t minIterations = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Replay an event trace against the schedulers");
+  cmd.AddValue ("file", "the event trace recorded with the EventTraceFile global value", fileName);
+  cmd.AddValue ("schedulers", "comma separated list of the schedulers to replay the trace against", schedulers);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (fileName.empty ())
+    {
+      std::cerr << "Error-- the event trace must be specified " <<
+        "by command-line argument --file=(event trace)" << std::endl;
+      exit (1);
+    }
+  EventTraceReader reader;
+  if (!reader.Open (fileName))
+    {
+      std::cerr << "Error-- " << fileName << " is not an event trace" << std::endl;
+      exit (1);
+    }
+  std::vector<EventTraceRecord> records;
+  EventTraceRecord record;
+  while (reader.Read (record))
+    {
+      records.push_back (record);
+    }
+  std::cout << "Running bench-event-trace with " << fileName << std::endl;
+  printStatistics (records);
+
+  std::istringstream list (schedulers);
+  std::string name;
+  while (std::getline (list, name, ','))
+    {
+      ObjectFactory factory (name);
+      uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+      uint64_t mismatches = 0;
+      for (uint32_t i = 0; i < minIterations; i++)
+        {
+          minDelay = std::min (minDelay, replay (records, factory, mismatches));
+        }
+      double ps = records.size ();
+      ps *= 1000;
+      ps /= std::max<uint64_t> (minDelay, 1);
+      std::cout << ps << " operations/s"
+                << " (" << minDelay << " ms elapsed";
+      if (mismatches > 0)
+        {
+          std::cout << ", " << mismatches << " events out of order";
+        }
+      std::cout << ")\t" << name << std::endl;
+    }
+
+  return 0;
+}
@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+## -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Runs a scratch (or example) program over a grid of CommandLine arguments,
+# with several independent RNG runs per configuration, in parallel worker
+# processes, and merges the CSV files written by the runs.
+#
+#   ./utils/dmg-sweep.py evaluate_per_vs_snr_11ad \
+#       --grid payloadSize=1000,1472 --grid simulationTime=1 --runs 5
+#
+# writes sweep-evaluate_per_vs_snr_11ad/PER_vs_SNR_11ad.csv, whose rows are
+# prefixed with the swept arguments and the RngRun of the run that wrote them.
+#
+# Each run works in its own directory, so the CSV files of the runs do not
+# overwrite each other. The read-only inputs of the DMG programs (DmgFiles:
+# Q-D channels, codebooks and error models) are linked into every run
+# directory, so all the workers read the same files through the page cache
+# instead of copies of them.
+
+import os
+import sys
+import re
+import csv
+import time
+import shutil
+import optparse
+import itertools
+import subprocess
+from concurrent.futures import ThreadPoolExecutor
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+import utils
+
+TOP_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+## Directories holding read-only inputs, shared by all the runs.
+SHARED_INPUTS = ['DmgFiles']
+
+
+def read_build_dir():
+    """! Find the build directory from the waf lock file, as test.py does
+    @return the absolute path of the build directory
+    """
+    for lock in [".lock-waf_" + sys.platform + "_build", ".lock-waf_linux2_build"]:
+        path = os.path.join(TOP_DIR, lock)
+        if os.path.exists(path):
+            for line in open(path, "rt"):
+                if line.startswith("out_dir ="):
+                    return os.path.join(TOP_DIR, eval(line.split('=', 1)[1].strip()))
+    print('The .lock-waf ... file was not found.  You must do waf build before running a sweep.', file=sys.stderr)
+    sys.exit(2)
+
+
+def set_library_path(build_dir):
+    """! Make the ns-3 libraries of the build visible to the programs, as test.py does
+    @param build_dir the build directory
+    @return none
+    """
+    variable = "DYLD_LIBRARY_PATH" if sys.platform == "darwin" else "LD_LIBRARY_PATH"
+    paths = [os.path.join(build_dir, 'lib')]
+    if os.environ.get(variable):
+        paths.append(os.environ[variable])
+    os.environ[variable] = ":".join(paths)
+
+
+def find_program(build_dir, name):
+    """! Find a built program by the name of its source file
+    @param build_dir the build directory
+    @param name the name of the program, e.g. evaluate_per_vs_snr_11ad
+    @return the absolute path of the executable
+    """
+    programs = utils.get_list_from_file(os.path.join(build_dir, 'build-status.py'), 'ns3_runnable_programs')
+    pattern = re.compile(r'^ns3-[^-]+-' + re.escape(name) + r'(-[a-z]+)?$')
+    for program in programs:
+        if pattern.match(os.path.basename(program)) or os.path.basename(program) == name:
+            path = program if os.path.isabs(program) else os.path.join(TOP_DIR, program)
+            # The scratch programs are built without the ns3-<version>- prefix
+            for candidate in [path, os.path.join(os.path.dirname(path), name)]:
+                if os.path.exists(candidate):
+                    return candidate
+    print('Program %s was not found, is it built?' % name, file=sys.stderr)
+    sys.exit(2)
+
+
+def parse_values(text):
+    """! Expand the values of a grid axis
+    @param text comma-separated values, or start:stop:step for an inclusive numeric range
+    @return the list of values, as strings
+    """
+    if ':' in text and ',' not in text:
+        fields = text.split(':')
+        if len(fields) == 3:
+            try:
+                start, stop, step = [float(field) for field in fields]
+            except ValueError:
+                return [text]
+            if step <= 0:
+                print('The step of range %s must be positive' % text, file=sys.stderr)
+                sys.exit(2)
+            values = []
+            count = int(round((stop - start) / step))
+            integral = all(float(field).is_integer() for field in fields)
+            for i in range(count + 1):
+                value = start + i * step
+                values.append(str(int(value)) if integral else repr(round(value, 12)))
+            return values
+    return text.split(',')
+
+
+def parse_grid(axes):
+    """! Parse the grid axes given on the command line
+    @param axes list of name=values strings
+    @return list of (name, values) pairs, in the order given
+    """
+    grid = []
+    for axis in axes:
+        if '=' not in axis:
+            print('Grid axis %s must be name=values' % axis, file=sys.stderr)
+            sys.exit(2)
+        name, values = axis.split('=', 1)
+        grid.append((name, parse_values(values)))
+    return grid
+
+
+def prepare_run_dir(run_dir):
+    """! Create the directory of a run and link the shared inputs into it
+    @param run_dir the directory of the run
+    @return none
+    """
+    os.makedirs(run_dir)
+    for shared in SHARED_INPUTS:
+        source = os.path.join(TOP_DIR, shared)
+        if os.path.exists(source):
+            os.symlink(source, os.path.join(run_dir, shared))
+
+
+def run_one(program, run):
+    """! Run one configuration in its directory
+    @param program the executable
+    @param run dictionary describing the run
+    @return the run, with its exit status and duration
+    """
+    args = [program] + ['--%s=%s' % (name, value) for name, value in run['params']]
+    args.append('--RngRun=%d' % run['rngRun'])
+    args += run['extra']
+    start = time.time()
+    with open(os.path.join(run['dir'], 'stdout.txt'), 'w') as out:
+        status = subprocess.call(args, cwd=run['dir'], stdout=out, stderr=subprocess.STDOUT)
+    run['status'] = status
+    run['duration'] = time.time() - start
+    return run
+
+
+def merge_csv(runs, names, output_dir):
+    """! Merge the CSV files written by the successful runs
+    @param runs the runs, in grid order
+    @param names the CSV file names to merge, all the CSV files found if empty
+    @param output_dir the directory of the merged files
+    @return the list of merged files
+    """
+    if not names:
+        found = set()
+        for run in runs:
+            if run['status'] == 0:
+                found.update(f for f in os.listdir(run['dir']) if f.endswith('.csv'))
+        names = sorted(found)
+
+    merged = []
+    for name in names:
+        header = None
+        rows = []
+        for run in runs:
+            path = os.path.join(run['dir'], name)
+            if run['status'] != 0 or not os.path.exists(path):
+                continue
+            prefix = [value for _, value in run['params']] + [str(run['rngRun'])]
+            with open(path, newline='') as f:
+                lines = list(csv.reader(f))
+            if not lines:
+                continue
+            # The programs write a header line of column names first
+            if header is None:
+                header = [n for n, _ in run['params']] + ['RngRun'] + lines[0]
+            rows += [prefix + line for line in lines[1:]]
+        if header is None:
+            continue
+        path = os.path.join(output_dir, name)
+        with open(path, 'w', newline='') as f:
+            writer = csv.writer(f)
+            writer.writerow(header)
+            writer.writerows(rows)
+        merged.append(path)
+    return merged
+
+
+def main(argv):
+    parser = optparse.OptionParser(usage="%prog [options] program [-- extra program arguments]")
+    parser.add_option("-g", "--grid", action="append", default=[], metavar="NAME=VALUES",
+                      help="sweep the CommandLine argument NAME over VALUES, either "
+                      "v1,v2,... or start:stop:step (can be repeated)")
+    parser.add_option("-r", "--runs", type="int", default=1,
+                      help="number of independent RNG runs of each configuration")
+    parser.add_option("--first-run", type="int", default=1,
+                      help="RngRun of the first run of each configuration")
+    parser.add_option("-j", "--jobs", type="int", default=os.cpu_count() or 1,
+                      help="number of configurations run in parallel (default: number of cores)")
+    parser.add_option("-c", "--csv", action="append", default=[], metavar="FILE",
+                      help="CSV file written by the program to merge (can be repeated, "
+                      "default: all the CSV files of the runs)")
+    parser.add_option("-o", "--output-dir", default="",
+                      help="directory of the runs and of the merged files (default: sweep-PROGRAM)")
+    parser.add_option("-f", "--force", action="store_true", default=False,
+                      help="remove the output directory if it exists")
+    parser.add_option("-n", "--dry-run", action="store_true", default=False,
+                      help="print the command lines of the runs without running them")
+    (options, args) = parser.parse_args(argv)
+
+    if not args:
+        parser.print_help()
+        return 2
+    name = args[0]
+    extra = args[1:]
+    grid = parse_grid(options.grid)
+    if options.runs < 1 or options.jobs < 1:
+        print('--runs and --jobs must be positive', file=sys.stderr)
+        return 2
+
+    output_dir = os.path.abspath(options.output_dir or 'sweep-' + name)
+    names = [n for n, _ in grid]
+    configurations = list(itertools.product(*[values for _, values in grid]))
+    runs = []
+    for config in configurations:
+        for rngRun in range(options.first_run, options.first_run + options.runs):
+            index = len(runs)
+            runs.append({'params': list(zip(names, config)),
+                         'rngRun': rngRun,
+                         'extra': extra,
+                         'dir': os.path.join(output_dir, 'run-%d' % index)})
+
+    if options.dry_run:
+        for run in runs:
+            print(' '.join([name] + ['--%s=%s' % p for p in run['params']]
+                           + ['--RngRun=%d' % run['rngRun']] + extra))
+        return 0
+
+    build_dir = read_build_dir()
+    program = find_program(build_dir, name)
+    set_library_path(build_dir)
+
+    if os.path.exists(output_dir):
+        if not options.force:
+            print('%s exists, use --force to replace it' % output_dir, file=sys.stderr)
+            return 2
+        shutil.rmtree(output_dir)
+    os.makedirs(output_dir)
+    for run in runs:
+        prepare_run_dir(run['dir'])
+
+    # Each run is a separate process, the threads only wait for them
+    print('%d configurations x %d runs on %d workers' % (len(configurations), options.runs, options.jobs))
+    failed = 0
+    with ThreadPoolExecutor(max_workers=options.jobs) as executor:
+        for done, run in enumerate(executor.map(lambda r: run_one(program, r), runs), 1):
+            state = 'PASS' if run['status'] == 0 else 'FAIL (%d)' % run['status']
+            command = [name] + ['--%s=%s' % p for p in run['params']] + ['--RngRun=%d' % run['rngRun']]
+            print('[%d/%d] %s: %s (%.1fs)' % (done, len(runs), state, ' '.join(command), run['duration']))
+            failed += run['status'] != 0
+
+    # Summary of the runs, to find the directory of a given configuration
+    with open(os.path.join(output_dir, 'runs.csv'), 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['Run'] + names + ['RngRun', 'Status', 'Duration'])
+        for index, run in enumerate(runs):
+            writer.writerow([index] + [value for _, value in run['params']]
+                            + [run['rngRun'], run['status'], '%.3f' % run['duration']])
+
+    for path in merge_csv(runs, options.csv, output_dir):
+        print('Merged %s' % path)
+    if failed:
+        print('%d of %d runs failed, see stdout.txt in their directories' % (failed, len(runs)), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
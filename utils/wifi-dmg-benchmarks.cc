@@ -0,0 +1,979 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the simulation speed of the DMG/EDMG models.
+//
+// The microbenchmarks measure the hot paths of the 60 GHz stack in isolation:
+//  - qd-channel-gain: Q-D channel gain of complete transmit sector sweeps, with
+//    the trace index (hence the channel) changing before every sweep.
+//  - array-pattern: parametric codebook array patterns over the angle grid.
+//  - error-model: DmgErrorModel::GetChunkSuccessRate over all the DMG SC MCSs.
+//  - interference-trn: InterferenceHelper SNR of TRN subfields with interferers.
+//  - k-best-combinations: DmgWifiMac::FindKBestCombinations of a 2x2 SISO feedback.
+//  - beacon-serialization: serialization and deserialization of a DMG Beacon.
+//
+// The macrobenchmarks are scaled versions of complete scenarios:
+//  - qd-dense-single-ap: evaluate_qd_dense_scenario_single_ap with --numSTAs
+//    DMG STAs sending UDP traffic to a single DMG PCP/AP.
+//  - mu-mimo: evaluate_11ay_mu_mimo, i.e., association, SLS and MU-MIMO BFT
+//    between an EDMG PCP/AP and two EDMG STAs.
+//
+// The output is one CSV line per benchmark with the following columns:
+// benchmark,type,status,operations,wall_ms,operations_per_s,events,events_per_s,peak_rss_kb
+//
+// wall_ms is the fastest of --repetitions runs. events is the number of
+// simulator events executed (macrobenchmarks and simulation based
+// microbenchmarks only). peak_rss_kb is the peak resident set size of the
+// process when the benchmark completes, run a single benchmark to get its own
+// peak. A benchmark whose input files are missing is reported as skipped.
+// --eventPool=false allocates every simulator event from the heap, to
+// measure the EventAllocator free lists on the event heavy benchmarks.
+// --eventDelays records the delay of every scheduled event for
+// bench-simulator --file, and --SchedulerType selects the scheduler of the
+// benchmarks, e.g. --SchedulerType=ns3::BucketHeapScheduler.
+//
+// Sample usage (from the top level directory so the DmgFiles folder is found):
+// ./waf --run 'wifi-dmg-benchmarks --benchmarks=micro --n=100000'
+// ./waf --run 'wifi-dmg-benchmarks --benchmarks=qd-dense-single-ap --numSTAs=8 --simulationTime=1'
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/spectrum-module.h"
+#include "ns3/wifi-module.h"
+
+using namespace ns3;
+
+/**
+ * The result of a benchmark.
+ */
+struct BenchmarkResult
+{
+  BenchmarkResult ()
+    : operations (0),
+      wallMs (0),
+      events (0)
+  {
+  }
+
+  uint64_t operations;  //!< The number of operations (calls, frames or packets) performed.
+  int64_t wallMs;       //!< The wall clock time of the measured part in milliseconds.
+  uint64_t events;      //!< The number of simulator events executed.
+};
+
+/// Signature of a benchmark, returns false if the benchmark cannot run
+typedef bool (*BenchmarkFunction) (BenchmarkResult &result);
+
+/**
+ * A benchmark.
+ */
+struct Benchmark
+{
+  const char *name;             //!< The name of the benchmark.
+  const char *type;             //!< Either micro or macro.
+  BenchmarkFunction function;   //!< The function running the benchmark.
+};
+
+/* Parameters of the benchmarks */
+static uint32_t g_n = 10000;                                       //!< The number of operations of the microbenchmarks.
+static uint32_t g_numStas = 4;                                     //!< The number of DMG STAs of qd-dense-single-ap.
+static double g_simulationTime = 0.5;                              //!< The simulated time of the macrobenchmarks in seconds.
+static std::string g_dmgFiles = "DmgFiles/";                       //!< The folder containing the DMG input files.
+static std::string g_apCodebook = "Codebook/CODEBOOK_URA_AP_28x.txt";                        //!< DMG PCP/AP codebook.
+static std::string g_staCodebook = "Codebook/CODEBOOK_URA_STA_28x.txt";                      //!< DMG STA codebook.
+static std::string g_apMimoCodebook = "Codebook/CODEBOOK_URA_AP_28x_AzEl_SU-MIMO_2x2_27.txt"; //!< EDMG PCP/AP MIMO codebook.
+static std::string g_staMimoCodebook = "Codebook/CODEBOOK_URA_STA_28x_AzEl_27.txt";          //!< EDMG STA MIMO codebook.
+
+/**
+ * \param fileName the name of the file relative to the DMG files folder.
+ * \return true if the file can be opened.
+ */
+static bool
+DmgFileExists (std::string fileName)
+{
+  std::ifstream file ((g_dmgFiles + fileName).c_str ());
+  return file.good ();
+}
+
+/**
+ * \return the peak resident set size of the process in kB, 0 if unknown.
+ */
+static uint64_t
+GetPeakRssKb (void)
+{
+#ifndef _WIN32
+  struct rusage usage;
+  if (getrusage (RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef __APPLE__
+      return usage.ru_maxrss / 1024;
+#else
+      return usage.ru_maxrss;
+#endif
+    }
+#endif
+  return 0;
+}
+
+/** The file the delays of the events are recorded to. */
+static std::ofstream g_eventDelays;
+
+/**
+ * The default MapScheduler recording the delay of every scheduled event,
+ * in seconds, in the format read by bench-simulator --file.
+ */
+class DelayRecordingScheduler : public MapScheduler
+{
+public:
+  /**
+   * rief Get the type ID.
+   * eturn the object TypeId
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::DelayRecordingScheduler")
+      .SetParent<MapScheduler> ()
+      .SetGroupName ("Core")
+      .AddConstructor<DelayRecordingScheduler> ()
+    ;
+    return tid;
+  }
+  virtual void Insert (const Scheduler::Event &ev)
+  {
+    g_eventDelays << (TimeStep (ev.key.m_ts) - Simulator::Now ()).GetSeconds () << "\n";
+    MapScheduler::Insert (ev);
+  }
+};
+
+NS_OBJECT_ENSURE_REGISTERED (DelayRecordingScheduler);
+
+/**
+ * Populate the ARP cache of all the nodes so that no ARP frame is exchanged.
+ */
+static void
+PopulateArpCache (void)
+{
+  Ptr<ArpCache> arp = CreateObject<ArpCache> ();
+  arp->SetAliveTimeout (Seconds (3600 * 24 * 365));
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      Ptr<Ipv4L3Protocol> ip = (*i)->GetObject<Ipv4L3Protocol> ();
+      ObjectVectorValue interfaces;
+      ip->GetAttribute ("InterfaceList", interfaces);
+      for (ObjectVectorValue::Iterator j = interfaces.Begin (); j != interfaces.End (); j++)
+        {
+          Ptr<Ipv4Interface> ipIface = (j->second)->GetObject<Ipv4Interface> ();
+          Ptr<NetDevice> device = ipIface->GetDevice ();
+          Mac48Address addr = Mac48Address::ConvertFrom (device->GetAddress ());
+          for (uint32_t k = 0; k < ipIface->GetNAddresses (); k++)
+            {
+              Ipv4Address ipAddr = ipIface->GetAddress (k).GetLocal ();
+              if (ipAddr == Ipv4Address::GetLoopback ())
+                {
+                  continue;
+                }
+              ArpCache::Entry *entry = arp->Add (ipAddr);
+              entry->MarkWaitReply (0);
+              entry->MarkAlive (addr);
+            }
+        }
+    }
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      Ptr<Ipv4L3Protocol> ip = (*i)->GetObject<Ipv4L3Protocol> ();
+      ObjectVectorValue interfaces;
+      ip->GetAttribute ("InterfaceList", interfaces);
+      for (ObjectVectorValue::Iterator j = interfaces.Begin (); j != interfaces.End (); j++)
+        {
+          Ptr<Ipv4Interface> ipIface = (j->second)->GetObject<Ipv4Interface> ();
+          ipIface->SetAttribute ("ArpCache", PointerValue (arp));
+        }
+    }
+}
+
+/**
+ * Create a spectrum channel using the Q-D propagation engine.
+ * \param qdFolder the folder of the Q-D files relative to the QdChannel folder.
+ * \param engine the created Q-D propagation engine.
+ * \return the spectrum channel.
+ */
+static Ptr<MultiModelSpectrumChannel>
+CreateQdChannel (std::string qdFolder, Ptr<QdPropagationEngine> &engine)
+{
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  engine = CreateObject<QdPropagationEngine> ();
+  engine->SetAttribute ("QDModelFolder", StringValue (g_dmgFiles + "QdChannel/" + qdFolder));
+  channel->AddSpectrumPropagationLossModel (CreateObject<QdPropagationLossModel> (engine));
+  channel->SetPropagationDelayModel (CreateObject<QdPropagationDelayModel> (engine));
+  return channel;
+}
+
+/**
+ * \param channel the spectrum channel.
+ * \return a PHY helper configured as in the Q-D scenarios.
+ */
+static SpectrumDmgWifiPhyHelper
+CreatePhyHelper (Ptr<MultiModelSpectrumChannel> channel)
+{
+  SpectrumDmgWifiPhyHelper spectrumWifiPhy = SpectrumDmgWifiPhyHelper::Default ();
+  spectrumWifiPhy.SetChannel (channel);
+  spectrumWifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
+  spectrumWifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
+  spectrumWifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  spectrumWifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  return spectrumWifiPhy;
+}
+
+/*************************** Microbenchmarks ***************************/
+
+/**
+ * Evaluate a complete transmit sector sweep between two DMG devices.
+ * \param txPhy the transmitting PHY.
+ * \param rxPhy the receiving PHY.
+ * \param txVector the TXVECTOR of the SSW frames.
+ * \param sweep the sector sweep.
+ * \param operations the number of channel gain evaluations.
+ */
+static void
+SweepSectors (Ptr<SpectrumDmgWifiPhy> txPhy, Ptr<SpectrumDmgWifiPhy> rxPhy, WifiTxVector txVector,
+              const SECTOR_SWEEP_CONFIGURATION_LIST *sweep, uint64_t *operations)
+{
+  std::vector<double> snrList;
+  txPhy->CalculateSectorSweepSnr (rxPhy, txVector, *sweep, snrList);
+  *operations += snrList.size ();
+}
+
+static bool
+BenchQdChannelGain (BenchmarkResult &result)
+{
+  if (!DmgFileExists ("QdChannel/SingleNodeMobility/QdFiles/Tx0Rx1.txt")
+      || !DmgFileExists (g_apCodebook) || !DmgFileExists (g_staCodebook))
+    {
+      return false;
+    }
+
+  /* The Q-D trace index changes every millisecond, which invalidates the cached channel gains */
+  Ptr<QdPropagationEngine> engine;
+  Ptr<MultiModelSpectrumChannel> channel = CreateQdChannel ("SingleNodeMobility/", engine);
+  engine->SetAttribute ("Interval", TimeValue (MilliSeconds (1)));
+  SpectrumDmgWifiPhyHelper spectrumWifiPhy = CreatePhyHelper (channel);
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  DmgWifiHelper wifi;
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgAdhocWifiMac");
+  wifi.SetCodebook ("ns3::CodebookParametric", "FileName", StringValue (g_dmgFiles + g_apCodebook));
+  NetDeviceContainer txDevice = wifi.Install (spectrumWifiPhy, wifiMac, nodes.Get (0));
+  wifi.SetCodebook ("ns3::CodebookParametric", "FileName", StringValue (g_dmgFiles + g_staCodebook));
+  NetDeviceContainer rxDevice = wifi.Install (spectrumWifiPhy, wifiMac, nodes.Get (1));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  Ptr<WifiNetDevice> txNetDevice = StaticCast<WifiNetDevice> (txDevice.Get (0));
+  Ptr<SpectrumDmgWifiPhy> txPhy = StaticCast<SpectrumDmgWifiPhy> (txNetDevice->GetPhy ());
+  Ptr<SpectrumDmgWifiPhy> rxPhy = StaticCast<SpectrumDmgWifiPhy> (StaticCast<WifiNetDevice> (rxDevice.Get (0))->GetPhy ());
+  Ptr<Codebook> codebook = txPhy->GetCodebook ();
+  SECTOR_SWEEP_CONFIGURATION_LIST sweep;
+  for (AntennaID antenna = 1; antenna <= codebook->GetTotalNumberOfAntennas (); antenna++)
+    {
+      for (SectorID sector = 1; sector <= codebook->GetNumberSectorsPerAntenna (antenna); sector++)
+        {
+          sweep.push_back (std::make_pair (std::make_pair (antenna, sector), 1));
+        }
+    }
+  WifiTxVector txVector = txNetDevice->GetRemoteStationManager ()->GetDmgControlTxVector ();
+
+  /* The first sweep, once the devices are initialized, loads the Q-D traces */
+  uint64_t operations = 0;
+  Simulator::Schedule (MicroSeconds (500), &SweepSectors, txPhy, rxPhy, txVector, &sweep, &operations);
+  Simulator::Stop (MilliSeconds (1));
+  Simulator::Run ();
+  uint64_t events = Simulator::GetEventCount ();
+
+  /* Then one sweep per Q-D trace */
+  uint32_t sweeps = std::max<uint32_t> (1, std::min<uint32_t> (g_n / std::max<uint32_t> (sweep.size (), 1), 999));
+  operations = 0;
+  for (uint32_t i = 0; i < sweeps; i++)
+    {
+      Simulator::Schedule (MicroSeconds (1000 * i + 500), &SweepSectors, txPhy, rxPhy, txVector, &sweep, &operations);
+    }
+  Simulator::Stop (MilliSeconds (sweeps));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  result.wallMs = clock.End ();
+  result.events = Simulator::GetEventCount () - events;
+  result.operations = operations;
+  Simulator::Destroy ();
+  return true;
+}
+
+/**
+ * Parametric codebook giving access to the calculation of the array patterns.
+ */
+class BenchmarkCodebook : public CodebookParametric
+{
+public:
+  using CodebookParametric::CalculateArrayPatterns;
+};
+
+static bool
+BenchArrayPattern (BenchmarkResult &result)
+{
+  if (!DmgFileExists (g_apCodebook))
+    {
+      return false;
+    }
+
+  /* Patterns are calculated on demand at the requested angles as with the Q-D traces */
+  Ptr<BenchmarkCodebook> codebook = CreateObject<BenchmarkCodebook> ();
+  codebook->SetAttribute ("PrecalculatePatterns", BooleanValue (false));
+  codebook->SetAttribute ("FileName", StringValue (g_dmgFiles + g_apCodebook));
+
+  uint32_t patterns = codebook->GetNumberSectorsPerAntenna (1) + 1;
+  uint32_t angles = std::min<uint32_t> (std::max<uint32_t> (g_n / patterns, 1), 361 * 181);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < angles; i++)
+    {
+      codebook->CalculateArrayPatterns (1, i % 361, i / 361);
+    }
+  result.wallMs = clock.End ();
+  result.operations = static_cast<uint64_t> (angles) * patterns;
+  codebook->Dispose ();
+  return true;
+}
+
+static bool
+BenchErrorModel (BenchmarkResult &result)
+{
+  if (!DmgFileExists ("ErrorModel/LookupTable_1458.txt"))
+    {
+      return false;
+    }
+
+  Ptr<DmgErrorModel> errorModel = CreateObject<DmgErrorModel> ();
+  errorModel->SetAttribute ("FileName", StringValue (g_dmgFiles + "ErrorModel/LookupTable_1458.txt"));
+  std::vector<WifiMode> modes;
+  modes.push_back (DmgWifiPhy::GetDMG_MCS1 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS2 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS3 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS4 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS5 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS6 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS7 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS8 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS9 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS10 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS11 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS12 ());
+
+  WifiTxVector txVector;
+  txVector.SetChannelWidth (2160);
+  double sum = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < g_n; i++)
+    {
+      WifiMode mode = modes[i % modes.size ()];
+      txVector.SetMode (mode);
+      /* SNR from -5 dB to 25 dB in 0.1 dB steps */
+      double snr = DbToRatio (-5.0 + 0.1 * ((i / modes.size ()) % 301));
+      sum += errorModel->GetChunkSuccessRate (mode, txVector, snr, 8 * 1500);
+    }
+  result.wallMs = clock.End ();
+  result.operations = g_n;
+  NS_ABORT_IF (sum < 0);
+  return true;
+}
+
+/**
+ * State of the TRN subfields reception of the interference-trn benchmark.
+ */
+struct TrnReception
+{
+  InterferenceHelper interference;  //!< The interference helper.
+  WifiTxVector txVector;            //!< The TXVECTOR of the TRN subfields.
+  uint32_t subfields;               //!< The number of TRN subfields to receive.
+  uint32_t received;                //!< The number of TRN subfields received so far.
+  double snr;                       //!< The sum of the SNRs of the TRN subfields.
+};
+
+static void StartTrnSubfield (TrnReception *reception);
+
+/**
+ * Calculate the SNR of a TRN subfield at its end and start the next one.
+ * \param reception the reception state.
+ * \param event the event of the TRN subfield.
+ */
+static void
+EndTrnSubfield (TrnReception *reception, Ptr<Event> event)
+{
+  reception->snr += reception->interference.CalculatePlcpTrnSnr (event);
+  reception->received++;
+  if ((reception->received % (4 * TRN_UNIT_SIZE)) == 0)
+    {
+      /* End of the TRN field of the PPDU, the next PPDU starts right away */
+      reception->interference.NotifyRxEnd ();
+    }
+  if (reception->received < reception->subfields)
+    {
+      StartTrnSubfield (reception);
+    }
+}
+
+/**
+ * Start receiving a TRN subfield, every TRN field is made of four TRN units
+ * and is disturbed by two overlapping interferers.
+ * \param reception the reception state.
+ */
+static void
+StartTrnSubfield (TrnReception *reception)
+{
+  uint32_t index = reception->received % (4 * TRN_UNIT_SIZE);
+  if (index == 0)
+    {
+      reception->interference.NotifyRxStart ();
+      reception->interference.AddForeignSignal (TRN_SUBFIELD_DURATION * 6, DbmToW (-75));
+    }
+  else if (index == 2 * TRN_UNIT_SIZE)
+    {
+      reception->interference.AddForeignSignal (TRN_SUBFIELD_DURATION * 3, DbmToW (-70));
+    }
+  double rxPowerW = DbmToW (-60.0 - (index % TRN_UNIT_SIZE));
+  Ptr<Event> event = reception->interference.Add (reception->txVector, TRN_SUBFIELD_DURATION, rxPowerW);
+  Simulator::Schedule (TRN_SUBFIELD_DURATION, &EndTrnSubfield, reception, event);
+}
+
+static bool
+BenchInterferenceTrn (BenchmarkResult &result)
+{
+  TrnReception reception;
+  reception.interference.SetNoiseFigure (DbToRatio (10));
+  reception.txVector.SetMode (DmgWifiPhy::GetDMG_MCS1 ());
+  reception.txVector.SetChannelWidth (2160);
+  reception.subfields = g_n;
+  reception.received = 0;
+  reception.snr = 0;
+  /* The interference helper keeps a zero power sentinel at time zero */
+  Simulator::Schedule (MicroSeconds (1), &StartTrnSubfield, &reception);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  result.wallMs = clock.End ();
+  result.events = Simulator::GetEventCount ();
+  result.operations = reception.received;
+  Simulator::Destroy ();
+  NS_ABORT_IF (reception.snr < 0);
+  return true;
+}
+
+static bool
+BenchKBestCombinations (BenchmarkResult &result)
+{
+  /* SISO feedback of a 2x2 SU-MIMO BFT with 32 sectors per transmit antenna */
+  const uint8_t nTxAntennas = 2;
+  const uint8_t nRxAntennas = 2;
+  const uint16_t k = 15;
+  Ptr<UniformRandomVariable> snr = CreateObject<UniformRandomVariable> ();
+  snr->SetStream (1);
+  MIMO_FEEDBACK_MAP feedback;
+  for (uint8_t tx = 1; tx <= nTxAntennas; tx++)
+    {
+      for (uint8_t rx = 1; rx <= nRxAntennas; rx++)
+        {
+          for (uint8_t sector = 1; sector <= 32; sector++)
+            {
+              feedback[std::make_tuple (tx, rx, sector)] = DbToRatio (snr->GetValue (-5, 25));
+            }
+        }
+    }
+
+  Ptr<DmgStaWifiMac> mac = CreateObject<DmgStaWifiMac> ();
+  uint32_t calls = std::max<uint32_t> (g_n / 100, 1);
+  uint64_t candidates = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < calls; i++)
+    {
+      candidates += mac->FindKBestCombinations (k, nTxAntennas, nRxAntennas, feedback).size ();
+    }
+  result.wallMs = clock.End ();
+  result.operations = calls;
+  NS_ABORT_IF (candidates == 0);
+  return true;
+}
+
+static bool
+BenchBeaconSerialization (BenchmarkResult &result)
+{
+  /* DMG Beacon of an EDMG PCP/AP announcing a full Extended Schedule */
+  ExtDMGBeacon beacon;
+  beacon.SetSsid (Ssid ("benchmark"));
+  beacon.SetBeaconIntervalUs (102400);
+  beacon.SetTimestamp (1000);
+  beacon.AddWifiInformationElement (Create<DmgCapabilities> ());
+  Ptr<EdmgCapabilities> capabilities = Create<EdmgCapabilities> ();
+  capabilities->AddSubElement (Create<BeamformingCapabilitySubelement> ());
+  capabilities->AddSubElement (Create<PhyCapabilitiesSubelement> ());
+  beacon.AddWifiInformationElement (capabilities);
+  beacon.AddWifiInformationElement (Create<EdmgOperationElement> ());
+  beacon.AddWifiInformationElement (Create<NextDmgAti> ());
+  Ptr<ExtendedScheduleElement> schedule = Create<ExtendedScheduleElement> ();
+  for (uint8_t i = 0; i < 17; i++)
+    {
+      AllocationField field;
+      field.SetAllocationID (i + 1);
+      field.SetAllocationType (SERVICE_PERIOD_ALLOCATION);
+      field.SetSourceAid (i + 1);
+      field.SetDestinationAid (0);
+      field.SetAllocationStart (5000 * i);
+      field.SetAllocationBlockDuration (5000);
+      field.SetNumberOfBlocks (1);
+      schedule->AddAllocationField (field);
+    }
+  beacon.AddWifiInformationElement (schedule);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < g_n; i++)
+    {
+      Ptr<Packet> packet = Create<Packet> ();
+      packet->AddHeader (beacon);
+      ExtDMGBeacon copy;
+      packet->RemoveHeader (copy);
+    }
+  result.wallMs = clock.End ();
+  result.operations = g_n;
+  return true;
+}
+
+/*************************** Macrobenchmarks ***************************/
+
+/**
+ * Start the application of a DMG STA once it is associated.
+ * \param application the application.
+ * \param address the MAC address of the DMG PCP/AP.
+ * \param aid the association ID.
+ */
+static void
+StationAssociated (Ptr<Application> application, Mac48Address address, uint16_t aid)
+{
+  application->StartApplication ();
+}
+
+/**
+ * Count the packets received by the sinks.
+ * \param packets the number of packets received.
+ * \param packet the received packet.
+ * \param from the address of the sender.
+ */
+static void
+PacketReceived (uint64_t *packets, Ptr<const Packet> packet, const Address &from)
+{
+  (*packets)++;
+}
+
+static bool
+BenchQdDenseSingleAp (BenchmarkResult &result)
+{
+  if (!DmgFileExists ("QdChannel/DenseScenario/QdFiles/Tx0Rx1.txt")
+      || !DmgFileExists (g_apCodebook) || !DmgFileExists (g_staCodebook))
+    {
+      return false;
+    }
+  NS_ABORT_MSG_IF ((g_numStas == 0) || (g_numStas > 10), "The dense scenario supports 1 to 10 DMG STAs");
+
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  Ptr<QdPropagationEngine> engine;
+  Ptr<MultiModelSpectrumChannel> channel = CreateQdChannel ("DenseScenario/", engine);
+  SpectrumDmgWifiPhyHelper spectrumWifiPhy = CreatePhyHelper (channel);
+
+  NodeContainer apWifiNode;
+  apWifiNode.Create (1);
+  NodeContainer staWifiNodes;
+  staWifiNodes.Create (g_numStas);
+
+  DmgWifiHelper wifi;
+  DmgWifiMacHelper wifiMacHelper = DmgWifiMacHelper::Default ();
+  Ssid ssid = Ssid ("DenseScenario");
+  wifiMacHelper.SetType ("ns3::DmgApWifiMac",
+                         "Ssid", SsidValue (ssid),
+                         "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (13),
+                         "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                         "ATIPresent", BooleanValue (false));
+  wifi.SetCodebook ("ns3::CodebookParametric", "FileName", StringValue (g_dmgFiles + g_apCodebook));
+  NetDeviceContainer apDevice = wifi.Install (spectrumWifiPhy, wifiMacHelper, apWifiNode);
+
+  wifiMacHelper.SetType ("ns3::DmgStaWifiMac",
+                         "Ssid", SsidValue (ssid), "ActiveProbing", BooleanValue (false));
+  wifi.SetCodebook ("ns3::CodebookParametric", "FileName", StringValue (g_dmgFiles + g_staCodebook));
+  NetDeviceContainer staDevices = wifi.Install (spectrumWifiPhy, wifiMacHelper, staWifiNodes);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apWifiNode);
+  mobility.Install (staWifiNodes);
+
+  InternetStackHelper stack;
+  stack.Install (apWifiNode);
+  stack.Install (staWifiNodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer apInterface = address.Assign (apDevice);
+  address.Assign (staDevices);
+  PopulateArpCache ();
+
+  /* Each DMG STA sends UDP traffic to the DMG PCP/AP once associated */
+  uint64_t packets = 0;
+  for (uint32_t i = 0; i < staWifiNodes.GetN (); i++)
+    {
+      OnOffHelper src ("ns3::UdpSocketFactory", InetSocketAddress (apInterface.GetAddress (0), 9000 + i));
+      src.SetAttribute ("PacketSize", UintegerValue (1448));
+      src.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1e6]"));
+      src.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+      src.SetAttribute ("DataRate", DataRateValue (DataRate ("300Mbps")));
+      ApplicationContainer srcApp = src.Install (staWifiNodes.Get (i));
+      srcApp.Start (Seconds (g_simulationTime + 1));
+      srcApp.Stop (Seconds (g_simulationTime));
+
+      PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9000 + i));
+      ApplicationContainer sinkApp = sinkHelper.Install (apWifiNode.Get (0));
+      sinkApp.Start (Seconds (0.0));
+      sinkApp.Get (0)->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&PacketReceived, &packets));
+
+      Ptr<DmgStaWifiMac> staWifiMac = StaticCast<DmgStaWifiMac> (StaticCast<WifiNetDevice> (staDevices.Get (i))->GetMac ());
+      staWifiMac->TraceConnectWithoutContext ("Assoc", MakeBoundCallback (&StationAssociated, srcApp.Get (0)));
+    }
+
+  Simulator::Stop (Seconds (g_simulationTime));
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  result.wallMs = clock.End ();
+  result.events = Simulator::GetEventCount ();
+  result.operations = packets;
+  Simulator::Destroy ();
+  return true;
+}
+
+/**
+ * State of the MU-MIMO benchmark.
+ */
+struct MuMimoState
+{
+  uint32_t beamformedLinks;  //!< The number of links beamformed during the DTI.
+  bool muMimoCompleted;      //!< Flag to indicate if the MU-MIMO BFT is completed.
+  uint32_t muMimoCount;      //!< The number of completed MU-MIMO BFTs.
+};
+
+static MuMimoState g_muMimo;  //!< The state of the MU-MIMO benchmark.
+
+/**
+ * Count the links beamformed during the DTI.
+ * \param attributes the attributes of the SLS.
+ */
+static void
+MuMimoSlsCompleted (SlsCompletionAttrbitutes attributes)
+{
+  if (attributes.accessPeriod == CHANNEL_ACCESS_DTI)
+    {
+      g_muMimo.beamformedLinks++;
+    }
+}
+
+/**
+ * Perform a TXSS with the EDMG PCP/AP in the first DTI following the association.
+ * \param wifiMac the MAC of the EDMG STA.
+ * \param firstDti flag to indicate if the TXSS has not been performed yet.
+ * \param address the MAC address of the EDMG PCP/AP.
+ * \param dtiDuration the duration of the DTI.
+ */
+static void
+MuMimoStaDtiStarted (Ptr<DmgStaWifiMac> wifiMac, bool *firstDti, Mac48Address address, Time dtiDuration)
+{
+  if (wifiMac->IsAssociated () && *firstDti)
+    {
+      wifiMac->Perform_TXSS_TXOP (wifiMac->GetBssid ());
+      DynamicCast<CodebookParametric> (wifiMac->GetCodebook ())->AppendAwvsForSuMimoBFT_27 ();
+      *firstDti = false;
+    }
+}
+
+/**
+ * Start the MU-MIMO BFT once the links with both EDMG STAs are beamformed.
+ * \param wifiMac the MAC of the EDMG PCP/AP.
+ * \param address the MAC address of the EDMG PCP/AP.
+ * \param dtiDuration the duration of the DTI.
+ */
+static void
+MuMimoApDtiStarted (Ptr<DmgApWifiMac> wifiMac, Mac48Address address, Time dtiDuration)
+{
+  if ((g_muMimo.beamformedLinks == 4) && !g_muMimo.muMimoCompleted)
+    {
+      EDMGGroupTuples groupTuples = wifiMac->GetEdmgGroupIdSetElement ()->GetEDMGGroupTuples ();
+      Simulator::Schedule (MicroSeconds (1), &DmgWifiMac::StartMuMimoBeamforming, wifiMac,
+                           true, groupTuples.begin ()->groupID);
+    }
+}
+
+/**
+ * Send the SISO feedback when polled by the EDMG PCP/AP.
+ * \param wifiMac the MAC of the EDMG STA.
+ * \param from the MAC address of the EDMG PCP/AP.
+ */
+static void
+MuMimoSisoFbckPolled (Ptr<DmgWifiMac> wifiMac, Mac48Address from)
+{
+  wifiMac->SendBrpFbckFrame (from, false);
+}
+
+/**
+ * Select the MIMO candidates at the end of the SISO phase and start the MIMO phase.
+ * \param wifiMac the MAC of the EDMG PCP/AP.
+ * \param feedbackMap the SISO feedback.
+ * \param numberOfTxAntennas the number of transmit antennas.
+ * \param numberOfRxAntennas the number of EDMG STAs in the MU group.
+ */
+static void
+MuMimoSisoPhaseCompleted (Ptr<DmgWifiMac> wifiMac, MIMO_FEEDBACK_MAP feedbackMap,
+                          uint8_t numberOfTxAntennas, uint8_t numberOfRxAntennas)
+{
+  MIMO_ANTENNA_COMBINATIONS_LIST mimoCandidates =
+      wifiMac->FindKBestCombinations (15, numberOfTxAntennas, numberOfRxAntennas, feedbackMap);
+  DynamicCast<CodebookParametric> (wifiMac->GetCodebook ())->AppendAwvsForSuMimoBFT_27 ();
+  wifiMac->StartMuMimoMimoPhase (mimoCandidates, false);
+}
+
+/**
+ * Record the completion of the MU-MIMO BFT at the EDMG PCP/AP.
+ */
+static void
+MuMimoMimoPhaseCompleted (void)
+{
+  g_muMimo.muMimoCompleted = true;
+  g_muMimo.muMimoCount++;
+}
+
+static bool
+BenchMuMimo (BenchmarkResult &result)
+{
+  if (!DmgFileExists ("QdChannel/MU-MIMO-Scenarios/IndoorMuMimo120/Output/Ns3/QdFiles/Tx0Rx1.txt")
+      || !DmgFileExists (g_apMimoCodebook) || !DmgFileExists (g_staMimoCodebook)
+      || !DmgFileExists ("ErrorModel/LookupTable_1458_ay.txt"))
+    {
+      return false;
+    }
+
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  g_muMimo.beamformedLinks = 0;
+  g_muMimo.muMimoCompleted = false;
+  g_muMimo.muMimoCount = 0;
+
+  DmgWifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ay);
+  Ptr<QdPropagationEngine> engine;
+  Ptr<MultiModelSpectrumChannel> channel = CreateQdChannel ("MU-MIMO-Scenarios/IndoorMuMimo120/Output/Ns3/", engine);
+  SpectrumDmgWifiPhyHelper spectrumWifiPhy = CreatePhyHelper (channel);
+  spectrumWifiPhy.SetErrorRateModel ("ns3::DmgErrorModel",
+                                     "FileName", StringValue (g_dmgFiles + "ErrorModel/LookupTable_1458_ay.txt"));
+  spectrumWifiPhy.Set ("SupportMuMimo", BooleanValue (true));
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("EDMG_SC_MCS1"));
+
+  NodeContainer wifiNodes;
+  wifiNodes.Create (3);
+
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  Ssid ssid = Ssid ("MU-MIMO");
+  wifiMac.SetType ("ns3::DmgApWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (16),
+                   "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                   "EDMGSupported", BooleanValue (true));
+  wifi.SetCodebook ("ns3::CodebookParametric", "FileName", StringValue (g_dmgFiles + g_apMimoCodebook));
+  NetDeviceContainer apDevice = wifi.Install (spectrumWifiPhy, wifiMac, wifiNodes.Get (0));
+
+  wifiMac.SetType ("ns3::DmgStaWifiMac",
+                   "Ssid", SsidValue (ssid), "ActiveProbing", BooleanValue (false),
+                   "EDMGSupported", BooleanValue (true));
+  wifi.SetCodebook ("ns3::CodebookParametric", "FileName", StringValue (g_dmgFiles + g_staMimoCodebook));
+  NetDeviceContainer staDevices;
+  staDevices.Add (wifi.Install (spectrumWifiPhy, wifiMac, wifiNodes.Get (1)));
+  staDevices.Add (wifi.Install (spectrumWifiPhy, wifiMac, wifiNodes.Get (2)));
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiNodes);
+
+  Ptr<DmgApWifiMac> apWifiMac = StaticCast<DmgApWifiMac> (StaticCast<WifiNetDevice> (apDevice.Get (0))->GetMac ());
+  apWifiMac->TraceConnectWithoutContext ("MuMimoSisoPhaseCompleted", MakeBoundCallback (&MuMimoSisoPhaseCompleted, apWifiMac));
+  apWifiMac->TraceConnectWithoutContext ("MuMimoMimoPhaseCompleted", MakeCallback (&MuMimoMimoPhaseCompleted));
+  apWifiMac->TraceConnectWithoutContext ("DTIStarted", MakeBoundCallback (&MuMimoApDtiStarted, apWifiMac));
+  apWifiMac->TraceConnectWithoutContext ("SLSCompleted", MakeCallback (&MuMimoSlsCompleted));
+  bool firstDti[2] = {true, true};
+  for (uint32_t i = 0; i < staDevices.GetN (); i++)
+    {
+      Ptr<DmgStaWifiMac> staWifiMac = StaticCast<DmgStaWifiMac> (StaticCast<WifiNetDevice> (staDevices.Get (i))->GetMac ());
+      staWifiMac->TraceConnectWithoutContext ("SLSCompleted", MakeCallback (&MuMimoSlsCompleted));
+      staWifiMac->TraceConnectWithoutContext ("MuMimoSisoFbckPolled", MakeBoundCallback (&MuMimoSisoFbckPolled, staWifiMac));
+      staWifiMac->TraceConnectWithoutContext ("DTIStarted", MakeBoundCallback (&MuMimoStaDtiStarted, staWifiMac, &firstDti[i]));
+    }
+
+  Simulator::Stop (Seconds (g_simulationTime));
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  result.wallMs = clock.End ();
+  result.events = Simulator::GetEventCount ();
+  result.operations = g_muMimo.muMimoCount;
+  Simulator::Destroy ();
+  return true;
+}
+
+/*************************** Driver ***************************/
+
+static const Benchmark g_benchmarks[] = {
+  { "qd-channel-gain", "micro", &BenchQdChannelGain },
+  { "array-pattern", "micro", &BenchArrayPattern },
+  { "error-model", "micro", &BenchErrorModel },
+  { "interference-trn", "micro", &BenchInterferenceTrn },
+  { "k-best-combinations", "micro", &BenchKBestCombinations },
+  { "beacon-serialization", "micro", &BenchBeaconSerialization },
+  { "qd-dense-single-ap", "macro", &BenchQdDenseSingleAp },
+  { "mu-mimo", "macro", &BenchMuMimo },
+};
+
+/**
+ * Run a benchmark and print its CSV line.
+ * \param benchmark the benchmark.
+ * \param repetitions the number of runs to take the fastest of.
+ * \param os the output stream.
+ */
+static void
+RunBenchmark (const Benchmark &benchmark, uint32_t repetitions, std::ostream &os)
+{
+  BenchmarkResult best;
+  bool run = true;
+  for (uint32_t i = 0; (i < repetitions) && run; i++)
+    {
+      BenchmarkResult result;
+      run = (*benchmark.function) (result);
+      if (run && ((i == 0) || (result.wallMs < best.wallMs)))
+        {
+          best = result;
+        }
+    }
+  os << benchmark.name << "," << benchmark.type << ",";
+  if (!run)
+    {
+      os << "skipped,0,0,0,0,0," << GetPeakRssKb () << std::endl;
+      return;
+    }
+  double seconds = std::max<int64_t> (best.wallMs, 1) / 1000.0;
+  os << "ok,"
+     << best.operations << ","
+     << best.wallMs << ","
+     << best.operations / seconds << ","
+     << best.events << ","
+     << best.events / seconds << ","
+     << GetPeakRssKb () << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string benchmarks = "all";
+  std::string output;
+  uint32_t repetitions = 1;
+  bool eventPool = true;
+  std::string eventDelays;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the simulation speed of the DMG/EDMG models");
+  cmd.AddValue ("benchmarks", "Comma separated list of benchmarks, micro, macro or all", benchmarks);
+  cmd.AddValue ("n", "The number of operations of the microbenchmarks", g_n);
+  cmd.AddValue ("numSTAs", "The number of DMG STAs in qd-dense-single-ap", g_numStas);
+  cmd.AddValue ("simulationTime", "The simulated time of the macrobenchmarks in seconds", g_simulationTime);
+  cmd.AddValue ("repetitions", "The number of runs of each benchmark, the fastest is reported", repetitions);
+  cmd.AddValue ("dmgFiles", "The folder containing the DMG input files", g_dmgFiles);
+  cmd.AddValue ("apCodebook", "The DMG PCP/AP codebook relative to the DMG files folder", g_apCodebook);
+  cmd.AddValue ("staCodebook", "The DMG STA codebook relative to the DMG files folder", g_staCodebook);
+  cmd.AddValue ("apMimoCodebook", "The EDMG PCP/AP MIMO codebook relative to the DMG files folder", g_apMimoCodebook);
+  cmd.AddValue ("staMimoCodebook", "The EDMG STA MIMO codebook relative to the DMG files folder", g_staMimoCodebook);
+  cmd.AddValue ("output", "The CSV file to write, the standard output if empty", output);
+  cmd.AddValue ("eventPool", "Reuse the memory of the simulator events", eventPool);
+  cmd.AddValue ("eventDelays", "The file to record the delays of the simulator events to for bench-simulator", eventDelays);
+  cmd.Parse (argc, argv);
+
+  EventAllocator::SetEnabled (eventPool);
+  if (!eventDelays.empty ())
+    {
+      g_eventDelays.open (eventDelays.c_str (), std::ios::out | std::ios::trunc);
+      NS_ABORT_MSG_IF (!g_eventDelays.is_open (), "Cannot open " << eventDelays);
+      g_eventDelays.precision (12);
+      Config::SetGlobal ("SchedulerType", StringValue ("ns3::DelayRecordingScheduler"));
+    }
+
+  std::set<std::string> selected;
+  std::istringstream list (benchmarks);
+  std::string name;
+  while (std::getline (list, name, ','))
+    {
+      selected.insert (name);
+    }
+
+  std::ofstream file;
+  if (!output.empty ())
+    {
+      file.open (output.c_str (), std::ios::out | std::ios::trunc);
+      NS_ABORT_MSG_IF (!file.is_open (), "Cannot open " << output);
+    }
+  std::ostream &os = output.empty () ? std::cout : file;
+
+  os << "benchmark,type,status,operations,wall_ms,operations_per_s,events,events_per_s,peak_rss_kb" << std::endl;
+  bool found = false;
+  for (uint32_t i = 0; i < sizeof (g_benchmarks) / sizeof (g_benchmarks[0]); i++)
+    {
+      const Benchmark &benchmark = g_benchmarks[i];
+      if (selected.count ("all") || selected.count (benchmark.type) || selected.count (benchmark.name))
+        {
+          RunBenchmark (benchmark, std::max<uint32_t> (repetitions, 1), os);
+          found = true;
+        }
+    }
+  NS_ABORT_MSG_IF (!found, "No benchmark matches " << benchmarks);
+
+  return 0;
+}